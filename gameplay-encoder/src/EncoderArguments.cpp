@@ -19,6 +19,7 @@ EncoderArguments::EncoderArguments(size_t argc, const char** argv) :
     _fontSize(0),
     _parseError(false),
     _fontPreview(false),
+    _fontDistanceField(false),
     _textOutput(false),
     _daeOutput(false),
     _optimizeAnimations(false)
@@ -152,6 +153,11 @@ const std::vector<EncoderArguments::HeightmapOption>& EncoderArguments::getHeigh
     return _heightmaps;
 }
 
+const std::vector<float>& EncoderArguments::getLevelScreenSizes() const
+{
+    return _levelScreenSizes;
+}
+
 bool EncoderArguments::parseErrorOccured() const
 {
     return _parseError;
@@ -197,10 +203,18 @@ void EncoderArguments::printUsage() const
         "\t\tFilename is the name of the image (PNG) to be saved.\n" \
         "\t\tMultiple -h arguments can be supplied to generate more than one heightmap.\n" \
         "\t\tFor 24-bit packed height data use -hp instead of -h.\n");
+    LOG(1, "  -lod \"<screen sizes>\"\n" \
+        "\t\tGenerates levels of detail for each mesh by simplifying it, one per\n" \
+        "\t\tscreen size, each with at most half the vertices of the level before.\n" \
+        "\t\tA level is drawn while the model is smaller on screen than its size,\n" \
+        "\t\ta fraction of the viewport height. Sizes should be in quotes with a\n" \
+        "\t\tspace between each size, from the largest to the smallest.\n");
     LOG(1, "\n");
     LOG(1, "TTF file options:\n");
     LOG(1, "  -s <size>\tSize of the font.\n");
     LOG(1, "  -p\t\tOutput font preview.\n");
+    LOG(1, "  -sdf\t\tOutput glyphs as signed distance fields, which can be drawn\n" \
+        "\t\tsharply at any size and with outlines and shadows.\n");
     LOG(1, "\n");
     exit(8);
 }
@@ -210,6 +224,11 @@ bool EncoderArguments::fontPreviewEnabled() const
     return _fontPreview;
 }
 
+bool EncoderArguments::fontDistanceFieldEnabled() const
+{
+    return _fontDistanceField;
+}
+
 bool EncoderArguments::textOutputEnabled() const
 {
     return _textOutput;
@@ -328,6 +347,36 @@ void EncoderArguments::readOption(const std::vector<std::string>& options, size_
             return;
         }
         break;
+    case 'l':
+        if (str.compare("-lod") == 0)
+        {
+            (*index)++;
+            if (*index < options.size())
+            {
+                // Split the screen size list into tokens
+                std::string sizes(options[*index]);
+                char* size = strtok(&sizes[0], " ");
+                while (size)
+                {
+                    float screenSize = (float)atof(size);
+                    if (screenSize <= 0.0f || (!_levelScreenSizes.empty() && screenSize >= _levelScreenSizes.back()))
+                    {
+                        LOG(1, "Error: -lod screen sizes must be positive and decreasing.\n");
+                        _parseError = true;
+                        return;
+                    }
+                    _levelScreenSizes.push_back(screenSize);
+                    size = strtok(NULL, " ");
+                }
+            }
+            else
+            {
+                LOG(1, "Error: missing argument for -lod.\n");
+                _parseError = true;
+                return;
+            }
+        }
+        break;
     case 'o':
         // Optimization flag
         if (str == "-oa")
@@ -395,6 +444,12 @@ void EncoderArguments::readOption(const std::vector<std::string>& options, size_
         _fontPreview = true;
         break;
     case 's':
+        if (str.compare("-sdf") == 0)
+        {
+            _fontDistanceField = true;
+            break;
+        }
+
         // Font Size
 
         // old format was -s##
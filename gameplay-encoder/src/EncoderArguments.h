@@ -82,6 +82,11 @@ public:
 
     const std::vector<HeightmapOption>& getHeightmapOptions() const;
 
+    /**
+     * Returns the screen sizes of the levels of detail to generate for each mesh.
+     */
+    const std::vector<float>& getLevelScreenSizes() const;
+
     /**
      * Returns true if an error occurred while parsing the command line arguments.
      */
@@ -100,6 +105,7 @@ public:
     void printUsage() const;
 
     bool fontPreviewEnabled() const;
+    bool fontDistanceFieldEnabled() const;
     bool textOutputEnabled() const;
     bool DAEOutputEnabled() const;
     bool optimizeAnimationsEnabled() const;
@@ -145,6 +151,7 @@ private:
 
     bool _parseError;
     bool _fontPreview;
+    bool _fontDistanceField;
     bool _textOutput;
     bool _daeOutput;
     bool _optimizeAnimations;
@@ -152,6 +159,7 @@ private:
     std::vector<std::string> _groupAnimationNodeId;
     std::vector<std::string> _groupAnimationAnimationId;
     std::vector<HeightmapOption> _heightmaps;
+    std::vector<float> _levelScreenSizes;
 
 };
 
@@ -7,6 +7,8 @@ namespace gameplay
 Font::Font(void) :
     style(0),
     size(0),
+    format(BITMAP),
+    distanceFieldSpread(0),
     texMapWidth(0),
     texMapHeight(0)
 {
@@ -32,6 +34,8 @@ void Font::writeBinary(FILE* file)
     write(style, file);
     write(size, file);
     write(charset, file);
+    write(format, file);
+    write(distanceFieldSpread, file);
     writeBinaryObjects(glyphs, file);
     write(texMapWidth, file);
     write(texMapHeight, file);
@@ -44,6 +48,8 @@ void Font::writeText(FILE* file)
     fprintfElement(file, "style", style);
     fprintfElement(file, "size", size);
     fprintfElement(file, "alphabet", charset);
+    fprintfElement(file, "format", format);
+    fprintfElement(file, "distanceFieldSpread", distanceFieldSpread);
     //fprintfElement(file, "glyphs", glyphs);
     fprintfElement(file, "texMapWidth", texMapWidth);
     fprintfElement(file, "texMapHeight", texMapHeight);
@@ -30,6 +30,8 @@ public:
     unsigned int style;
     unsigned int size;
     std::string  charset;
+    unsigned int format;
+    unsigned int distanceFieldSpread;
     std::list<Glyph*> glyphs;
     unsigned int texMapWidth;
     unsigned int texMapHeight;
@@ -42,6 +44,12 @@ public:
         ITALIC = 2,
         BOLD_ITALIC = 4
     };
+
+    enum FontFormat
+    {
+        BITMAP = 0,
+        DISTANCE_FIELD = 1
+    };
 };
 
 }
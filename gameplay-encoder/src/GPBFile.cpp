@@ -315,6 +315,13 @@ void GPBFile::adjust()
         computeBounds(*i);
     }
 
+    const std::vector<float>& levelScreenSizes = EncoderArguments::getInstance()->getLevelScreenSizes();
+    if (!levelScreenSizes.empty())
+    {
+        LOG(1, "Generating levels of detail.\n");
+        generateLevels(levelScreenSizes);
+    }
+
     if (EncoderArguments::getInstance()->optimizeAnimationsEnabled())
     {
         LOG(1, "Optimizing animations.\n");
@@ -393,6 +400,85 @@ void GPBFile::computeBounds(Node* node)
     }
 }
 
+void GPBFile::generateLevels(const std::vector<float>& screenSizes)
+{
+    // Models that share a mesh share its levels.
+    std::map<Mesh*, std::vector<Mesh*> > meshLevels;
+    for (std::list<Node*>::const_iterator i = _nodes.begin(); i != _nodes.end(); ++i)
+    {
+        Model* model = (*i)->getModel();
+        Mesh* mesh = model ? model->getMesh() : NULL;
+        if (mesh == NULL)
+        {
+            continue;
+        }
+        std::map<Mesh*, std::vector<Mesh*> >::iterator itr = meshLevels.find(mesh);
+        if (itr == meshLevels.end())
+        {
+            itr = meshLevels.insert(std::make_pair(mesh, std::vector<Mesh*>())).first;
+            generateLevels(mesh, screenSizes.size(), itr->second);
+        }
+        for (size_t j = 0, count = itr->second.size(); j < count; ++j)
+        {
+            model->addLevel(itr->second[j], screenSizes[j]);
+        }
+    }
+}
+
+void GPBFile::generateLevels(Mesh* mesh, size_t levelCount, std::vector<Mesh*>& levels)
+{
+    assert(mesh);
+    size_t vertexCount = mesh->getVertexCount();
+    float extent = std::max(mesh->bounds.max.x - mesh->bounds.min.x,
+        std::max(mesh->bounds.max.y - mesh->bounds.min.y, mesh->bounds.max.z - mesh->bounds.min.z));
+    if (vertexCount == 0 || extent <= 0.0f)
+    {
+        return;
+    }
+
+    // Start from cells about as large as the spacing of the vertices over a surface, and
+    // grow them until the mesh is simple enough.
+    float cellSize = extent / sqrt((float)vertexCount);
+    for (size_t level = 1; level <= levelCount; ++level)
+    {
+        size_t targetCount = vertexCount / 2;
+        Mesh* simpleMesh = NULL;
+        for (unsigned int attempt = 0; attempt < 32 && simpleMesh == NULL; ++attempt)
+        {
+            simpleMesh = mesh->simplify(cellSize);
+            if (simpleMesh == NULL)
+            {
+                break;
+            }
+            if (simpleMesh->getVertexCount() > targetCount)
+            {
+                for (std::vector<MeshPart*>::iterator i = simpleMesh->parts.begin(); i != simpleMesh->parts.end(); ++i)
+                {
+                    delete *i;
+                }
+                delete simpleMesh;
+                simpleMesh = NULL;
+                cellSize *= 1.25f;
+            }
+        }
+        if (simpleMesh == NULL)
+        {
+            LOG(1, "Warning: Mesh '%s' cannot be simplified to level %u.\n", mesh->getId().c_str(), (unsigned int)level);
+            return;
+        }
+
+        char id[32];
+        sprintf(id, "_lod%u", (unsigned int)level);
+        simpleMesh->setId(mesh->getId() + id);
+        simpleMesh->computeBounds();
+        addMesh(simpleMesh);
+        levels.push_back(simpleMesh);
+        LOG(2, "Generated level %u of mesh '%s' with %u vertices.\n", (unsigned int)level, mesh->getId().c_str(), (unsigned int)simpleMesh->getVertexCount());
+
+        vertexCount = simpleMesh->getVertexCount();
+    }
+}
+
 void GPBFile::optimizeAnimations()
 {
     const unsigned int animationCount = _animations.getAnimationCount();
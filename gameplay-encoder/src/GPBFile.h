@@ -21,7 +21,7 @@ namespace gameplay
  * Increment the version number when making a change that break binary compatibility.
  * [0] is major, [1] is minor.
  */
-const unsigned char GPB_VERSION[2] = {1, 2};
+const unsigned char GPB_VERSION[2] = {1, 4};
 
 /**
  * The GamePlay Binary file class handles writing the GamePlay Binary file.
@@ -122,6 +122,21 @@ private:
      */
     void computeBounds(Node* node);
 
+    /**
+     * Generates levels of detail for the meshes of all models, one per screen size.
+     */
+    void generateLevels(const std::vector<float>& screenSizes);
+
+    /**
+     * Generates simplified meshes of a mesh, each with at most half the vertices of the one before.
+     *
+     * @param mesh The mesh to simplify.
+     * @param levelCount The number of levels to generate.
+     * @param levels The list to add the generated meshes to. Fewer levels are generated
+     *               when the mesh cannot be simplified further.
+     */
+    void generateLevels(Mesh* mesh, size_t levelCount, std::vector<Mesh*>& levels);
+
     /**
      * Optimizes animation data by removing unneccessary channels and keyframes.
      */
@@ -220,4 +220,122 @@ void Mesh::computeBounds()
     bounds.radius = sqrt(bounds.radius);
 }
 
+Mesh* Mesh::simplify(float cellSize) const
+{
+    assert(cellSize > 0.0f);
+
+    if (vertices.empty() || parts.empty())
+    {
+        return NULL;
+    }
+
+    Vector3 min(FLT_MAX, FLT_MAX, FLT_MAX);
+    for (std::vector<Vertex>::const_iterator i = vertices.begin(); i != vertices.end(); ++i)
+    {
+        min.x = std::min(min.x, i->position.x);
+        min.y = std::min(min.y, i->position.y);
+        min.z = std::min(min.z, i->position.z);
+    }
+
+    // Cluster the vertices by the grid cell they are in.
+    typedef std::pair<int, std::pair<int, int> > Cell;
+    std::map<Cell, unsigned int> cells;
+    std::vector<unsigned int> clusters(vertices.size());
+    std::vector<Vector3> centers;
+    std::vector<unsigned int> counts;
+    for (size_t i = 0, count = vertices.size(); i < count; ++i)
+    {
+        const Vector3& position = vertices[i].position;
+        Cell cell((int)floor((position.x - min.x) / cellSize),
+            std::make_pair((int)floor((position.y - min.y) / cellSize), (int)floor((position.z - min.z) / cellSize)));
+        std::map<Cell, unsigned int>::iterator itr = cells.find(cell);
+        if (itr == cells.end())
+        {
+            itr = cells.insert(std::make_pair(cell, (unsigned int)centers.size())).first;
+            centers.push_back(Vector3(0.0f, 0.0f, 0.0f));
+            counts.push_back(0);
+        }
+        unsigned int cluster = itr->second;
+        clusters[i] = cluster;
+        centers[cluster].x += position.x;
+        centers[cluster].y += position.y;
+        centers[cluster].z += position.z;
+        ++counts[cluster];
+    }
+
+    // Each cluster keeps the vertex nearest to the average of its vertices, so the
+    // simplified mesh has valid attributes and skin weights.
+    size_t clusterCount = centers.size();
+    for (size_t i = 0; i < clusterCount; ++i)
+    {
+        centers[i].scale(1.0f / counts[i]);
+    }
+    std::vector<unsigned int> kept(clusterCount, 0);
+    std::vector<float> distances(clusterCount, FLT_MAX);
+    for (size_t i = 0, count = vertices.size(); i < count; ++i)
+    {
+        unsigned int cluster = clusters[i];
+        float d = centers[cluster].distanceSquared(vertices[i].position);
+        if (d < distances[cluster])
+        {
+            distances[cluster] = d;
+            kept[cluster] = (unsigned int)i;
+        }
+    }
+
+    Mesh* mesh = new Mesh();
+    mesh->_vertexFormat = _vertexFormat;
+    for (size_t i = 0; i < clusterCount; ++i)
+    {
+        mesh->vertices.push_back(vertices[kept[i]]);
+    }
+
+    // Triangles that collapse, or that repeat another triangle, are dropped.
+    typedef std::pair<unsigned int, std::pair<unsigned int, unsigned int> > Triangle;
+    for (std::vector<MeshPart*>::const_iterator i = parts.begin(); i != parts.end(); ++i)
+    {
+        const MeshPart* part = *i;
+        MeshPart* simplePart = new MeshPart();
+        std::map<Triangle, bool> triangles;
+        for (unsigned int j = 0, indexCount = (unsigned int)part->getIndicesCount(); j + 2 < indexCount; j += 3)
+        {
+            unsigned int a = clusters[part->getIndex(j)];
+            unsigned int b = clusters[part->getIndex(j + 1)];
+            unsigned int c = clusters[part->getIndex(j + 2)];
+            if (a == b || b == c || a == c)
+            {
+                continue;
+            }
+
+            // Rotate the smallest index first, keeping the winding.
+            while (a > b || a > c)
+            {
+                unsigned int t = a;
+                a = b;
+                b = c;
+                c = t;
+            }
+            if (!triangles.insert(std::make_pair(Triangle(a, std::make_pair(b, c)), true)).second)
+            {
+                continue;
+            }
+            simplePart->addIndex(a);
+            simplePart->addIndex(b);
+            simplePart->addIndex(c);
+        }
+        mesh->addMeshPart(simplePart);
+
+        if (simplePart->getIndicesCount() == 0)
+        {
+            for (std::vector<MeshPart*>::iterator j = mesh->parts.begin(); j != mesh->parts.end(); ++j)
+            {
+                delete *j;
+            }
+            delete mesh;
+            return NULL;
+        }
+    }
+    return mesh;
+}
+
 }
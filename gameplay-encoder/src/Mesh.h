@@ -62,6 +62,16 @@ public:
 
     void computeBounds();
 
+    /**
+     * Creates a simplified copy of this mesh by clustering its vertices in the cells of a grid.
+     *
+     * @param cellSize The size of the grid cells.
+     *
+     * @return The simplified mesh, without an id, or NULL if a part of the mesh would
+     *      have no triangles left.
+     */
+    Mesh* simplify(float cellSize) const;
+
     Model* model;
     std::vector<Vertex> vertices;
     std::vector<MeshPart*> parts;
@@ -48,7 +48,13 @@ void Model::writeBinary(FILE* file)
     }
     // materials[]
     writeBinaryObjects(_materials, file);
-
+    // levels[]
+    write((unsigned int)_levelMeshes.size(), file);
+    for (size_t i = 0, count = _levelMeshes.size(); i < count; ++i)
+    {
+        _levelMeshes[i]->writeBinaryXref(file);
+        write(_levelScreenSizes[i], file);
+    }
 }
 
 void Model::writeText(FILE* file)
@@ -64,6 +70,13 @@ void Model::writeText(FILE* file)
     {
         _meshSkin->writeText(file);
     }
+    for (size_t i = 0, count = _levelMeshes.size(); i < count; ++i)
+    {
+        fprintf(file, "<level>\n");
+        fprintfElement(file, "ref", _levelMeshes[i]->getId());
+        fprintfElement(file, "screenSize", _levelScreenSizes[i]);
+        fprintf(file, "</level>\n");
+    }
     fprintElementEnd(file);
 }
 
@@ -92,6 +105,12 @@ void Model::setMesh(Mesh* mesh)
     }
 }
 
+void Model::addLevel(Mesh* mesh, float screenSize)
+{
+    _levelMeshes.push_back(mesh);
+    _levelScreenSizes.push_back(screenSize);
+}
+
 void Model::setSkin(MeshSkin* skin)
 {
     _meshSkin = skin;
@@ -33,11 +33,19 @@ public:
     MeshSkin* getSkin();
     void setSkin(MeshSkin* skin);
 
+    /**
+     * Adds a level of detail, a simpler mesh drawn while the model is smaller on screen
+     * than the screen size, as a fraction of the viewport height.
+     */
+    void addLevel(Mesh* mesh, float screenSize);
+
 private:
 
     Mesh* _mesh;
     MeshSkin* _meshSkin;
     std::list<Material*> _materials;
+    std::vector<Mesh*> _levelMeshes;
+    std::vector<float> _levelScreenSizes;
 };
 
 }
@@ -34,56 +34,19 @@ static void writeString(FILE* fp, const char* str)
     }
 }
 
-int writeFont(const char* inFilePath, const char* outFilePath, unsigned int fontSize, const char* id, bool fontpreview = false)
+/**
+ * Draws the glyphs of a face as they are rendered at the font size.
+ *
+ * @return The image of the glyphs, or NULL if it could not be drawn.
+ */
+static unsigned char* drawBitmapGlyphs(FT_Face face, Glyph* glyphArray, unsigned int& imageWidth, unsigned int& imageHeight, int& rowSize)
 {
-    Glyph glyphArray[END_INDEX - START_INDEX];
-    
-    // Initialize freetype library.
-    FT_Library library;
-    FT_Error error = FT_Init_FreeType(&library);
-    if (error)
-    {
-        LOG(1, "FT_Init_FreeType error: %d \n", error);
-        return -1;
-    }
-    
-    // Initialize font face.
-    FT_Face face;
-    error = FT_New_Face(library, inFilePath, 0, &face);
-    if (error)
-    {
-        LOG(1, "FT_New_Face error: %d \n", error);
-        return -1;
-    }
-    
-    // Set the pixel size.
-    error = FT_Set_Char_Size(
-            face,           // handle to face object.
-            0,              // char_width in 1/64th of points.
-            fontSize * 64,   // char_height in 1/64th of points.
-            0,              // horizontal device resolution (defaults to 72 dpi if resolution (0, 0)).
-            0 );            // vertical device resolution.
-    
-    if (error)
-    {
-        LOG(1, "FT_Set_Char_Size error: %d \n", error);
-        return -1;
-    }
-
-    /* 
-    error = FT_Set_Pixel_Sizes(face, FONT_SIZE, 0);
-    if (error)
-    {
-        LOG(1, "FT_Set_Pixel_Sizes error : %d \n", error);
-        exit(1);
-    }
-    */
-
     // Save glyph information (slot contains the actual glyph bitmap).
     FT_GlyphSlot slot = face->glyph;
+    FT_Error error;
     
     int actualfontHeight = 0;
-    int rowSize = 0; // Stores the total number of rows required to all glyphs.
+    rowSize = 0; // Stores the total number of rows required to all glyphs.
     
     // Find the width of the image.
     for (unsigned char ascii = START_INDEX; ascii < END_INDEX; ++ascii)
@@ -114,8 +77,8 @@ int writeFont(const char* inFilePath, const char* outFilePath, unsigned int font
     int row = 0;
     
     double powerOf2 = 2;
-    unsigned int imageWidth = 0;
-    unsigned int imageHeight = 0;
+    imageWidth = 0;
+    imageHeight = 0;
     bool textureSizeFound = false;
 
     int advance;
@@ -224,7 +187,7 @@ int writeFont(const char* inFilePath, const char* outFilePath, unsigned int font
             {
                 free(imageBuffer);
 				LOG(1, "Image size exceeded!");
-				return -1;
+				return NULL;
             }
         }
         
@@ -251,6 +214,310 @@ int writeFont(const char* inFilePath, const char* outFilePath, unsigned int font
         i++;
     }
 
+    return imageBuffer;
+}
+
+/**
+ * Computes the squared distance of each sample of a row or column to the nearest feature,
+ * from the lower envelope of the parabolas rooted at the samples (Felzenszwalb and Huttenlocher).
+ *
+ * @param f The squared distances of the samples along the other axis, 0 for features.
+ * @param n The number of samples.
+ * @param d The squared distances computed.
+ * @param v Storage for the roots of the envelope's parabolas (n).
+ * @param z Storage for the boundaries between the envelope's parabolas (n + 1).
+ */
+static void distanceTransform(const double* f, int n, double* d, int* v, double* z)
+{
+    int k = 0;
+    v[0] = 0;
+    z[0] = -DBL_MAX;
+    z[1] = DBL_MAX;
+    for (int q = 1; q < n; ++q)
+    {
+        double s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+        while (s <= z[k])
+        {
+            --k;
+            s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+        }
+        ++k;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = DBL_MAX;
+    }
+
+    k = 0;
+    for (int q = 0; q < n; ++q)
+    {
+        while (z[k + 1] < q)
+        {
+            ++k;
+        }
+        d[q] = (q - v[k]) * (q - v[k]) + f[v[k]];
+    }
+}
+
+/**
+ * Replaces the values of a grid, 0 at features and DISTANCE_FIELD_FAR elsewhere, with the squared
+ * distances to the nearest feature, transforming the columns and then the rows.
+ */
+static void distanceTransform(std::vector<double>& grid, int width, int height)
+{
+    int n = std::max(width, height);
+    std::vector<double> f(n);
+    std::vector<double> d(n);
+    std::vector<int> v(n);
+    std::vector<double> z(n + 1);
+
+    for (int x = 0; x < width; ++x)
+    {
+        for (int y = 0; y < height; ++y)
+        {
+            f[y] = grid[y * width + x];
+        }
+        distanceTransform(&f[0], height, &d[0], &v[0], &z[0]);
+        for (int y = 0; y < height; ++y)
+        {
+            grid[y * width + x] = d[y];
+        }
+    }
+
+    for (int y = 0; y < height; ++y)
+    {
+        distanceTransform(&grid[y * width], width, &d[0], &v[0], &z[0]);
+        memcpy(&grid[y * width], &d[0], width * sizeof(double));
+    }
+}
+
+/**
+ * Draws the glyphs of a face as signed distance fields, into cells that extend DISTANCE_FIELD_SPREAD
+ * pixels beyond the glyphs on each side.
+ *
+ * Each glyph is rendered at DISTANCE_FIELD_SCALE times the font size, and the distance of each
+ * pixel of its cell to the edge of the glyph is averaged over the samples of the pixel. The
+ * distance is mapped so that the edge is at 0.5, the inside of the glyph above it and the outside
+ * below it, reaching 0 and 1 at the spread.
+ *
+ * @return The image of the glyphs, or NULL if it could not be drawn.
+ */
+static unsigned char* drawDistanceFieldGlyphs(FT_Face face, unsigned int fontSize, Glyph* glyphArray,
+                                              unsigned int& imageWidth, unsigned int& imageHeight, int& rowSize)
+{
+    const int scale = DISTANCE_FIELD_SCALE;
+    const int spread = DISTANCE_FIELD_SPREAD;
+    const unsigned int glyphCount = END_INDEX - START_INDEX;
+
+    FT_Error error = FT_Set_Char_Size(face, 0, fontSize * 64 * scale, 0, 0);
+    if (error)
+    {
+        LOG(1, "FT_Set_Char_Size error: %d \n", error);
+        return NULL;
+    }
+
+    // Render the glyphs, keeping their bitmaps.
+    FT_GlyphSlot slot = face->glyph;
+    std::vector<std::vector<unsigned char> > bitmaps(glyphCount);
+    std::vector<int> widths(glyphCount, 0);
+    std::vector<int> heights(glyphCount, 0);
+    std::vector<int> tops(glyphCount, 0);
+    int actualfontHeight = 0;
+    for (unsigned int i = 0; i < glyphCount; ++i)
+    {
+        error = FT_Load_Char(face, START_INDEX + i, FT_LOAD_RENDER);
+        if (error)
+        {
+            LOG(1, "FT_Load_Char error : %d \n", error);
+            continue;
+        }
+
+        widths[i] = slot->bitmap.width;
+        heights[i] = slot->bitmap.rows;
+        tops[i] = slot->bitmap_top;
+        bitmaps[i].resize(widths[i] * heights[i]);
+        for (int y = 0; y < heights[i]; ++y)
+        {
+            memcpy(&bitmaps[i][y * widths[i]], slot->bitmap.buffer + y * slot->bitmap.pitch, widths[i]);
+        }
+        actualfontHeight = std::max(actualfontHeight, heights[i]);
+    }
+
+    // Place the glyphs on their rows as drawBitmapGlyphs does, finding the size of the rows.
+    int rowHeight = 0;
+    for (unsigned int i = 0; i < glyphCount; ++i)
+    {
+        rowHeight = std::max(rowHeight, std::max(actualfontHeight - tops[i], 0) + heights[i]);
+    }
+    rowSize = (rowHeight + scale - 1) / scale + GLYPH_PADDING;
+    int cellHeight = rowSize + 2 * spread;
+
+    // Find the smallest square power of two image that fits the cells, separated by a pixel,
+    // and then the smallest power of two height.
+    int rowCount;
+    imageWidth = 64;
+    for (;;)
+    {
+        int penX = 0;
+        rowCount = 1;
+        for (unsigned int i = 0; i < glyphCount; ++i)
+        {
+            int advance = (widths[i] + scale - 1) / scale + 2 * spread + 1;
+            if (penX + advance > (int)imageWidth)
+            {
+                penX = 0;
+                rowCount++;
+            }
+            penX += advance;
+        }
+        if (rowCount * (cellHeight + 1) <= (int)imageWidth)
+        {
+            break;
+        }
+        imageWidth *= 2;
+    }
+    imageHeight = 1;
+    while ((int)imageHeight < rowCount * (cellHeight + 1))
+    {
+        imageHeight *= 2;
+    }
+
+    unsigned char* imageBuffer = (unsigned char *)malloc(imageWidth * imageHeight);
+    memset(imageBuffer, 0, imageWidth * imageHeight);
+
+    int penX = 0;
+    int penY = 0;
+    int sampleHeight = cellHeight * scale;
+    std::vector<double> outside;
+    std::vector<double> inside;
+    for (unsigned int i = 0; i < glyphCount; ++i)
+    {
+        int glyphWidth = (widths[i] + scale - 1) / scale;
+        int cellWidth = glyphWidth + 2 * spread;
+        if (penX + cellWidth + 1 > (int)imageWidth)
+        {
+            penX = 0;
+            penY += cellHeight + 1;
+        }
+
+        // Find the squared distances of the samples of the cell to the glyph, and to its outside.
+        int sampleWidth = cellWidth * scale;
+        outside.assign(sampleWidth * sampleHeight, DISTANCE_FIELD_FAR);
+        inside.assign(sampleWidth * sampleHeight, 0.0);
+        int left = spread * scale;
+        int top = spread * scale + std::max(actualfontHeight - tops[i], 0);
+        for (int y = 0; y < heights[i]; ++y)
+        {
+            for (int x = 0; x < widths[i]; ++x)
+            {
+                if (bitmaps[i][y * widths[i] + x] >= 128)
+                {
+                    int sample = (top + y) * sampleWidth + left + x;
+                    outside[sample] = 0.0;
+                    inside[sample] = DISTANCE_FIELD_FAR;
+                }
+            }
+        }
+        distanceTransform(outside, sampleWidth, sampleHeight);
+        distanceTransform(inside, sampleWidth, sampleHeight);
+
+        // Average the signed distances of the samples of each pixel, from their edge between samples.
+        for (int y = 0; y < cellHeight; ++y)
+        {
+            for (int x = 0; x < cellWidth; ++x)
+            {
+                double sum = 0.0;
+                for (int sy = 0; sy < scale; ++sy)
+                {
+                    for (int sx = 0; sx < scale; ++sx)
+                    {
+                        int sample = (y * scale + sy) * sampleWidth + x * scale + sx;
+                        sum += outside[sample] > 0.0 ? sqrt(outside[sample]) - 0.5 : 0.5 - sqrt(inside[sample]);
+                    }
+                }
+                double distance = sum / (scale * scale * scale);
+                double value = std::min(std::max(0.5 - distance / (2.0 * spread), 0.0), 1.0);
+                imageBuffer[(penY + y) * imageWidth + penX + x] = (unsigned char)(value * 255.0 + 0.5);
+            }
+        }
+
+        glyphArray[i].index = START_INDEX + i;
+        glyphArray[i].width = glyphWidth;
+
+        // Generate UV coords, covering the spread around the glyph.
+        glyphArray[i].uvCoords[0] = (float)penX / (float)imageWidth;
+        glyphArray[i].uvCoords[1] = (float)penY / (float)imageHeight;
+        glyphArray[i].uvCoords[2] = (float)(penX + cellWidth) / (float)imageWidth;
+        glyphArray[i].uvCoords[3] = (float)(penY + cellHeight) / (float)imageHeight;
+
+        penX += cellWidth + 1;
+    }
+
+    return imageBuffer;
+}
+
+int writeFont(const char* inFilePath, const char* outFilePath, unsigned int fontSize, const char* id, bool fontpreview = false, bool distanceField = false)
+{
+    Glyph glyphArray[END_INDEX - START_INDEX];
+    
+    // Initialize freetype library.
+    FT_Library library;
+    FT_Error error = FT_Init_FreeType(&library);
+    if (error)
+    {
+        LOG(1, "FT_Init_FreeType error: %d \n", error);
+        return -1;
+    }
+    
+    // Initialize font face.
+    FT_Face face;
+    error = FT_New_Face(library, inFilePath, 0, &face);
+    if (error)
+    {
+        LOG(1, "FT_New_Face error: %d \n", error);
+        return -1;
+    }
+    
+    // Set the pixel size.
+    error = FT_Set_Char_Size(
+            face,           // handle to face object.
+            0,              // char_width in 1/64th of points.
+            fontSize * 64,   // char_height in 1/64th of points.
+            0,              // horizontal device resolution (defaults to 72 dpi if resolution (0, 0)).
+            0 );            // vertical device resolution.
+    
+    if (error)
+    {
+        LOG(1, "FT_Set_Char_Size error: %d \n", error);
+        return -1;
+    }
+
+    /* 
+    error = FT_Set_Pixel_Sizes(face, FONT_SIZE, 0);
+    if (error)
+    {
+        LOG(1, "FT_Set_Pixel_Sizes error : %d \n", error);
+        exit(1);
+    }
+    */
+
+    unsigned int imageWidth = 0;
+    unsigned int imageHeight = 0;
+    int rowSize = 0;
+    unsigned char* imageBuffer;
+    if (distanceField)
+    {
+        imageBuffer = drawDistanceFieldGlyphs(face, fontSize, glyphArray, imageWidth, imageHeight, rowSize);
+    }
+    else
+    {
+        imageBuffer = drawBitmapGlyphs(face, glyphArray, imageWidth, imageHeight, rowSize);
+    }
+    if (imageBuffer == NULL)
+    {
+        FT_Done_Face(face);
+        FT_Done_FreeType(library);
+        return -1;
+    }
 
     FILE *gpbFp = fopen(outFilePath, "wb");
     
@@ -282,6 +549,10 @@ int writeFont(const char* inFilePath, const char* outFilePath, unsigned int font
     // Character set.
     // TODO: Empty for now
     writeString(gpbFp, "");
+
+    // Format, and the spread of distance fields.
+    writeUint(gpbFp, distanceField ? 1 : 0); // 0 == BITMAP, 1 == DISTANCE_FIELD
+    writeUint(gpbFp, distanceField ? DISTANCE_FIELD_SPREAD : 0);
     
     // Glyphs.
     unsigned int glyphSetSize = END_INDEX - START_INDEX;
@@ -5,6 +5,15 @@
 #define END_INDEX       127
 #define GLYPH_PADDING   4
 
+// Glyphs are rendered at this multiple of the font size to compute distance fields.
+#define DISTANCE_FIELD_SCALE    8
+
+// Distance, in pixels of the font size, that distance fields cover on each side of the edges of glyphs.
+#define DISTANCE_FIELD_SPREAD   4
+
+// Squared distance of samples that are not yet known to be near a glyph's edge.
+#define DISTANCE_FIELD_FAR      1e20
+
 namespace gameplay
 {
 
@@ -19,15 +28,20 @@ public:
 
 /**
  * Writes the font gpb file.
+ *
+ * A distance field font stores, for each pixel of its glyphs, the distance to the edge of the
+ * glyph rather than its coverage, so that it can be drawn sharply at any size and with outlines
+ * and shadows.
  * 
  * @param inFilePath Input file path to the tiff file.
  * @param outFilePath Output file path to write the gpb to.
  * @param fontSize Size of the font.
  * @param id ID string of the font in the ref table.
  * @param fontpreview True if the pgm font preview file should be written. (For debugging)
+ * @param distanceField True if the glyphs should be written as signed distance fields.
  * 
  * @return 0 if successful, -1 if error.
  */
-int writeFont(const char* inFilePath, const char* outFilePath, unsigned int fontSize, const char* id, bool fontpreview);
+int writeFont(const char* inFilePath, const char* outFilePath, unsigned int fontSize, const char* id, bool fontpreview, bool distanceField);
 
 }
@@ -77,19 +77,34 @@ include $(CLEAR_VARS)
 LOCAL_MODULE    := gameplay-tests
 LOCAL_SRC_FILES := ../../../GamePlay/gameplay/src/gameplay-main-android.cpp \
     Audio3DTest.cpp \
+    AnimationThreadsBenchmark.cpp \
+    BundleBenchmark.cpp \
     CreateSceneTest.cpp \
+    CurveBenchmark.cpp \
     FirstPersonCamera.cpp \
     Grid.cpp \
     GestureTest.cpp \
     InputTest.cpp \
+    LevelOfDetailBenchmark.cpp \
     LoadSceneTest.cpp \
+    MathBenchmark.cpp \
 	MeshBatchTest.cpp \
     MeshPrimitiveTest.cpp \
+    ModelBatchBenchmark.cpp \
+    NodeMatricesBenchmark.cpp \
+    ParticleEmitterBenchmark.cpp \
 	PhysicsSceneTest.cpp \
+	SceneCullingBenchmark.cpp \
+	SceneLoadingBenchmark.cpp \
+	SceneVisitBenchmark.cpp \
+	SpriteBatchBenchmark.cpp \
 	SpriteBatchTest.cpp \
+	SpriteTexturesBenchmark.cpp \
     Test.cpp \
     TestsGame.cpp \
     TextTest.cpp \
+    TextLayoutBenchmark.cpp \
+    FormRedrawBenchmark.cpp \
     TextureTest.cpp \
 	TriangleTest.cpp
 
@@ -0,0 +1,101 @@
+#include "AnimationThreadsBenchmark.h"
+#include "TestsGame.h"
+
+#if defined(ADD_TEST)
+    ADD_TEST("Benchmark", "Animation Threads", AnimationThreadsBenchmark, 2);
+#endif
+
+#define ANIMATED_NODE_COUNT 4000
+#define KEYFRAME_COUNT 120
+#define FRAMES_PER_THREAD_COUNT 120
+
+AnimationThreadsBenchmark::AnimationThreadsBenchmark()
+    : _font(NULL), _threadCountMax(1), _previousThreadCount(1), _previousProfilerEnabled(false)
+{
+}
+
+void AnimationThreadsBenchmark::initialize()
+{
+    _font = Font::create("res/common/arial18.gpb");
+
+    // Create a rotate and translate animation with a different phase for each node.
+    unsigned int keyTimes[KEYFRAME_COUNT];
+    float keyValues[KEYFRAME_COUNT * 7];
+    for (unsigned int i = 0; i < ANIMATED_NODE_COUNT; ++i)
+    {
+        Node* node = Node::create();
+        for (unsigned int j = 0; j < KEYFRAME_COUNT; ++j)
+        {
+            float angle = MATH_PIX2 * (float)(i + j) / (float)KEYFRAME_COUNT;
+            Quaternion rotation;
+            Quaternion::createFromAxisAngle(Vector3::unitY(), angle, &rotation);
+            float* value = &keyValues[j * 7];
+            value[0] = rotation.x;
+            value[1] = rotation.y;
+            value[2] = rotation.z;
+            value[3] = rotation.w;
+            value[4] = cos(angle);
+            value[5] = (float)j / (float)KEYFRAME_COUNT;
+            value[6] = sin(angle);
+            keyTimes[j] = j * 50;
+        }
+        Animation* animation = node->createAnimation("benchmark", Transform::ANIMATE_ROTATE_TRANSLATE, KEYFRAME_COUNT, keyTimes, keyValues, Curve::LINEAR);
+        AnimationClip* clip = animation->getClip();
+        clip->setRepeatCount(AnimationClip::REPEAT_INDEFINITE);
+        clip->play();
+        _nodes.push_back(node);
+    }
+
+    // Time the animation updates with the frame profiler.
+    _previousProfilerEnabled = Profiler::isEnabled();
+    Profiler::setEnabled(true);
+    Profiler::clear();
+
+    _previousThreadCount = getAnimationController()->getThreadCount();
+    _threadCountMax = ThreadPool::getProcessorCount();
+    getAnimationController()->setThreadCount(1);
+}
+
+void AnimationThreadsBenchmark::finalize()
+{
+    getAnimationController()->setThreadCount(_previousThreadCount);
+    Profiler::setEnabled(_previousProfilerEnabled);
+
+    for (size_t i = 0; i < _nodes.size(); ++i)
+    {
+        SAFE_RELEASE(_nodes[i]);
+    }
+    _nodes.clear();
+    SAFE_RELEASE(_font);
+}
+
+void AnimationThreadsBenchmark::update(float elapsedTime)
+{
+    if (_updateTimes.size() >= _threadCountMax || Profiler::getFrameCount() < std::min((unsigned int)FRAMES_PER_THREAD_COUNT, Profiler::getFrameHistory()))
+        return;
+
+    // Record the average update time of this thread count and move on to the next one.
+    Profiler::Stats stats;
+    Profiler::getStats("AnimationController::update", &stats);
+    _updateTimes.push_back(stats.average);
+    Profiler::clear();
+
+    if (_updateTimes.size() < _threadCountMax)
+        getAnimationController()->setThreadCount((unsigned int)_updateTimes.size() + 1);
+}
+
+void AnimationThreadsBenchmark::render(float elapsedTime)
+{
+    clear(CLEAR_COLOR_DEPTH, Vector4::zero(), 1.0f, 0);
+
+    _font->start();
+    char text[64];
+    sprintf(text, "%u animations", ANIMATED_NODE_COUNT);
+    _font->drawText(text, 5, 5, Vector4::one(), _font->getSize());
+    for (size_t i = 0; i < _updateTimes.size(); ++i)
+    {
+        sprintf(text, "%u threads: %.3f ms (%.2fx)", (unsigned int)i + 1, _updateTimes[i], _updateTimes[i] > 0.0 ? _updateTimes[0] / _updateTimes[i] : 0.0);
+        _font->drawText(text, 5, 5 + (i + 1) * _font->getSize(), Vector4::one(), _font->getSize());
+    }
+    _font->finish();
+}
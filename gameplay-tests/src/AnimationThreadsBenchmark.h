@@ -0,0 +1,41 @@
+#ifndef ANIMATIONTHREADSBENCHMARK_H_
+#define ANIMATIONTHREADSBENCHMARK_H_
+
+#include "gameplay.h"
+#include "Test.h"
+
+using namespace gameplay;
+
+/**
+ * Benchmark measuring how AnimationController::update scales with the number of animation threads.
+ *
+ * Thousands of transform animations are played while the thread count is stepped from
+ * one up to the number of processors, recording the average update time of each step.
+ */
+class AnimationThreadsBenchmark : public Test
+{
+public:
+
+    AnimationThreadsBenchmark();
+
+protected:
+
+    void initialize();
+
+    void finalize();
+
+    void update(float elapsedTime);
+
+    void render(float elapsedTime);
+
+private:
+
+    Font* _font;
+    std::vector<Node*> _nodes;
+    std::vector<double> _updateTimes;
+    unsigned int _threadCountMax;
+    unsigned int _previousThreadCount;
+    bool _previousProfilerEnabled;
+};
+
+#endif
@@ -0,0 +1,172 @@
+#include "BundleBenchmark.h"
+#include "TestsGame.h"
+
+#if defined(ADD_TEST)
+    ADD_TEST("Benchmark", "Bundle Loading", BundleBenchmark, 5);
+#endif
+
+#define BUNDLE_PATH "res/benchmark.gpb"
+#define BUNDLE_MESH_COUNT 128
+#define BUNDLE_VERTEX_COUNT 65535
+#define BUNDLE_VERTEX_FLOATS 8
+#define BUNDLE_INDEX_COUNT (BUNDLE_VERTEX_COUNT * 3)
+#define BUNDLE_TYPE_MESH 34
+
+static void writeUInt(FILE* fp, unsigned int value)
+{
+    fwrite(&value, 4, 1, fp);
+}
+
+/**
+ * Writes a bundle of large meshes (a few hundred MB) and returns its size in bytes.
+ */
+static unsigned int writeBundle(const char* path)
+{
+    FILE* fp = FileSystem::openFile(path, "wb");
+    if (!fp)
+        return 0;
+
+    std::vector<std::string> ids;
+    unsigned int offset = 9 + 2 + 4;
+    char id[32];
+    for (unsigned int i = 0; i < BUNDLE_MESH_COUNT; ++i)
+    {
+        sprintf(id, "mesh%u", i);
+        ids.push_back(id);
+        offset += 4 + ids[i].length() + 4 + 4;
+    }
+
+    unsigned int vertexByteCount = BUNDLE_VERTEX_COUNT * BUNDLE_VERTEX_FLOATS * sizeof(float);
+    unsigned int indexByteCount = BUNDLE_INDEX_COUNT * sizeof(unsigned short);
+    unsigned int meshByteCount = 4 + 3 * 8 + 4 + vertexByteCount + 10 * 4 + 4 + 3 * 4 + indexByteCount;
+
+    // Header and reference table.
+    fwrite("\xABGPB\xBB\r\n\x1A\n", 1, 9, fp);
+    unsigned char version[2] = { 1, 2 };
+    fwrite(version, 1, 2, fp);
+    writeUInt(fp, BUNDLE_MESH_COUNT);
+    for (unsigned int i = 0; i < BUNDLE_MESH_COUNT; ++i)
+    {
+        writeUInt(fp, ids[i].length());
+        fwrite(ids[i].c_str(), 1, ids[i].length(), fp);
+        writeUInt(fp, BUNDLE_TYPE_MESH);
+        writeUInt(fp, offset + i * meshByteCount);
+    }
+
+    std::vector<float> vertices(BUNDLE_VERTEX_COUNT * BUNDLE_VERTEX_FLOATS);
+    for (unsigned int i = 0; i < vertices.size(); ++i)
+        vertices[i] = MATH_RANDOM_MINUS1_1();
+    std::vector<unsigned short> indices(BUNDLE_INDEX_COUNT);
+    for (unsigned int i = 0; i < indices.size(); ++i)
+        indices[i] = (unsigned short)(i % BUNDLE_VERTEX_COUNT);
+    float bounds[10] = { -1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.7321f };
+
+    // Meshes with a position, normal and texture coordinate, and one triangle list.
+    for (unsigned int i = 0; i < BUNDLE_MESH_COUNT; ++i)
+    {
+        writeUInt(fp, 3);
+        writeUInt(fp, VertexFormat::POSITION);
+        writeUInt(fp, 3);
+        writeUInt(fp, VertexFormat::NORMAL);
+        writeUInt(fp, 3);
+        writeUInt(fp, VertexFormat::TEXCOORD0);
+        writeUInt(fp, 2);
+        writeUInt(fp, vertexByteCount);
+        fwrite(&vertices[0], 1, vertexByteCount, fp);
+        fwrite(bounds, sizeof(float), 10, fp);
+        writeUInt(fp, 1);
+        writeUInt(fp, Mesh::TRIANGLES);
+        writeUInt(fp, Mesh::INDEX16);
+        writeUInt(fp, indexByteCount);
+        fwrite(&indices[0], 1, indexByteCount, fp);
+    }
+
+    unsigned int size = (unsigned int)ftell(fp);
+    fclose(fp);
+    return size;
+}
+
+/**
+ * Loads every mesh in the bundle and returns the time taken in milliseconds.
+ */
+static double loadBundle(const char* path, bool memoryMapped, bool* mapped)
+{
+    Bundle::setMemoryMappingEnabled(memoryMapped);
+    double start = Platform::getAbsoluteTime();
+    Bundle* bundle = Bundle::create(path);
+    if (!bundle)
+        return 0.0;
+
+    *mapped = bundle->isMemoryMapped();
+    char id[32];
+    for (unsigned int i = 0; i < BUNDLE_MESH_COUNT; ++i)
+    {
+        sprintf(id, "mesh%u", i);
+        Mesh* mesh = bundle->loadMesh(id);
+        SAFE_RELEASE(mesh);
+    }
+    SAFE_RELEASE(bundle);
+    return Platform::getAbsoluteTime() - start;
+}
+
+BundleBenchmark::BundleBenchmark()
+    : _font(NULL)
+{
+}
+
+void BundleBenchmark::initialize()
+{
+    _font = Font::create("res/common/arial18.gpb");
+
+    char text[128];
+    unsigned int size = writeBundle(BUNDLE_PATH);
+    if (size == 0)
+    {
+        _results.push_back("Failed to write " BUNDLE_PATH);
+        return;
+    }
+    sprintf(text, "%u meshes, %.1f MB (ms)     file        mmap", BUNDLE_MESH_COUNT, size / (1024.0f * 1024.0f));
+    _results.push_back(text);
+
+    // Alternate the two readers so that both see a warm file cache.
+    bool enabled = Bundle::isMemoryMappingEnabled();
+    bool mapped = false;
+    for (unsigned int pass = 1; pass <= 3; ++pass)
+    {
+        double fileTime = loadBundle(BUNDLE_PATH, false, &mapped);
+        double mapTime = loadBundle(BUNDLE_PATH, true, &mapped);
+        sprintf(text, "Pass %u                    %10.3f  %10.3f%s", pass, fileTime, mapTime, mapped ? "" : " (not mapped)");
+        _results.push_back(text);
+    }
+    Bundle::setMemoryMappingEnabled(enabled);
+
+    std::string path(FileSystem::getResourcePath());
+    path += BUNDLE_PATH;
+    remove(path.c_str());
+
+    for (size_t i = 0; i < _results.size(); ++i)
+    {
+        print("%s\n", _results[i].c_str());
+    }
+}
+
+void BundleBenchmark::finalize()
+{
+    SAFE_RELEASE(_font);
+}
+
+void BundleBenchmark::update(float elapsedTime)
+{
+}
+
+void BundleBenchmark::render(float elapsedTime)
+{
+    clear(CLEAR_COLOR_DEPTH, Vector4::zero(), 1.0f, 0);
+
+    _font->start();
+    for (size_t i = 0; i < _results.size(); ++i)
+    {
+        _font->drawText(_results[i].c_str(), 5, 5 + i * _font->getSize(), Vector4::one(), _font->getSize());
+    }
+    _font->finish();
+}
@@ -0,0 +1,35 @@
+#ifndef BUNDLEBENCHMARK_H_
+#define BUNDLEBENCHMARK_H_
+
+#include "gameplay.h"
+#include "Test.h"
+
+using namespace gameplay;
+
+/**
+ * Benchmark of loading meshes from a large generated bundle,
+ * comparing memory mapped reads with buffered file reads.
+ */
+class BundleBenchmark : public Test
+{
+public:
+
+    BundleBenchmark();
+
+protected:
+
+    void initialize();
+
+    void finalize();
+
+    void update(float elapsedTime);
+
+    void render(float elapsedTime);
+
+private:
+
+    Font* _font;
+    std::vector<std::string> _results;
+};
+
+#endif
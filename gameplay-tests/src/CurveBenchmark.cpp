@@ -0,0 +1,141 @@
+#include "CurveBenchmark.h"
+#include "TestsGame.h"
+
+#if defined(ADD_TEST)
+    ADD_TEST("Benchmark", "Curve Evaluation", CurveBenchmark, 3);
+#endif
+
+#define EVALUATION_COUNT 100000
+#define BATCH_CURVE_COUNT 64
+
+/**
+ * Creates a curve of rotation and translation keys with the given interpolation.
+ * A quaternion offset is set for the SLERP case.
+ */
+static Curve* createCurve(unsigned int pointCount, Curve::InterpolationType type, bool slerp)
+{
+    Curve* curve = Curve::create(pointCount, 7);
+    if (slerp)
+        curve->setQuaternionOffset(0);
+
+    float value[7];
+    float tangent[7];
+    for (unsigned int i = 0; i < pointCount; ++i)
+    {
+        float angle = MATH_PIX2 * (float)i / (float)pointCount;
+        Quaternion rotation;
+        Quaternion::createFromAxisAngle(Vector3::unitY(), angle, &rotation);
+        value[0] = rotation.x;
+        value[1] = rotation.y;
+        value[2] = rotation.z;
+        value[3] = rotation.w;
+        value[4] = cos(angle);
+        value[5] = (float)i;
+        value[6] = sin(angle);
+        for (unsigned int j = 0; j < 7; ++j)
+            tangent[j] = 0.5f;
+
+        float time = pointCount > 1 ? (float)i / (float)(pointCount - 1) : 0.0f;
+        if (type == Curve::BEZIER || type == Curve::HERMITE)
+            curve->setPoint(i, time, value, type, tangent, tangent);
+        else
+            curve->setPoint(i, time, value, type);
+    }
+    return curve;
+}
+
+/**
+ * Evaluates the curve at increasing times as an animation plays back, and returns the time taken in milliseconds.
+ */
+static double evaluateCurve(Curve* curve, bool useCursor)
+{
+    float value[7];
+    unsigned int cursor = 0;
+    double start = Platform::getAbsoluteTime();
+    for (unsigned int i = 0; i < EVALUATION_COUNT; ++i)
+    {
+        float time = (float)i / (float)(EVALUATION_COUNT - 1);
+        curve->evaluate(time, value, useCursor ? &cursor : NULL);
+    }
+    return Platform::getAbsoluteTime() - start;
+}
+
+CurveBenchmark::CurveBenchmark()
+    : _font(NULL)
+{
+}
+
+void CurveBenchmark::initialize()
+{
+    _font = Font::create("res/common/arial18.gpb");
+
+    static const unsigned int pointCounts[] = { 16, 1024, 16384 };
+    static const char* typeNames[] = { "LINEAR", "BEZIER", "HERMITE", "SLERP" };
+    static const Curve::InterpolationType types[] = { Curve::LINEAR, Curve::BEZIER, Curve::HERMITE, Curve::LINEAR };
+
+    char text[128];
+    sprintf(text, "%u evaluations (ms)       search      cursor", EVALUATION_COUNT);
+    _results.push_back(text);
+    for (unsigned int i = 0; i < sizeof(pointCounts) / sizeof(pointCounts[0]); ++i)
+    {
+        for (unsigned int j = 0; j < sizeof(types) / sizeof(types[0]); ++j)
+        {
+            Curve* curve = createCurve(pointCounts[i], types[j], j == 3);
+            double searchTime = evaluateCurve(curve, false);
+            double cursorTime = evaluateCurve(curve, true);
+            SAFE_RELEASE(curve);
+
+            sprintf(text, "%-8s %5u keys     %8.3f    %8.3f", typeNames[j], pointCounts[i], searchTime, cursorTime);
+            _results.push_back(text);
+        }
+    }
+
+    // Evaluate a batch of curves into a contiguous buffer, as for the joints of a skeleton.
+    Curve* curves[BATCH_CURVE_COUNT];
+    unsigned int cursors[BATCH_CURVE_COUNT];
+    for (unsigned int i = 0; i < BATCH_CURVE_COUNT; ++i)
+    {
+        curves[i] = createCurve(1024, Curve::LINEAR, true);
+        cursors[i] = 0;
+    }
+    std::vector<float> values(BATCH_CURVE_COUNT * 7);
+    unsigned int batchCount = EVALUATION_COUNT / BATCH_CURVE_COUNT;
+    double start = Platform::getAbsoluteTime();
+    for (unsigned int i = 0; i < batchCount; ++i)
+    {
+        Curve::evaluateBatch((float)i / (float)(batchCount - 1), curves, BATCH_CURVE_COUNT, &values[0], cursors);
+    }
+    double batchTime = Platform::getAbsoluteTime() - start;
+    for (unsigned int i = 0; i < BATCH_CURVE_COUNT; ++i)
+    {
+        SAFE_RELEASE(curves[i]);
+    }
+    sprintf(text, "SLERP batch of %u, 1024 keys              %8.3f", BATCH_CURVE_COUNT, batchTime);
+    _results.push_back(text);
+
+    for (size_t i = 0; i < _results.size(); ++i)
+    {
+        print("%s\n", _results[i].c_str());
+    }
+}
+
+void CurveBenchmark::finalize()
+{
+    SAFE_RELEASE(_font);
+}
+
+void CurveBenchmark::update(float elapsedTime)
+{
+}
+
+void CurveBenchmark::render(float elapsedTime)
+{
+    clear(CLEAR_COLOR_DEPTH, Vector4::zero(), 1.0f, 0);
+
+    _font->start();
+    for (size_t i = 0; i < _results.size(); ++i)
+    {
+        _font->drawText(_results[i].c_str(), 5, 5 + i * _font->getSize(), Vector4::one(), _font->getSize());
+    }
+    _font->finish();
+}
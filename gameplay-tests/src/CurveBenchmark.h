@@ -0,0 +1,35 @@
+#ifndef CURVEBENCHMARK_H_
+#define CURVEBENCHMARK_H_
+
+#include "gameplay.h"
+#include "Test.h"
+
+using namespace gameplay;
+
+/**
+ * Microbenchmark of Curve evaluation over key counts and interpolation types,
+ * comparing a binary search per evaluation with a playback cursor.
+ */
+class CurveBenchmark : public Test
+{
+public:
+
+    CurveBenchmark();
+
+protected:
+
+    void initialize();
+
+    void finalize();
+
+    void update(float elapsedTime);
+
+    void render(float elapsedTime);
+
+private:
+
+    Font* _font;
+    std::vector<std::string> _results;
+};
+
+#endif
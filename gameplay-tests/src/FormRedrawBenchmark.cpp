@@ -0,0 +1,105 @@
+#include "FormRedrawBenchmark.h"
+#include "TestsGame.h"
+
+#if defined(ADD_TEST)
+    ADD_TEST("Benchmark", "Form Redraw", FormRedrawBenchmark, 15);
+#endif
+
+#define LABEL_COUNT 60
+
+FormRedrawBenchmark::FormRedrawBenchmark()
+    : _font(NULL), _form(NULL), _slider(NULL), _changeLabels(false), _updateTime(0.0), _drawTime(0.0), _frameCount(0)
+{
+}
+
+void FormRedrawBenchmark::initialize()
+{
+    _font = Font::create("res/common/arial18.gpb");
+
+    Theme* theme = Theme::create("res/common/mainMenu.theme");
+    Theme::Style* formStyle = theme->getStyle("basic");
+    Theme::Style* labelStyle = theme->getStyle("noBorder");
+
+    // Note: this calls addRef() on formStyle's Theme, which we created above.
+    _form = Form::create("formRedraw", formStyle, Layout::LAYOUT_FLOW);
+    theme->release();
+
+    float top = 5.0f + 3 * _font->getSize();
+    _form->setPosition(0, top);
+    _form->setSize(getWidth(), getHeight() - top);
+
+    _slider = Slider::create("slider", formStyle);
+    _slider->setMin(0.0f);
+    _slider->setMax(1.0f);
+    _slider->setSize(getWidth() - 40.0f, 50.0f);
+    _form->addControl(_slider);
+    _slider->release();
+
+    for (unsigned int i = 0; i < LABEL_COUNT; ++i)
+    {
+        char id[16];
+        sprintf(id, "label%u", i);
+        Label* label = Label::create(id, labelStyle);
+        label->setSize(150.0f, 40.0f);
+        label->setText(id);
+        _form->addControl(label);
+        _labels.push_back(label);
+        label->release();
+    }
+}
+
+void FormRedrawBenchmark::finalize()
+{
+    _labels.clear();
+    SAFE_RELEASE(_form);
+    SAFE_RELEASE(_font);
+}
+
+void FormRedrawBenchmark::update(float elapsedTime)
+{
+    _slider->setValue(0.5f + 0.5f * sin(Game::getGameTime() * 0.002));
+    if (_changeLabels)
+    {
+        char text[32];
+        for (size_t i = 0, count = _labels.size(); i < count; ++i)
+        {
+            sprintf(text, "%u", (unsigned int)((_frameCount + i) % 1000));
+            _labels[i]->setText(text);
+        }
+    }
+
+    double start = Platform::getAbsoluteTime();
+    _form->update(elapsedTime);
+    double time = Platform::getAbsoluteTime() - start;
+    _updateTime = _frameCount > 0 ? _updateTime * 0.95 + time * 0.05 : time;
+}
+
+void FormRedrawBenchmark::render(float elapsedTime)
+{
+    clear(CLEAR_COLOR_DEPTH, Vector4::zero(), 1.0f, 0);
+
+    double start = Platform::getAbsoluteTime();
+    _form->draw();
+    double time = Platform::getAbsoluteTime() - start;
+    _drawTime = _frameCount > 0 ? _drawTime * 0.95 + time * 0.05 : time;
+    ++_frameCount;
+
+    unsigned int size = _font->getSize();
+    _font->start();
+    drawFrameRate(_font, Vector4(0, 0.5f, 1, 1), 5, 1, getFrameRate());
+    char text[128];
+    sprintf(text, "%u labels, %s change", (unsigned int)_labels.size(), _changeLabels ? "all controls" : "one slider");
+    _font->drawText(text, 5, 5 + size, Vector4::one(), size);
+    sprintf(text, "Update: %.3f ms, Draw: %.3f ms", _updateTime, _drawTime);
+    _font->drawText(text, 5, 5 + 2 * size, Vector4::one(), size);
+    _font->finish();
+}
+
+void FormRedrawBenchmark::touchEvent(Touch::TouchEvent evt, int x, int y, unsigned int contactIndex)
+{
+    if (evt == Touch::TOUCH_PRESS)
+    {
+        _changeLabels = !_changeLabels;
+        _frameCount = 0;
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef FORMREDRAWBENCHMARK_H_
+#define FORMREDRAWBENCHMARK_H_
+
+#include "gameplay.h"
+#include "Test.h"
+
+using namespace gameplay;
+
+/**
+ * Benchmark of updating and drawing a form of many controls while few of them change.
+ *
+ * A slider in the form moves every frame, and the form lays out and draws again only
+ * the controls that changed. The times spent updating and drawing the form are shown.
+ * Touch the screen to change the text of every label every frame as well.
+ */
+class FormRedrawBenchmark : public Test
+{
+public:
+
+    FormRedrawBenchmark();
+
+    void touchEvent(Touch::TouchEvent evt, int x, int y, unsigned int contactIndex);
+
+protected:
+
+    void initialize();
+
+    void finalize();
+
+    void update(float elapsedTime);
+
+    void render(float elapsedTime);
+
+private:
+
+    Font* _font;
+    Form* _form;
+    Slider* _slider;
+    std::vector<Label*> _labels;
+    bool _changeLabels;
+    double _updateTime;
+    double _drawTime;
+    unsigned int _frameCount;
+};
+
+#endif
@@ -0,0 +1,187 @@
+#include "LevelOfDetailBenchmark.h"
+#include "TestsGame.h"
+
+#if defined(ADD_TEST)
+    ADD_TEST("Benchmark", "Level Of Detail", LevelOfDetailBenchmark, 11);
+#endif
+
+#define GRID_SIZE 24
+#define GRID_SPACING 4.0f
+#define LEVEL_COUNT 4
+
+// The sphere resolution and the screen size below which each level is drawn.
+static const unsigned int __levelSegments[LEVEL_COUNT] = { 96, 32, 12, 6 };
+static const float __levelScreenSizes[LEVEL_COUNT] = { 0.0f, 0.2f, 0.08f, 0.03f };
+
+/**
+ * Creates a unit sphere mesh with positions and normals.
+ */
+static Mesh* createSphere(unsigned int segments)
+{
+    unsigned int rings = segments / 2;
+    unsigned int vertexCount = (rings + 1) * (segments + 1);
+    std::vector<float> vertices;
+    vertices.reserve(vertexCount * 6);
+    for (unsigned int r = 0; r <= rings; ++r)
+    {
+        float phi = MATH_PI * r / rings;
+        for (unsigned int s = 0; s <= segments; ++s)
+        {
+            float theta = MATH_PIX2 * s / segments;
+            float x = sin(phi) * cos(theta);
+            float y = cos(phi);
+            float z = sin(phi) * sin(theta);
+            float vertex[] = { x, y, z, x, y, z };
+            vertices.insert(vertices.end(), vertex, vertex + 6);
+        }
+    }
+    std::vector<unsigned short> indices;
+    indices.reserve(rings * segments * 6);
+    for (unsigned int r = 0; r < rings; ++r)
+    {
+        for (unsigned int s = 0; s < segments; ++s)
+        {
+            unsigned short a = (unsigned short)(r * (segments + 1) + s);
+            unsigned short b = (unsigned short)(a + segments + 1);
+            unsigned short triangles[] = { a, (unsigned short)(a + 1), b, b, (unsigned short)(a + 1), (unsigned short)(b + 1) };
+            indices.insert(indices.end(), triangles, triangles + 6);
+        }
+    }
+
+    VertexFormat::Element elements[] =
+    {
+        VertexFormat::Element(VertexFormat::POSITION, 3),
+        VertexFormat::Element(VertexFormat::NORMAL, 3)
+    };
+    Mesh* mesh = Mesh::createMesh(VertexFormat(elements, 2), vertexCount, false);
+    mesh->setVertexData(&vertices[0], 0, vertexCount);
+    mesh->setBoundingSphere(BoundingSphere(Vector3::zero(), 1.0f));
+    mesh->setBoundingBox(BoundingBox(-Vector3::one(), Vector3::one()));
+    MeshPart* part = mesh->addPart(Mesh::TRIANGLES, Mesh::INDEX16, (unsigned int)indices.size(), false);
+    part->setIndexData(&indices[0], 0, (unsigned int)indices.size());
+    return mesh;
+}
+
+LevelOfDetailBenchmark::LevelOfDetailBenchmark()
+    : _font(NULL), _scene(NULL), _queue(NULL), _levelsEnabled(true), _triangleCount(0), _drawTime(0.0), _frameCount(0)
+{
+}
+
+void LevelOfDetailBenchmark::initialize()
+{
+    _font = Font::create("res/common/arial18.gpb");
+    _queue = RenderQueue::create();
+
+    _scene = Scene::create();
+    Camera* camera = Camera::createPerspective(45.0f, getAspectRatio(), 0.5f, 500.0f);
+    _scene->addNode("camera")->setCamera(camera);
+    _scene->setActiveCamera(camera);
+    SAFE_RELEASE(camera);
+
+    Mesh* meshes[LEVEL_COUNT];
+    for (unsigned int i = 0; i < LEVEL_COUNT; ++i)
+    {
+        meshes[i] = createSphere(__levelSegments[i]);
+    }
+
+    Vector3 lightDirection(-1.0f, -1.0f, -1.0f);
+    lightDirection.normalize();
+    for (unsigned int i = 0; i < GRID_SIZE * GRID_SIZE; ++i)
+    {
+        Model* model = Model::create(meshes[0]);
+        for (unsigned int j = 1; j < LEVEL_COUNT; ++j)
+        {
+            model->addLevel(meshes[j], __levelScreenSizes[j]);
+        }
+        Material* material = model->setMaterial("res/shaders/colored.vert", "res/shaders/colored.frag");
+        material->setParameterAutoBinding("u_worldViewProjectionMatrix", "WORLD_VIEW_PROJECTION_MATRIX");
+        material->setParameterAutoBinding("u_inverseTransposeWorldViewMatrix", "INVERSE_TRANSPOSE_WORLD_VIEW_MATRIX");
+        material->getParameter("u_diffuseColor")->setValue(Vector4(i % 3 == 0 ? 1.0f : 0.5f, i % 3 == 1 ? 1.0f : 0.5f, i % 3 == 2 ? 1.0f : 0.5f, 1.0f));
+        material->getParameter("u_ambientColor")->setValue(Vector3(0.2f, 0.2f, 0.2f));
+        material->getParameter("u_lightColor")->setValue(Vector3::one());
+        material->getParameter("u_lightDirection")->setValue(lightDirection);
+        material->getStateBlock()->setCullFace(true);
+        material->getStateBlock()->setDepthTest(true);
+
+        Node* node = _scene->addNode();
+        node->setModel(model);
+        float x = ((float)(i % GRID_SIZE) - GRID_SIZE * 0.5f) * GRID_SPACING;
+        float z = -((float)(i / GRID_SIZE)) * GRID_SPACING;
+        node->setTranslation(x, 0.0f, z);
+        _models.push_back(model);
+        SAFE_RELEASE(model);
+    }
+
+    for (unsigned int i = 0; i < LEVEL_COUNT; ++i)
+    {
+        SAFE_RELEASE(meshes[i]);
+    }
+}
+
+void LevelOfDetailBenchmark::finalize()
+{
+    _models.clear();
+    SAFE_DELETE(_queue);
+    SAFE_RELEASE(_scene);
+    SAFE_RELEASE(_font);
+}
+
+void LevelOfDetailBenchmark::update(float elapsedTime)
+{
+    // Move the camera from the front of the field to far behind it and back.
+    float t = (float)(0.5 - 0.5 * cos(Game::getGameTime() * 0.0002));
+    Node* cameraNode = _scene->getActiveCamera()->getNode();
+    cameraNode->setTranslation(0.0f, 4.0f + t * 20.0f, 4.0f + t * 150.0f);
+    cameraNode->setRotation(Vector3::unitX(), MATH_DEG_TO_RAD(-10.0f));
+}
+
+void LevelOfDetailBenchmark::render(float elapsedTime)
+{
+    clear(CLEAR_COLOR_DEPTH, Vector4::zero(), 1.0f, 0);
+
+    double start = Platform::getAbsoluteTime();
+    _queue->clear();
+    _queue->add(_scene);
+    _queue->draw();
+    double time = Platform::getAbsoluteTime() - start;
+    _drawTime = _frameCount > 0 ? _drawTime * 0.95 + time * 0.05 : time;
+    ++_frameCount;
+
+    // Count the models at each level, including the culled ones, and the triangles of the drawn level.
+    unsigned int levelCounts[LEVEL_COUNT] = { 0 };
+    _triangleCount = 0;
+    for (size_t i = 0, count = _models.size(); i < count; ++i)
+    {
+        Model* model = _models[i];
+        Mesh* mesh = model->getLevelMesh(model->getLevel());
+        ++levelCounts[model->getLevel()];
+        _triangleCount += mesh->getPart(0)->getIndexCount() / 3;
+    }
+
+    _font->start();
+    drawFrameRate(_font, Vector4(0, 0.5f, 1, 1), 5, 1, getFrameRate());
+    char text[128];
+    sprintf(text, "%u models, levels of detail %s", (unsigned int)_models.size(), _levelsEnabled ? "on" : "off");
+    _font->drawText(text, 5, 5 + _font->getSize(), Vector4::one(), _font->getSize());
+    sprintf(text, "Models per level: %u %u %u %u", levelCounts[0], levelCounts[1], levelCounts[2], levelCounts[3]);
+    _font->drawText(text, 5, 5 + 2 * _font->getSize(), Vector4::one(), _font->getSize());
+    sprintf(text, "Triangles: %u", _triangleCount);
+    _font->drawText(text, 5, 5 + 3 * _font->getSize(), Vector4::one(), _font->getSize());
+    sprintf(text, "Draw: %.3f ms", _drawTime);
+    _font->drawText(text, 5, 5 + 4 * _font->getSize(), Vector4::one(), _font->getSize());
+    _font->finish();
+}
+
+void LevelOfDetailBenchmark::touchEvent(Touch::TouchEvent evt, int x, int y, unsigned int contactIndex)
+{
+    if (evt == Touch::TOUCH_PRESS)
+    {
+        // Always drawing level 0 draws the full detail meshes.
+        _levelsEnabled = !_levelsEnabled;
+        for (size_t i = 0, count = _models.size(); i < count; ++i)
+        {
+            _models[i]->setLevel(_levelsEnabled ? -1 : 0);
+        }
+        _frameCount = 0;
+    }
+}
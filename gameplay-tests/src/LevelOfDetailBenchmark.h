@@ -0,0 +1,47 @@
+#ifndef LEVELOFDETAILBENCHMARK_H_
+#define LEVELOFDETAILBENCHMARK_H_
+
+#include "gameplay.h"
+#include "Test.h"
+
+using namespace gameplay;
+
+/**
+ * Benchmark of drawing a field of detailed spheres with levels of detail, selected from
+ * their size on screen, against drawing the full detail meshes.
+ *
+ * The camera moves back and forth over the field while the models are drawn through a
+ * render queue, and the triangles drawn each frame and the number of models at each level
+ * are shown. Touch the screen to turn the levels of detail on or off.
+ */
+class LevelOfDetailBenchmark : public Test
+{
+public:
+
+    LevelOfDetailBenchmark();
+
+    void touchEvent(Touch::TouchEvent evt, int x, int y, unsigned int contactIndex);
+
+protected:
+
+    void initialize();
+
+    void finalize();
+
+    void update(float elapsedTime);
+
+    void render(float elapsedTime);
+
+private:
+
+    Font* _font;
+    Scene* _scene;
+    RenderQueue* _queue;
+    std::vector<Model*> _models;
+    bool _levelsEnabled;
+    unsigned int _triangleCount;
+    double _drawTime;
+    unsigned int _frameCount;
+};
+
+#endif
@@ -0,0 +1,168 @@
+#include "MathBenchmark.h"
+#include "TestsGame.h"
+
+#if defined(ADD_TEST)
+    ADD_TEST("Benchmark", "Math", MathBenchmark, 4);
+#endif
+
+#define MULTIPLY_COUNT 1000000
+#define POINT_COUNT 100000
+#define POINT_PASSES 20
+
+/**
+ * Scalar matrix multiply, as used when no SIMD backend is available.
+ */
+static void scalarMultiply(const float* m1, const float* m2, float* dst)
+{
+    float product[16];
+    for (int c = 0; c < 4; ++c)
+    {
+        for (int r = 0; r < 4; ++r)
+        {
+            product[c * 4 + r] = m1[r] * m2[c * 4] + m1[4 + r] * m2[c * 4 + 1] + m1[8 + r] * m2[c * 4 + 2] + m1[12 + r] * m2[c * 4 + 3];
+        }
+    }
+    memcpy(dst, product, sizeof(product));
+}
+
+/**
+ * Scalar point transform, as used when no SIMD backend is available.
+ */
+static void scalarTransformPoint(const float* m, const Vector3& point, Vector3* dst)
+{
+    float x = point.x * m[0] + point.y * m[4] + point.z * m[8] + m[12];
+    float y = point.x * m[1] + point.y * m[5] + point.z * m[9] + m[13];
+    float z = point.x * m[2] + point.y * m[6] + point.z * m[10] + m[14];
+    dst->set(x, y, z);
+}
+
+MathBenchmark::MathBenchmark()
+    : _font(NULL)
+{
+}
+
+void MathBenchmark::initialize()
+{
+    _font = Font::create("res/common/arial18.gpb");
+
+    Matrix a;
+    Matrix::createRotation(Vector3(1.0f, 2.0f, 3.0f).normalize(), 0.5f, &a);
+    a.translate(1.0f, 2.0f, 3.0f);
+    Matrix b(a);
+    b.invert();
+    b.scale(1.0001f);
+
+    char text[128];
+    sprintf(text, "Operation (ms)                   scalar        simd   speedup");
+    _results.push_back(text);
+
+    // Matrix multiply.
+    Matrix result = Matrix::identity();
+    double start = Platform::getAbsoluteTime();
+    for (unsigned int i = 0; i < MULTIPLY_COUNT; ++i)
+        scalarMultiply(result.m, i & 1 ? a.m : b.m, result.m);
+    double scalarTime = Platform::getAbsoluteTime() - start;
+    float check = result.m[0];
+
+    result.setIdentity();
+    start = Platform::getAbsoluteTime();
+    for (unsigned int i = 0; i < MULTIPLY_COUNT; ++i)
+        Matrix::multiply(result, i & 1 ? a : b, &result);
+    double simdTime = Platform::getAbsoluteTime() - start;
+    check += result.m[0];
+
+    sprintf(text, "%u multiplies          %10.3f  %10.3f  %7.2fx", MULTIPLY_COUNT, scalarTime, simdTime, scalarTime / simdTime);
+    _results.push_back(text);
+
+    // Point transforms, one at a time and as a batch.
+    std::vector<Vector3> points(POINT_COUNT);
+    std::vector<Vector3> transformed(POINT_COUNT);
+    for (unsigned int i = 0; i < POINT_COUNT; ++i)
+        points[i].set(MATH_RANDOM_MINUS1_1(), MATH_RANDOM_MINUS1_1(), MATH_RANDOM_MINUS1_1());
+
+    start = Platform::getAbsoluteTime();
+    for (unsigned int pass = 0; pass < POINT_PASSES; ++pass)
+        for (unsigned int i = 0; i < POINT_COUNT; ++i)
+            scalarTransformPoint(a.m, points[i], &transformed[i]);
+    scalarTime = Platform::getAbsoluteTime() - start;
+    check += transformed[POINT_COUNT - 1].x;
+
+    start = Platform::getAbsoluteTime();
+    for (unsigned int pass = 0; pass < POINT_PASSES; ++pass)
+        for (unsigned int i = 0; i < POINT_COUNT; ++i)
+            a.transformPoint(points[i], &transformed[i]);
+    simdTime = Platform::getAbsoluteTime() - start;
+    check += transformed[POINT_COUNT - 1].x;
+
+    sprintf(text, "%u transformPoint    %10.3f  %10.3f  %7.2fx", POINT_COUNT * POINT_PASSES, scalarTime, simdTime, scalarTime / simdTime);
+    _results.push_back(text);
+
+    start = Platform::getAbsoluteTime();
+    for (unsigned int pass = 0; pass < POINT_PASSES; ++pass)
+        a.transformPoints(&points[0], POINT_COUNT, &transformed[0]);
+    simdTime = Platform::getAbsoluteTime() - start;
+    check += transformed[POINT_COUNT - 1].x;
+
+    sprintf(text, "%u transformPoints   %10.3f  %10.3f  %7.2fx", POINT_COUNT * POINT_PASSES, scalarTime, simdTime, scalarTime / simdTime);
+    _results.push_back(text);
+
+    // Vector4 batch transforms.
+    std::vector<Vector4> vectors(POINT_COUNT);
+    std::vector<Vector4> transformedVectors(POINT_COUNT);
+    for (unsigned int i = 0; i < POINT_COUNT; ++i)
+        vectors[i].set(MATH_RANDOM_MINUS1_1(), MATH_RANDOM_MINUS1_1(), MATH_RANDOM_MINUS1_1(), 1.0f);
+
+    start = Platform::getAbsoluteTime();
+    for (unsigned int pass = 0; pass < POINT_PASSES; ++pass)
+    {
+        for (unsigned int i = 0; i < POINT_COUNT; ++i)
+        {
+            const Vector4& v = vectors[i];
+            const float* m = a.m;
+            transformedVectors[i].set(v.x * m[0] + v.y * m[4] + v.z * m[8] + v.w * m[12],
+                                      v.x * m[1] + v.y * m[5] + v.z * m[9] + v.w * m[13],
+                                      v.x * m[2] + v.y * m[6] + v.z * m[10] + v.w * m[14],
+                                      v.x * m[3] + v.y * m[7] + v.z * m[11] + v.w * m[15]);
+        }
+    }
+    scalarTime = Platform::getAbsoluteTime() - start;
+    check += transformedVectors[POINT_COUNT - 1].x;
+
+    start = Platform::getAbsoluteTime();
+    for (unsigned int pass = 0; pass < POINT_PASSES; ++pass)
+        a.transformVectors(&vectors[0], POINT_COUNT, &transformedVectors[0]);
+    simdTime = Platform::getAbsoluteTime() - start;
+    check += transformedVectors[POINT_COUNT - 1].x;
+
+    sprintf(text, "%u transformVectors  %10.3f  %10.3f  %7.2fx", POINT_COUNT * POINT_PASSES, scalarTime, simdTime, scalarTime / simdTime);
+    _results.push_back(text);
+
+    for (size_t i = 0; i < _results.size(); ++i)
+    {
+        print("%s\n", _results[i].c_str());
+    }
+
+    // Keep the results alive so the loops are not optimized away.
+    print("(checksum %f)\n", check);
+}
+
+void MathBenchmark::finalize()
+{
+    SAFE_RELEASE(_font);
+}
+
+void MathBenchmark::update(float elapsedTime)
+{
+}
+
+void MathBenchmark::render(float elapsedTime)
+{
+    clear(CLEAR_COLOR_DEPTH, Vector4::zero(), 1.0f, 0);
+
+    _font->start();
+    for (size_t i = 0; i < _results.size(); ++i)
+    {
+        _font->drawText(_results[i].c_str(), 5, 5 + i * _font->getSize(), Vector4::one(), _font->getSize());
+    }
+    _font->finish();
+}
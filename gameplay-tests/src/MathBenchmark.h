@@ -0,0 +1,35 @@
+#ifndef MATHBENCHMARK_H_
+#define MATHBENCHMARK_H_
+
+#include "gameplay.h"
+#include "Test.h"
+
+using namespace gameplay;
+
+/**
+ * Microbenchmark of the Matrix kernels and batch transforms,
+ * comparing them with a plain scalar implementation.
+ */
+class MathBenchmark : public Test
+{
+public:
+
+    MathBenchmark();
+
+protected:
+
+    void initialize();
+
+    void finalize();
+
+    void update(float elapsedTime);
+
+    void render(float elapsedTime);
+
+private:
+
+    Font* _font;
+    std::vector<std::string> _results;
+};
+
+#endif
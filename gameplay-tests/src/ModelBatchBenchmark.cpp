@@ -0,0 +1,125 @@
+#include "ModelBatchBenchmark.h"
+#include "TestsGame.h"
+
+#if defined(ADD_TEST)
+    ADD_TEST("Benchmark", "Model Batch", ModelBatchBenchmark, 7);
+#endif
+
+#define GRID_SIZE 32
+#define GRID_SPACING 3.0f
+
+ModelBatchBenchmark::ModelBatchBenchmark()
+    : _font(NULL), _scene(NULL), _batch(NULL), _batched(true)
+{
+}
+
+void ModelBatchBenchmark::initialize()
+{
+    _font = Font::create("res/common/arial18.gpb");
+
+    Bundle* bundle = Bundle::create("res/common/box.gpb");
+    _scene = bundle->loadScene();
+    SAFE_RELEASE(bundle);
+
+    Node* lightNode = _scene->findNode("directionalLight1");
+    Light* light = lightNode->getLight();
+
+    // Separate boxes are clones of the box node, drawn with its material.
+    Node* boxNode = _scene->findNode("box");
+    boxNode->addRef();
+    _scene->removeNode(boxNode);
+    Material* material = boxNode->getModel()->setMaterial("res/common/box.material");
+    material->getParameter("u_lightColor")->setValue(light->getColor());
+    material->getParameter("u_lightDirection")->setValue(lightNode->getForwardVectorView());
+    for (unsigned int i = 0; i < GRID_SIZE * GRID_SIZE; ++i)
+    {
+        Node* node = boxNode->clone();
+        float x = ((float)(i % GRID_SIZE) - GRID_SIZE * 0.5f) * GRID_SPACING;
+        float z = ((float)(i / GRID_SIZE) - GRID_SIZE * 0.5f) * GRID_SPACING;
+        node->setTranslation(x, 0.0f, z);
+        node->rotateY(MATH_DEG_TO_RAD((float)(i * 7 % 360)));
+        _scene->addNode(node);
+        _boxes.push_back(node);
+        _colors.push_back(Vector4(i % 3 == 0 ? 1.0f : 0.5f, i % 3 == 1 ? 1.0f : 0.5f, i % 3 == 2 ? 1.0f : 0.5f, 1.0f));
+        node->release();
+    }
+
+    // The batch draws its instances through a model of the same mesh on a node with an identity transform.
+    Model* batchModel = Model::create(boxNode->getModel()->getMesh());
+    _scene->addNode("batch")->setModel(batchModel);
+    material = batchModel->setMaterial("res/common/box-instanced.material");
+    material->getParameter("u_lightColor")->setValue(light->getColor());
+    material->getParameter("u_lightDirection")->setValue(lightNode->getForwardVectorView());
+    _batch = ModelBatch::create(batchModel, GRID_SIZE * GRID_SIZE);
+    SAFE_RELEASE(batchModel);
+    SAFE_RELEASE(boxNode);
+
+    Camera* camera = _scene->getActiveCamera();
+    if (camera)
+    {
+        camera->getNode()->setTranslation(0.0f, GRID_SIZE * GRID_SPACING * 0.5f, GRID_SIZE * GRID_SPACING * 0.75f);
+        camera->getNode()->rotateX(MATH_DEG_TO_RAD(-35.0f));
+    }
+}
+
+void ModelBatchBenchmark::finalize()
+{
+    SAFE_DELETE(_batch);
+    _boxes.clear();
+    SAFE_RELEASE(_scene);
+    SAFE_RELEASE(_font);
+}
+
+void ModelBatchBenchmark::update(float elapsedTime)
+{
+    for (size_t i = 0, count = _boxes.size(); i < count; ++i)
+    {
+        _boxes[i]->rotateY(elapsedTime * 0.001f);
+    }
+
+    if (_batched)
+    {
+        _batch->start();
+        for (size_t i = 0, count = _boxes.size(); i < count; ++i)
+        {
+            _batch->add(_boxes[i], _colors[i]);
+        }
+        _batch->finish();
+    }
+}
+
+void ModelBatchBenchmark::render(float elapsedTime)
+{
+    clear(CLEAR_COLOR_DEPTH, Vector4::zero(), 1.0f, 0);
+
+    if (_batched)
+        _batch->draw();
+    else
+        _scene->visit(this, &ModelBatchBenchmark::drawNode);
+
+    const RenderQueue::Stats& stats = RenderQueue::getFrameStats();
+    _font->start();
+    drawFrameRate(_font, Vector4(0, 0.5f, 1, 1), 5, 1, getFrameRate());
+    char text[64];
+    sprintf(text, "%u boxes, %s", GRID_SIZE * GRID_SIZE, _batched ? (ModelBatch::isInstancingSupported() ? "instanced" : "batched") : "separate");
+    _font->drawText(text, 5, 5 + _font->getSize(), Vector4::one(), _font->getSize());
+    sprintf(text, "Draw calls: %u", stats.drawCalls);
+    _font->drawText(text, 5, 5 + 2 * _font->getSize(), Vector4::one(), _font->getSize());
+    _font->finish();
+}
+
+bool ModelBatchBenchmark::drawNode(Node* node)
+{
+    Model* model = node->getModel();
+    if (model && model != _batch->getModel())
+        model->draw();
+    return true;
+}
+
+void ModelBatchBenchmark::touchEvent(Touch::TouchEvent evt, int x, int y, unsigned int contactIndex)
+{
+    if (evt == Touch::TOUCH_PRESS)
+    {
+        _batched = !_batched;
+    }
+}
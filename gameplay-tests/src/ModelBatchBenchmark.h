@@ -0,0 +1,45 @@
+#ifndef MODELBATCHBENCHMARK_H_
+#define MODELBATCHBENCHMARK_H_
+
+#include "gameplay.h"
+#include "Test.h"
+
+using namespace gameplay;
+
+/**
+ * Draws a grid of spinning boxes either as separate models or as the instances
+ * of a model batch, to compare their draw calls and frame rates.
+ *
+ * Touch the screen to switch between the two.
+ */
+class ModelBatchBenchmark : public Test
+{
+public:
+
+    ModelBatchBenchmark();
+
+    void touchEvent(Touch::TouchEvent evt, int x, int y, unsigned int contactIndex);
+
+protected:
+
+    void initialize();
+
+    void finalize();
+
+    void update(float elapsedTime);
+
+    void render(float elapsedTime);
+
+private:
+
+    bool drawNode(Node* node);
+
+    Font* _font;
+    Scene* _scene;
+    ModelBatch* _batch;
+    std::vector<Node*> _boxes;
+    std::vector<Vector4> _colors;
+    bool _batched;
+};
+
+#endif
@@ -0,0 +1,139 @@
+#include "NodeMatricesBenchmark.h"
+#include "TestsGame.h"
+
+#if defined(ADD_TEST)
+    ADD_TEST("Benchmark", "Node Matrices", NodeMatricesBenchmark, 6);
+#endif
+
+#define NODE_COUNT 20000
+#define CHILD_COUNT 4
+#define SHARED_NODE_COUNT 16
+#define MOVED_NODE_COUNT 500
+
+NodeMatricesBenchmark::NodeMatricesBenchmark()
+    : _font(NULL), _scene(NULL), _threadPool(NULL), _threadCount(1), _frameCount(0), _errorCount(0), _queryTime(0.0)
+{
+}
+
+void NodeMatricesBenchmark::initialize()
+{
+    _font = Font::create("res/common/arial18.gpb");
+
+    _scene = Scene::create();
+    Camera* camera = Camera::createPerspective(45.0f, getAspectRatio(), 1.0f, 1000.0f);
+    Node* cameraNode = _scene->addNode("camera");
+    cameraNode->setCamera(camera);
+    cameraNode->setTranslation(0.0f, 10.0f, 100.0f);
+    _scene->setActiveCamera(camera);
+    SAFE_RELEASE(camera);
+
+    // Build a tree where each node has a few children, offset and rotated from their parent.
+    for (unsigned int i = 0; i < NODE_COUNT; ++i)
+    {
+        Node* node = Node::create();
+        node->setTranslation((float)(i % CHILD_COUNT) - 1.5f, 1.0f, 0.0f);
+        node->rotateY(MATH_DEG_TO_RAD((float)(i % 360)));
+        node->setScale(0.99f);
+        if (i == 0)
+            _scene->addNode(node);
+        else
+            _nodes[(i - 1) / CHILD_COUNT]->addChild(node);
+        _nodes.push_back(node);
+        node->release();
+    }
+    _scene->setTransformsFlattened(true);
+
+    _threadCount = ThreadPool::getProcessorCount();
+    _threadPool = ThreadPool::create(_threadCount);
+    _expected.resize(SHARED_NODE_COUNT);
+    _errors.resize(_threadCount * 4);
+}
+
+void NodeMatricesBenchmark::finalize()
+{
+    SAFE_DELETE(_threadPool);
+    _nodes.clear();
+    SAFE_RELEASE(_scene);
+    SAFE_RELEASE(_font);
+}
+
+void NodeMatricesBenchmark::queryNodes(void* benchmark, unsigned int job)
+{
+    NodeMatricesBenchmark* b = static_cast<NodeMatricesBenchmark*>(benchmark);
+    unsigned int jobCount = (unsigned int)b->_errors.size();
+    unsigned int errors = 0;
+
+    // Query the cached matrices of the nodes of this job, checking them against
+    // the matrices computed into our own output.
+    Matrix m;
+    for (unsigned int i = job; i < NODE_COUNT; i += jobCount)
+    {
+        const Node* node = b->_nodes[i];
+        node->getWorldViewProjectionMatrix(&m);
+        if (memcmp(&m, &node->getWorldViewProjectionMatrix(), sizeof(Matrix)) != 0)
+            ++errors;
+        node->getWorldViewMatrix(&m);
+        if (memcmp(&m, &node->getWorldViewMatrix(), sizeof(Matrix)) != 0)
+            ++errors;
+        node->getInverseTransposeWorldViewMatrix(&m);
+        if (memcmp(&m, &node->getInverseTransposeWorldViewMatrix(), sizeof(Matrix)) != 0)
+            ++errors;
+    }
+
+    // Every job computes the matrices of the same shared nodes.
+    for (unsigned int i = 0; i < SHARED_NODE_COUNT; ++i)
+    {
+        b->_nodes[i]->getWorldViewProjectionMatrix(&m);
+        if (memcmp(&m, &b->_expected[i], sizeof(Matrix)) != 0)
+            ++errors;
+    }
+
+    b->_errors[job] = errors;
+}
+
+void NodeMatricesBenchmark::update(float elapsedTime)
+{
+    // Move the camera and some of the nodes.
+    Node* cameraNode = _scene->getActiveCamera()->getNode();
+    cameraNode->rotateY(elapsedTime * 0.0005f);
+    for (unsigned int i = 0; i < MOVED_NODE_COUNT; ++i)
+    {
+        _nodes[(_frameCount * MOVED_NODE_COUNT + i * 37) % NODE_COUNT]->rotateX(elapsedTime * 0.001f);
+    }
+
+    // World and camera matrices are brought up to date on the main thread before the threads read them.
+    _scene->updateTransforms();
+    _scene->getActiveCamera()->getViewProjectionMatrix();
+    for (unsigned int i = 0; i < SHARED_NODE_COUNT; ++i)
+    {
+        Matrix::multiply(_scene->getActiveCamera()->getViewProjectionMatrix(), _nodes[i]->getWorldMatrix(), &_expected[i]);
+    }
+
+    double start = Platform::getAbsoluteTime();
+    _threadPool->run(&NodeMatricesBenchmark::queryNodes, this, (unsigned int)_errors.size());
+    double time = Platform::getAbsoluteTime() - start;
+
+    for (size_t i = 0; i < _errors.size(); ++i)
+    {
+        _errorCount += _errors[i];
+    }
+    _queryTime = _frameCount > 0 ? _queryTime * 0.95 + time * 0.05 : time;
+    ++_frameCount;
+}
+
+void NodeMatricesBenchmark::render(float elapsedTime)
+{
+    clear(CLEAR_COLOR_DEPTH, Vector4::zero(), 1.0f, 0);
+
+    _font->start();
+    char text[64];
+    sprintf(text, "%u nodes, %u threads", NODE_COUNT, _threadCount);
+    _font->drawText(text, 5, 5, Vector4::one(), _font->getSize());
+    sprintf(text, "Frames: %u", _frameCount);
+    _font->drawText(text, 5, 5 + _font->getSize(), Vector4::one(), _font->getSize());
+    sprintf(text, "Queries: %.3f ms", _queryTime);
+    _font->drawText(text, 5, 5 + 2 * _font->getSize(), Vector4::one(), _font->getSize());
+    sprintf(text, "Mismatches: %u", _errorCount);
+    _font->drawText(text, 5, 5 + 3 * _font->getSize(), _errorCount > 0 ? Vector4(1, 0, 0, 1) : Vector4::one(), _font->getSize());
+    _font->finish();
+}
@@ -0,0 +1,49 @@
+#ifndef NODEMATRICESBENCHMARK_H_
+#define NODEMATRICESBENCHMARK_H_
+
+#include "gameplay.h"
+#include "Test.h"
+
+using namespace gameplay;
+
+/**
+ * Stress test of the Node matrix accessors queried concurrently from many threads.
+ *
+ * Every frame the camera and some nodes move, then all threads of a pool query the
+ * cached matrices of their own nodes and compute the matrices of shared nodes into
+ * their own output. The results are checked against the matrices computed on the
+ * main thread, and the time taken by the threads is recorded.
+ */
+class NodeMatricesBenchmark : public Test
+{
+public:
+
+    NodeMatricesBenchmark();
+
+protected:
+
+    void initialize();
+
+    void finalize();
+
+    void update(float elapsedTime);
+
+    void render(float elapsedTime);
+
+private:
+
+    static void queryNodes(void* benchmark, unsigned int job);
+
+    Font* _font;
+    Scene* _scene;
+    ThreadPool* _threadPool;
+    std::vector<Node*> _nodes;
+    std::vector<Matrix> _expected;
+    std::vector<unsigned int> _errors;
+    unsigned int _threadCount;
+    unsigned int _frameCount;
+    unsigned int _errorCount;
+    double _queryTime;
+};
+
+#endif
@@ -0,0 +1,86 @@
+#include "ParticleEmitterBenchmark.h"
+#include "TestsGame.h"
+
+#if defined(ADD_TEST)
+    ADD_TEST("Benchmark", "Particle Emitter", ParticleEmitterBenchmark, 1);
+#endif
+
+static const unsigned int __particleCounts[PARTICLE_EMITTER_BENCHMARK_COUNT] = { 1000, 10000, 100000 };
+
+ParticleEmitterBenchmark::ParticleEmitterBenchmark()
+    : _font(NULL), _scene(NULL), _frameCount(0)
+{
+    for (unsigned int i = 0; i < PARTICLE_EMITTER_BENCHMARK_COUNT; ++i)
+    {
+        _emitters[i] = NULL;
+        _updateTime[i] = 0.0;
+    }
+}
+
+void ParticleEmitterBenchmark::initialize()
+{
+    _font = Font::create("res/common/arial18.gpb");
+
+    _scene = Scene::create();
+    Camera* camera = Camera::createPerspective(45.0f, getAspectRatio(), 1.0f, 100.0f);
+    Node* cameraNode = _scene->addNode("camera");
+    cameraNode->setCamera(camera);
+    cameraNode->setTranslation(0.0f, 0.0f, 20.0f);
+    _scene->setActiveCamera(camera);
+    SAFE_RELEASE(camera);
+
+    // Emit all the particles up front with a lifetime long enough to keep each emitter full.
+    for (unsigned int i = 0; i < PARTICLE_EMITTER_BENCHMARK_COUNT; ++i)
+    {
+        ParticleEmitter* emitter = ParticleEmitter::create("res/common/box-diffuse.png", ParticleEmitter::BLEND_ADDITIVE, __particleCounts[i]);
+        emitter->setEnergy(1000000, 1000000);
+        emitter->setEllipsoid(true);
+        emitter->setPosition(Vector3::zero(), Vector3(10.0f, 10.0f, 10.0f));
+        emitter->setVelocity(Vector3::zero(), Vector3(2.0f, 2.0f, 2.0f));
+        emitter->setAcceleration(Vector3(0.0f, -0.1f, 0.0f), Vector3(0.1f, 0.1f, 0.1f));
+        emitter->setColor(Vector4::one(), Vector4::zero(), Vector4(1.0f, 1.0f, 1.0f, 0.0f), Vector4::zero());
+        emitter->setSize(0.1f, 0.2f, 0.0f, 0.1f);
+        emitter->setRotationPerParticle(-1.0f, 1.0f);
+
+        Node* node = _scene->addNode();
+        node->setParticleEmitter(emitter);
+        emitter->emitOnce(__particleCounts[i]);
+        _emitters[i] = emitter;
+    }
+}
+
+void ParticleEmitterBenchmark::finalize()
+{
+    for (unsigned int i = 0; i < PARTICLE_EMITTER_BENCHMARK_COUNT; ++i)
+    {
+        SAFE_RELEASE(_emitters[i]);
+    }
+    SAFE_RELEASE(_scene);
+    SAFE_RELEASE(_font);
+}
+
+void ParticleEmitterBenchmark::update(float elapsedTime)
+{
+    // Update with a constant time step so every frame does the same amount of work.
+    for (unsigned int i = 0; i < PARTICLE_EMITTER_BENCHMARK_COUNT; ++i)
+    {
+        double start = Platform::getAbsoluteTime();
+        _emitters[i]->update(16.0f);
+        _updateTime[i] += Platform::getAbsoluteTime() - start;
+    }
+    ++_frameCount;
+}
+
+void ParticleEmitterBenchmark::render(float elapsedTime)
+{
+    clear(CLEAR_COLOR_DEPTH, Vector4::zero(), 1.0f, 0);
+
+    _font->start();
+    char text[64];
+    for (unsigned int i = 0; i < PARTICLE_EMITTER_BENCHMARK_COUNT; ++i)
+    {
+        sprintf(text, "%u particles: %.3f ms", __particleCounts[i], _frameCount ? _updateTime[i] / _frameCount : 0.0);
+        _font->drawText(text, 5, 5 + i * _font->getSize(), Vector4::one(), _font->getSize());
+    }
+    _font->finish();
+}
@@ -0,0 +1,41 @@
+#ifndef PARTICLEEMITTERBENCHMARK_H_
+#define PARTICLEEMITTERBENCHMARK_H_
+
+#include "gameplay.h"
+#include "Test.h"
+
+using namespace gameplay;
+
+#define PARTICLE_EMITTER_BENCHMARK_COUNT 3
+
+/**
+ * Benchmark measuring the time spent updating particle emitters of 1k, 10k and 100k particles.
+ *
+ * Build gameplay with GP_NO_SSE defined to compare the SIMD update with the scalar one.
+ */
+class ParticleEmitterBenchmark : public Test
+{
+public:
+
+    ParticleEmitterBenchmark();
+
+protected:
+
+    void initialize();
+
+    void finalize();
+
+    void update(float elapsedTime);
+
+    void render(float elapsedTime);
+
+private:
+
+    Font* _font;
+    Scene* _scene;
+    ParticleEmitter* _emitters[PARTICLE_EMITTER_BENCHMARK_COUNT];
+    double _updateTime[PARTICLE_EMITTER_BENCHMARK_COUNT];
+    unsigned int _frameCount;
+};
+
+#endif
@@ -0,0 +1,155 @@
+#include "SceneCullingBenchmark.h"
+#include "TestsGame.h"
+
+#if defined(ADD_TEST)
+    ADD_TEST("Benchmark", "Scene Culling", SceneCullingBenchmark, 8);
+#endif
+
+#define BOX_SPACING 6.0f
+#define MOVED_BOX_FRACTION 100
+
+static const unsigned int __boxCounts[] = { 1000, 10000, 100000, 500000 };
+
+SceneCullingBenchmark::SceneCullingBenchmark()
+    : _font(NULL), _mesh(NULL), _scene(NULL), _batch(NULL), _countIndex(0), _frameCount(0), _bruteForceCount(0),
+    _cullTime(0.0), _bruteForceTime(0.0)
+{
+}
+
+void SceneCullingBenchmark::initialize()
+{
+    _font = Font::create("res/common/arial18.gpb");
+
+    Bundle* bundle = Bundle::create("res/common/box.gpb");
+    Scene* scene = bundle->loadScene();
+    _mesh = scene->findNode("box")->getModel()->getMesh();
+    _mesh->addRef();
+    SAFE_RELEASE(scene);
+    SAFE_RELEASE(bundle);
+
+    createScene();
+}
+
+void SceneCullingBenchmark::createScene()
+{
+    SAFE_DELETE(_batch);
+    _boxes.clear();
+    SAFE_RELEASE(_scene);
+
+    _scene = Scene::create();
+    Camera* camera = Camera::createPerspective(45.0f, getAspectRatio(), 1.0f, 200.0f);
+    Node* cameraNode = _scene->addNode("camera");
+    cameraNode->setCamera(camera);
+    _scene->setActiveCamera(camera);
+    SAFE_RELEASE(camera);
+
+    // Spread the boxes through a cube, at the same density whatever their number. Their
+    // models have no material since the visible boxes are drawn by the batch.
+    unsigned int count = __boxCounts[_countIndex];
+    unsigned int side = (unsigned int)ceil(pow((double)count, 1.0 / 3.0));
+    float extent = side * BOX_SPACING * 0.5f;
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        Node* node = Node::create();
+        Model* model = Model::create(_mesh);
+        node->setModel(model);
+        SAFE_RELEASE(model);
+        node->setTranslation(MATH_RANDOM_MINUS1_1() * extent, MATH_RANDOM_MINUS1_1() * extent, MATH_RANDOM_MINUS1_1() * extent);
+        _scene->addNode(node);
+        _boxes.push_back(node);
+        node->release();
+    }
+
+    Model* batchModel = Model::create(_mesh);
+    _scene->addNode("batch")->setModel(batchModel);
+    Material* material = batchModel->setMaterial("res/common/box-instanced.material");
+    Vector3 lightDirection(-1.0f, -1.0f, -1.0f);
+    lightDirection.normalize();
+    material->getParameter("u_lightDirection")->setValue(lightDirection);
+    _batch = ModelBatch::create(batchModel, 1024);
+    SAFE_RELEASE(batchModel);
+
+    _frameCount = 0;
+}
+
+void SceneCullingBenchmark::finalize()
+{
+    SAFE_DELETE(_batch);
+    _boxes.clear();
+    _visible.clear();
+    SAFE_RELEASE(_scene);
+    SAFE_RELEASE(_mesh);
+    SAFE_RELEASE(_font);
+}
+
+bool SceneCullingBenchmark::testNode(Node* node, const Frustum* frustum)
+{
+    if (node->getModel() && node != _batch->getModel()->getNode() && node->getBoundingSphere().intersects(*frustum))
+        ++_bruteForceCount;
+    return true;
+}
+
+void SceneCullingBenchmark::update(float elapsedTime)
+{
+    // Turn the camera and move some of the boxes.
+    Node* cameraNode = _scene->getActiveCamera()->getNode();
+    cameraNode->rotateY(elapsedTime * 0.0002f);
+    unsigned int count = (unsigned int)_boxes.size();
+    unsigned int moved = count / MOVED_BOX_FRACTION;
+    for (unsigned int i = 0; i < moved; ++i)
+    {
+        _boxes[(_frameCount * moved + i) % count]->translateY((float)sin(Game::getGameTime() * 0.001 + i) * 0.1f);
+    }
+
+    // Cull through the bounding volume hierarchy, which first updates the bounds of the moved boxes.
+    double start = Platform::getAbsoluteTime();
+    _visible.clear();
+    _scene->cull(_visible);
+    double cullTime = Platform::getAbsoluteTime() - start;
+
+    // Cull by testing the bounds of every node.
+    const Frustum& frustum = _scene->getActiveCamera()->getFrustum();
+    start = Platform::getAbsoluteTime();
+    _bruteForceCount = 0;
+    _scene->visit(this, &SceneCullingBenchmark::testNode, &frustum);
+    double bruteForceTime = Platform::getAbsoluteTime() - start;
+
+    _cullTime = _frameCount > 0 ? _cullTime * 0.95 + cullTime * 0.05 : cullTime;
+    _bruteForceTime = _frameCount > 0 ? _bruteForceTime * 0.95 + bruteForceTime * 0.05 : bruteForceTime;
+    ++_frameCount;
+
+    _batch->start();
+    for (size_t i = 0, visibleCount = _visible.size(); i < visibleCount; ++i)
+    {
+        if (_visible[i]->getModel() != _batch->getModel())
+            _batch->add(_visible[i]);
+    }
+    _batch->finish();
+}
+
+void SceneCullingBenchmark::render(float elapsedTime)
+{
+    clear(CLEAR_COLOR_DEPTH, Vector4::zero(), 1.0f, 0);
+
+    _batch->draw();
+
+    _font->start();
+    drawFrameRate(_font, Vector4(0, 0.5f, 1, 1), 5, 1, getFrameRate());
+    char text[64];
+    sprintf(text, "%u boxes, %u visible", (unsigned int)_boxes.size(), _batch->getInstanceCount());
+    _font->drawText(text, 5, 5 + _font->getSize(), Vector4::one(), _font->getSize());
+    sprintf(text, "Hierarchy: %.3f ms", _cullTime);
+    _font->drawText(text, 5, 5 + 2 * _font->getSize(), Vector4::one(), _font->getSize());
+    sprintf(text, "All nodes: %.3f ms (%u visible)", _bruteForceTime, _bruteForceCount);
+    _font->drawText(text, 5, 5 + 3 * _font->getSize(), Vector4::one(), _font->getSize());
+    _font->finish();
+}
+
+void SceneCullingBenchmark::touchEvent(Touch::TouchEvent evt, int x, int y, unsigned int contactIndex)
+{
+    if (evt == Touch::TOUCH_PRESS)
+    {
+        _countIndex = (_countIndex + 1) % (sizeof(__boxCounts) / sizeof(__boxCounts[0]));
+        createScene();
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef SCENECULLINGBENCHMARK_H_
+#define SCENECULLINGBENCHMARK_H_
+
+#include "gameplay.h"
+#include "Test.h"
+
+using namespace gameplay;
+
+/**
+ * Compares culling a scene of moving boxes to the camera's view frustum through the
+ * scene's bounding volume hierarchy with testing the bounds of every node.
+ *
+ * Every frame the camera turns and some of the boxes move, then the visible boxes are
+ * found both ways and drawn as the instances of a model batch.
+ *
+ * Touch the screen to change the number of boxes.
+ */
+class SceneCullingBenchmark : public Test
+{
+public:
+
+    SceneCullingBenchmark();
+
+    void touchEvent(Touch::TouchEvent evt, int x, int y, unsigned int contactIndex);
+
+protected:
+
+    void initialize();
+
+    void finalize();
+
+    void update(float elapsedTime);
+
+    void render(float elapsedTime);
+
+private:
+
+    void createScene();
+
+    bool testNode(Node* node, const Frustum* frustum);
+
+    Font* _font;
+    Mesh* _mesh;
+    Scene* _scene;
+    ModelBatch* _batch;
+    std::vector<Node*> _boxes;
+    std::vector<Node*> _visible;
+    unsigned int _countIndex;
+    unsigned int _frameCount;
+    unsigned int _bruteForceCount;
+    double _cullTime;
+    double _bruteForceTime;
+};
+
+#endif
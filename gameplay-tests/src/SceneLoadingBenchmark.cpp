@@ -0,0 +1,173 @@
+#include "SceneLoadingBenchmark.h"
+#include "TestsGame.h"
+
+#if defined(ADD_TEST)
+    ADD_TEST("Benchmark", "Scene Loading", SceneLoadingBenchmark, 9);
+#endif
+
+#define SCENE_PATH "res/benchmark.scene"
+#define SKINNED_SCENE_PATH "res/common/skinned.scene"
+
+static const unsigned int __nodeCounts[] = { 500, 2000, 8000 };
+
+/**
+ * Writes a scene of boxes stitched in from a bundle and returns whether it succeeded.
+ */
+static bool writeScene(const char* path, unsigned int nodeCount, bool indexed)
+{
+    FILE* fp = FileSystem::openFile(path, "w");
+    if (!fp)
+        return false;
+
+    fprintf(fp, "scene\n{\n    path = res/common/scene.gpb\n    indexNodes = %s\n", indexed ? "true" : "false");
+    for (unsigned int i = 0; i < nodeCount; ++i)
+    {
+        fprintf(fp, "    node box%u\n    {\n        url = res/common/box.gpb#box\n        translate = %u, 0, %u\n    }\n", i, i % 100, i / 100);
+    }
+    fprintf(fp, "}\n");
+    fclose(fp);
+    return true;
+}
+
+/**
+ * Loads a scene and returns the time taken in milliseconds.
+ */
+static double loadScene(const char* path, Scene** scene)
+{
+    double start = Platform::getAbsoluteTime();
+    *scene = Scene::load(path);
+    return Platform::getAbsoluteTime() - start;
+}
+
+/**
+ * Finds each box of a scene by id and returns the time taken in milliseconds.
+ */
+static double findNodes(Scene* scene, unsigned int nodeCount, unsigned int* misses)
+{
+    char id[32];
+    *misses = 0;
+    double start = Platform::getAbsoluteTime();
+    for (unsigned int i = 0; i < nodeCount; ++i)
+    {
+        sprintf(id, "box%u", i);
+        if (scene->findNode(id) == NULL)
+            ++(*misses);
+    }
+    return Platform::getAbsoluteTime() - start;
+}
+
+/**
+ * Finds the joints of the skin of a node by id in its scene and returns the number found.
+ *
+ * The joints of a skin are not part of the scene, so they are not in its index.
+ */
+static unsigned int findJoints(Scene* scene, Node* node, unsigned int* jointCount)
+{
+    *jointCount = 0;
+    if (!node || !node->getModel() || !node->getModel()->getSkin())
+        return 0;
+
+    MeshSkin* skin = node->getModel()->getSkin();
+    unsigned int found = 0;
+    *jointCount = skin->getJointCount();
+    for (unsigned int i = 0; i < *jointCount; ++i)
+    {
+        Joint* joint = skin->getJoint(i);
+        if (scene->findNode(joint->getId()) == joint && node->findNode(joint->getId()) == joint)
+            ++found;
+    }
+    return found;
+}
+
+SceneLoadingBenchmark::SceneLoadingBenchmark()
+    : _font(NULL)
+{
+}
+
+void SceneLoadingBenchmark::initialize()
+{
+    _font = Font::create("res/common/arial18.gpb");
+
+    char text[128];
+    _results.push_back("Nodes (ms)        load     indexed    find all     indexed");
+    for (unsigned int i = 0; i < sizeof(__nodeCounts) / sizeof(__nodeCounts[0]); ++i)
+    {
+        unsigned int nodeCount = __nodeCounts[i];
+        Scene* scene = NULL;
+        Scene* indexedScene = NULL;
+        if (!writeScene(SCENE_PATH, nodeCount, false))
+        {
+            _results.push_back("Failed to write " SCENE_PATH);
+            return;
+        }
+        double loadTime = loadScene(SCENE_PATH, &scene);
+        writeScene(SCENE_PATH, nodeCount, true);
+        double indexedLoadTime = loadScene(SCENE_PATH, &indexedScene);
+        if (!scene || !indexedScene)
+        {
+            _results.push_back("Failed to load " SCENE_PATH);
+            SAFE_RELEASE(scene);
+            SAFE_RELEASE(indexedScene);
+            break;
+        }
+
+        unsigned int misses;
+        unsigned int indexedMisses;
+        double findTime = findNodes(scene, nodeCount, &misses);
+        double indexedFindTime = findNodes(indexedScene, nodeCount, &indexedMisses);
+        sprintf(text, "%5u       %10.3f  %10.3f  %10.3f  %10.3f", nodeCount, loadTime, indexedLoadTime, findTime, indexedFindTime);
+        _results.push_back(text);
+        if (misses > 0 || indexedMisses > 0)
+        {
+            sprintf(text, "      Failed to find %u nodes, %u indexed", misses, indexedMisses);
+            _results.push_back(text);
+        }
+
+        SAFE_RELEASE(scene);
+        SAFE_RELEASE(indexedScene);
+    }
+
+    std::string path(FileSystem::getResourcePath());
+    path += SCENE_PATH;
+    remove(path.c_str());
+
+    Scene* skinnedScene = Scene::load(SKINNED_SCENE_PATH);
+    if (skinnedScene)
+    {
+        unsigned int jointCount;
+        unsigned int found = findJoints(skinnedScene, skinnedScene->findNode("character"), &jointCount);
+        sprintf(text, "Skin joints found in indexed scene: %u of %u", found, jointCount);
+        _results.push_back(text);
+        SAFE_RELEASE(skinnedScene);
+    }
+    else
+    {
+        _results.push_back("Failed to load " SKINNED_SCENE_PATH);
+    }
+
+    for (size_t i = 0; i < _results.size(); ++i)
+    {
+        print("%s\n", _results[i].c_str());
+    }
+}
+
+void SceneLoadingBenchmark::finalize()
+{
+    SAFE_RELEASE(_font);
+}
+
+void SceneLoadingBenchmark::update(float elapsedTime)
+{
+}
+
+void SceneLoadingBenchmark::render(float elapsedTime)
+{
+    clear(CLEAR_COLOR_DEPTH, Vector4::zero(), 1.0f, 0);
+
+    _font->start();
+    for (size_t i = 0; i < _results.size(); ++i)
+    {
+        _font->drawText(_results[i].c_str(), 5, 5 + i * _font->getSize(), Vector4::one(), _font->getSize());
+    }
+    _font->finish();
+}
@@ -0,0 +1,38 @@
+#ifndef SCENELOADINGBENCHMARK_H_
+#define SCENELOADINGBENCHMARK_H_
+
+#include "gameplay.h"
+#include "Test.h"
+
+using namespace gameplay;
+
+/**
+ * Benchmark of loading generated .scene files with many nodes stitched in
+ * from a bundle, and of finding their nodes by id, comparing scenes with
+ * and without an index of their nodes. Also checks that the joints of a
+ * skinned model, which are not part of its scene, are found by id in an
+ * indexed scene.
+ */
+class SceneLoadingBenchmark : public Test
+{
+public:
+
+    SceneLoadingBenchmark();
+
+protected:
+
+    void initialize();
+
+    void finalize();
+
+    void update(float elapsedTime);
+
+    void render(float elapsedTime);
+
+private:
+
+    Font* _font;
+    std::vector<std::string> _results;
+};
+
+#endif
@@ -0,0 +1,122 @@
+#include "SceneVisitBenchmark.h"
+#include "TestsGame.h"
+
+#if defined(ADD_TEST)
+    ADD_TEST("Benchmark", "Scene Visit", SceneVisitBenchmark, 10);
+#endif
+
+#define NODE_COUNT 100000
+#define CHILD_COUNT 4
+#define SENSOR_RANGE 10.0f
+
+SceneVisitBenchmark::SceneVisitBenchmark()
+    : _font(NULL), _scene(NULL), _count(0), _frameCount(0), _errorCount(0), _visitTime(0.0), _parallelVisitTime(0.0)
+{
+}
+
+void SceneVisitBenchmark::initialize()
+{
+    _font = Font::create("res/common/arial18.gpb");
+
+    // Build a tree where each node has a few children, offset and rotated from their parent.
+    _scene = Scene::create();
+    std::vector<Node*> nodes;
+    for (unsigned int i = 0; i < NODE_COUNT; ++i)
+    {
+        Node* node = Node::create();
+        node->setTranslation((float)(i % CHILD_COUNT) - 1.5f, 1.0f, 0.0f);
+        node->rotateY(MATH_DEG_TO_RAD((float)(i % 360)));
+        if (i == 0)
+            _scene->addNode(node);
+        else
+            nodes[(i - 1) / CHILD_COUNT]->addChild(node);
+        nodes.push_back(node);
+        node->release();
+    }
+
+    // World matrices are computed up front, so that the visit threads only read them.
+    _scene->setTransformsFlattened(true);
+    _scene->updateTransforms();
+    _scene->setVisitThreadCount(0);
+}
+
+void SceneVisitBenchmark::finalize()
+{
+    SAFE_RELEASE(_scene);
+    SAFE_RELEASE(_font);
+}
+
+bool SceneVisitBenchmark::senseNode(Node* node)
+{
+    if (node->getTranslationWorld().distanceSquared(_sensor) < SENSOR_RANGE * SENSOR_RANGE)
+        ++_count;
+    return true;
+}
+
+bool SceneVisitBenchmark::senseNodeParallel(Node* node, unsigned int& count) const
+{
+    if (node->getTranslationWorld().distanceSquared(_sensor) < SENSOR_RANGE * SENSOR_RANGE)
+        ++count;
+    return true;
+}
+
+void SceneVisitBenchmark::update(float elapsedTime)
+{
+    float angle = (float)Game::getGameTime() * 0.0005f;
+    _sensor.set(cos(angle) * 20.0f, 10.0f, sin(angle) * 20.0f);
+
+    double start = Platform::getAbsoluteTime();
+    _count = 0;
+    _scene->visit(this, &SceneVisitBenchmark::senseNode);
+    double time = Platform::getAbsoluteTime() - start;
+    _visitTime = _frameCount > 0 ? _visitTime * 0.95 + time * 0.05 : time;
+
+    start = Platform::getAbsoluteTime();
+    for (size_t i = 0; i < _counts.size(); ++i)
+    {
+        _counts[i] = 0;
+    }
+    _scene->visitParallel(this, &SceneVisitBenchmark::senseNodeParallel, _counts);
+    unsigned int count = 0;
+    for (size_t i = 0; i < _counts.size(); ++i)
+    {
+        count += _counts[i];
+    }
+    time = Platform::getAbsoluteTime() - start;
+    _parallelVisitTime = _frameCount > 0 ? _parallelVisitTime * 0.95 + time * 0.05 : time;
+
+    if (count != _count)
+        ++_errorCount;
+    ++_frameCount;
+}
+
+void SceneVisitBenchmark::render(float elapsedTime)
+{
+    clear(CLEAR_COLOR_DEPTH, Vector4::zero(), 1.0f, 0);
+
+    _font->start();
+    char text[64];
+    sprintf(text, "%u nodes, %u threads", NODE_COUNT, _scene->getVisitThreadCount());
+    _font->drawText(text, 5, 5, Vector4::one(), _font->getSize());
+    sprintf(text, "Nodes sensed: %u", _count);
+    _font->drawText(text, 5, 5 + _font->getSize(), Vector4::one(), _font->getSize());
+    sprintf(text, "Visit: %.3f ms", _visitTime);
+    _font->drawText(text, 5, 5 + 2 * _font->getSize(), Vector4::one(), _font->getSize());
+    sprintf(text, "Parallel visit: %.3f ms", _parallelVisitTime);
+    _font->drawText(text, 5, 5 + 3 * _font->getSize(), Vector4::one(), _font->getSize());
+    sprintf(text, "Mismatches: %u", _errorCount);
+    _font->drawText(text, 5, 5 + 4 * _font->getSize(), _errorCount > 0 ? Vector4(1, 0, 0, 1) : Vector4::one(), _font->getSize());
+    _font->finish();
+}
+
+void SceneVisitBenchmark::touchEvent(Touch::TouchEvent evt, int x, int y, unsigned int contactIndex)
+{
+    if (evt == Touch::TOUCH_PRESS)
+    {
+        // Cycle from one thread up to one per processor.
+        unsigned int threadCount = _scene->getVisitThreadCount();
+        _scene->setVisitThreadCount(threadCount < ThreadPool::getProcessorCount() ? threadCount + 1 : 1);
+        _parallelVisitTime = 0.0;
+        _frameCount = 0;
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef SCENEVISITBENCHMARK_H_
+#define SCENEVISITBENCHMARK_H_
+
+#include "gameplay.h"
+#include "Test.h"
+
+using namespace gameplay;
+
+/**
+ * Benchmark of visiting the nodes of a large scene, comparing the serial visit
+ * with the parallel visit across a number of threads.
+ *
+ * Every frame both visits count the nodes near a moving sensor, each thread of the
+ * parallel visit counting into its own result, and the counts are checked against
+ * each other. Touch the screen to change the number of threads.
+ */
+class SceneVisitBenchmark : public Test
+{
+public:
+
+    SceneVisitBenchmark();
+
+    void touchEvent(Touch::TouchEvent evt, int x, int y, unsigned int contactIndex);
+
+protected:
+
+    void initialize();
+
+    void finalize();
+
+    void update(float elapsedTime);
+
+    void render(float elapsedTime);
+
+private:
+
+    bool senseNode(Node* node);
+
+    bool senseNodeParallel(Node* node, unsigned int& count) const;
+
+    Font* _font;
+    Scene* _scene;
+    Vector3 _sensor;
+    unsigned int _count;
+    std::vector<unsigned int> _counts;
+    unsigned int _frameCount;
+    unsigned int _errorCount;
+    double _visitTime;
+    double _parallelVisitTime;
+};
+
+#endif
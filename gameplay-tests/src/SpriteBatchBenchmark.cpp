@@ -0,0 +1,122 @@
+#include "SpriteBatchBenchmark.h"
+#include "TestsGame.h"
+
+#if defined(ADD_TEST)
+    ADD_TEST("Benchmark", "Sprite Batch", SpriteBatchBenchmark, 12);
+#endif
+
+#define SPRITE_COUNT_COUNT 5
+#define SPRITE_SIZE 8.0f
+#define CLIENT_BATCH_SIZE 10000
+
+static const unsigned int __spriteCounts[SPRITE_COUNT_COUNT] = { 10000, 25000, 50000, 100000, 200000 };
+
+SpriteBatchBenchmark::SpriteBatchBenchmark()
+    : _font(NULL), _batch(NULL), _countIndex(0), _drawTime(0.0), _frameCount(0)
+{
+}
+
+void SpriteBatchBenchmark::initialize()
+{
+    _font = Font::create("res/common/arial18.gpb");
+    _batch = SpriteBatch::create("res/common/box-diffuse.png");
+    _batch->getStateBlock()->setBlend(true);
+    _batch->getStateBlock()->setBlendSrc(RenderState::BLEND_SRC_ALPHA);
+    _batch->getStateBlock()->setBlendDst(RenderState::BLEND_ONE_MINUS_SRC_ALPHA);
+    setSpriteCount(__spriteCounts[_countIndex]);
+}
+
+void SpriteBatchBenchmark::finalize()
+{
+    _sprites.clear();
+    SAFE_DELETE(_batch);
+    SAFE_RELEASE(_font);
+}
+
+void SpriteBatchBenchmark::setSpriteCount(unsigned int count)
+{
+    // Each sprite holds its position and velocity, in pixels per second.
+    _sprites.resize(count);
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        _sprites[i].set(MATH_RANDOM_0_1() * getWidth(), MATH_RANDOM_0_1() * getHeight(),
+            MATH_RANDOM_MINUS1_1() * 100.0f, MATH_RANDOM_MINUS1_1() * 100.0f);
+    }
+    _frameCount = 0;
+}
+
+void SpriteBatchBenchmark::update(float elapsedTime)
+{
+    // Move the sprites, bouncing them off the sides of the screen.
+    float t = elapsedTime * 0.001f;
+    float width = (float)getWidth() - SPRITE_SIZE;
+    float height = (float)getHeight() - SPRITE_SIZE;
+    for (size_t i = 0, count = _sprites.size(); i < count; ++i)
+    {
+        Vector4& s = _sprites[i];
+        s.x += s.z * t;
+        s.y += s.w * t;
+        if (s.x < 0.0f || s.x > width)
+        {
+            s.z = -s.z;
+            s.x = MATH_CLAMP(s.x, 0.0f, width);
+        }
+        if (s.y < 0.0f || s.y > height)
+        {
+            s.w = -s.w;
+            s.y = MATH_CLAMP(s.y, 0.0f, height);
+        }
+    }
+}
+
+void SpriteBatchBenchmark::render(float elapsedTime)
+{
+    clear(CLEAR_COLOR_DEPTH, Vector4::zero(), 1.0f, 0);
+
+    double start = Platform::getAbsoluteTime();
+    Vector4 color(1.0f, 1.0f, 1.0f, 0.5f);
+    bool streaming = _batch->isStreaming();
+    _batch->start();
+    for (size_t i = 0, count = _sprites.size(); i < count; ++i)
+    {
+        if (!streaming && i > 0 && i % CLIENT_BATCH_SIZE == 0)
+        {
+            _batch->finish();
+            _batch->start();
+        }
+        const Vector4& s = _sprites[i];
+        _batch->draw(s.x, s.y, SPRITE_SIZE, SPRITE_SIZE, 0.0f, 1.0f, 1.0f, 0.0f, color);
+    }
+    _batch->finish();
+    double time = Platform::getAbsoluteTime() - start;
+    _drawTime = _frameCount > 0 ? _drawTime * 0.95 + time * 0.05 : time;
+    ++_frameCount;
+
+    _font->start();
+    drawFrameRate(_font, Vector4(0, 0.5f, 1, 1), 5, 1, getFrameRate());
+    char text[128];
+    sprintf(text, "%u sprites, streaming %s", (unsigned int)_sprites.size(), streaming ? "on" : "off");
+    _font->drawText(text, 5, 5 + _font->getSize(), Vector4::one(), _font->getSize());
+    sprintf(text, "Draw calls: %u", RenderQueue::getFrameStats().drawCalls);
+    _font->drawText(text, 5, 5 + 2 * _font->getSize(), Vector4::one(), _font->getSize());
+    sprintf(text, "Draw: %.3f ms", _drawTime);
+    _font->drawText(text, 5, 5 + 3 * _font->getSize(), Vector4::one(), _font->getSize());
+    _font->finish();
+}
+
+void SpriteBatchBenchmark::touchEvent(Touch::TouchEvent evt, int x, int y, unsigned int contactIndex)
+{
+    if (evt == Touch::TOUCH_PRESS)
+    {
+        if (x < (int)getWidth() / 2)
+        {
+            _countIndex = (_countIndex + 1) % SPRITE_COUNT_COUNT;
+            setSpriteCount(__spriteCounts[_countIndex]);
+        }
+        else
+        {
+            _batch->setStreaming(!_batch->isStreaming());
+            _frameCount = 0;
+        }
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef SPRITEBATCHBENCHMARK_H_
+#define SPRITEBATCHBENCHMARK_H_
+
+#include "gameplay.h"
+#include "Test.h"
+
+using namespace gameplay;
+
+/**
+ * Benchmark of drawing large numbers of moving sprites each frame with a sprite batch.
+ *
+ * The sprites are streamed to buffers on the graphics device by default. When streaming
+ * is turned off, the batch is drawn from client memory and flushed every 10000 sprites,
+ * since it is limited to 16-bit indices. The time spent adding the sprites to the batch
+ * and finishing it is shown along with the draw calls of the previous frame. Touch the
+ * left half of the screen to change the number of sprites and the right half to turn
+ * streaming on or off.
+ */
+class SpriteBatchBenchmark : public Test
+{
+public:
+
+    SpriteBatchBenchmark();
+
+    void touchEvent(Touch::TouchEvent evt, int x, int y, unsigned int contactIndex);
+
+protected:
+
+    void initialize();
+
+    void finalize();
+
+    void update(float elapsedTime);
+
+    void render(float elapsedTime);
+
+private:
+
+    void setSpriteCount(unsigned int count);
+
+    Font* _font;
+    SpriteBatch* _batch;
+    std::vector<Vector4> _sprites;
+    unsigned int _countIndex;
+    double _drawTime;
+    unsigned int _frameCount;
+};
+
+#endif
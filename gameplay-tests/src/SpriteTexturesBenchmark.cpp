@@ -0,0 +1,150 @@
+#include "SpriteTexturesBenchmark.h"
+#include "TestsGame.h"
+
+#if defined(ADD_TEST)
+    ADD_TEST("Benchmark", "Sprite Textures", SpriteTexturesBenchmark, 13);
+#endif
+
+#define SPRITE_COUNT 5000
+#define SPRITE_SIZE 24.0f
+
+static const char* __texturePaths[SPRITE_TEXTURES_BENCHMARK_TEXTURE_COUNT] =
+{
+    "res/common/duck-diffuse.png",
+    "res/common/atlas.png",
+    "res/common/box-diffuse.png",
+    "res/common/theme.png",
+    "res/common/color-wheel.png"
+};
+
+static const char* __modeNames[] = { "a batch per texture", "a batch of several textures", "a batch of a texture atlas" };
+
+SpriteTexturesBenchmark::SpriteTexturesBenchmark()
+    : _font(NULL), _multiTextureBatch(NULL), _atlasBatch(NULL), _atlas(NULL), _mode(TEXTURE_BATCHES), _drawTime(0.0), _frameCount(0)
+{
+    for (unsigned int i = 0; i < SPRITE_TEXTURES_BENCHMARK_TEXTURE_COUNT; ++i)
+    {
+        _textureBatches[i] = NULL;
+    }
+}
+
+void SpriteTexturesBenchmark::initialize()
+{
+    _font = Font::create("res/common/arial18.gpb");
+
+    // The images are added from the largest to the smallest to pack them tightly.
+    _atlas = TextureAtlas::create(1024, 1024);
+    Texture* textures[SPRITE_TEXTURES_BENCHMARK_TEXTURE_COUNT];
+    for (unsigned int i = 0; i < SPRITE_TEXTURES_BENCHMARK_TEXTURE_COUNT; ++i)
+    {
+        textures[i] = Texture::create(__texturePaths[i]);
+        _textureBatches[i] = SpriteBatch::create(textures[i]);
+        _atlas->add(__texturePaths[i]);
+        _atlasRegions[i] = _atlas->getRegion(__texturePaths[i]);
+    }
+    _multiTextureBatch = SpriteBatch::create(textures, SPRITE_TEXTURES_BENCHMARK_TEXTURE_COUNT);
+    _atlasBatch = SpriteBatch::create(_atlas->getPageSampler(0)->getTexture());
+    for (unsigned int i = 0; i < SPRITE_TEXTURES_BENCHMARK_TEXTURE_COUNT; ++i)
+    {
+        SAFE_RELEASE(textures[i]);
+    }
+
+    _sprites.resize(SPRITE_COUNT);
+    for (unsigned int i = 0; i < SPRITE_COUNT; ++i)
+    {
+        Sprite& sprite = _sprites[i];
+        sprite.dst.set(MATH_RANDOM_0_1() * (getWidth() - SPRITE_SIZE), MATH_RANDOM_0_1() * (getHeight() - SPRITE_SIZE), SPRITE_SIZE, SPRITE_SIZE);
+        sprite.texture = rand() % SPRITE_TEXTURES_BENCHMARK_TEXTURE_COUNT;
+    }
+}
+
+void SpriteTexturesBenchmark::finalize()
+{
+    _sprites.clear();
+    for (unsigned int i = 0; i < SPRITE_TEXTURES_BENCHMARK_TEXTURE_COUNT; ++i)
+    {
+        SAFE_DELETE(_textureBatches[i]);
+    }
+    SAFE_DELETE(_multiTextureBatch);
+    SAFE_DELETE(_atlasBatch);
+    SAFE_RELEASE(_atlas);
+    SAFE_RELEASE(_font);
+}
+
+void SpriteTexturesBenchmark::update(float elapsedTime)
+{
+}
+
+void SpriteTexturesBenchmark::render(float elapsedTime)
+{
+    clear(CLEAR_COLOR_DEPTH, Vector4::zero(), 1.0f, 0);
+
+    double start = Platform::getAbsoluteTime();
+    switch (_mode)
+    {
+    case TEXTURE_BATCHES:
+        {
+            // Flush the batch of the previous texture whenever the texture changes.
+            SpriteBatch* batch = NULL;
+            for (size_t i = 0, count = _sprites.size(); i < count; ++i)
+            {
+                const Sprite& sprite = _sprites[i];
+                if (_textureBatches[sprite.texture] != batch)
+                {
+                    if (batch)
+                        batch->finish();
+                    batch = _textureBatches[sprite.texture];
+                    batch->start();
+                }
+                batch->draw(sprite.dst.x, sprite.dst.y, sprite.dst.width, sprite.dst.height, 0.0f, 1.0f, 1.0f, 0.0f, Vector4::one());
+            }
+            if (batch)
+                batch->finish();
+        }
+        break;
+    case MULTI_TEXTURE_BATCH:
+        _multiTextureBatch->start();
+        for (size_t i = 0, count = _sprites.size(); i < count; ++i)
+        {
+            const Sprite& sprite = _sprites[i];
+            _multiTextureBatch->setTextureIndex(sprite.texture);
+            _multiTextureBatch->draw(sprite.dst.x, sprite.dst.y, sprite.dst.width, sprite.dst.height, 0.0f, 1.0f, 1.0f, 0.0f, Vector4::one());
+        }
+        _multiTextureBatch->finish();
+        break;
+    case ATLAS_BATCH:
+        _atlasBatch->start();
+        for (size_t i = 0, count = _sprites.size(); i < count; ++i)
+        {
+            const Sprite& sprite = _sprites[i];
+            _atlasBatch->draw(sprite.dst, _atlasRegions[sprite.texture]);
+        }
+        _atlasBatch->finish();
+        break;
+    default:
+        break;
+    }
+    double time = Platform::getAbsoluteTime() - start;
+    _drawTime = _frameCount > 0 ? _drawTime * 0.95 + time * 0.05 : time;
+    ++_frameCount;
+
+    _font->start();
+    drawFrameRate(_font, Vector4(0, 0.5f, 1, 1), 5, 1, getFrameRate());
+    char text[128];
+    sprintf(text, "%u sprites of %u textures, %s", SPRITE_COUNT, SPRITE_TEXTURES_BENCHMARK_TEXTURE_COUNT, __modeNames[_mode]);
+    _font->drawText(text, 5, 5 + _font->getSize(), Vector4::one(), _font->getSize());
+    sprintf(text, "Draw calls: %u", RenderQueue::getFrameStats().drawCalls);
+    _font->drawText(text, 5, 5 + 2 * _font->getSize(), Vector4::one(), _font->getSize());
+    sprintf(text, "Draw: %.3f ms", _drawTime);
+    _font->drawText(text, 5, 5 + 3 * _font->getSize(), Vector4::one(), _font->getSize());
+    _font->finish();
+}
+
+void SpriteTexturesBenchmark::touchEvent(Touch::TouchEvent evt, int x, int y, unsigned int contactIndex)
+{
+    if (evt == Touch::TOUCH_PRESS)
+    {
+        _mode = (Mode)((_mode + 1) % MODE_COUNT);
+        _frameCount = 0;
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef SPRITETEXTURESBENCHMARK_H_
+#define SPRITETEXTURESBENCHMARK_H_
+
+#include "gameplay.h"
+#include "Test.h"
+
+using namespace gameplay;
+
+#define SPRITE_TEXTURES_BENCHMARK_TEXTURE_COUNT 5
+
+/**
+ * Benchmark of drawing sprites of several textures in an interleaved order, as the
+ * controls, fonts and icons of a user interface are drawn.
+ *
+ * The sprites are drawn with a sprite batch per texture, which is flushed whenever the
+ * texture changes, with one sprite batch of all the textures, selected per sprite, or
+ * with one sprite batch of a texture atlas that the images are packed into. The draw
+ * calls of the previous frame and the time spent drawing the sprites are shown. Touch
+ * the screen to change how the sprites are drawn.
+ */
+class SpriteTexturesBenchmark : public Test
+{
+public:
+
+    SpriteTexturesBenchmark();
+
+    void touchEvent(Touch::TouchEvent evt, int x, int y, unsigned int contactIndex);
+
+protected:
+
+    void initialize();
+
+    void finalize();
+
+    void update(float elapsedTime);
+
+    void render(float elapsedTime);
+
+private:
+
+    enum Mode
+    {
+        TEXTURE_BATCHES,
+        MULTI_TEXTURE_BATCH,
+        ATLAS_BATCH,
+        MODE_COUNT
+    };
+
+    struct Sprite
+    {
+        Rectangle dst;
+        unsigned int texture;
+    };
+
+    Font* _font;
+    SpriteBatch* _textureBatches[SPRITE_TEXTURES_BENCHMARK_TEXTURE_COUNT];
+    SpriteBatch* _multiTextureBatch;
+    SpriteBatch* _atlasBatch;
+    TextureAtlas* _atlas;
+    Rectangle _atlasRegions[SPRITE_TEXTURES_BENCHMARK_TEXTURE_COUNT];
+    std::vector<Sprite> _sprites;
+    Mode _mode;
+    double _drawTime;
+    unsigned int _frameCount;
+};
+
+#endif
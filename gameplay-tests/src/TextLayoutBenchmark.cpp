@@ -0,0 +1,91 @@
+#include "TextLayoutBenchmark.h"
+#include "TestsGame.h"
+
+#if defined(ADD_TEST)
+    ADD_TEST("Benchmark", "Text Layout", TextLayoutBenchmark, 14);
+#endif
+
+#define LABEL_COLUMNS 6
+#define LABEL_ROWS 12
+
+static const char* __words[] = { "quick", "brown", "fox", "jumps", "over", "the", "lazy", "dog", "menu", "options", "score", "level" };
+
+TextLayoutBenchmark::TextLayoutBenchmark()
+    : _font(NULL), _layoutCacheSize(0), _drawTime(0.0), _frameCount(0)
+{
+}
+
+void TextLayoutBenchmark::initialize()
+{
+    _font = Font::create("res/common/arial18.gpb");
+    _layoutCacheSize = _font->getLayoutCacheSize();
+
+    // Each label has a few words, enough to wrap within its area.
+    _labels.resize(LABEL_COLUMNS * LABEL_ROWS);
+    for (size_t i = 0, count = _labels.size(); i < count; ++i)
+    {
+        unsigned int words = 3 + (unsigned int)(i % 5);
+        for (unsigned int j = 0; j < words; ++j)
+        {
+            if (j > 0)
+                _labels[i] += ' ';
+            _labels[i] += __words[(i * 7 + j * 3) % (sizeof(__words) / sizeof(__words[0]))];
+        }
+    }
+}
+
+void TextLayoutBenchmark::finalize()
+{
+    // The font is shared with other tests, so restore its cache.
+    _font->setLayoutCacheSize(_layoutCacheSize);
+    _labels.clear();
+    SAFE_RELEASE(_font);
+}
+
+void TextLayoutBenchmark::update(float elapsedTime)
+{
+}
+
+void TextLayoutBenchmark::render(float elapsedTime)
+{
+    clear(CLEAR_COLOR_DEPTH, Vector4::zero(), 1.0f, 0);
+
+    unsigned int size = _font->getSize();
+    float top = 5.0f + 3 * size;
+    float width = (float)getWidth() / LABEL_COLUMNS;
+    float height = ((float)getHeight() - top) / LABEL_ROWS;
+    Font::Justify justify[] = { Font::ALIGN_TOP_LEFT, Font::ALIGN_VCENTER_HCENTER, Font::ALIGN_BOTTOM_RIGHT };
+    char counter[32];
+    sprintf(counter, "frame %u", _frameCount);
+
+    double start = Platform::getAbsoluteTime();
+    _font->start();
+    for (size_t i = 0, count = _labels.size(); i < count; ++i)
+    {
+        Rectangle area((i % LABEL_COLUMNS) * width, top + (i / LABEL_COLUMNS) * height, width - 4.0f, height - 4.0f);
+        const char* text = i == 0 ? counter : _labels[i].c_str();
+        _font->drawText(text, area, Vector4::one(), size, justify[i % 3], true, false, &area);
+    }
+    _font->finish();
+    double time = Platform::getAbsoluteTime() - start;
+    _drawTime = _frameCount > 0 ? _drawTime * 0.95 + time * 0.05 : time;
+    ++_frameCount;
+
+    _font->start();
+    drawFrameRate(_font, Vector4(0, 0.5f, 1, 1), 5, 1, getFrameRate());
+    char text[128];
+    sprintf(text, "%u labels, layout cache %s", (unsigned int)_labels.size(), _font->getLayoutCacheSize() > 0 ? "on" : "off");
+    _font->drawText(text, 5, 5 + size, Vector4::one(), size);
+    sprintf(text, "Draw: %.3f ms", _drawTime);
+    _font->drawText(text, 5, 5 + 2 * size, Vector4::one(), size);
+    _font->finish();
+}
+
+void TextLayoutBenchmark::touchEvent(Touch::TouchEvent evt, int x, int y, unsigned int contactIndex)
+{
+    if (evt == Touch::TOUCH_PRESS)
+    {
+        _font->setLayoutCacheSize(_font->getLayoutCacheSize() > 0 ? 0 : _layoutCacheSize);
+        _frameCount = 0;
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef TEXTLAYOUTBENCHMARK_H_
+#define TEXTLAYOUTBENCHMARK_H_
+
+#include "gameplay.h"
+#include "Test.h"
+
+using namespace gameplay;
+
+/**
+ * Benchmark of drawing many wrapped and aligned text labels each frame, as a form does.
+ *
+ * The labels are drawn within areas of the screen with Font::drawText, which keeps the
+ * layouts of the text it draws. One label changes every frame. The time spent drawing
+ * the labels is shown. Touch the screen to turn the layout cache of the font on or off.
+ */
+class TextLayoutBenchmark : public Test
+{
+public:
+
+    TextLayoutBenchmark();
+
+    void touchEvent(Touch::TouchEvent evt, int x, int y, unsigned int contactIndex);
+
+protected:
+
+    void initialize();
+
+    void finalize();
+
+    void update(float elapsedTime);
+
+    void render(float elapsedTime);
+
+private:
+
+    Font* _font;
+    unsigned int _layoutCacheSize;
+    std::vector<std::string> _labels;
+    double _drawTime;
+    unsigned int _frameCount;
+};
+
+#endif
@@ -14,11 +14,12 @@ std::string _fontNames[] =
     "squarehead",
     "baroque",
     "custom",
+    "arial-distance-field",
 };
 
 TextTest::TextTest()
     : _font(NULL), _fontIndex(0), _stateBlock(NULL), _viewport(250, 100, 512, 200), _alignment(Font::ALIGN_LEFT),  
-    _scale(1.0f), _wrap(true), _ignoreClip(false), _useViewport(true), _simple(false), _rightToLeft(false), _fontsCount(7), _form(NULL)
+    _scale(1.0f), _wrap(true), _ignoreClip(false), _useViewport(true), _simple(false), _rightToLeft(false), _fontsCount(8), _form(NULL)
 {
 }
 
@@ -53,6 +54,14 @@ void TextTest::initialize()
         _fonts.push_back(f);
     }
     _font = _fonts[0];
+
+    // The font of distance fields stays sharp at any scale, and draws an outline and a shadow.
+    Font* distanceField = _fonts[_fontsCount - 1];
+    if (distanceField && distanceField->getFormat() == Font::DISTANCE_FIELD)
+    {
+        distanceField->setOutline(Vector4(0.1f, 0.3f, 0.8f, 1.0f), 1.5f);
+        distanceField->setShadow(Vector4(0, 0, 0, 0.6f), Vector2(2, 2));
+    }
     
     _testString = std::string( "Lorem ipsum dolor sit amet, \n" \
                                 "consectetur adipisicing elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.\n" \
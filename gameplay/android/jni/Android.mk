@@ -34,6 +34,7 @@ LOCAL_SRC_FILES := \
     AudioSource.cpp \
     BoundingBox.cpp \
     BoundingSphere.cpp \
+    BoundsHierarchy.cpp \
     Bundle.cpp \
     Button.cpp \
     Camera.cpp \
@@ -68,7 +69,9 @@ LOCAL_SRC_FILES := \
     MeshPart.cpp \
     MeshSkin.cpp \
     Model.cpp \
+    ModelBatch.cpp \
     Node.cpp \
+    NodeIndex.cpp \
     ParticleEmitter.cpp \
     Pass.cpp \
     PhysicsCharacter.cpp \
@@ -86,6 +89,7 @@ LOCAL_SRC_FILES := \
     PhysicsVehicle.cpp \
     PhysicsVehicleWheel.cpp \
     Plane.cpp \
+    Profiler.cpp \
     PlatformAndroid.cpp \
     Properties.cpp \
     Quaternion.cpp \
@@ -93,8 +97,11 @@ LOCAL_SRC_FILES := \
     Ray.cpp \
     Rectangle.cpp \
     Ref.cpp \
+    RenderQueue.cpp \
     RenderState.cpp \
     RenderTarget.cpp \
+    ResourceCache.cpp \
+    ResourceLoader.cpp \
     Scene.cpp \
     SceneLoader.cpp \
     ScreenDisplayer.cpp \
@@ -105,9 +112,12 @@ LOCAL_SRC_FILES := \
     Technique.cpp \
     TextBox.cpp \
     Texture.cpp \
+    TextureAtlas.cpp \
     Theme.cpp \
     ThemeStyle.cpp \
+    ThreadPool.cpp \
     Transform.cpp \
+    TransformHierarchy.cpp \
     Vector2.cpp \
     Vector3.cpp \
     Vector4.cpp \
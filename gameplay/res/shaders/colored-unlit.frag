@@ -10,6 +10,10 @@ varying vec3 v_color;						// Input Vertex color ( r g b )
 varying vec2 v_texCoord;
 #endif
 
+#if defined(INSTANCED)
+varying vec4 v_instanceColor;					// Instance color
+#endif
+
 // Uniforms
 uniform vec4 u_diffuseColor;               	// Diffuse color
 #if defined(TEXTURE_LIGHTMAP)
@@ -35,6 +39,10 @@ void main()
 	vec4 lightColor = texture2D(u_lightmapTexture, v_texCoord);
 	gl_FragColor.rgb *= lightColor.rgb;
 	#endif
+    // Color the instance
+    #if defined(INSTANCED)
+    gl_FragColor *= v_instanceColor;
+    #endif
 	// Global color modulation
 	#if defined(MODULATE_COLOR)
 	gl_FragColor *= u_modulateColor;
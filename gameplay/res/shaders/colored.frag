@@ -22,6 +22,10 @@ varying vec3 v_lightDirection;					// Direction of light in tangent space
 varying vec3 v_cameraDirection;                 // Camera direction
 #endif
 
+#if defined(INSTANCED)
+varying vec4 v_instanceColor;					// Instance color
+#endif
+
 // Uniforms
 uniform vec4 u_diffuseColor;               		// Diffuse color
 uniform vec3 u_ambientColor;                    // Ambient color
@@ -61,6 +65,10 @@ void main()
     gl_FragColor.a = _baseColor.a;
     gl_FragColor.rgb = getLitPixel();
     
+    // Color the instance
+    #if defined(INSTANCED)
+    gl_FragColor *= v_instanceColor;
+    #endif
 	#if defined(MODULATE_COLOR)
     gl_FragColor.a *= u_modulateColor;
     #endif
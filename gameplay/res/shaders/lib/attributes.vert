@@ -1,25 +1,63 @@
+#if defined(INSTANCED)
+
+attribute vec4 a_instanceMatrix0;							// Instance world matrix, column 0
+attribute vec4 a_instanceMatrix1;							// Instance world matrix, column 1
+attribute vec4 a_instanceMatrix2;							// Instance world matrix, column 2
+attribute vec4 a_instanceMatrix3;							// Instance world matrix, column 3
+attribute vec4 a_instanceColor;								// Instance color							(r, g, b, a)
+varying vec4 v_instanceColor;								// Output instance color
+
+mat3 getInstanceRotation()
+{
+    return mat3(a_instanceMatrix0.xyz, a_instanceMatrix1.xyz, a_instanceMatrix2.xyz);
+}
+
+vec4 getPosition()
+{
+    // Instances are drawn with an identity model transform, so the instance matrix
+    // takes the vertex to world space. The instance color is passed on as well.
+    v_instanceColor = a_instanceColor;
+    return mat4(a_instanceMatrix0, a_instanceMatrix1, a_instanceMatrix2, a_instanceMatrix3) * a_position;
+}
+
+#else
+
 vec4 getPosition()
 {
     return a_position;    
 }
 
+#endif
+
 #if defined(LIGHTING)
 
 vec3 getNormal()
 {
+    #if defined(INSTANCED)
+    return getInstanceRotation() * a_normal;
+    #else
     return a_normal;
+    #endif
 }
 
 #if defined(BUMPED)
 
 vec3 getTangent()
 {
+    #if defined(INSTANCED)
+    return getInstanceRotation() * a_tangent;
+    #else
     return a_tangent;
+    #endif
 }
 
 vec3 getBinormal()
 {
+    #if defined(INSTANCED)
+    return getInstanceRotation() * a_binormal;
+    #else
     return a_binormal;
+    #endif
 }
 
 #endif
@@ -20,6 +20,10 @@ varying vec2 v_texCoord0;                	// Texture coordinate(u, v)
 varying vec2 v_texCoord1;                   // Second tex coord for multi-texturing
 #endif
 
+#if defined(INSTANCED)
+varying vec4 v_instanceColor;					// Instance color
+#endif
+
 // Fragment Program
 void main()
 {
@@ -33,6 +37,10 @@ void main()
     #endif
     gl_FragColor.rgb *= lightColor.rgb;
 	#endif
+    // Color the instance
+    #if defined(INSTANCED)
+    gl_FragColor *= v_instanceColor;
+    #endif
 	// Global color modulation
 	#if defined(MODULATE_COLOR)
 	gl_FragColor *= u_modulateColor;
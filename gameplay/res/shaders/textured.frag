@@ -21,6 +21,10 @@ varying vec3 v_lightDirection;					// Direction of light in tangent space.
 varying vec3 v_cameraDirection;                 // Camera direction
 #endif
 
+#if defined(INSTANCED)
+varying vec4 v_instanceColor;					// Instance color
+#endif
+
 // Uniforms
 uniform sampler2D u_diffuseTexture;             // Diffuse map texture
 uniform vec3 u_ambientColor;                    // Ambient color
@@ -57,6 +61,10 @@ void main()
     gl_FragColor.a = _baseColor.a;
     gl_FragColor.rgb = getLitPixel();
 	
+    // Color the instance
+    #if defined(INSTANCED)
+    gl_FragColor *= v_instanceColor;
+    #endif
 	// Global color modulation
 	#if defined(MODULATE_COLOR)
 	gl_FragColor *= u_modulateColor;
@@ -48,7 +48,7 @@ void AbsoluteLayout::update(const Container* container, const Vector2& offset)
         GP_ASSERT(control);
 
         align(control, container);
-        control->update(container, offset);
+        updateControl(control, container, offset);
     }
 }
 
@@ -13,7 +13,7 @@ AnimationClip::AnimationClip(const char* id, Animation* animation, unsigned long
     : _id(id), _animation(animation), _startTime(startTime), _endTime(endTime), _duration(_endTime - _startTime), 
       _stateBits(0x00), _repeatCount(1.0f), _activeDuration(_duration * _repeatCount), _speed(1.0f), _timeStarted(0), 
       _elapsedTime(0), _crossFadeToClip(NULL), _crossFadeOutElapsed(0), _crossFadeOutDuration(0), _blendWeight(1.0f), 
-      _beginListeners(NULL), _endListeners(NULL), _listeners(NULL), _listenerItr(NULL), _scriptListeners(NULL)
+      _percentComplete(0.0f), _beginListeners(NULL), _endListeners(NULL), _listeners(NULL), _listenerItr(NULL), _scriptListeners(NULL)
 {
     GP_ASSERT(_animation);
     GP_ASSERT(0 <= startTime && startTime <= _animation->_duration && 0 <= endTime && endTime <= _animation->_duration);
@@ -24,6 +24,7 @@ AnimationClip::AnimationClip(const char* id, Animation* animation, unsigned long
         GP_ASSERT(_animation->_channels[i]->getCurve());
         _values.push_back(new AnimationValue(_animation->_channels[i]->getCurve()->getComponentCount()));
     }
+    _curveCursors.resize(_values.size(), 0);
 }
 
 AnimationClip::~AnimationClip()
@@ -354,6 +355,21 @@ void AnimationClip::addListener(const char* function, unsigned long eventTime)
 
 bool AnimationClip::update(float elapsedTime)
 {
+    bool ended = false;
+    if (!advance(elapsedTime, &ended))
+        return ended;
+
+    evaluate(0, _values.size());
+    apply();
+
+    return finishUpdate();
+}
+
+bool AnimationClip::advance(float elapsedTime, bool* ended)
+{
+    GP_ASSERT(ended);
+    *ended = false;
+
     if (isClipStateBitSet(CLIP_IS_PAUSED_BIT))
     {
         return false;
@@ -363,7 +379,8 @@ bool AnimationClip::update(float elapsedTime)
         // after the last update call. Reset the flag, and return true so the AnimationClip is removed from the 
         // running clips on the AnimationController.
         onEnd();
-        return true;
+        *ended = true;
+        return false;
     }
     else if (!isClipStateBitSet(CLIP_IS_STARTED_BIT))
     {
@@ -445,7 +462,7 @@ bool AnimationClip::update(float elapsedTime)
     // Add back in start time, and divide by the total animation's duration to get the actual percentage complete
     GP_ASSERT(_animation);
     GP_ASSERT(_animation->_duration > 0);
-    float percentComplete = ((float)_startTime + currentTime) / (float)_animation->_duration;
+    _percentComplete = ((float)_startTime + currentTime) / (float)_animation->_duration;
     
     if (isClipStateBitSet(CLIP_IS_FADING_OUT_BIT))
     {
@@ -492,28 +509,49 @@ bool AnimationClip::update(float elapsedTime)
             SAFE_RELEASE(_crossFadeToClip);
         }
     }
-    
-    // Evaluate this clip.
-    Animation::Channel* channel = NULL;
-    AnimationValue* value = NULL;
-    AnimationTarget* target = NULL;
+
+    return true;
+}
+
+void AnimationClip::evaluate(size_t channelBegin, size_t channelEnd)
+{
+    GP_ASSERT(_animation);
+    GP_ASSERT(channelEnd <= _animation->_channels.size() && channelEnd <= _values.size());
+
+    for (size_t i = channelBegin; i < channelEnd; i++)
+    {
+        Animation::Channel* channel = _animation->_channels[i];
+        GP_ASSERT(channel);
+        AnimationValue* value = _values[i];
+        GP_ASSERT(value);
+
+        // Evaluate the point on Curve
+        GP_ASSERT(channel->getCurve());
+        channel->getCurve()->evaluate(_percentComplete, value->_value, &_curveCursors[i]);
+    }
+}
+
+void AnimationClip::apply()
+{
+    GP_ASSERT(_animation);
+
     size_t channelCount = _animation->_channels.size();
     for (size_t i = 0; i < channelCount; i++)
     {
-        channel = _animation->_channels[i];
+        Animation::Channel* channel = _animation->_channels[i];
         GP_ASSERT(channel);
-        target = channel->_target;
+        AnimationTarget* target = channel->_target;
         GP_ASSERT(target);
-        value = _values[i];
+        AnimationValue* value = _values[i];
         GP_ASSERT(value);
 
-        // Evaluate the point on Curve
-        GP_ASSERT(channel->getCurve());
-        channel->getCurve()->evaluate(percentComplete, value->_value);
         // Set the animation value on the target property.
         target->setAnimationPropertyValue(channel->_propertyId, value, _blendWeight);
     }
+}
 
+bool AnimationClip::finishUpdate()
+{
     // When ended. Probably should move to it's own method so we can call it when the clip is ended early.
     if (isClipStateBitSet(CLIP_IS_MARKED_FOR_REMOVAL_BIT) || !isClipStateBitSet(CLIP_IS_STARTED_BIT))
     {
@@ -348,9 +348,44 @@ private:
 
     /**
      * Updates the animation with the elapsed time.
+     *
+     * @return true if the clip has ended and should be removed from the AnimationController.
      */
     bool update(float elapsedTime);
 
+    /**
+     * Advances the clip's time, notifies its listeners and updates its blend weight.
+     * This is the first stage of update().
+     *
+     * @param elapsedTime The elapsed time.
+     * @param ended Set to true if the clip has ended without needing to be evaluated.
+     *
+     * @return true if the clip's channels must be evaluated and applied, false otherwise.
+     */
+    bool advance(float elapsedTime, bool* ended);
+
+    /**
+     * Evaluates the curves of a range of the clip's channels into the clip's animation values.
+     * This only writes to the clip's own values, so separate ranges and clips can be evaluated
+     * on separate threads.
+     *
+     * @param channelBegin The index of the first channel to evaluate.
+     * @param channelEnd The index after the last channel to evaluate.
+     */
+    void evaluate(size_t channelBegin, size_t channelEnd);
+
+    /**
+     * Sets the evaluated animation values on the clip's targets.
+     */
+    void apply();
+
+    /**
+     * Ends the clip if it has completed. This is the last stage of update().
+     *
+     * @return true if the clip has ended and should be removed from the AnimationController.
+     */
+    bool finishUpdate();
+
     /**
      * Handles when the AnimationClip begins.
      */
@@ -400,7 +435,9 @@ private:
     float _crossFadeOutElapsed;                         // The amount of time that has elapsed for the crossfade.
     unsigned long _crossFadeOutDuration;                // The duration of the cross fade.
     float _blendWeight;                                 // The clip's blendweight.
+    float _percentComplete;                             // The position of the clip in its animation, evaluated by the last update.
     std::vector<AnimationValue*> _values;               // AnimationValue holder.
+    std::vector<unsigned int> _curveCursors;            // The playback cursor of each channel's curve.
     std::vector<Listener*>* _beginListeners;            // Collection of begin listeners on the clip.
     std::vector<Listener*>* _endListeners;              // Collection of end listeners on the clip.
     std::list<ListenerEvent*>* _listeners;              // Ordered collection of listeners on the clip.
@@ -3,16 +3,21 @@
 #include "Game.h"
 #include "Curve.h"
 
+// The number of channels evaluated by a single job. Channels of small clips are grouped
+// together and channels of large clips are split up to balance the work between threads.
+#define ANIMATION_CHANNELS_PER_JOB 32
+
 namespace gameplay
 {
 
 AnimationController::AnimationController()
-    : _state(STOPPED)
+    : _state(STOPPED), _threadPool(NULL)
 {
 }
 
 AnimationController::~AnimationController()
 {
+    SAFE_DELETE(_threadPool);
 }
 
 void AnimationController::stopAllAnimations() 
@@ -27,6 +32,24 @@ void AnimationController::stopAllAnimations()
     }
 }
 
+unsigned int AnimationController::getThreadCount() const
+{
+    return _threadPool ? _threadPool->getThreadCount() : 1;
+}
+
+void AnimationController::setThreadCount(unsigned int threadCount)
+{
+    if (threadCount == 0)
+        threadCount = ThreadPool::getProcessorCount();
+
+    if (threadCount == getThreadCount())
+        return;
+
+    SAFE_DELETE(_threadPool);
+    if (threadCount > 1)
+        _threadPool = ThreadPool::create(threadCount);
+}
+
 AnimationController::State AnimationController::getState() const
 {
     return _state;
@@ -46,6 +69,10 @@ void AnimationController::finalize()
         SAFE_RELEASE(clip);
     }
     _runningClips.clear();
+    _evaluateRanges.clear();
+    _evaluateJobs.clear();
+    _evaluatedClips.clear();
+    SAFE_DELETE(_threadPool);
     _state = STOPPED;
 }
 
@@ -97,6 +124,12 @@ void AnimationController::update(float elapsedTime)
 {
     if (_state != RUNNING)
         return;
+
+    if (_threadPool)
+    {
+        updateParallel(elapsedTime);
+        return;
+    }
     
     Transform::suspendTransformChanged();
 
@@ -131,4 +164,104 @@ void AnimationController::update(float elapsedTime)
         _state = IDLE;
 }
 
+void AnimationController::updateParallel(float elapsedTime)
+{
+    GP_ASSERT(_threadPool);
+
+    Transform::suspendTransformChanged();
+
+    // Advance the running clips and gather the channels to evaluate. This notifies listeners,
+    // so it runs on the calling thread in the same order as a serial update.
+    _evaluateRanges.clear();
+    _evaluateJobs.clear();
+    _evaluatedClips.clear();
+    size_t jobChannelCount = 0;
+    std::list<AnimationClip*>::iterator clipIter = _runningClips.begin();
+    while (clipIter != _runningClips.end())
+    {
+        AnimationClip* clip = (*clipIter);
+        GP_ASSERT(clip);
+        bool ended = false;
+        if (clip->isClipStateBitSet(AnimationClip::CLIP_IS_RESTARTED_BIT))
+        {   // If the CLIP_IS_RESTARTED_BIT is set, we should end the clip and 
+            // move it from where it is in the running clips list to the back.
+            clip->onEnd();
+            clip->setClipStateBit(AnimationClip::CLIP_IS_PLAYING_BIT);
+            _runningClips.push_back(clip);
+            clipIter = _runningClips.erase(clipIter);
+        }
+        else if (clip->advance(elapsedTime, &ended))
+        {
+            size_t channelCount = clip->_values.size();
+            for (size_t i = 0; i < channelCount; )
+            {
+                if (jobChannelCount == 0)
+                    _evaluateJobs.push_back(_evaluateRanges.size());
+
+                EvaluateRange range;
+                range.clip = clip;
+                range.channelBegin = i;
+                range.channelEnd = std::min(i + ANIMATION_CHANNELS_PER_JOB - jobChannelCount, channelCount);
+                _evaluateRanges.push_back(range);
+
+                jobChannelCount += range.channelEnd - range.channelBegin;
+                if (jobChannelCount == ANIMATION_CHANNELS_PER_JOB)
+                    jobChannelCount = 0;
+                i = range.channelEnd;
+            }
+            _evaluatedClips.push_back(clipIter);
+            clipIter++;
+        }
+        else if (ended)
+        {
+            SAFE_RELEASE(clip);
+            clipIter = _runningClips.erase(clipIter);
+        }
+        else
+        {
+            clipIter++;
+        }
+    }
+
+    // Evaluate the channel curves in parallel. Each job only writes to its clips' animation values.
+    unsigned int jobCount = (unsigned int)_evaluateJobs.size();
+    _evaluateJobs.push_back(_evaluateRanges.size());
+    _threadPool->run(&AnimationController::evaluateJob, this, jobCount);
+
+    // Apply the evaluated values to the targets in running order, then end the completed clips.
+    size_t clipCount = _evaluatedClips.size();
+    for (size_t i = 0; i < clipCount; i++)
+    {
+        (*_evaluatedClips[i])->apply();
+    }
+    for (size_t i = 0; i < clipCount; i++)
+    {
+        AnimationClip* clip = *_evaluatedClips[i];
+        if (clip->finishUpdate())
+        {
+            SAFE_RELEASE(clip);
+            _runningClips.erase(_evaluatedClips[i]);
+        }
+    }
+    _evaluatedClips.clear();
+
+    Transform::resumeTransformChanged();
+
+    if (_runningClips.empty())
+        _state = IDLE;
+}
+
+void AnimationController::evaluateJob(void* controller, unsigned int index)
+{
+    AnimationController* animationController = static_cast<AnimationController*>(controller);
+    GP_ASSERT(index + 1 < animationController->_evaluateJobs.size());
+
+    size_t rangeEnd = animationController->_evaluateJobs[index + 1];
+    for (size_t i = animationController->_evaluateJobs[index]; i < rangeEnd; i++)
+    {
+        const EvaluateRange& range = animationController->_evaluateRanges[i];
+        range.clip->evaluate(range.channelBegin, range.channelEnd);
+    }
+}
+
 }
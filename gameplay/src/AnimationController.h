@@ -5,6 +5,7 @@
 #include "Animation.h"
 #include "AnimationTarget.h"
 #include "Properties.h"
+#include "ThreadPool.h"
 
 namespace gameplay
 {
@@ -25,9 +26,44 @@ public:
      * Stops all AnimationClips currently playing on the AnimationController.
      */
     void stopAllAnimations();
+
+    /**
+     * Gets the number of threads used to evaluate the running AnimationClips.
+     *
+     * @return The number of threads.
+     */
+    unsigned int getThreadCount() const;
+
+    /**
+     * Sets the number of threads used to evaluate the running AnimationClips.
+     *
+     * With more than one thread, each update first advances all running clips and notifies
+     * their listeners on the calling thread. The curves of the clips' channels are then
+     * evaluated in parallel on a pool of worker threads, and the results are applied to the
+     * animation targets on the calling thread in the order the clips are running, so the
+     * result does not depend on the number of threads. Clip end events are sent after all
+     * running clips have been applied.
+     *
+     * This can also be set with animation.threads in the game config.
+     *
+     * @param threadCount The number of threads, including the thread calling Game::frame().
+     *      The default of 1 evaluates all clips on the calling thread, and 0 uses one thread
+     *      per processor.
+     */
+    void setThreadCount(unsigned int threadCount);
        
 private:
 
+    /**
+     * A range of channels of a running AnimationClip to evaluate.
+     */
+    struct EvaluateRange
+    {
+        AnimationClip* clip;
+        size_t channelBegin;
+        size_t channelEnd;
+    };
+
     /**
      * The states that the AnimationController may be in.
      */
@@ -95,9 +131,23 @@ private:
      * Callback for when the controller receives a frame update event.
      */
     void update(float elapsedTime);
+
+    /**
+     * Updates the running clips, evaluating their channels on the thread pool.
+     */
+    void updateParallel(float elapsedTime);
+
+    /**
+     * Thread pool job function evaluating a group of channel ranges.
+     */
+    static void evaluateJob(void* controller, unsigned int index);
     
     State _state;                                 // The current state of the AnimationController.
     std::list<AnimationClip*> _runningClips;      // A list of running AnimationClips.
+    ThreadPool* _threadPool;                      // The thread pool evaluating clips, or NULL to evaluate them on the calling thread.
+    std::vector<EvaluateRange> _evaluateRanges;   // The channel ranges to evaluate in the current update.
+    std::vector<size_t> _evaluateJobs;            // The index of the first channel range of each job, followed by the range count.
+    std::vector<std::list<AnimationClip*>::iterator> _evaluatedClips; // The running clips evaluated in the current update.
 };
 
 }
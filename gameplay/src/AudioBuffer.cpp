@@ -1,13 +1,11 @@
 #include "Base.h"
 #include "AudioBuffer.h"
 #include "FileSystem.h"
+#include "ResourceCache.h"
 
 namespace gameplay
 {
 
-// Audio buffer cache
-static std::vector<AudioBuffer*> __buffers;
-
 AudioBuffer::AudioBuffer(const char* path, ALuint buffer)
     : _filePath(path), _alBuffer(buffer)
 {
@@ -16,15 +14,7 @@ AudioBuffer::AudioBuffer(const char* path, ALuint buffer)
 AudioBuffer::~AudioBuffer()
 {
     // Remove the buffer from the cache.
-    unsigned int bufferCount = (unsigned int)__buffers.size();
-    for (unsigned int i = 0; i < bufferCount; i++)
-    {
-        if (this == __buffers[i])
-        {
-            __buffers.erase(__buffers.begin() + i);
-            break;
-        }
-    }
+    ResourceCache::remove(this);
 
     if (_alBuffer)
     {
@@ -38,19 +28,57 @@ AudioBuffer* AudioBuffer::create(const char* path)
     GP_ASSERT(path);
 
     // Search the cache for a stream from this file.
-    unsigned int bufferCount = (unsigned int)__buffers.size();
-    AudioBuffer* buffer = NULL;
-    for (unsigned int i = 0; i < bufferCount; i++)
+    AudioBuffer* buffer = findCached(path);
+    if (buffer)
+        return buffer;
+
+    ALuint alBuffer = loadBuffer(path);
+    if (alBuffer == 0)
+        return NULL;
+
+    return create(path, alBuffer);
+}
+
+AudioBuffer* AudioBuffer::create(const char* path, ALuint alBuffer)
+{
+    GP_ASSERT(path);
+    GP_ASSERT(alBuffer);
+
+    // Another load of the same file may have finished first.
+    AudioBuffer* buffer = findCached(path);
+    if (buffer)
     {
-        buffer = __buffers[i];
-        GP_ASSERT(buffer);
-        if (buffer->_filePath.compare(path) == 0)
-        {
-            buffer->addRef();
-            return buffer;
-        }
+        AL_CHECK( alDeleteBuffers(1, &alBuffer) );
+        return buffer;
+    }
+
+    buffer = new AudioBuffer(path, alBuffer);
+
+    // Add the buffer to the cache.
+    ALint size = 0;
+    AL_CHECK( alGetBufferi(alBuffer, AL_SIZE, &size) );
+    ResourceCache::add(ResourceCache::AUDIO_BUFFER, ResourceCache::getPathKey(path), buffer, size > 0 ? (size_t)size : 0);
+
+    return buffer;
+}
+
+AudioBuffer* AudioBuffer::findCached(const char* path)
+{
+    GP_ASSERT(path);
+
+    AudioBuffer* buffer = static_cast<AudioBuffer*>(ResourceCache::find(ResourceCache::AUDIO_BUFFER, ResourceCache::getPathKey(path)));
+    if (buffer)
+    {
+        buffer->addRef();
     }
 
+    return buffer;
+}
+
+ALuint AudioBuffer::loadBuffer(const char* path)
+{
+    GP_ASSERT(path);
+
     ALuint alBuffer;
 
     // Load audio data into a buffer.
@@ -59,7 +87,7 @@ AudioBuffer* AudioBuffer::create(const char* path)
     {
         GP_ERROR("Failed to create OpenAL buffer; alGenBuffers error: %d", AL_LAST_ERROR());
         AL_CHECK( alDeleteBuffers(1, &alBuffer) );
-        return NULL;
+        return 0;
     }
     
     // Load sound file.
@@ -105,12 +133,7 @@ AudioBuffer* AudioBuffer::create(const char* path)
     if (file)    
         fclose(file);
 
-    buffer = new AudioBuffer(path, alBuffer);
-
-    // Add the buffer to the cache.
-    __buffers.push_back(buffer);
-
-    return buffer;
+    return alBuffer;
     
 cleanup:
     
@@ -118,7 +141,7 @@ cleanup:
         fclose(file);
     if (alBuffer)
         AL_CHECK( alDeleteBuffers(1, &alBuffer) );
-    return NULL;
+    return 0;
 }
 
 bool AudioBuffer::loadWav(FILE* file, ALuint buffer)
@@ -16,6 +16,7 @@ class AudioSource;
 class AudioBuffer : public Ref
 {
     friend class AudioSource;
+    friend class ResourceLoader;
 
 private:
     
@@ -42,6 +43,38 @@ private:
      * @return The buffer from a file.
      */
     static AudioBuffer* create(const char* path);
+
+    /**
+     * Creates an audio buffer for a file from an OpenAL buffer already holding its data,
+     * or returns the cached buffer for the file if there is one.
+     *
+     * @param path The path to the audio buffer on the filesystem.
+     * @param alBuffer The OpenAL buffer, which is owned by the returned audio buffer
+     *      or deleted if the file was already cached.
+     *
+     * @return The buffer for the file.
+     */
+    static AudioBuffer* create(const char* path, ALuint alBuffer);
+
+    /**
+     * Gets the cached audio buffer for a file and increments its reference count.
+     *
+     * @param path The path to the audio buffer on the filesystem.
+     *
+     * @return The cached buffer, or NULL if the file is not cached.
+     */
+    static AudioBuffer* findCached(const char* path);
+
+    /**
+     * Creates an OpenAL buffer and loads the audio data of a file into it.
+     *
+     * This does not use the cache and may be called from any thread.
+     *
+     * @param path The path to the audio file on the filesystem.
+     *
+     * @return The OpenAL buffer, or 0 if the file could not be loaded.
+     */
+    static ALuint loadBuffer(const char* path);
     
     static bool loadWav(FILE* file, ALuint buffer);
     
@@ -193,6 +193,9 @@ using std::va_list;
     extern PFNGLDELETEVERTEXARRAYSOESPROC glDeleteVertexArrays;
     extern PFNGLGENVERTEXARRAYSOESPROC glGenVertexArrays;
     extern PFNGLISVERTEXARRAYOESPROC glIsVertexArray;
+    extern PFNGLDRAWARRAYSINSTANCEDEXTPROC glDrawArraysInstanced;
+    extern PFNGLDRAWELEMENTSINSTANCEDEXTPROC glDrawElementsInstanced;
+    extern PFNGLVERTEXATTRIBDIVISOREXTPROC glVertexAttribDivisor;
     #define GL_DEPTH24_STENCIL8 GL_DEPTH24_STENCIL8_OES
     #define glClearDepth glClearDepthf
     #define OPENGL_ES
@@ -208,6 +211,9 @@ using std::va_list;
     extern PFNGLDELETEVERTEXARRAYSOESPROC glDeleteVertexArrays;
     extern PFNGLGENVERTEXARRAYSOESPROC glGenVertexArrays;
     extern PFNGLISVERTEXARRAYOESPROC glIsVertexArray;
+    extern PFNGLDRAWARRAYSINSTANCEDEXTPROC glDrawArraysInstanced;
+    extern PFNGLDRAWELEMENTSINSTANCEDEXTPROC glDrawElementsInstanced;
+    extern PFNGLVERTEXATTRIBDIVISOREXTPROC glVertexAttribDivisor;
     #define GL_DEPTH24_STENCIL8 GL_DEPTH24_STENCIL8_OES
     #define glClearDepth glClearDepthf
     #define OPENGL_ES
@@ -216,10 +222,58 @@ using std::va_list;
     #define GLEW_STATIC
     #include <GL/glew.h>
     #define USE_VAO
+    #define USE_MAP_BUFFER_RANGE
 #elif __linux__
         #define GLEW_STATIC
         #include <GL/glew.h>
         #define USE_VAO
+        #define USE_MAP_BUFFER_RANGE
+        // The OpenGL 1.1 functions are called through pointers, as GLEW calls the later ones,
+        // so that the platform can replace every function when it runs without a GL context.
+        extern void (GLAPIENTRY *__gpBindTexture)(GLenum target, GLuint texture);
+        extern void (GLAPIENTRY *__gpBlendFunc)(GLenum sfactor, GLenum dfactor);
+        extern void (GLAPIENTRY *__gpClear)(GLbitfield mask);
+        extern void (GLAPIENTRY *__gpClearColor)(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha);
+        extern void (GLAPIENTRY *__gpClearDepth)(GLclampd depth);
+        extern void (GLAPIENTRY *__gpClearStencil)(GLint s);
+        extern void (GLAPIENTRY *__gpDeleteTextures)(GLsizei n, const GLuint* textures);
+        extern void (GLAPIENTRY *__gpDepthMask)(GLboolean flag);
+        extern void (GLAPIENTRY *__gpDisable)(GLenum cap);
+        extern void (GLAPIENTRY *__gpDrawArrays)(GLenum mode, GLint first, GLsizei count);
+        extern void (GLAPIENTRY *__gpDrawElements)(GLenum mode, GLsizei count, GLenum type, const GLvoid* indices);
+        extern void (GLAPIENTRY *__gpEnable)(GLenum cap);
+        extern void (GLAPIENTRY *__gpGenTextures)(GLsizei n, GLuint* textures);
+        extern GLenum (GLAPIENTRY *__gpGetError)(void);
+        extern void (GLAPIENTRY *__gpGetIntegerv)(GLenum pname, GLint* params);
+        extern const GLubyte* (GLAPIENTRY *__gpGetString)(GLenum name);
+        extern void (GLAPIENTRY *__gpPixelStorei)(GLenum pname, GLint param);
+        extern void (GLAPIENTRY *__gpScissor)(GLint x, GLint y, GLsizei width, GLsizei height);
+        extern void (GLAPIENTRY *__gpTexImage2D)(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const GLvoid* pixels);
+        extern void (GLAPIENTRY *__gpTexParameteri)(GLenum target, GLenum pname, GLint param);
+        extern void (GLAPIENTRY *__gpTexSubImage2D)(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const GLvoid* pixels);
+        extern void (GLAPIENTRY *__gpViewport)(GLint x, GLint y, GLsizei width, GLsizei height);
+        #define glBindTexture __gpBindTexture
+        #define glBlendFunc __gpBlendFunc
+        #define glClear __gpClear
+        #define glClearColor __gpClearColor
+        #define glClearDepth __gpClearDepth
+        #define glClearStencil __gpClearStencil
+        #define glDeleteTextures __gpDeleteTextures
+        #define glDepthMask __gpDepthMask
+        #define glDisable __gpDisable
+        #define glDrawArrays __gpDrawArrays
+        #define glDrawElements __gpDrawElements
+        #define glEnable __gpEnable
+        #define glGenTextures __gpGenTextures
+        #define glGetError __gpGetError
+        #define glGetIntegerv __gpGetIntegerv
+        #define glGetString __gpGetString
+        #define glPixelStorei __gpPixelStorei
+        #define glScissor __gpScissor
+        #define glTexImage2D __gpTexImage2D
+        #define glTexParameteri __gpTexParameteri
+        #define glTexSubImage2D __gpTexSubImage2D
+        #define glViewport __gpViewport
 #elif __APPLE__
     #include "TargetConditionals.h"
     #if TARGET_OS_IPHONE || TARGET_IPHONE_SIMULATOR
@@ -229,6 +283,9 @@ using std::va_list;
         #define glDeleteVertexArrays glDeleteVertexArraysOES
         #define glGenVertexArrays glGenVertexArraysOES
         #define glIsVertexArray glIsVertexArrayOES
+        #define glDrawArraysInstanced glDrawArraysInstancedEXT
+        #define glDrawElementsInstanced glDrawElementsInstancedEXT
+        #define glVertexAttribDivisor glVertexAttribDivisorEXT
         #define GL_DEPTH24_STENCIL8 GL_DEPTH24_STENCIL8_OES
         #define glClearDepth glClearDepthf
         #define OPENGL_ES
@@ -243,12 +300,22 @@ using std::va_list;
         #define glDeleteVertexArrays glDeleteVertexArraysAPPLE
         #define glGenVertexArrays glGenVertexArraysAPPLE
         #define glIsVertexArray glIsVertexArrayAPPLE
+        #define glDrawArraysInstanced glDrawArraysInstancedARB
+        #define glDrawElementsInstanced glDrawElementsInstancedARB
+        #define glVertexAttribDivisor glVertexAttribDivisorARB
         #define USE_VAO
     #else
         #error "Unsupported Apple Device"
     #endif
 #endif
 
+// SIMD (SSE) for x86 and x64 targets that do not use NEON.
+#if !defined(USE_NEON) && !defined(GP_NO_SSE)
+    #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #define USE_SSE
+    #endif
+#endif
+
 // Graphics (GLSL)
 #define VERTEX_ATTRIBUTE_POSITION_NAME              "a_position"
 #define VERTEX_ATTRIBUTE_NORMAL_NAME                "a_normal"
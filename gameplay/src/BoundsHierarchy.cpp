@@ -0,0 +1,468 @@
+#include "Base.h"
+#include "BoundsHierarchy.h"
+#include "Node.h"
+#include "Scene.h"
+
+// The margin the box of a leaf is enlarged by, as a fraction of the radius of its bounds.
+#define BOUNDS_MARGIN 0.25f
+
+namespace gameplay
+{
+
+/**
+ * Returns the surface area of a box, the cost of visiting it in a query.
+ */
+static float surfaceArea(const BoundingBox& box)
+{
+    float x = box.max.x - box.min.x;
+    float y = box.max.y - box.min.y;
+    float z = box.max.z - box.min.z;
+    return 2.0f * (x * y + y * z + z * x);
+}
+
+/**
+ * Sets a box to contain two boxes.
+ */
+static void merge(const BoundingBox& box1, const BoundingBox& box2, BoundingBox* dst)
+{
+    dst->set(box1);
+    dst->merge(box2);
+}
+
+/**
+ * Sets a box to contain a sphere, scaled about its center.
+ */
+static void getBox(const BoundingSphere& sphere, float scale, BoundingBox* dst)
+{
+    float extent = sphere.radius * scale;
+    dst->set(sphere.center.x - extent, sphere.center.y - extent, sphere.center.z - extent,
+             sphere.center.x + extent, sphere.center.y + extent, sphere.center.z + extent);
+}
+
+/**
+ * Determines if a box contains another box.
+ */
+static bool contains(const BoundingBox& box, const BoundingBox& inner)
+{
+    return box.min.x <= inner.min.x && box.min.y <= inner.min.y && box.min.z <= inner.min.z &&
+           box.max.x >= inner.max.x && box.max.y >= inner.max.y && box.max.z >= inner.max.z;
+}
+
+BoundsHierarchy::BoundsHierarchy(Scene* scene)
+    : _scene(scene), _root(-1), _freeList(-1)
+{
+    GP_ASSERT(scene);
+
+    for (Node* node = scene->getFirstNode(); node != NULL; node = node->getNextSibling())
+    {
+        insert(node);
+    }
+}
+
+BoundsHierarchy::~BoundsHierarchy()
+{
+    for (size_t i = 0, count = _entries.size(); i < count; ++i)
+    {
+        Node* node = _entries[i].node;
+        if (node)
+        {
+            node->_boundsHierarchy = NULL;
+            node->_boundsProxy = -1;
+        }
+    }
+}
+
+void BoundsHierarchy::insert(Node* node)
+{
+    GP_ASSERT(node);
+
+    if (node->getModel())
+    {
+        addProxy(node);
+    }
+    for (Node* child = node->getFirstChild(); child != NULL; child = child->getNextSibling())
+    {
+        insert(child);
+    }
+}
+
+void BoundsHierarchy::remove(Node* node)
+{
+    GP_ASSERT(node);
+
+    removeProxy(node);
+    for (Node* child = node->getFirstChild(); child != NULL; child = child->getNextSibling())
+    {
+        remove(child);
+    }
+}
+
+void BoundsHierarchy::modelChanged(Node* node)
+{
+    GP_ASSERT(node);
+
+    if (!node->getModel())
+    {
+        removeProxy(node);
+    }
+    else if (node->_boundsHierarchy)
+    {
+        setDirty(node);
+    }
+    else
+    {
+        addProxy(node);
+    }
+}
+
+void BoundsHierarchy::setDirty(Node* node)
+{
+    GP_ASSERT(node && node->_boundsHierarchy == this);
+
+    Entry& entry = _entries[node->_boundsProxy];
+    if (!entry.dirty)
+    {
+        entry.dirty = true;
+        _dirtyLeaves.push_back(node->_boundsProxy);
+    }
+}
+
+void BoundsHierarchy::update()
+{
+    for (size_t i = 0, count = _dirtyLeaves.size(); i < count; ++i)
+    {
+        int leaf = _dirtyLeaves[i];
+
+        // Leaves removed since they were marked, or marked twice, are skipped.
+        Entry& entry = _entries[leaf];
+        if (!entry.dirty || !entry.node)
+            continue;
+        entry.dirty = false;
+
+        // A node that stays within the enlarged box of its leaf only updates its bounds.
+        computeBounds(leaf);
+        BoundingBox box;
+        getBox(entry.bounds, 1.0f, &box);
+        if (isInserted(leaf))
+        {
+            if (contains(entry.box, box))
+                continue;
+            removeLeaf(leaf);
+        }
+        getBox(entry.bounds, 1.0f + BOUNDS_MARGIN, &entry.box);
+        insertLeaf(leaf);
+    }
+    _dirtyLeaves.clear();
+}
+
+unsigned int BoundsHierarchy::find(const Ray& ray, std::vector<Node*>& nodes)
+{
+    update();
+
+    if (_root < 0)
+        return 0;
+
+    std::vector<std::pair<float, Node*> > hits;
+    _stack.push_back(_root);
+    while (!_stack.empty())
+    {
+        const Entry& entry = _entries[_stack.back()];
+        _stack.pop_back();
+        if (entry.node)
+        {
+            // Spheres behind the origin of the ray give negative distances.
+            float distance = ray.intersects(entry.bounds);
+            if (distance >= 0.0f)
+            {
+                hits.push_back(std::make_pair(distance, entry.node));
+            }
+        }
+        else if (ray.intersects(entry.box) != Ray::INTERSECTS_NONE)
+        {
+            _stack.push_back(entry.child1);
+            _stack.push_back(entry.child2);
+        }
+    }
+
+    std::sort(hits.begin(), hits.end());
+    for (size_t i = 0, count = hits.size(); i < count; ++i)
+    {
+        nodes.push_back(hits[i].second);
+    }
+    return (unsigned int)hits.size();
+}
+
+void BoundsHierarchy::addProxy(Node* node)
+{
+    GP_ASSERT(node);
+
+    if (node->_boundsHierarchy)
+        return;
+
+    // The leaf is inserted with its bounds by the next update, so that nodes
+    // added to the scene do not compute their world matrices right away.
+    int leaf = allocate();
+    _entries[leaf].node = node;
+    _entries[leaf].dirty = true;
+    _dirtyLeaves.push_back(leaf);
+    node->_boundsHierarchy = this;
+    node->_boundsProxy = leaf;
+}
+
+void BoundsHierarchy::removeProxy(Node* node)
+{
+    GP_ASSERT(node);
+
+    if (node->_boundsHierarchy != this)
+        return;
+
+    int leaf = node->_boundsProxy;
+    if (isInserted(leaf))
+    {
+        removeLeaf(leaf);
+    }
+    deallocate(leaf);
+    node->_boundsHierarchy = NULL;
+    node->_boundsProxy = -1;
+}
+
+int BoundsHierarchy::allocate()
+{
+    int index;
+    if (_freeList < 0)
+    {
+        index = (int)_entries.size();
+        _entries.push_back(Entry());
+    }
+    else
+    {
+        index = _freeList;
+        _freeList = _entries[index].parent;
+    }
+
+    Entry& entry = _entries[index];
+    entry.node = NULL;
+    entry.parent = -1;
+    entry.child1 = -1;
+    entry.child2 = -1;
+    entry.height = 0;
+    entry.dirty = false;
+    return index;
+}
+
+void BoundsHierarchy::deallocate(int index)
+{
+    Entry& entry = _entries[index];
+    entry.node = NULL;
+    entry.parent = _freeList;
+    entry.height = -1;
+    entry.dirty = false;
+    _freeList = index;
+}
+
+void BoundsHierarchy::computeBounds(int leaf)
+{
+    Entry& entry = _entries[leaf];
+    GP_ASSERT(entry.node);
+
+    if (!entry.node->computeModelBounds(&entry.bounds))
+    {
+        // A model without a mesh occupies no space.
+        entry.node->getWorldMatrix().getTranslation(&entry.bounds.center);
+        entry.bounds.radius = 0;
+    }
+}
+
+bool BoundsHierarchy::isInserted(int leaf) const
+{
+    return leaf == _root || _entries[leaf].parent >= 0;
+}
+
+void BoundsHierarchy::insertLeaf(int leaf)
+{
+    if (_root < 0)
+    {
+        _root = leaf;
+        _entries[leaf].parent = -1;
+        return;
+    }
+
+    // Descend to the sibling for the leaf that adds the least surface area to the tree,
+    // counting the growth of the boxes of the branches above it.
+    const BoundingBox leafBox = _entries[leaf].box;
+    BoundingBox combined;
+    int index = _root;
+    while (!_entries[index].node)
+    {
+        const Entry& entry = _entries[index];
+        float area = surfaceArea(entry.box);
+        merge(entry.box, leafBox, &combined);
+        float combinedArea = surfaceArea(combined);
+
+        // The cost of making the leaf a sibling of this branch, and the minimum
+        // cost of pushing it further down.
+        float cost = 2.0f * combinedArea;
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        float childCost[2];
+        int children[2] = { entry.child1, entry.child2 };
+        for (int i = 0; i < 2; ++i)
+        {
+            const Entry& child = _entries[children[i]];
+            merge(child.box, leafBox, &combined);
+            childCost[i] = surfaceArea(combined) + inheritanceCost;
+            if (!child.node)
+            {
+                childCost[i] -= surfaceArea(child.box);
+            }
+        }
+
+        if (cost < childCost[0] && cost < childCost[1])
+            break;
+        index = childCost[0] < childCost[1] ? children[0] : children[1];
+    }
+
+    // Replace the sibling with a new branch holding the sibling and the leaf.
+    int sibling = index;
+    int parent = allocate();
+    Entry& branch = _entries[parent];
+    Entry& siblingEntry = _entries[sibling];
+    int oldParent = siblingEntry.parent;
+    branch.parent = oldParent;
+    branch.child1 = sibling;
+    branch.child2 = leaf;
+    branch.height = siblingEntry.height + 1;
+    merge(siblingEntry.box, leafBox, &branch.box);
+    siblingEntry.parent = parent;
+    _entries[leaf].parent = parent;
+
+    if (oldParent >= 0)
+    {
+        Entry& oldParentEntry = _entries[oldParent];
+        if (oldParentEntry.child1 == sibling)
+            oldParentEntry.child1 = parent;
+        else
+            oldParentEntry.child2 = parent;
+    }
+    else
+    {
+        _root = parent;
+    }
+
+    refit(_entries[leaf].parent);
+}
+
+void BoundsHierarchy::removeLeaf(int leaf)
+{
+    if (leaf == _root)
+    {
+        _root = -1;
+        return;
+    }
+
+    int parent = _entries[leaf].parent;
+    int grandParent = _entries[parent].parent;
+    int sibling = _entries[parent].child1 == leaf ? _entries[parent].child2 : _entries[parent].child1;
+    _entries[leaf].parent = -1;
+
+    // Replace the parent with the sibling.
+    deallocate(parent);
+    _entries[sibling].parent = grandParent;
+    if (grandParent >= 0)
+    {
+        Entry& grandParentEntry = _entries[grandParent];
+        if (grandParentEntry.child1 == parent)
+            grandParentEntry.child1 = sibling;
+        else
+            grandParentEntry.child2 = sibling;
+        refit(grandParent);
+    }
+    else
+    {
+        _root = sibling;
+    }
+}
+
+void BoundsHierarchy::refit(int index)
+{
+    while (index >= 0)
+    {
+        index = balance(index);
+        updateBranch(index);
+        index = _entries[index].parent;
+    }
+}
+
+int BoundsHierarchy::balance(int index)
+{
+    Entry& a = _entries[index];
+    if (a.node || a.height < 2)
+        return index;
+
+    int indexB = a.child1;
+    int indexC = a.child2;
+    Entry& b = _entries[indexB];
+    Entry& c = _entries[indexC];
+    int heightDifference = c.height - b.height;
+    if (heightDifference > -2 && heightDifference < 2)
+        return index;
+
+    // Rotate the taller child up into the place of a, and a down into the place
+    // of the shorter grandchild below it.
+    int indexUp = heightDifference > 1 ? indexC : indexB;
+    Entry& up = _entries[indexUp];
+    Entry& other = heightDifference > 1 ? b : c;
+    int indexF = up.child1;
+    int indexG = up.child2;
+    Entry& f = _entries[indexF];
+    Entry& g = _entries[indexG];
+
+    up.child1 = index;
+    up.parent = a.parent;
+    a.parent = indexUp;
+    if (up.parent >= 0)
+    {
+        Entry& parent = _entries[up.parent];
+        if (parent.child1 == index)
+            parent.child1 = indexUp;
+        else
+            parent.child2 = indexUp;
+    }
+    else
+    {
+        _root = indexUp;
+    }
+
+    // The taller grandchild stays below the rotated child, and the shorter one moves below a.
+    int indexTaller = f.height > g.height ? indexF : indexG;
+    int indexShorter = f.height > g.height ? indexG : indexF;
+    Entry& taller = _entries[indexTaller];
+    Entry& shorter = _entries[indexShorter];
+    up.child2 = indexTaller;
+    if (heightDifference > 1)
+        a.child2 = indexShorter;
+    else
+        a.child1 = indexShorter;
+    shorter.parent = index;
+
+    merge(other.box, shorter.box, &a.box);
+    a.height = 1 + std::max(other.height, shorter.height);
+    merge(a.box, taller.box, &up.box);
+    up.height = 1 + std::max(a.height, taller.height);
+
+    return indexUp;
+}
+
+void BoundsHierarchy::updateBranch(int index)
+{
+    Entry& entry = _entries[index];
+    if (entry.node)
+        return;
+
+    const Entry& child1 = _entries[entry.child1];
+    const Entry& child2 = _entries[entry.child2];
+    entry.height = 1 + std::max(child1.height, child2.height);
+    merge(child1.box, child2.box, &entry.box);
+}
+
+}
@@ -0,0 +1,231 @@
+#ifndef BOUNDSHIERARCHY_H_
+#define BOUNDSHIERARCHY_H_
+
+#include "BoundingBox.h"
+#include "BoundingSphere.h"
+#include "Frustum.h"
+#include "Ray.h"
+
+namespace gameplay
+{
+
+class Node;
+class Scene;
+
+/**
+ * Defines a bounding volume hierarchy over the bounds of the models in a scene.
+ *
+ * Each node with a model is a leaf of a binary tree of axis-aligned boxes, where every box
+ * contains the boxes below it, so that spatial queries only descend into the branches that
+ * intersect the query volume.
+ *
+ * The hierarchy is maintained incrementally: nodes are inserted and removed as they join
+ * and leave the scene, and nodes whose transform or bounds change are marked dirty and
+ * updated before the next query. The box of a leaf is enlarged by a margin, so a node that
+ * moves within it only updates its bounds. Nodes that leave it are reinserted, and the tree
+ * is rebalanced with rotations as it changes.
+ */
+class BoundsHierarchy
+{
+    friend class Node;
+    friend class Scene;
+
+private:
+
+    /**
+     * An entry in the tree, either a leaf holding a node or a branch with two children.
+     */
+    struct Entry
+    {
+        /**
+         * The box containing the entry, enlarged by a margin for leaves.
+         */
+        BoundingBox box;
+
+        /**
+         * The world-space bounds of the model of the node of a leaf.
+         */
+        BoundingSphere bounds;
+
+        /**
+         * The node of a leaf, or NULL for branches.
+         */
+        Node* node;
+
+        /**
+         * The parent of the entry, or the next free entry when the entry is free.
+         */
+        int parent;
+
+        /**
+         * The children of a branch, or -1 for leaves.
+         */
+        int child1;
+        int child2;
+
+        /**
+         * The height of the subtree below the entry, zero for leaves and -1 for free entries.
+         */
+        int height;
+
+        /**
+         * Whether the bounds of a leaf must be updated, or the leaf inserted, before the next query.
+         */
+        bool dirty;
+    };
+
+    /**
+     * Constructor, inserting the nodes of a scene.
+     *
+     * @param scene The scene the hierarchy is built over.
+     */
+    BoundsHierarchy(Scene* scene);
+
+    /**
+     * Destructor.
+     */
+    ~BoundsHierarchy();
+
+    /**
+     * Hidden copy constructor.
+     */
+    BoundsHierarchy(const BoundsHierarchy& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    BoundsHierarchy& operator=(const BoundsHierarchy&);
+
+    /**
+     * Inserts a node and its descendants that have models.
+     */
+    void insert(Node* node);
+
+    /**
+     * Removes a node and its descendants.
+     */
+    void remove(Node* node);
+
+    /**
+     * Inserts or removes a node, without its descendants, after its model changed.
+     */
+    void modelChanged(Node* node);
+
+    /**
+     * Marks the bounds of a node dirty, to be updated before the next query.
+     */
+    void setDirty(Node* node);
+
+    /**
+     * Updates the bounds of the nodes marked dirty.
+     */
+    void update();
+
+    /**
+     * Finds the nodes whose bounds intersect a frustum, sphere or box, appending them to a vector.
+     */
+    template <class T>
+    unsigned int find(const T& volume, std::vector<Node*>& nodes);
+
+    /**
+     * Finds the nodes whose bounds a ray intersects, appending them to a vector nearest first.
+     */
+    unsigned int find(const Ray& ray, std::vector<Node*>& nodes);
+
+    /**
+     * Adds a leaf for a node, to be inserted into the tree by the next update.
+     */
+    void addProxy(Node* node);
+
+    /**
+     * Removes the leaf of a node.
+     */
+    void removeProxy(Node* node);
+
+    /**
+     * Allocates an entry, returning its index.
+     */
+    int allocate();
+
+    /**
+     * Returns an entry to the free list.
+     */
+    void deallocate(int index);
+
+    /**
+     * Computes the bounds of a leaf from the model of its node.
+     */
+    void computeBounds(int leaf);
+
+    /**
+     * Determines if a leaf has been inserted into the tree.
+     */
+    bool isInserted(int leaf) const;
+
+    /**
+     * Inserts a leaf into the tree, next to the entry whose box grows the least.
+     */
+    void insertLeaf(int leaf);
+
+    /**
+     * Removes a leaf from the tree, replacing its parent with its sibling.
+     */
+    void removeLeaf(int leaf);
+
+    /**
+     * Rebalances and refits the boxes of the entries from an entry up to the root.
+     */
+    void refit(int index);
+
+    /**
+     * Rotates the children of an entry whose subtrees are unbalanced, returning the entry now at its place.
+     */
+    int balance(int index);
+
+    /**
+     * Updates the height and box of a branch from its children.
+     */
+    void updateBranch(int index);
+
+    Scene* _scene;
+    std::vector<Entry> _entries;
+    int _root;
+    int _freeList;
+    std::vector<int> _dirtyLeaves;
+    std::vector<int> _stack;
+};
+
+template <class T>
+unsigned int BoundsHierarchy::find(const T& volume, std::vector<Node*>& nodes)
+{
+    update();
+
+    unsigned int count = 0;
+    if (_root < 0)
+        return count;
+
+    _stack.push_back(_root);
+    while (!_stack.empty())
+    {
+        const Entry& entry = _entries[_stack.back()];
+        _stack.pop_back();
+        if (entry.node)
+        {
+            if (entry.bounds.intersects(volume))
+            {
+                nodes.push_back(entry.node);
+                ++count;
+            }
+        }
+        else if (volume.intersects(entry.box))
+        {
+            _stack.push_back(entry.child1);
+            _stack.push_back(entry.child2);
+        }
+    }
+    return count;
+}
+
+}
+
+#endif
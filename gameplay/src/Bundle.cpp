@@ -4,9 +4,16 @@
 #include "MeshPart.h"
 #include "Scene.h"
 #include "Joint.h"
+#include "Profiler.h"
+#include "ResourceCache.h"
 
 #define BUNDLE_VERSION_MAJOR            1
-#define BUNDLE_VERSION_MINOR            2
+#define BUNDLE_VERSION_MINOR            4
+
+// Bundles from before models had levels of detail are still read.
+#define BUNDLE_VERSION_MINOR_MIN        2
+#define BUNDLE_VERSION_MINOR_LEVELS     3
+#define BUNDLE_VERSION_MINOR_FONT_FORMAT 4
 
 #define BUNDLE_TYPE_SCENE               1
 #define BUNDLE_TYPE_NODE                2
@@ -29,11 +36,14 @@
 namespace gameplay
 {
 
-static std::vector<Bundle*> __bundleCache;
+static bool __memoryMappingEnabled = true;
 
 Bundle::Bundle(const char* path) :
-    _path(path), _referenceCount(0), _references(NULL), _file(NULL), _trackedNodes(NULL)
+    _path(path), _referenceCount(0), _references(NULL), _file(NULL), _data(NULL), _dataSize(0), _position(0),
+    _trackedNodes(NULL)
 {
+    _version[0] = BUNDLE_VERSION_MAJOR;
+    _version[1] = BUNDLE_VERSION_MINOR;
 }
 
 Bundle::~Bundle()
@@ -41,11 +51,7 @@ Bundle::~Bundle()
     clearLoadSession();
 
     // Remove this Bundle from the cache.
-    std::vector<Bundle*>::iterator itr = std::find(__bundleCache.begin(), __bundleCache.end(), this);
-    if (itr != __bundleCache.end())
-    {
-        __bundleCache.erase(itr);
-    }
+    ResourceCache::remove(this);
 
     SAFE_DELETE_ARRAY(_references);
 
@@ -54,6 +60,12 @@ Bundle::~Bundle()
         fclose(_file);
         _file = NULL;
     }
+
+    if (_data)
+    {
+        FileSystem::unmapFile((const char*)_data, _dataSize);
+        _data = NULL;
+    }
 }
 
 template <class T>
@@ -61,7 +73,7 @@ bool Bundle::readArray(unsigned int* length, T** ptr)
 {
     GP_ASSERT(length);
     GP_ASSERT(ptr);
-    GP_ASSERT(_file);
+    GP_ASSERT(_file || _data);
 
     if (!read(length))
     {
@@ -71,7 +83,7 @@ bool Bundle::readArray(unsigned int* length, T** ptr)
     if (*length > 0)
     {
         *ptr = new T[*length];
-        if (fread(*ptr, sizeof(T), *length, _file) != *length)
+        if (readBytes(*ptr, sizeof(T), *length) != *length)
         {
             GP_ERROR("Failed to read an array of data from bundle (into an array).");
             SAFE_DELETE_ARRAY(*ptr);
@@ -85,7 +97,7 @@ template <class T>
 bool Bundle::readArray(unsigned int* length, std::vector<T>* values)
 {
     GP_ASSERT(length);
-    GP_ASSERT(_file);
+    GP_ASSERT(_file || _data);
 
     if (!read(length))
     {
@@ -95,7 +107,7 @@ bool Bundle::readArray(unsigned int* length, std::vector<T>* values)
     if (*length > 0 && values)
     {
         values->resize(*length);
-        if (fread(&(*values)[0], sizeof(T), *length, _file) != *length)
+        if (readBytes(&(*values)[0], sizeof(T), *length) != *length)
         {
             GP_ERROR("Failed to read an array of data from bundle (into a std::vector).");
             return false;
@@ -108,7 +120,7 @@ template <class T>
 bool Bundle::readArray(unsigned int* length, std::vector<T>* values, unsigned int readSize)
 {
     GP_ASSERT(length);
-    GP_ASSERT(_file);
+    GP_ASSERT(_file || _data);
     GP_ASSERT(sizeof(T) >= readSize);
 
     if (!read(length))
@@ -119,7 +131,7 @@ bool Bundle::readArray(unsigned int* length, std::vector<T>* values, unsigned in
     if (*length > 0 && values)
     {
         values->resize(*length);
-        if (fread(&(*values)[0], readSize, *length, _file) != *length)
+        if (readBytes(&(*values)[0], readSize, *length) != *length)
         {
             GP_ERROR("Failed to read an array of data from bundle (into a std::vector with a specified single element read size).");
             return false;
@@ -128,12 +140,10 @@ bool Bundle::readArray(unsigned int* length, std::vector<T>* values, unsigned in
     return true;
 }
 
-static std::string readString(FILE* fp)
+std::string Bundle::readString()
 {
-    GP_ASSERT(fp);
-
     unsigned int length;
-    if (fread(&length, 4, 1, fp) != 1)
+    if (!read(&length))
     {
         GP_ERROR("Failed to read the length of a string from a bundle.");
         return std::string();
@@ -145,11 +155,25 @@ static std::string readString(FILE* fp)
     std::string str;
     if (length > 0)
     {
-        str.resize(length);
-        if (fread(&str[0], 1, length, fp) != length)
+        if (_data)
         {
-            GP_ERROR("Failed to read string from bundle.");
-            return std::string();
+            // Construct the string straight from the mapped file.
+            const char* view = (const char*)readView(length);
+            if (view == NULL)
+            {
+                GP_ERROR("Failed to read string from bundle.");
+                return std::string();
+            }
+            str.assign(view, length);
+        }
+        else
+        {
+            str.resize(length);
+            if (readBytes(&str[0], 1, length) != length)
+            {
+                GP_ERROR("Failed to read string from bundle.");
+                return std::string();
+            }
         }
     }
     return str;
@@ -160,68 +184,90 @@ Bundle* Bundle::create(const char* path)
     GP_ASSERT(path);
 
     // Search the cache for this bundle.
-    for (size_t i = 0, count = __bundleCache.size(); i < count; ++i)
+    Bundle* bundle = findCached(path);
+    if (bundle)
+        return bundle;
+
+    bundle = open(path);
+    if (bundle)
+        bundle->addToCache();
+
+    return bundle;
+}
+
+Bundle* Bundle::findCached(const char* path)
+{
+    GP_ASSERT(path);
+
+    Bundle* bundle = static_cast<Bundle*>(ResourceCache::find(ResourceCache::BUNDLE, ResourceCache::getPathKey(path)));
+    if (bundle)
     {
-        Bundle* p = __bundleCache[i];
-        GP_ASSERT(p);
-        if (p->_path == path)
-        {
-            // Found a match
-            p->addRef();
-            return p;
-        }
+        // Found a match
+        bundle->addRef();
     }
 
-    // Open the bundle.
-    FILE* fp = FileSystem::openFile(path, "rb");
-    if (!fp)
+    return bundle;
+}
+
+void Bundle::addToCache()
+{
+    ResourceCache::add(ResourceCache::BUNDLE, ResourceCache::getPathKey(_path.c_str()), this, 0);
+}
+
+Bundle* Bundle::open(const char* path)
+{
+    GP_ASSERT(path);
+
+    // Open the bundle, preferring a memory mapping of the file.
+    // The mapping or the file is kept open for faster reading later.
+    Bundle* bundle = new Bundle(path);
+    if (__memoryMappingEnabled)
     {
-        GP_ERROR("Failed to open file '%s'.", path);
-        return NULL;
+        bundle->_data = (const unsigned char*)FileSystem::mapFile(path, &bundle->_dataSize);
+    }
+    if (bundle->_data == NULL)
+    {
+        bundle->_file = FileSystem::openFile(path, "rb");
+        if (!bundle->_file)
+        {
+            GP_ERROR("Failed to open file '%s'.", path);
+            SAFE_RELEASE(bundle);
+            return NULL;
+        }
     }
 
     // Read the GPB header info.
     char sig[9];
-    if (fread(sig, 1, 9, fp) != 9 || memcmp(sig, "\xABGPB\xBB\r\n\x1A\n", 9) != 0)
+    if (bundle->readBytes(sig, 1, 9) != 9 || memcmp(sig, "\xABGPB\xBB\r\n\x1A\n", 9) != 0)
     {
         GP_ERROR("Invalid GPB header for bundle '%s'.", path);
-        if (fclose(fp) != 0)
-        {
-            GP_ERROR("Failed to close file '%s'.", path);
-        }
+        SAFE_RELEASE(bundle);
         return NULL;
     }
 
     // Read version.
     unsigned char ver[2];
-    if (fread(ver, 1, 2, fp) != 2)
+    if (bundle->readBytes(ver, 1, 2) != 2)
     {
         GP_ERROR("Failed to read GPB version for bundle '%s'.", path);
-        if (fclose(fp) != 0)
-        {
-            GP_ERROR("Failed to close file '%s'.", path);
-        }
+        SAFE_RELEASE(bundle);
         return NULL;
     }
-    if (ver[0] != BUNDLE_VERSION_MAJOR || ver[1] != BUNDLE_VERSION_MINOR)
+    if (ver[0] != BUNDLE_VERSION_MAJOR || ver[1] < BUNDLE_VERSION_MINOR_MIN || ver[1] > BUNDLE_VERSION_MINOR)
     {
         GP_ERROR("Unsupported version (%d.%d) for bundle '%s' (expected %d.%d).", (int)ver[0], (int)ver[1], path, BUNDLE_VERSION_MAJOR, BUNDLE_VERSION_MINOR);
-        if (fclose(fp) != 0)
-        {
-            GP_ERROR("Failed to close file '%s'.", path);
-        }
+        SAFE_RELEASE(bundle);
         return NULL;
     }
+    bundle->_version[0] = ver[0];
+    bundle->_version[1] = ver[1];
 
     // Read ref table.
     unsigned int refCount;
-    if (fread(&refCount, 4, 1, fp) != 1)
+    if (!bundle->read(&refCount))
     {
         GP_ERROR("Failed to read ref table for bundle '%s'.", path);
-        if (fclose(fp) != 0)
-        {
-            GP_ERROR("Failed to close file '%s'.", path);
-        }
+        SAFE_RELEASE(bundle);
         return NULL;
     }
 
@@ -229,29 +275,38 @@ Bundle* Bundle::create(const char* path)
     Reference* refs = new Reference[refCount];
     for (unsigned int i = 0; i < refCount; ++i)
     {
-        if ((refs[i].id = readString(fp)).empty() ||
-            fread(&refs[i].type, 4, 1, fp) != 1 ||
-            fread(&refs[i].offset, 4, 1, fp) != 1)
+        if ((refs[i].id = bundle->readString()).empty() ||
+            !bundle->read(&refs[i].type) ||
+            !bundle->read(&refs[i].offset))
         {
             GP_ERROR("Failed to read ref number %d for bundle '%s'.", i, path);
-            if (fclose(fp) != 0)
-            {
-                GP_ERROR("Failed to close file '%s'.", path);
-            }
             SAFE_DELETE_ARRAY(refs);
+            SAFE_RELEASE(bundle);
             return NULL;
         }
     }
 
-    // Keep file open for faster reading later.
-    Bundle* bundle = new Bundle(path);
     bundle->_referenceCount = refCount;
     bundle->_references = refs;
-    bundle->_file = fp;
 
     return bundle;
 }
 
+void Bundle::setMemoryMappingEnabled(bool enabled)
+{
+    __memoryMappingEnabled = enabled;
+}
+
+bool Bundle::isMemoryMappingEnabled()
+{
+    return __memoryMappingEnabled;
+}
+
+bool Bundle::isMemoryMapped() const
+{
+    return _data != NULL;
+}
+
 Bundle::Reference* Bundle::find(const char* id) const
 {
     GP_ASSERT(id);
@@ -281,8 +336,8 @@ void Bundle::clearLoadSession()
 
 const char* Bundle::getIdFromOffset() const
 {
-    GP_ASSERT(_file);
-    return getIdFromOffset((unsigned int) ftell(_file));
+    GP_ASSERT(_file || _data);
+    return getIdFromOffset((unsigned int) tell());
 }
 
 const char* Bundle::getIdFromOffset(unsigned int offset) const
@@ -318,8 +373,8 @@ Bundle::Reference* Bundle::seekTo(const char* id, unsigned int type)
     }
 
     // Seek to the offset of this object.
-    GP_ASSERT(_file);
-    if (fseek(_file, ref->offset, SEEK_SET) != 0)
+    GP_ASSERT(_file || _data);
+    if (!seek(ref->offset, SEEK_SET))
     {
         GP_ERROR("Failed to seek to object '%s' in bundle '%s'.", id, _path.c_str());
         return NULL;
@@ -331,7 +386,7 @@ Bundle::Reference* Bundle::seekTo(const char* id, unsigned int type)
 Bundle::Reference* Bundle::seekToFirstType(unsigned int type)
 {
     GP_ASSERT(_references);
-    GP_ASSERT(_file);
+    GP_ASSERT(_file || _data);
 
     for (unsigned int i = 0; i < _referenceCount; ++i)
     {
@@ -339,7 +394,7 @@ Bundle::Reference* Bundle::seekToFirstType(unsigned int type)
         if (ref->type == type)
         {
             // Found a match.
-            if (fseek(_file, ref->offset, SEEK_SET) != 0)
+            if (!seek(ref->offset, SEEK_SET))
             {
                 GP_ERROR("Failed to seek to object '%s' in bundle '%s'.", ref->id.c_str(), _path.c_str());
                 return NULL;
@@ -350,28 +405,83 @@ Bundle::Reference* Bundle::seekToFirstType(unsigned int type)
     return NULL;
 }
 
+size_t Bundle::readBytes(void* ptr, size_t size, size_t count)
+{
+    if (_data)
+    {
+        // Read as many whole elements as remain in the mapped file.
+        GP_ASSERT(size > 0);
+        size_t available = (_dataSize - _position) / size;
+        if (count > available)
+            count = available;
+        memcpy(ptr, _data + _position, size * count);
+        _position += (unsigned int)(size * count);
+        return count;
+    }
+
+    GP_ASSERT(_file);
+    return fread(ptr, size, count, _file);
+}
+
+const unsigned char* Bundle::readView(unsigned int size)
+{
+    if (_data == NULL || size > _dataSize - _position)
+        return NULL;
+
+    const unsigned char* view = _data + _position;
+    _position += size;
+    return view;
+}
+
+bool Bundle::seek(long offset, int origin)
+{
+    if (_data)
+    {
+        GP_ASSERT(origin == SEEK_SET || origin == SEEK_CUR);
+        long position = origin == SEEK_CUR ? (long)_position + offset : offset;
+        if (position < 0 || position > (long)_dataSize)
+            return false;
+        _position = (unsigned int)position;
+        return true;
+    }
+
+    GP_ASSERT(_file);
+    return fseek(_file, offset, origin) == 0;
+}
+
+long Bundle::tell() const
+{
+    if (_data)
+        return (long)_position;
+
+    GP_ASSERT(_file);
+    return ftell(_file);
+}
+
 bool Bundle::read(unsigned int* ptr)
 {
-    return fread(ptr, sizeof(unsigned int), 1, _file) == 1;
+    return readBytes(ptr, sizeof(unsigned int), 1) == 1;
 }
 
 bool Bundle::read(unsigned char* ptr)
 {
-    return fread(ptr, sizeof(unsigned char), 1, _file) == 1;
+    return readBytes(ptr, sizeof(unsigned char), 1) == 1;
 }
 
 bool Bundle::read(float* ptr)
 {
-    return fread(ptr, sizeof(float), 1, _file) == 1;
+    return readBytes(ptr, sizeof(float), 1) == 1;
 }
 
 bool Bundle::readMatrix(float* m)
 {
-    return fread(m, sizeof(float), 16, _file) == 16;
+    return readBytes(m, sizeof(float), 16) == 16;
 }
 
 Scene* Bundle::loadScene(const char* id)
 {
+    Profiler::Scope profilerScope("Bundle::loadScene");
+
     clearLoadSession();
 
     Reference* ref = NULL;
@@ -397,6 +507,9 @@ Scene* Bundle::loadScene(const char* id)
     Scene* scene = Scene::create();
     scene->setId(getIdFromOffset());
 
+    // Nodes already loaded are looked up by id as each node is read, so index them while loading.
+    scene->setNodesIndexed(true);
+
     // Read the number of children.
     unsigned int childrenCount;
     if (!read(&childrenCount))
@@ -419,7 +532,7 @@ Scene* Bundle::loadScene(const char* id)
         }
     }
     // Read active camera.
-    std::string xref = readString(_file);
+    std::string xref = readString();
     if (xref.length() > 1 && xref[0] == '#') // TODO: Handle full xrefs
     {
         Node* node = scene->findNode(xref.c_str() + 1, true);
@@ -428,6 +541,7 @@ Scene* Bundle::loadScene(const char* id)
         GP_ASSERT(camera);
         scene->setActiveCamera(camera);
     }
+    scene->setNodesIndexed(false);
 
     // Read ambient color.
     float red, blue, green;
@@ -453,14 +567,14 @@ Scene* Bundle::loadScene(const char* id)
 
     // Parse animations.
     GP_ASSERT(_references);
-    GP_ASSERT(_file);
+    GP_ASSERT(_file || _data);
     for (unsigned int i = 0; i < _referenceCount; ++i)
     {
         Reference* ref = &_references[i];
         if (ref->type == BUNDLE_TYPE_ANIMATIONS)
         {
             // Found a match.
-            if (fseek(_file, ref->offset, SEEK_SET) != 0)
+            if (!seek(ref->offset, SEEK_SET))
             {
                 GP_ERROR("Failed to seek to object '%s' in bundle '%s'.", ref->id.c_str(), _path.c_str());
                 return NULL;
@@ -483,7 +597,7 @@ Node* Bundle::loadNode(const char* id, Scene* sceneContext)
 {
     GP_ASSERT(id);
     GP_ASSERT(_references);
-    GP_ASSERT(_file);
+    GP_ASSERT(_file || _data);
 
     clearLoadSession();
 
@@ -499,7 +613,7 @@ Node* Bundle::loadNode(const char* id, Scene* sceneContext)
         Reference* ref = &_references[i];
         if (ref->type == BUNDLE_TYPE_ANIMATIONS)
         {
-            if (fseek(_file, ref->offset, SEEK_SET) != 0)
+            if (!seek(ref->offset, SEEK_SET))
             {
                 GP_ERROR("Failed to seek to object '%s' in bundle '%s'.", ref->id.c_str(), _path.c_str());
                 SAFE_DELETE(_trackedNodes);
@@ -517,7 +631,7 @@ Node* Bundle::loadNode(const char* id, Scene* sceneContext)
 
             for (unsigned int j = 0; j < animationCount; j++)
             {
-                const std::string id = readString(_file);
+                const std::string id = readString();
 
                 // Read the number of animation channels in this animation.
                 unsigned int animationChannelCount;
@@ -532,7 +646,7 @@ Node* Bundle::loadNode(const char* id, Scene* sceneContext)
                 for (unsigned int k = 0; k < animationChannelCount; k++)
                 {
                     // Read target id.
-                    std::string targetId = readString(_file);
+                    std::string targetId = readString();
                     if (targetId.empty())
                     {
                         GP_ERROR("Failed to read target id for animation '%s'.", id.c_str());
@@ -627,7 +741,7 @@ bool Bundle::skipNode()
 {
     const char* id = getIdFromOffset();
     GP_ASSERT(id);
-    GP_ASSERT(_file);
+    GP_ASSERT(_file || _data);
 
     // Skip the node's type.
     unsigned int nodeType;
@@ -638,12 +752,12 @@ bool Bundle::skipNode()
     }
 
     // Skip over the node's transform and parent ID.
-    if (fseek(_file, sizeof(float) * 16, SEEK_CUR) != 0)
+    if (!seek(sizeof(float) * 16, SEEK_CUR))
     {
         GP_ERROR("Failed to skip over node transform for node '%s'.", id);
         return false;
     }
-    readString(_file);
+    readString();
 
     // Skip over the node's children.
     unsigned int childrenCount;
@@ -673,7 +787,7 @@ Node* Bundle::readNode(Scene* sceneContext, Node* nodeContext)
 {
     const char* id = getIdFromOffset();
     GP_ASSERT(id);
-    GP_ASSERT(_file);
+    GP_ASSERT(_file || _data);
 
     // If we are tracking nodes and it's not in the set yet, add it.
     if (_trackedNodes)
@@ -725,7 +839,7 @@ Node* Bundle::readNode(Scene* sceneContext, Node* nodeContext)
 
     // Read transform.
     float transform[16];
-    if (fread(transform, sizeof(float), 16, _file) != 16)
+    if (readBytes(transform, sizeof(float), 16) != 16)
     {
         GP_ERROR("Failed to read transform for node '%s'.", id);
         SAFE_RELEASE(node);
@@ -734,7 +848,7 @@ Node* Bundle::readNode(Scene* sceneContext, Node* nodeContext)
     setTransform(transform, node);
 
     // Skip the parent ID.
-    readString(_file);
+    readString();
 
     // Read children.
     unsigned int childrenCount;
@@ -954,30 +1068,47 @@ Model* Bundle::readModel(const char* nodeId)
 {
     // Read mesh.
     Mesh* mesh = NULL;
-    std::string xref = readString(_file);
+    std::string xref = readString();
     if (xref.length() > 1 && xref[0] == '#') // TODO: Handle full xrefs
     {
-        mesh = loadMesh(xref.c_str() + 1, nodeId);
+        // Read whether the model has a skin (loadMesh restores the file position).
+        unsigned char hasSkin;
+        if (!read(&hasSkin))
+        {
+            GP_ERROR("Failed to load whether model with mesh '%s' has a mesh skin in bundle '%s'.", xref.c_str() + 1, _path.c_str());
+            return NULL;
+        }
+
+        // Skins skinned on the CPU keep their bind pose vertices and need a dynamic mesh.
+        unsigned char* vertexData = NULL;
+        bool cpuSkinning = false;
+        Properties* config = Game::getInstance()->getConfig();
+        if (hasSkin && config)
+        {
+            Properties* skinning = config->getNamespace("skinning", true);
+            cpuSkinning = skinning && skinning->getBool("cpu");
+        }
+
+        mesh = loadMesh(xref.c_str() + 1, nodeId, cpuSkinning ? &vertexData : NULL);
         if (mesh)
         {
             Model* model = Model::create(mesh);
             SAFE_RELEASE(mesh);
 
             // Read skin.
-            unsigned char hasSkin;
-            if (!read(&hasSkin))
-            {
-                GP_ERROR("Failed to load whether model with mesh '%s' has a mesh skin in bundle '%s'.", xref.c_str() + 1, _path.c_str());
-                return NULL;
-            }
             if (hasSkin)
             {
                 MeshSkin* skin = readMeshSkin();
                 if (skin)
                 {
                     model->setSkin(skin);
+                    if (vertexData)
+                    {
+                        skin->setCpuSkinning((const float*)vertexData);
+                    }
                 }
             }
+            SAFE_DELETE_ARRAY(vertexData);
             // Read material.
             unsigned int materialCount;
             if (!read(&materialCount))
@@ -990,6 +1121,35 @@ Model* Bundle::readModel(const char* nodeId)
                 // TODO: Material loading not supported yet.
                 GP_WARN("Material loading is not yet supported.");
             }
+
+            // Read levels of detail.
+            if (_version[1] >= BUNDLE_VERSION_MINOR_LEVELS)
+            {
+                unsigned int levelCount;
+                if (!read(&levelCount))
+                {
+                    GP_ERROR("Failed to load level count for model with mesh '%s' in bundle '%s'.", xref.c_str() + 1, _path.c_str());
+                    SAFE_RELEASE(model);
+                    return NULL;
+                }
+                for (unsigned int i = 0; i < levelCount; ++i)
+                {
+                    std::string levelXref = readString();
+                    float screenSize;
+                    if (levelXref.length() <= 1 || levelXref[0] != '#' || !read(&screenSize))
+                    {
+                        GP_ERROR("Failed to load level %d for model with mesh '%s' in bundle '%s'.", i + 1, xref.c_str() + 1, _path.c_str());
+                        SAFE_RELEASE(model);
+                        return NULL;
+                    }
+                    Mesh* levelMesh = loadMesh(levelXref.c_str() + 1, nodeId);
+                    if (levelMesh)
+                    {
+                        model->addLevel(levelMesh, screenSize);
+                        SAFE_RELEASE(levelMesh);
+                    }
+                }
+            }
             return model;
         }
     }
@@ -1035,7 +1195,7 @@ MeshSkin* Bundle::readMeshSkin()
     // Read joint xref strings for all joints in the list.
     for (unsigned int i = 0; i < jointCount; i++)
     {
-        skinData->joints.push_back(readString(_file));
+        skinData->joints.push_back(readString());
     }
 
     // Read bind poses.
@@ -1072,7 +1232,7 @@ MeshSkin* Bundle::readMeshSkin()
 
 void Bundle::resolveJointReferences(Scene* sceneContext, Node* nodeContext)
 {
-    GP_ASSERT(_file);
+    GP_ASSERT(_file || _data);
 
     for (size_t i = 0, skinCount = _meshSkins.size(); i < skinCount; ++i)
     {
@@ -1144,12 +1304,12 @@ void Bundle::resolveJointReferences(Scene* sceneContext, Node* nodeContext)
                         seekTo(nodeId.c_str(), ref->type);
 
                         // Skip over the node type (1 unsigned int) and transform (16 floats) and read the parent id.
-                        if (fseek(_file, sizeof(unsigned int) + sizeof(float)*16, SEEK_CUR) != 0)
+                        if (!seek(sizeof(unsigned int) + sizeof(float)*16, SEEK_CUR))
                         {
                             GP_ERROR("Failed to skip over node type and transform for node '%s' in bundle '%s'.", nodeId.c_str(), _path.c_str());
                             return;
                         }
-                        std::string parentID = readString(_file);
+                        std::string parentID = readString();
 
                         if (!parentID.empty())
                             nodeId = parentID;
@@ -1185,7 +1345,7 @@ void Bundle::resolveJointReferences(Scene* sceneContext, Node* nodeContext)
 
 void Bundle::readAnimation(Scene* scene)
 {
-    const std::string animationId = readString(_file);
+    const std::string animationId = readString();
 
     // Read the number of animation channels in this animation.
     unsigned int animationChannelCount;
@@ -1223,7 +1383,7 @@ Animation* Bundle::readAnimationChannel(Scene* scene, Animation* animation, cons
     GP_ASSERT(animationId);
 
     // Read target id.
-    std::string targetId = readString(_file);
+    std::string targetId = readString();
     if (targetId.empty())
     {
         GP_ERROR("Failed to read target id for animation '%s'.", animationId);
@@ -1331,11 +1491,16 @@ Mesh* Bundle::loadMesh(const char* id)
 
 Mesh* Bundle::loadMesh(const char* id, const char* nodeId)
 {
-    GP_ASSERT(_file);
+    return loadMesh(id, nodeId, NULL);
+}
+
+Mesh* Bundle::loadMesh(const char* id, const char* nodeId, unsigned char** vertexData)
+{
+    GP_ASSERT(_file || _data);
     GP_ASSERT(id);
 
     // Save the file position.
-    long position = ftell(_file);
+    long position = tell();
     if (position == -1L)
     {
         GP_ERROR("Failed to save the current file position before loading mesh '%s'.", id);
@@ -1350,8 +1515,8 @@ Mesh* Bundle::loadMesh(const char* id, const char* nodeId)
         return NULL;
     }
 
-    // Read mesh data.
-    MeshData* meshData = readMeshData();
+    // Read mesh data, uploading it straight from the mapped file unless the caller keeps it.
+    MeshData* meshData = readMeshData(vertexData == NULL);
     if (meshData == NULL)
     {
         GP_ERROR("Failed to load mesh data for mesh '%s'.", id);
@@ -1359,11 +1524,11 @@ Mesh* Bundle::loadMesh(const char* id, const char* nodeId)
     }
 
     // Create mesh.
-    Mesh* mesh = Mesh::createMesh(meshData->vertexFormat, meshData->vertexCount, false);
+    Mesh* mesh = Mesh::createMesh(meshData->vertexFormat, meshData->vertexCount, vertexData != NULL);
     if (mesh == NULL)
     {
         GP_ERROR("Failed to create mesh '%s'.", id);
-        SAFE_DELETE_ARRAY(meshData);
+        SAFE_DELETE(meshData);
         return NULL;
     }
 
@@ -1392,10 +1557,16 @@ Mesh* Bundle::loadMesh(const char* id, const char* nodeId)
         part->setIndexData(partData->indexData, 0, partData->indexCount);
     }
 
+    if (vertexData)
+    {
+        // Hand the vertex data over to the caller.
+        *vertexData = meshData->vertexData;
+        meshData->vertexData = NULL;
+    }
     SAFE_DELETE(meshData);
 
     // Restore file pointer.
-    if (fseek(_file, position, SEEK_SET) != 0)
+    if (!seek(position, SEEK_SET))
     {
         GP_ERROR("Failed to restore file pointer after loading mesh '%s'.", id);
         return NULL;
@@ -1405,10 +1576,15 @@ Mesh* Bundle::loadMesh(const char* id, const char* nodeId)
 }
 
 Bundle::MeshData* Bundle::readMeshData()
+{
+    return readMeshData(false);
+}
+
+Bundle::MeshData* Bundle::readMeshData(bool mapData)
 {
     // Read vertex format/elements.
     unsigned int vertexElementCount;
-    if (fread(&vertexElementCount, 4, 1, _file) != 1)
+    if (readBytes(&vertexElementCount, 4, 1) != 1)
     {
         GP_ERROR("Failed to load vertex element count.");
         return NULL;
@@ -1423,13 +1599,13 @@ Bundle::MeshData* Bundle::readMeshData()
     for (unsigned int i = 0; i < vertexElementCount; ++i)
     {
         unsigned int vUsage, vSize;
-        if (fread(&vUsage, 4, 1, _file) != 1)
+        if (readBytes(&vUsage, 4, 1) != 1)
         {
             GP_ERROR("Failed to load vertex usage.");
             SAFE_DELETE_ARRAY(vertexElements);
             return NULL;
         }
-        if (fread(&vSize, 4, 1, _file) != 1)
+        if (readBytes(&vSize, 4, 1) != 1)
         {
             GP_ERROR("Failed to load vertex size.");
             SAFE_DELETE_ARRAY(vertexElements);
@@ -1445,7 +1621,7 @@ Bundle::MeshData* Bundle::readMeshData()
 
     // Read vertex data.
     unsigned int vertexByteCount;
-    if (fread(&vertexByteCount, 4, 1, _file) != 1)
+    if (readBytes(&vertexByteCount, 4, 1) != 1)
     {
         GP_ERROR("Failed to load vertex byte count.");
         SAFE_DELETE(meshData);
@@ -1460,8 +1636,18 @@ Bundle::MeshData* Bundle::readMeshData()
 
     GP_ASSERT(meshData->vertexFormat.getVertexSize());
     meshData->vertexCount = vertexByteCount / meshData->vertexFormat.getVertexSize();
-    meshData->vertexData = new unsigned char[vertexByteCount];
-    if (fread(meshData->vertexData, 1, vertexByteCount, _file) != vertexByteCount)
+    if (mapData && _data)
+    {
+        meshData->vertexData = (unsigned char*)readView(vertexByteCount);
+        meshData->vertexDataMapped = true;
+    }
+    else
+    {
+        meshData->vertexData = new unsigned char[vertexByteCount];
+        if (readBytes(meshData->vertexData, 1, vertexByteCount) != vertexByteCount)
+            SAFE_DELETE_ARRAY(meshData->vertexData);
+    }
+    if (meshData->vertexData == NULL)
     {
         GP_ERROR("Failed to load vertex data.");
         SAFE_DELETE(meshData);
@@ -1469,13 +1655,13 @@ Bundle::MeshData* Bundle::readMeshData()
     }
 
     // Read mesh bounds (bounding box and bounding sphere).
-    if (fread(&meshData->boundingBox.min.x, 4, 3, _file) != 3 || fread(&meshData->boundingBox.max.x, 4, 3, _file) != 3)
+    if (readBytes(&meshData->boundingBox.min.x, 4, 3) != 3 || readBytes(&meshData->boundingBox.max.x, 4, 3) != 3)
     {
         GP_ERROR("Failed to load mesh bounding box.");
         SAFE_DELETE(meshData);
         return NULL;
     }
-    if (fread(&meshData->boundingSphere.center.x, 4, 3, _file) != 3 || fread(&meshData->boundingSphere.radius, 4, 1, _file) != 1)
+    if (readBytes(&meshData->boundingSphere.center.x, 4, 3) != 3 || readBytes(&meshData->boundingSphere.radius, 4, 1) != 1)
     {
         GP_ERROR("Failed to load mesh bounding sphere.");
         SAFE_DELETE(meshData);
@@ -1484,7 +1670,7 @@ Bundle::MeshData* Bundle::readMeshData()
 
     // Read mesh parts.
     unsigned int meshPartCount;
-    if (fread(&meshPartCount, 4, 1, _file) != 1)
+    if (readBytes(&meshPartCount, 4, 1) != 1)
     {
         GP_ERROR("Failed to load mesh part count.");
         SAFE_DELETE(meshData);
@@ -1494,19 +1680,19 @@ Bundle::MeshData* Bundle::readMeshData()
     {
         // Read primitive type, index format and index count.
         unsigned int pType, iFormat, iByteCount;
-        if (fread(&pType, 4, 1, _file) != 1)
+        if (readBytes(&pType, 4, 1) != 1)
         {
             GP_ERROR("Failed to load primitive type for mesh part with index %d.", i);
             SAFE_DELETE(meshData);
             return NULL;
         }
-        if (fread(&iFormat, 4, 1, _file) != 1)
+        if (readBytes(&iFormat, 4, 1) != 1)
         {
             GP_ERROR("Failed to load index format for mesh part with index %d.", i);
             SAFE_DELETE(meshData);
             return NULL;
         }
-        if (fread(&iByteCount, 4, 1, _file) != 1)
+        if (readBytes(&iByteCount, 4, 1) != 1)
         {
             GP_ERROR("Failed to load index byte count for mesh part with index %d.", i);
             SAFE_DELETE(meshData);
@@ -1533,14 +1719,25 @@ Bundle::MeshData* Bundle::readMeshData()
             break;
         default:
             GP_ERROR("Unsupported index format for mesh part with index %d.", i);
+            SAFE_DELETE(meshData);
             return NULL;
         }
 
         GP_ASSERT(indexSize);
         partData->indexCount = iByteCount / indexSize;
 
-        partData->indexData = new unsigned char[iByteCount];
-        if (fread(partData->indexData, 1, iByteCount, _file) != iByteCount)
+        if (mapData && _data)
+        {
+            partData->indexData = (unsigned char*)readView(iByteCount);
+            partData->indexDataMapped = true;
+        }
+        else
+        {
+            partData->indexData = new unsigned char[iByteCount];
+            if (readBytes(partData->indexData, 1, iByteCount) != iByteCount)
+                SAFE_DELETE_ARRAY(partData->indexData);
+        }
+        if (partData->indexData == NULL && iByteCount > 0)
         {
             GP_ERROR("Failed to read index data for mesh part with index %d.", i);
             SAFE_DELETE(meshData);
@@ -1601,7 +1798,7 @@ Bundle::MeshData* Bundle::readMeshData(const char* url)
 Font* Bundle::loadFont(const char* id)
 {
     GP_ASSERT(id);
-    GP_ASSERT(_file);
+    GP_ASSERT(_file || _data);
 
     // Seek to the specified font.
     Reference* ref = seekTo(id, BUNDLE_TYPE_FONT);
@@ -1612,7 +1809,7 @@ Font* Bundle::loadFont(const char* id)
     }
 
     // Read font family.
-    std::string family = readString(_file);
+    std::string family = readString();
     if (family.empty())
     {
         GP_ERROR("Failed to read font family for font '%s'.", id);
@@ -1621,23 +1818,45 @@ Font* Bundle::loadFont(const char* id)
 
     // Read font style and size.
     unsigned int style, size;
-    if (fread(&style, 4, 1, _file) != 1)
+    if (readBytes(&style, 4, 1) != 1)
     {
         GP_ERROR("Failed to read style for font '%s'.", id);
         return NULL;
     }
-    if (fread(&size, 4, 1, _file) != 1)
+    if (readBytes(&size, 4, 1) != 1)
     {
         GP_ERROR("Failed to read size for font '%s'.", id);
         return NULL;
     }
 
     // Read character set.
-    std::string charset = readString(_file);
+    std::string charset = readString();
+
+    // Read the format of the glyphs.
+    unsigned int format = Font::BITMAP;
+    unsigned int spread = 0;
+    if (_version[1] >= BUNDLE_VERSION_MINOR_FONT_FORMAT)
+    {
+        if (readBytes(&format, 4, 1) != 1)
+        {
+            GP_ERROR("Failed to read format for font '%s'.", id);
+            return NULL;
+        }
+        if (readBytes(&spread, 4, 1) != 1)
+        {
+            GP_ERROR("Failed to read distance field spread for font '%s'.", id);
+            return NULL;
+        }
+        if (format != Font::BITMAP && format != Font::DISTANCE_FIELD)
+        {
+            GP_ERROR("Invalid format (%u) for font '%s'.", format, id);
+            return NULL;
+        }
+    }
 
     // Read font glyphs.
     unsigned int glyphCount;
-    if (fread(&glyphCount, 4, 1, _file) != 1)
+    if (readBytes(&glyphCount, 4, 1) != 1)
     {
         GP_ERROR("Failed to read glyph count for font '%s'.", id);
         return NULL;
@@ -1649,7 +1868,7 @@ Font* Bundle::loadFont(const char* id)
     }
 
     Font::Glyph* glyphs = new Font::Glyph[glyphCount];
-    if (fread(glyphs, sizeof(Font::Glyph), glyphCount, _file) != glyphCount)
+    if (readBytes(glyphs, sizeof(Font::Glyph), glyphCount) != glyphCount)
     {
         GP_ERROR("Failed to read glyphs for font '%s'.", id);
         SAFE_DELETE_ARRAY(glyphs);
@@ -1658,19 +1877,19 @@ Font* Bundle::loadFont(const char* id)
 
     // Read texture attributes.
     unsigned int width, height, textureByteCount;
-    if (fread(&width, 4, 1, _file) != 1)
+    if (readBytes(&width, 4, 1) != 1)
     {
         GP_ERROR("Failed to read texture width for font '%s'.", id);
         SAFE_DELETE_ARRAY(glyphs);
         return NULL;
     }
-    if (fread(&height, 4, 1, _file) != 1)
+    if (readBytes(&height, 4, 1) != 1)
     {
         GP_ERROR("Failed to read texture height for font '%s'.", id);
         SAFE_DELETE_ARRAY(glyphs);
         return NULL;
     }
-    if (fread(&textureByteCount, 4, 1, _file) != 1)
+    if (readBytes(&textureByteCount, 4, 1) != 1)
     {
         GP_ERROR("Failed to read texture byte count for font '%s'.", id);
         SAFE_DELETE_ARRAY(glyphs);
@@ -1683,18 +1902,24 @@ Font* Bundle::loadFont(const char* id)
         return NULL;
     }
 
-    // Read texture data.
-    unsigned char* textureData = new unsigned char[textureByteCount];
-    if (fread(textureData, 1, textureByteCount, _file) != textureByteCount)
+    // Read texture data, uploading it straight from the mapped file if possible.
+    const unsigned char* textureView = readView(textureByteCount);
+    unsigned char* textureData = NULL;
+    if (textureView == NULL)
     {
-        GP_ERROR("Failed to read texture data for font '%s'.", id);
-        SAFE_DELETE_ARRAY(glyphs);
-        SAFE_DELETE_ARRAY(textureData);
-        return NULL;
+        textureData = new unsigned char[textureByteCount];
+        if (readBytes(textureData, 1, textureByteCount) != textureByteCount)
+        {
+            GP_ERROR("Failed to read texture data for font '%s'.", id);
+            SAFE_DELETE_ARRAY(glyphs);
+            SAFE_DELETE_ARRAY(textureData);
+            return NULL;
+        }
+        textureView = textureData;
     }
 
     // Create the texture for the font.
-    Texture* texture = Texture::create(Texture::ALPHA, width, height, textureData, true);
+    Texture* texture = Texture::create(Texture::ALPHA, width, height, (unsigned char*)textureView, true);
 
     // Free the texture data (no longer needed).
     SAFE_DELETE_ARRAY(textureData);
@@ -1707,7 +1932,7 @@ Font* Bundle::loadFont(const char* id)
     }
 
     // Create the font.
-    Font* font = Font::create(family.c_str(), Font::PLAIN, size, glyphs, glyphCount, texture);
+    Font* font = Font::create(family.c_str(), Font::PLAIN, size, glyphs, glyphCount, texture, (Font::Format)format, spread);
 
     // Free the glyph array.
     SAFE_DELETE_ARRAY(glyphs);
@@ -1764,23 +1989,29 @@ Bundle::Reference::~Reference()
 }
 
 Bundle::MeshPartData::MeshPartData() :
-    indexCount(0), indexData(NULL)
+    indexCount(0), indexData(NULL), indexDataMapped(false)
 {
 }
 
 Bundle::MeshPartData::~MeshPartData()
 {
-    SAFE_DELETE_ARRAY(indexData);
+    if (!indexDataMapped)
+    {
+        SAFE_DELETE_ARRAY(indexData);
+    }
 }
 
 Bundle::MeshData::MeshData(const VertexFormat& vertexFormat)
-    : vertexFormat(vertexFormat), vertexCount(0), vertexData(NULL)
+    : vertexFormat(vertexFormat), vertexCount(0), vertexData(NULL), vertexDataMapped(false)
 {
 }
 
 Bundle::MeshData::~MeshData()
 {
-    SAFE_DELETE_ARRAY(vertexData);
+    if (!vertexDataMapped)
+    {
+        SAFE_DELETE_ARRAY(vertexData);
+    }
 
     for (unsigned int i = 0; i < parts.size(); ++i)
     {
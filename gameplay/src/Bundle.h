@@ -15,8 +15,10 @@ namespace gameplay
  */
 class Bundle : public Ref
 {
+    friend class ModelBatch;
     friend class PhysicsController;
     friend class SceneLoader;
+    friend class ResourceLoader;
 
 public:
 
@@ -33,6 +35,33 @@ public:
      */
     static Bundle* create(const char* path);
 
+    /**
+     * Sets whether bundles opened after this call are read through a read-only
+     * memory mapping of their file, instead of through buffered file reads.
+     *
+     * With a memory mapping, the vertex and index data of meshes and the texture
+     * data of fonts are uploaded directly from the mapped file. Bundles that cannot
+     * be mapped are read from the file. Memory mapping is enabled by default and can
+     * also be set with bundle.mmap in the game config.
+     *
+     * @param enabled true to memory map bundles, false to read them from the file.
+     */
+    static void setMemoryMappingEnabled(bool enabled);
+
+    /**
+     * Determines if bundles opened from now on are memory mapped.
+     *
+     * @return true if bundles are memory mapped when possible, false otherwise.
+     */
+    static bool isMemoryMappingEnabled();
+
+    /**
+     * Determines if this bundle is read through a memory mapping of its file.
+     *
+     * @return true if the bundle is memory mapped, false if it is read from the file.
+     */
+    bool isMemoryMapped() const;
+
     /**
      * Loads the scene with the specified ID from the bundle.
      * If id is NULL then the first scene found is loaded.
@@ -133,6 +162,7 @@ private:
         Mesh::IndexFormat indexFormat;
         unsigned int indexCount;
         unsigned char* indexData;
+        bool indexDataMapped;
     };
 
     struct MeshData
@@ -143,6 +173,7 @@ private:
         VertexFormat vertexFormat;
         unsigned int vertexCount;
         unsigned char* vertexData;
+        bool vertexDataMapped;
         BoundingBox boundingBox;
         BoundingSphere boundingSphere;
         Mesh::PrimitiveType primitiveType;
@@ -161,6 +192,31 @@ private:
      */
     Bundle& operator=(const Bundle&);
 
+    /**
+     * Opens a bundle and reads its reference table, without searching the bundle cache.
+     *
+     * This may be called from any thread.
+     *
+     * @param path The path of the bundle file.
+     *
+     * @return The new bundle, or NULL if the file is not a valid bundle.
+     */
+    static Bundle* open(const char* path);
+
+    /**
+     * Gets the cached bundle for the given path and increments its reference count.
+     *
+     * @param path The path of the bundle file.
+     *
+     * @return The cached bundle, or NULL if the bundle is not cached.
+     */
+    static Bundle* findCached(const char* path);
+
+    /**
+     * Adds this bundle to the bundle cache.
+     */
+    void addToCache();
+
     /**
      * Finds a reference by ID.
      */
@@ -231,6 +287,62 @@ private:
      */
     Mesh* loadMesh(const char* id, const char* nodeId);
 
+    /**
+     * Loads a mesh with the specified ID from the bundle.
+     *
+     * @param id The ID of the mesh to load.
+     * @param nodeId The id of the mesh's model's parent node.
+     * @param vertexData If not NULL, the mesh is created dynamic and this is set to its vertex
+     *      data, which the caller must delete.
+     * 
+     * @return The loaded mesh, or NULL if the mesh could not be loaded.
+     */
+    Mesh* loadMesh(const char* id, const char* nodeId, unsigned char** vertexData);
+
+    /**
+     * Reads count elements of the given size from the current file position, like fread.
+     *
+     * @param ptr A pointer to load the elements into.
+     * @param size The size of each element in bytes.
+     * @param count The number of elements to read.
+     *
+     * @return The number of elements read.
+     */
+    size_t readBytes(void* ptr, size_t size, size_t count);
+
+    /**
+     * Returns a pointer to the given number of bytes at the current position in the
+     * memory mapped file, and advances past them.
+     *
+     * @param size The number of bytes.
+     *
+     * @return A pointer into the mapped file, or NULL if the bundle is not memory
+     *      mapped or the file is too short.
+     */
+    const unsigned char* readView(unsigned int size);
+
+    /**
+     * Sets the file position, like fseek.
+     *
+     * @param offset The offset in bytes.
+     * @param origin SEEK_SET or SEEK_CUR.
+     *
+     * @return True if successful, false if an error occurred.
+     */
+    bool seek(long offset, int origin);
+
+    /**
+     * Returns the current file position.
+     */
+    long tell() const;
+
+    /**
+     * Reads a string from the current file position.
+     *
+     * @return The string read, or an empty string if an error occurred.
+     */
+    std::string readString();
+
     /**
      * Reads an unsigned int from the current file position.
      *
@@ -344,6 +456,14 @@ private:
      */
     MeshData* readMeshData();
 
+    /**
+     * Reads mesh data from the current file position.
+     *
+     * @param mapData If true and the bundle is memory mapped, the vertex and index
+     *      data point into the mapped file instead of being copied.
+     */
+    MeshData* readMeshData(bool mapData);
+
     /**
      * Reads mesh data for the specified URL.
      *
@@ -427,9 +547,13 @@ private:
     bool skipNode();
 
     std::string _path;
+    unsigned char _version[2];
     unsigned int _referenceCount;
     Reference* _references;
     FILE* _file;
+    const unsigned char* _data;
+    unsigned int _dataSize;
+    unsigned int _position;
 
     std::vector<MeshSkinData*> _meshSkins;
     std::map<std::string, Node*>* _trackedNodes;
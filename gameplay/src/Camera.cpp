@@ -17,15 +17,18 @@
 namespace gameplay
 {
 
+// Versions are unique across cameras, so a version identifies both a camera and its state.
+static unsigned int __version = 0;
+
 Camera::Camera(float fieldOfView, float aspectRatio, float nearPlane, float farPlane)
     : _type(PERSPECTIVE), _fieldOfView(fieldOfView), _aspectRatio(aspectRatio), _nearPlane(nearPlane), _farPlane(farPlane),
-      _dirtyBits(CAMERA_DIRTY_ALL), _node(NULL)
+      _dirtyBits(CAMERA_DIRTY_ALL), _version(++__version), _node(NULL)
 {
 }
 
 Camera::Camera(float zoomX, float zoomY, float aspectRatio, float nearPlane, float farPlane)
     : _type(ORTHOGRAPHIC), _aspectRatio(aspectRatio), _nearPlane(nearPlane), _farPlane(farPlane),
-      _dirtyBits(CAMERA_DIRTY_ALL), _node(NULL)
+      _dirtyBits(CAMERA_DIRTY_ALL), _version(++__version), _node(NULL)
 {
     // Orthographic camera.
     _zoom[0] = zoomX;
@@ -64,6 +67,7 @@ void Camera::setFieldOfView(float fieldOfView)
 
     _fieldOfView = fieldOfView;
     _dirtyBits |= CAMERA_DIRTY_PROJ | CAMERA_DIRTY_VIEW_PROJ | CAMERA_DIRTY_INV_VIEW_PROJ | CAMERA_DIRTY_BOUNDS;
+    _version = ++__version;
 }
 
 float Camera::getZoomX() const
@@ -79,6 +83,7 @@ void Camera::setZoomX(float zoomX)
 
     _zoom[0] = zoomX;
     _dirtyBits |= CAMERA_DIRTY_PROJ | CAMERA_DIRTY_VIEW_PROJ | CAMERA_DIRTY_INV_VIEW_PROJ | CAMERA_DIRTY_BOUNDS;
+    _version = ++__version;
 }
 
 float Camera::getZoomY() const
@@ -94,6 +99,7 @@ void Camera::setZoomY(float zoomY)
 
     _zoom[1] = zoomY;
     _dirtyBits |= CAMERA_DIRTY_PROJ | CAMERA_DIRTY_VIEW_PROJ | CAMERA_DIRTY_INV_VIEW_PROJ | CAMERA_DIRTY_BOUNDS;
+    _version = ++__version;
 }
 
 float Camera::getAspectRatio() const
@@ -105,6 +111,7 @@ void Camera::setAspectRatio(float aspectRatio)
 {
     _aspectRatio = aspectRatio;
     _dirtyBits |= CAMERA_DIRTY_PROJ | CAMERA_DIRTY_VIEW_PROJ | CAMERA_DIRTY_INV_VIEW_PROJ | CAMERA_DIRTY_BOUNDS;
+    _version = ++__version;
 }
 
 float Camera::getNearPlane() const
@@ -116,6 +123,7 @@ void Camera::setNearPlane(float nearPlane)
 {
     _nearPlane = nearPlane;
     _dirtyBits |= CAMERA_DIRTY_PROJ | CAMERA_DIRTY_VIEW_PROJ | CAMERA_DIRTY_INV_VIEW_PROJ | CAMERA_DIRTY_BOUNDS;
+    _version = ++__version;
 }
 
 float Camera::getFarPlane() const
@@ -127,6 +135,7 @@ void Camera::setFarPlane(float farPlane)
 {
     _farPlane = farPlane;
     _dirtyBits |= CAMERA_DIRTY_PROJ | CAMERA_DIRTY_VIEW_PROJ | CAMERA_DIRTY_INV_VIEW_PROJ | CAMERA_DIRTY_BOUNDS;
+    _version = ++__version;
 }
 
 Node* Camera::getNode() const
@@ -134,6 +143,11 @@ Node* Camera::getNode() const
     return _node;
 }
 
+unsigned int Camera::getVersion() const
+{
+    return _version;
+}
+
 void Camera::setNode(Node* node)
 {
     if (_node != node)
@@ -152,6 +166,7 @@ void Camera::setNode(Node* node)
         }
 
         _dirtyBits |= CAMERA_DIRTY_VIEW | CAMERA_DIRTY_VIEW_PROJ | CAMERA_DIRTY_INV_VIEW | CAMERA_DIRTY_INV_VIEW_PROJ | CAMERA_DIRTY_BOUNDS;
+        _version = ++__version;
     }
 }
 
@@ -314,6 +329,26 @@ void Camera::pickRay(const Rectangle& viewport, float x, float y, Ray* dst) cons
     dst->set(nearPoint, direction);
 }
 
+float Camera::getScreenSize(const BoundingSphere& sphere) const
+{
+    // The projection maps view space heights onto the [-1, 1] range of the viewport.
+    float scale = getProjectionMatrix().m[5];
+    if (_type != PERSPECTIVE)
+    {
+        return sphere.radius * scale;
+    }
+
+    // Perspective divides the height by the distance from the camera.
+    const Matrix& inverseView = getInverseViewMatrix();
+    Vector3 position(inverseView.m[12], inverseView.m[13], inverseView.m[14]);
+    float distance = sphere.center.distance(position);
+    if (distance <= sphere.radius)
+    {
+        return scale;
+    }
+    return sphere.radius * scale / distance;
+}
+
 Camera* Camera::clone(NodeCloneContext &context) const
 {
     Camera* cameraClone = NULL;
@@ -337,6 +372,7 @@ Camera* Camera::clone(NodeCloneContext &context) const
 void Camera::transformChanged(Transform* transform, long cookie)
 {
     _dirtyBits |= CAMERA_DIRTY_VIEW | CAMERA_DIRTY_INV_VIEW | CAMERA_DIRTY_INV_VIEW_PROJ | CAMERA_DIRTY_VIEW_PROJ | CAMERA_DIRTY_BOUNDS;
+    _version = ++__version;
 }
 
 }
@@ -9,6 +9,7 @@
 namespace gameplay
 {
 
+class BoundingSphere;
 class Node;
 class NodeCloneContext;
 
@@ -187,6 +188,17 @@ public:
      */
     const Matrix& getInverseViewProjectionMatrix() const;
 
+    /**
+     * Gets the version of the camera's matrices.
+     *
+     * The version changes whenever the view or projection of the camera changes, and is
+     * never shared by two cameras, so it can be stored with values computed from the
+     * camera's matrices to tell when they must be recomputed.
+     *
+     * @return The version of the camera's matrices.
+     */
+    unsigned int getVersion() const;
+
     /**
      * Gets the view bounding frustum.
      *
@@ -229,6 +241,18 @@ public:
      */
     void pickRay(const Rectangle& viewport, float x, float y, Ray* dst) const;
 
+    /**
+     * Gets the size on screen of a bounding sphere, as the fraction of the viewport height
+     * that its diameter covers.
+     *
+     * The size of a sphere that contains the camera is that of a sphere touching it.
+     *
+     * @param sphere The world space bounding sphere.
+     *
+     * @return The size of the sphere on screen.
+     */
+    float getScreenSize(const BoundingSphere& sphere) const;
+
 private:
 
     /**
@@ -282,6 +306,7 @@ private:
     mutable Matrix _inverseViewProjection;
     mutable Frustum _bounds;
     mutable int _dirtyBits;
+    unsigned int _version;
     Node* _node;
 };
 
@@ -218,6 +218,7 @@ unsigned int Container::addControl(Control* control)
         _controls.push_back(control);
         control->addRef();
         control->_parent = this;
+        _dirty = true;
         return (unsigned int)(_controls.size() - 1);
     }
     else
@@ -255,6 +256,7 @@ void Container::insertControl(Control* control, unsigned int index)
         _controls.insert(it, control);
         control->addRef();
         control->_parent = this;
+        _dirty = true;
     }
 }
 
@@ -263,10 +265,11 @@ void Container::removeControl(unsigned int index)
     GP_ASSERT(index < _controls.size());
 
     std::vector<Control*>::iterator it = _controls.begin() + index;
-    _controls.erase(it);
     Control* control = *it;
+    _controls.erase(it);
     control->_parent = NULL;
     SAFE_RELEASE(control);
+    _dirty = true;
 }
 
 void Container::removeControl(const char* id)
@@ -280,6 +283,7 @@ void Container::removeControl(const char* id)
         {
             SAFE_RELEASE(c);
             _controls.erase(it);
+            _dirty = true;
             return;
         }
     }
@@ -295,6 +299,7 @@ void Container::removeControl(Control* control)
         {
             SAFE_RELEASE(control);
             _controls.erase(it);
+            _dirty = true;
             return;
         }
     }
@@ -441,37 +446,22 @@ void Container::update(const Control* container, const Vector2& offset)
         _layout->update(this, Vector2::zero());
 }
 
-void Container::draw(SpriteBatch* spriteBatch, const Rectangle& clip, bool needsClear, bool cleared, float targetHeight)
+void Container::draw(SpriteBatch* spriteBatch, const Rectangle& clip, const Rectangle& region)
 {
-    if (needsClear)
-    {
-        GL_ASSERT( glEnable(GL_SCISSOR_TEST) );
-        float clearY = targetHeight - _clearBounds.y - _clearBounds.height;
-        GL_ASSERT( glScissor(_clearBounds.x, clearY, _clearBounds.width, _clearBounds.height) );
-        Game::getInstance()->clear(Game::CLEAR_COLOR, Vector4::zero(), 1.0f, 0);
-        GL_ASSERT( glDisable(GL_SCISSOR_TEST) );
-        needsClear = false;
-        cleared = true;
-    }
-    else if (!cleared)
-    {
-        needsClear = true;
-    }
-
     spriteBatch->start();
     Control::drawBorder(spriteBatch, clip);
     spriteBatch->finish();
 
+    // Draw the controls under the region, which were cleared with it, and those that changed,
+    // which are within it unless they are empty, to mark them drawn.
     std::vector<Control*>::const_iterator it;
-    Rectangle boundsUnion = Rectangle::empty();
     for (it = _controls.begin(); it < _controls.end(); it++)
     {
         Control* control = *it;
         GP_ASSERT(control);
-        if (!needsClear || control->isDirty() || control->_clearBounds.intersects(boundsUnion))
+        if (control->isDirty() || control->_absoluteClipBounds.intersects(region))
         {
-            control->draw(spriteBatch, _viewportClipBounds, needsClear, cleared, targetHeight);
-            Rectangle::combine(control->_clearBounds, boundsUnion, &boundsUnion);
+            control->draw(spriteBatch, _viewportClipBounds, region);
         }
     }
 
@@ -559,6 +549,36 @@ void Container::draw(SpriteBatch* spriteBatch, const Rectangle& clip, bool needs
     }
 }
 
+void Container::getDirtyRegion(Rectangle* region) const
+{
+    GP_ASSERT(region);
+
+    std::vector<Control*>::const_iterator it;
+    for (it = _controls.begin(); it < _controls.end(); it++)
+    {
+        Control* control = *it;
+        GP_ASSERT(control);
+        if (control->_dirty)
+        {
+            // The control is drawn again whole, where it was and where it is now.
+            const Rectangle* bounds[] = { &control->_clearBounds, &control->_absoluteClipBounds };
+            for (int i = 0; i < 2; ++i)
+            {
+                if (bounds[i]->width <= 0 || bounds[i]->height <= 0)
+                    continue;
+                if (region->isEmpty())
+                    region->set(*bounds[i]);
+                else
+                    Rectangle::combine(*region, *bounds[i], region);
+            }
+        }
+        else if (control->isContainer())
+        {
+            static_cast<Container*>(control)->getDirtyRegion(region);
+        }
+    }
+}
+
 bool Container::isDirty()
 {
     if (_dirty)
@@ -319,15 +319,22 @@ protected:
     void addControls(Theme* theme, Properties* properties);
 
     /**
-     * Draws a sprite batch for the specified clipping rect .
+     * Draws this container, and the controls within it that overlap the region of the form
+     * being redrawn or have changed.
      *
      * @param spriteBatch The sprite batch to use.
-     * @param clip The clipping rectangle.
-     * @param needsClear Whether it needs to be cleared.
-     * @param cleared Whether it was previously cleared
-     * @param targetHeight The targets height
+     * @param clip The clipping rectangle of this container's parent container.
+     * @param region The region of the form being redrawn.
      */
-    virtual void draw(SpriteBatch* spriteBatch, const Rectangle& clip, bool needsClear, bool cleared, float targetHeight);
+    virtual void draw(SpriteBatch* spriteBatch, const Rectangle& clip, const Rectangle& region);
+
+    /**
+     * Adds to a region the areas covered by the controls within this container that have
+     * changed since they were last drawn, both before and after they changed.
+     *
+     * @param region The region to add to, which may be empty.
+     */
+    void getDirtyRegion(Rectangle* region) const;
 
     /**
      * Update scroll position and velocity.
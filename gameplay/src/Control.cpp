@@ -828,6 +828,9 @@ void Control::update(const Control* container, const Vector2& offset)
     const Rectangle& absoluteViewport = container->_viewportBounds;
 
     _clearBounds.set(_absoluteClipBounds);
+    _updateViewportBounds.set(absoluteViewport);
+    _updateClip.set(clip);
+    _updateOffset.set(offset);
 
     // Calculate the clipped bounds.
     float x = _bounds.x + offset.x;
@@ -993,16 +996,8 @@ void Control::drawText(const Rectangle& position)
 {
 }
 
-void Control::draw(SpriteBatch* spriteBatch, const Rectangle& clip, bool needsClear, bool cleared, float targetHeight)
+void Control::draw(SpriteBatch* spriteBatch, const Rectangle& clip, const Rectangle& region)
 {
-    if (needsClear)
-    {
-        GL_ASSERT( glEnable(GL_SCISSOR_TEST) );
-        GL_ASSERT( glScissor(_clearBounds.x, targetHeight - _clearBounds.y - _clearBounds.height, _clearBounds.width, _clearBounds.height) );
-        Game::getInstance()->clear(Game::CLEAR_COLOR, Vector4::zero(), 1.0f, 0);
-        GL_ASSERT( glDisable(GL_SCISSOR_TEST) );
-    }
-
     spriteBatch->start();
     drawBorder(spriteBatch, clip);
     drawImages(spriteBatch, clip);
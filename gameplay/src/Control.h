@@ -847,15 +847,16 @@ protected:
     virtual void drawText(const Rectangle& clip);
 
     /**
-     * Draws a sprite batch for the specified clipping rect .
+     * Draws this control into the framebuffer of its form.
+     *
+     * The form clears the region being redrawn and scissors drawing to it, so a control is
+     * drawn whole even where only part of it is within the region.
      *
      * @param spriteBatch The sprite batch to use.
-     * @param clip The clipping rectangle.
-     * @param needsClear Whether it needs to be cleared.
-     * @param cleared Whether it was previously cleared
-     * @param targetHeight The targets height
+     * @param clip The clipping rectangle of this control's parent container.
+     * @param region The region of the form being redrawn.
      */
-    virtual void draw(SpriteBatch* spriteBatch, const Rectangle& clip, bool needsClear, bool cleared, float targetHeight);
+    virtual void draw(SpriteBatch* spriteBatch, const Rectangle& clip, const Rectangle& region);
 
     /**
      * Initialize properties common to all Controls from a Properties object.
@@ -951,6 +952,21 @@ protected:
      */
     Rectangle _clearBounds;         
 
+    /**
+     * The parent container's absolute viewport bounds this control was last updated within.
+     */
+    Rectangle _updateViewportBounds;
+
+    /**
+     * The parent container's clip this control was last updated within.
+     */
+    Rectangle _updateClip;
+
+    /**
+     * The positioning offset this control was last updated with.
+     */
+    Vector2 _updateOffset;
+
     /**
      * If the control is dirty and need updating.
      */
@@ -177,6 +177,11 @@ void Curve::setTangent(unsigned int index, InterpolationType type, float* inValu
 }
 
 void Curve::evaluate(float time, float* dst) const
+{
+    evaluate(time, dst, NULL);
+}
+
+void Curve::evaluate(float time, float* dst, unsigned int* cursor) const
 {
     assert(dst && time >= 0 && time <= 1.0f);
 
@@ -185,16 +190,30 @@ void Curve::evaluate(float time, float* dst) const
     if (_pointCount == 1 || time <= _points[0].time)
     {
         memcpy(dst, _points[0].value, _componentSize);
+        if (cursor)
+            *cursor = 0;
         return;
     }
     else if (time >= _points[_pointCount - 1].time)
     {
         memcpy(dst, _points[_pointCount - 1].value, _componentSize);
+        if (cursor)
+            *cursor = _pointCount - 2;
         return;
     }
 
-    // Locate the points we are interpolating between using a binary search.
-    unsigned int index = determineIndex(time);
+    // Locate the points we are interpolating between, from the cursor if there is one
+    // or else using a binary search.
+    unsigned int index;
+    if (cursor)
+    {
+        index = determineIndex(time, *cursor);
+        *cursor = index;
+    }
+    else
+    {
+        index = determineIndex(time, 0, _pointCount - 1);
+    }
     
     Point* from = _points + index;
     Point* to = _points + (index + 1);
@@ -738,6 +757,19 @@ void Curve::evaluate(float time, float* dst) const
     interpolateLinear(t, from, to, dst);
 }
 
+void Curve::evaluateBatch(float time, Curve** curves, unsigned int curveCount, float* dst, unsigned int* cursors)
+{
+    assert(curves && dst);
+
+    for (unsigned int i = 0; i < curveCount; i++)
+    {
+        Curve* curve = curves[i];
+        assert(curve);
+        curve->evaluate(time, dst, cursors ? cursors + i : NULL);
+        dst += curve->_componentCount;
+    }
+}
+
 float Curve::lerp(float t, float from, float to)
 {
     return lerpInl(t, from, to);
@@ -1157,10 +1189,8 @@ void Curve::interpolateQuaternion(float s, float* from, float* to, float* dst) c
         Quaternion::slerp(to[0], to[1], to[2], to[3], from[0], from[1], from[2], from[3], s, dst, dst + 1, dst + 2, dst + 3);
 }
 
-int Curve::determineIndex(float time) const
+int Curve::determineIndex(float time, unsigned int min, unsigned int max) const
 {
-    unsigned int min = 0;
-    unsigned int max = _pointCount - 1;
     unsigned int mid = 0;
 
     // Do a binary search to determine the index.
@@ -1168,7 +1198,7 @@ int Curve::determineIndex(float time) const
     {
         mid = (min + max) >> 1;
 
-        if (time >= _points[mid].time && time <= _points[mid + 1].time)
+        if (time >= _points[mid].time && time < _points[mid + 1].time)
             return mid;
         else if (time < _points[mid].time)
             max = mid - 1;
@@ -1180,6 +1210,31 @@ int Curve::determineIndex(float time) const
     return -1;
 }
 
+unsigned int Curve::determineIndex(float time, unsigned int cursor) const
+{
+    // The time is strictly between the first and last points (see evaluate).
+    if (cursor >= _pointCount - 1)
+        return determineIndex(time, 0, _pointCount - 1);
+
+    if (time >= _points[cursor].time)
+    {
+        // Playing forwards: the time is usually in the same segment or the next one.
+        // A time equal to a point's time starts the segment from that point.
+        if (time < _points[cursor + 1].time)
+            return cursor;
+        if (time < _points[cursor + 2].time)
+            return cursor + 1;
+        return determineIndex(time, cursor + 2, _pointCount - 1);
+    }
+    else
+    {
+        // Playing backwards: the time is usually in the previous segment.
+        if (time >= _points[cursor - 1].time)
+            return cursor - 1;
+        return determineIndex(time, 0, cursor - 1);
+    }
+}
+
 int Curve::getInterpolationType(const char* curveId)
 {
     if (strcmp(curveId, "BEZIER") == 0)
@@ -352,6 +352,47 @@ public:
      */
     void evaluate(float time, float* dst) const;
 
+    /**
+     * Evaluates the curve at the given position value (between 0.0 and 1.0 inclusive),
+     * using and updating a playback cursor.
+     *
+     * The cursor holds the index of the point the curve was last evaluated from. When the
+     * curve is played back continuously the point is found in constant time from the cursor,
+     * and a binary search is only done after seeking. Each playback of the curve should
+     * use its own cursor, which should be initialized to zero.
+     *
+     * @param time The position to evaluate the curve at.
+     * @param dst The evaluated value of the curve at the given time.
+     * @param cursor The playback cursor, or NULL to search the whole curve.
+     * @script{ignore}
+     */
+    void evaluate(float time, float* dst, unsigned int* cursor) const;
+
+    /**
+     * Evaluates a number of curves at the same position value (between 0.0 and 1.0 inclusive).
+     *
+     * The values of the curves are written one after the other into the destination buffer,
+     * which must hold the sum of the component counts of the curves.
+     *
+     * @param time The position to evaluate the curves at.
+     * @param curves The curves to evaluate.
+     * @param curveCount The number of curves.
+     * @param dst The evaluated values of the curves at the given time.
+     * @param cursors The playback cursor of each curve (see evaluate), or NULL.
+     * @script{ignore}
+     */
+    static void evaluateBatch(float time, Curve** curves, unsigned int curveCount, float* dst, unsigned int* cursors);
+
+    /**
+     * Sets the offset for the beginning of a Quaternion piece of data within the curve's value span at the specified
+     * index. The next four components of data starting at the given index will be interpolated as a Quaternion.
+     * This function will assert an error if the given index is greater than the component size subtracted by the four components required
+     * to store a quaternion.
+     * 
+     * @param index The index of the Quaternion rotation data.
+     */
+    void setQuaternionOffset(unsigned int index);
+
     /**
      * Linear interpolation function.
      */
@@ -457,19 +498,16 @@ private:
     void interpolateQuaternion(float s, float* from, float* to, float* dst) const;
     
     /**
-     * Determines the current keyframe to interpolate from based on the specified time.
+     * Determines the current keyframe to interpolate from based on the specified time,
+     * searching the points between min and max.
      */ 
-    int determineIndex(float time) const;
+    int determineIndex(float time, unsigned int min, unsigned int max) const;
 
     /**
-     * Sets the offset for the beginning of a Quaternion piece of data within the curve's value span at the specified
-     * index. The next four components of data starting at the given index will be interpolated as a Quaternion.
-     * This function will assert an error if the given index is greater than the component size subtracted by the four components required
-     * to store a quaternion.
-     * 
-     * @param index The index of the Quaternion rotation data.
+     * Determines the current keyframe to interpolate from based on the specified time,
+     * starting from the keyframe at the playback cursor.
      */
-    void setQuaternionOffset(unsigned int index);
+    unsigned int determineIndex(float time, unsigned int cursor) const;
 
     /**
      * Gets the InterpolationType value for the given string ID
@@ -1,15 +1,52 @@
 #include "Base.h"
 #include "Effect.h"
 #include "FileSystem.h"
+#include "ResourceCache.h"
+#include "RenderQueue.h"
 
 #define OPENGL_ES_DEFINE  "#define OPENGL_ES\n"
 
 namespace gameplay
 {
 
-// Cache of unique effects.
-static std::map<std::string, Effect*> __effectCache;
 static Effect* __currentEffect = NULL;
+static std::list<std::string> __uniformNameStrings;
+static std::vector<const char*> __uniformNames;
+static std::vector<unsigned int> __uniformNameHashes;
+static std::vector<unsigned int> __uniformHandleSlots;
+
+/**
+ * Hashes a uniform name with FNV-1a.
+ */
+static unsigned int hashUniformName(const char* name)
+{
+    unsigned int hash = 2166136261u;
+    for (const char* c = name; *c; ++c)
+    {
+        hash ^= (unsigned char)*c;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * Finds the slot of the handle table that holds a name, or the empty slot where it belongs.
+ *
+ * Slots hold handles plus one, so that zero marks an empty slot.
+ */
+static unsigned int findUniformHandleSlot(const char* name, unsigned int hash)
+{
+    unsigned int mask = (unsigned int)__uniformHandleSlots.size() - 1;
+    unsigned int slot = hash & mask;
+    while (__uniformHandleSlots[slot] != 0)
+    {
+        unsigned int handle = __uniformHandleSlots[slot] - 1;
+        if (__uniformNameHashes[handle] == hash && strcmp(__uniformNames[handle], name) == 0)
+            break;
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
 
 Effect::Effect() : _program(0)
 {
@@ -18,7 +55,7 @@ Effect::Effect() : _program(0)
 Effect::~Effect()
 {
     // Remove this effect from the cache.
-    __effectCache.erase(_id);
+    ResourceCache::remove(this);
 
     // Free uniforms.
     for (std::map<std::string, Uniform*>::iterator itr = _uniforms.begin(); itr != _uniforms.end(); itr++)
@@ -54,13 +91,20 @@ Effect* Effect::createFromFile(const char* vshPath, const char* fshPath, const c
     {
         uniqueId += defines;
     }
-    std::map<std::string, Effect*>::const_iterator itr = __effectCache.find(uniqueId);
-    if (itr != __effectCache.end())
+    std::string key = ResourceCache::getPathKey(vshPath);
+    key += ';';
+    key += ResourceCache::getPathKey(fshPath);
+    key += ';';
+    if (defines)
+    {
+        key += defines;
+    }
+    Effect* cached = static_cast<Effect*>(ResourceCache::find(ResourceCache::EFFECT, key));
+    if (cached)
     {
         // Found an exiting effect with this id, so increase its ref count and return it.
-        GP_ASSERT(itr->second);
-        itr->second->addRef();
-        return itr->second;
+        cached->addRef();
+        return cached;
     }
 
     // Read source from file.
@@ -91,7 +135,7 @@ Effect* Effect::createFromFile(const char* vshPath, const char* fshPath, const c
     {
         // Store this effect in the cache.
         effect->_id = uniqueId;
-        __effectCache[uniqueId] = effect;
+        ResourceCache::add(ResourceCache::EFFECT, key, effect, 0);
     }
 
     return effect;
@@ -421,11 +465,17 @@ Effect* Effect::createFromSource(const char* vshPath, const char* vshSource, con
                 Uniform* uniform = new Uniform();
                 uniform->_effect = effect;
                 uniform->_name = uniformName;
+                uniform->_handle = getUniformHandle(uniformName);
                 uniform->_location = uniformLocation;
                 uniform->_type = uniformType;
                 uniform->_index = uniformType == GL_SAMPLER_2D ? (samplerIndex++) : 0;
 
                 effect->_uniforms[uniformName] = uniform;
+                if (uniform->_handle >= effect->_uniformsByHandle.size())
+                {
+                    effect->_uniformsByHandle.resize(uniform->_handle + 1, NULL);
+                }
+                effect->_uniformsByHandle[uniform->_handle] = uniform;
             }
             SAFE_DELETE_ARRAY(uniformName);
         }
@@ -464,6 +514,49 @@ Uniform* Effect::getUniform(unsigned int index) const
     return NULL;
 }
 
+Uniform* Effect::getUniformByHandle(unsigned int handle) const
+{
+    return (handle < _uniformsByHandle.size() ? _uniformsByHandle[handle] : NULL);
+}
+
+unsigned int Effect::getUniformHandle(const char* name)
+{
+    GP_ASSERT(name);
+
+    // Names are looked up in an open addressing table, which does not allocate unless the name is new.
+    if (__uniformHandleSlots.empty())
+        __uniformHandleSlots.resize(256, 0);
+
+    unsigned int hash = hashUniformName(name);
+    unsigned int slot = findUniformHandleSlot(name, hash);
+    if (__uniformHandleSlots[slot] != 0)
+    {
+        return __uniformHandleSlots[slot] - 1;
+    }
+
+    unsigned int handle = (unsigned int)__uniformNames.size();
+    __uniformNameStrings.push_back(name);
+    __uniformNames.push_back(__uniformNameStrings.back().c_str());
+    __uniformNameHashes.push_back(hash);
+    __uniformHandleSlots[slot] = handle + 1;
+
+    // Keep the table at most half full.
+    if (__uniformNames.size() * 2 > __uniformHandleSlots.size())
+    {
+        __uniformHandleSlots.assign(__uniformHandleSlots.size() * 2, 0);
+        for (unsigned int i = 0, count = (unsigned int)__uniformNames.size(); i < count; ++i)
+        {
+            __uniformHandleSlots[findUniformHandleSlot(__uniformNames[i], __uniformNameHashes[i])] = i + 1;
+        }
+    }
+    return handle;
+}
+
+const char* Effect::getUniformName(unsigned int handle)
+{
+    return (handle < __uniformNames.size() ? __uniformNames[handle] : NULL);
+}
+
 unsigned int Effect::getUniformCount() const
 {
     return (unsigned int)_uniforms.size();
@@ -472,79 +565,115 @@ unsigned int Effect::getUniformCount() const
 void Effect::setValue(Uniform* uniform, float value)
 {
     GP_ASSERT(uniform);
-    GL_ASSERT( glUniform1f(uniform->_location, value) );
+    if (uniform->update(&value, sizeof(float)))
+    {
+        GL_ASSERT( glUniform1f(uniform->_location, value) );
+    }
 }
 
 void Effect::setValue(Uniform* uniform, const float* values, unsigned int count)
 {
     GP_ASSERT(uniform);
     GP_ASSERT(values);
-    GL_ASSERT( glUniform1fv(uniform->_location, count, values) );
+    if (uniform->update(values, count * sizeof(float)))
+    {
+        GL_ASSERT( glUniform1fv(uniform->_location, count, values) );
+    }
 }
 
 void Effect::setValue(Uniform* uniform, int value)
 {
     GP_ASSERT(uniform);
-    GL_ASSERT( glUniform1i(uniform->_location, value) );
+    if (uniform->update(&value, sizeof(int)))
+    {
+        GL_ASSERT( glUniform1i(uniform->_location, value) );
+    }
 }
 
 void Effect::setValue(Uniform* uniform, const int* values, unsigned int count)
 {
     GP_ASSERT(uniform);
     GP_ASSERT(values);
-    GL_ASSERT( glUniform1iv(uniform->_location, count, values) );
+    if (uniform->update(values, count * sizeof(int)))
+    {
+        GL_ASSERT( glUniform1iv(uniform->_location, count, values) );
+    }
 }
 
 void Effect::setValue(Uniform* uniform, const Matrix& value)
 {
     GP_ASSERT(uniform);
-    GL_ASSERT( glUniformMatrix4fv(uniform->_location, 1, GL_FALSE, value.m) );
+    if (uniform->update(value.m, sizeof(Matrix)))
+    {
+        GL_ASSERT( glUniformMatrix4fv(uniform->_location, 1, GL_FALSE, value.m) );
+    }
 }
 
 void Effect::setValue(Uniform* uniform, const Matrix* values, unsigned int count)
 {
     GP_ASSERT(uniform);
     GP_ASSERT(values);
-    GL_ASSERT( glUniformMatrix4fv(uniform->_location, count, GL_FALSE, (GLfloat*)values) );
+    if (uniform->update(values, count * sizeof(Matrix)))
+    {
+        GL_ASSERT( glUniformMatrix4fv(uniform->_location, count, GL_FALSE, (GLfloat*)values) );
+    }
 }
 
 void Effect::setValue(Uniform* uniform, const Vector2& value)
 {
     GP_ASSERT(uniform);
-    GL_ASSERT( glUniform2f(uniform->_location, value.x, value.y) );
+    if (uniform->update(&value.x, sizeof(Vector2)))
+    {
+        GL_ASSERT( glUniform2f(uniform->_location, value.x, value.y) );
+    }
 }
 
 void Effect::setValue(Uniform* uniform, const Vector2* values, unsigned int count)
 {
     GP_ASSERT(uniform);
     GP_ASSERT(values);
-    GL_ASSERT( glUniform2fv(uniform->_location, count, (GLfloat*)values) );
+    if (uniform->update(values, count * sizeof(Vector2)))
+    {
+        GL_ASSERT( glUniform2fv(uniform->_location, count, (GLfloat*)values) );
+    }
 }
 
 void Effect::setValue(Uniform* uniform, const Vector3& value)
 {
     GP_ASSERT(uniform);
-    GL_ASSERT( glUniform3f(uniform->_location, value.x, value.y, value.z) );
+    if (uniform->update(&value.x, sizeof(Vector3)))
+    {
+        GL_ASSERT( glUniform3f(uniform->_location, value.x, value.y, value.z) );
+    }
 }
 
 void Effect::setValue(Uniform* uniform, const Vector3* values, unsigned int count)
 {
     GP_ASSERT(uniform);
     GP_ASSERT(values);
-    GL_ASSERT( glUniform3fv(uniform->_location, count, (GLfloat*)values) );
+    if (uniform->update(values, count * sizeof(Vector3)))
+    {
+        GL_ASSERT( glUniform3fv(uniform->_location, count, (GLfloat*)values) );
+    }
 }
 
 void Effect::setValue(Uniform* uniform, const Vector4& value)
 {
     GP_ASSERT(uniform);
-    GL_ASSERT( glUniform4f(uniform->_location, value.x, value.y, value.z, value.w) );
+    if (uniform->update(&value.x, sizeof(Vector4)))
+    {
+        GL_ASSERT( glUniform4f(uniform->_location, value.x, value.y, value.z, value.w) );
+    }
 }
 
 void Effect::setValue(Uniform* uniform, const Vector4* values, unsigned int count)
 {
     GP_ASSERT(uniform);
     GP_ASSERT(values);
-    GL_ASSERT( glUniform4fv(uniform->_location, count, (GLfloat*)values) );
+    if (uniform->update(values, count * sizeof(Vector4)))
+    {
+        GL_ASSERT( glUniform4fv(uniform->_location, count, (GLfloat*)values) );
+    }
 }
 
 void Effect::setValue(Uniform* uniform, const Texture::Sampler* sampler)
@@ -553,17 +682,25 @@ void Effect::setValue(Uniform* uniform, const Texture::Sampler* sampler)
     GP_ASSERT(uniform->_type == GL_SAMPLER_2D);
     GP_ASSERT(sampler);
 
-    GL_ASSERT( glActiveTexture(GL_TEXTURE0 + uniform->_index) );
+    Texture::setActiveUnit(uniform->_index);
 
     // Bind the sampler - this binds the texture and applies sampler state
     const_cast<Texture::Sampler*>(sampler)->bind();
 
-    GL_ASSERT( glUniform1i(uniform->_location, uniform->_index) );
+    if (uniform->update(&uniform->_index, sizeof(int)))
+    {
+        GL_ASSERT( glUniform1i(uniform->_location, uniform->_index) );
+    }
 }
 
 void Effect::bind()
 {
-   GL_ASSERT( glUseProgram(_program) );
+    // Programs are only switched through here, so a bound effect does not need binding again.
+    if (__currentEffect == this)
+        return;
+
+    GL_ASSERT( glUseProgram(_program) );
+    ++RenderQueue::_frameCounters.programSwitches;
 
     __currentEffect = this;
 }
@@ -574,7 +711,7 @@ Effect* Effect::getCurrentEffect()
 }
 
 Uniform::Uniform() :
-    _location(-1), _type(0), _index(0)
+    _handle(0), _location(-1), _type(0), _index(0), _version(0)
 {
 }
 
@@ -593,9 +730,31 @@ const char* Uniform::getName() const
     return _name.c_str();
 }
 
+unsigned int Uniform::getHandle() const
+{
+    return _handle;
+}
+
 const GLenum Uniform::getType() const
 {
     return _type;
 }
 
+bool Uniform::update(const void* value, size_t size)
+{
+    GP_ASSERT(value || size == 0);
+
+    // A program keeps its uniform values, so a value it already holds is not uploaded again.
+    if (_value.size() == size && (size == 0 || memcmp(&_value[0], value, size) == 0))
+    {
+        ++RenderQueue::_frameCounters.skippedUniformUploads;
+        return false;
+    }
+
+    _value.assign(static_cast<const unsigned char*>(value), static_cast<const unsigned char*>(value) + size);
+    _version = 0;
+    ++RenderQueue::_frameCounters.uniformUploads;
+    return true;
+}
+
 }
@@ -82,6 +82,37 @@ public:
      */
     Uniform* getUniform(unsigned int index) const;
 
+    /**
+     * Returns the uniform whose name has the specified handle.
+     *
+     * @param handle The name handle of the uniform to return, from getUniformHandle.
+     *
+     * @return The uniform, or NULL if no such uniform exists.
+     */
+    Uniform* getUniformByHandle(unsigned int handle) const;
+
+    /**
+     * Returns the handle of a uniform name.
+     *
+     * Names are interned, so a name has the same handle in every effect and render state.
+     * Looking uniforms and material parameters up by handle avoids comparing their names.
+     * Looking up a name that was interned before does not allocate memory.
+     *
+     * @param name The uniform name.
+     *
+     * @return The handle of the name.
+     */
+    static unsigned int getUniformHandle(const char* name);
+
+    /**
+     * Returns the uniform name with the specified handle.
+     *
+     * @param handle The handle of the name, from getUniformHandle.
+     *
+     * @return The name, or NULL if the handle is invalid.
+     */
+    static const char* getUniformName(unsigned int handle);
+
     /**
      * Returns the number of active uniforms in this effect.
      * 
@@ -234,6 +265,7 @@ private:
     std::string _id;
     std::map<std::string, VertexAttribute> _vertexAttributes;
     std::map<std::string, Uniform*> _uniforms;
+    std::vector<Uniform*> _uniformsByHandle;
     static Uniform _emptyUniform;
 };
 
@@ -243,6 +275,7 @@ private:
 class Uniform
 {
     friend class Effect;
+    friend class MaterialParameter;
 
 public:
 
@@ -267,6 +300,14 @@ public:
      */
     Effect* getEffect() const;
 
+    /**
+     * Returns the handle of this uniform's name.
+     *
+     * @return The name handle of the uniform.
+     * @see Effect::getUniformHandle
+     */
+    unsigned int getHandle() const;
+
 private:
 
     /**
@@ -289,11 +330,24 @@ private:
      */
     Uniform& operator=(const Uniform&);
 
+    /**
+     * Updates the copy of the value last uploaded to this uniform.
+     *
+     * @param value The value to upload.
+     * @param size The size of the value in bytes.
+     *
+     * @return false if the uniform already holds the value, so that it need not be uploaded.
+     */
+    bool update(const void* value, size_t size);
+
     std::string _name;
+    unsigned int _handle;
     GLint _location;
     GLenum _type;
     unsigned int _index;
     Effect* _effect;
+    std::vector<unsigned char> _value;
+    unsigned int _version;
 };
 
 }
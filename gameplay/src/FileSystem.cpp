@@ -9,10 +9,12 @@
     #include <windows.h>
     #include <tchar.h>
     #include <stdio.h>
+    #include <io.h>
     #define gp_stat _stat
     #define gp_stat_struct struct stat
 #else
     #include <dirent.h>
+    #include <sys/mman.h>
     #define gp_stat stat
     #define gp_stat_struct struct stat
 #endif
@@ -314,6 +316,67 @@ char* FileSystem::readAll(const char* filePath, int* fileSize)
     return buffer;
 }
 
+const char* FileSystem::mapFile(const char* filePath, unsigned int* fileSize)
+{
+    GP_ASSERT(filePath);
+    GP_ASSERT(fileSize);
+
+    *fileSize = 0;
+
+    FILE* file = openFile(filePath, "rb");
+    if (file == NULL)
+    {
+        return NULL;
+    }
+
+    // Obtain file length.
+    const char* data = NULL;
+    if (fseek(file, 0, SEEK_END) == 0)
+    {
+        long size = ftell(file);
+        if (size > 0)
+        {
+            // The mapping stays valid after the file is closed.
+#ifdef WIN32
+            HANDLE mapping = CreateFileMapping((HANDLE)_get_osfhandle(_fileno(file)), NULL, PAGE_READONLY, 0, 0, NULL);
+            if (mapping)
+            {
+                data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                CloseHandle(mapping);
+            }
+#else
+            void* mapping = mmap(NULL, (size_t)size, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+            if (mapping != MAP_FAILED)
+            {
+                data = (const char*)mapping;
+            }
+#endif
+            if (data)
+            {
+                *fileSize = (unsigned int)size;
+            }
+        }
+    }
+
+    if (fclose(file) != 0)
+    {
+        GP_ERROR("Failed to close file '%s'.", filePath);
+    }
+    return data;
+}
+
+void FileSystem::unmapFile(const char* data, unsigned int fileSize)
+{
+    if (data == NULL)
+        return;
+
+#ifdef WIN32
+    UnmapViewOfFile(data);
+#else
+    munmap((void*)data, fileSize);
+#endif
+}
+
 bool FileSystem::isAbsolutePath(const char* filePath)
 {
     if (filePath == 0 || filePath[0] == '\0')
@@ -137,6 +137,30 @@ public:
      */
     static char* readAll(const char* filePath, int* fileSize = NULL);
 
+    /**
+     * Maps the entire contents of the specified file into memory for reading.
+     *
+     * The file is opened as with openFile and stays mapped until unmapFile is called.
+     * The mapped data is read-only and must not be modified.
+     *
+     * @param filePath The path to the file to be mapped.
+     * @param fileSize Set to the size of the file in bytes.
+     * 
+     * @return A pointer to the mapped contents of the file, or NULL if the file
+     *      could not be mapped (for example, if it is empty).
+     * @script{ignore}
+     */
+    static const char* mapFile(const char* filePath, unsigned int* fileSize);
+
+    /**
+     * Unmaps a file that was mapped with mapFile.
+     *
+     * @param data The pointer returned by mapFile.
+     * @param fileSize The size of the mapped file in bytes.
+     * @script{ignore}
+     */
+    static void unmapFile(const char* data, unsigned int fileSize);
+
     /**
      * Determines if the file path is an absolute path for the current platform.
      * 
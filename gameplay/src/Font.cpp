@@ -3,6 +3,7 @@
 #include "Game.h"
 #include "FileSystem.h"
 #include "Bundle.h"
+#include "ResourceCache.h"
 
 // Default font vertex shader
 #define FONT_VSH \
@@ -33,29 +34,143 @@
         "gl_FragColor.a = texture2D(u_texture, v_texCoord).a;\n" \
     "}"
 
+// Distance field font fragment shader, where glyph outlines are at a distance of 0.5
+#define FONT_DISTANCE_FIELD_FSH \
+    "#ifdef OPENGL_ES\n" \
+    "#extension GL_OES_standard_derivatives : enable\n" \
+    "precision highp float;\n" \
+    "#endif\n" \
+    "varying vec2 v_texCoord;\n" \
+    "varying vec4 v_color;\n" \
+    "uniform sampler2D u_texture;\n" \
+    "uniform vec4 u_outlineColor;\n" \
+    "uniform float u_outlineWidth;\n" \
+    "uniform vec4 u_shadowColor;\n" \
+    "uniform vec2 u_shadowOffset;\n" \
+    "vec4 over(vec4 top, vec4 bottom)\n" \
+    "{\n" \
+        "float alpha = top.a + bottom.a * (1.0 - top.a);\n" \
+        "return vec4((top.rgb * top.a + bottom.rgb * bottom.a * (1.0 - top.a)) / max(alpha, 0.0001), alpha);\n" \
+    "}\n" \
+    "void main()\n" \
+    "{\n" \
+        "float distance = texture2D(u_texture, v_texCoord).a;\n" \
+    "#if defined(OPENGL_ES) && !defined(GL_OES_standard_derivatives)\n" \
+        "float smoothing = 0.05;\n" \
+    "#else\n" \
+        "float smoothing = max(0.5 * fwidth(distance), 0.001);\n" \
+    "#endif\n" \
+        "float edge = 0.5 - u_outlineWidth;\n" \
+        "vec4 color = vec4(v_color.rgb, v_color.a * smoothstep(0.5 - smoothing, 0.5 + smoothing, distance));\n" \
+        "color = over(color, vec4(u_outlineColor.rgb, u_outlineColor.a * v_color.a * smoothstep(edge - smoothing, edge + smoothing, distance)));\n" \
+        "float shadow = texture2D(u_texture, v_texCoord - u_shadowOffset).a;\n" \
+        "gl_FragColor = over(color, vec4(u_shadowColor.rgb, u_shadowColor.a * v_color.a * smoothstep(edge - smoothing, edge + smoothing, shadow)));\n" \
+    "}"
+
+// Default number of text layouts kept by a font
+#define FONT_LAYOUT_CACHE_SIZE 128
+
+// Number of character codes in a block of the glyph lookup table
+#define FONT_GLYPH_BLOCK_SIZE 256
+
 namespace gameplay
 {
 
-static std::vector<Font*> __fontCache;
 
 static Effect* __fontEffect = NULL;
+static Effect* __fontDistanceFieldEffect = NULL;
+
+/**
+ * Decodes the UTF-8 character that starts at a byte of text.
+ *
+ * Bytes that continue a character decode to 0, as do invalid sequences, so that loops
+ * over the bytes of text in either direction find each character once, at its first byte.
+ */
+static unsigned int decodeCharacter(const char* text)
+{
+    const unsigned char* bytes = (const unsigned char*)text;
+    unsigned int code = bytes[0];
+    unsigned int count;
+    if (code < 0x80)
+        return code;
+    else if (code < 0xC0)
+        return 0;
+    else if (code < 0xE0)
+    {
+        code &= 0x1F;
+        count = 1;
+    }
+    else if (code < 0xF0)
+    {
+        code &= 0x0F;
+        count = 2;
+    }
+    else if (code < 0xF8)
+    {
+        code &= 0x07;
+        count = 3;
+    }
+    else
+        return 0;
+
+    // Stop at the first byte that does not continue the character, including the terminator.
+    for (unsigned int i = 1; i <= count; ++i)
+    {
+        if ((bytes[i] & 0xC0) != 0x80)
+            return 0;
+        code = (code << 6) | (bytes[i] & 0x3F);
+    }
+    return code;
+}
+
+static bool equals(const Rectangle& r1, const Rectangle& r2)
+{
+    return r1.x == r2.x && r1.y == r2.y && r1.width == r2.width && r1.height == r2.height;
+}
+
+static unsigned int hash(unsigned int h, const void* data, size_t size)
+{
+    // FNV-1a.
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; ++i)
+    {
+        h ^= bytes[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static unsigned int hashLayout(const char* text, const Rectangle& area, unsigned int size, Font::Justify justify,
+                               bool wrap, bool rightToLeft, const Rectangle* clip)
+{
+    unsigned int h = hash(2166136261u, text, strlen(text));
+    h = hash(h, &area, sizeof(Rectangle));
+    if (clip)
+        h = hash(h, clip, sizeof(Rectangle));
+    unsigned int flags = (wrap ? 1 : 0) | (rightToLeft ? 2 : 0) | (clip ? 4 : 0);
+    h = hash(h, &flags, sizeof(flags));
+    h = hash(h, &size, sizeof(size));
+    return hash(h, &justify, sizeof(justify));
+}
 
 Font::Font() :
-    _style(PLAIN), _size(0), _glyphs(NULL), _glyphCount(0), _texture(NULL), _batch(NULL)
+    _style(PLAIN), _size(0), _format(BITMAP), _spread(0), _glyphs(NULL), _glyphCount(0), _texture(NULL), _batch(NULL),
+    _layoutCacheSize(FONT_LAYOUT_CACHE_SIZE), _layoutUse(0), _measured(false)
 {
 }
 
 Font::~Font()
 {
     // Remove this Font from the font cache.
-    std::vector<Font*>::iterator itr = std::find(__fontCache.begin(), __fontCache.end(), this);
-    if (itr != __fontCache.end())
-    {
-        __fontCache.erase(itr);
-    }
+    ResourceCache::remove(this);
 
+    trimLayouts(0);
     SAFE_DELETE(_batch);
     SAFE_DELETE_ARRAY(_glyphs);
+    for (size_t i = 0, count = _glyphBlocks.size(); i < count; ++i)
+    {
+        SAFE_DELETE_ARRAY(_glyphBlocks[i]);
+    }
     SAFE_RELEASE(_texture);
 }
 
@@ -63,17 +178,21 @@ Font* Font::create(const char* path, const char* id)
 {
     GP_ASSERT(path);
 
-    // Search the font cache for a font with the given path and ID.
-    for (size_t i = 0, count = __fontCache.size(); i < count; ++i)
+    // Search the font cache for a font with the given path and ID. Fonts loaded
+    // without an ID are cached by their path as well as by their path and ID.
+    std::string pathKey = ResourceCache::getPathKey(path);
+    std::string key = pathKey;
+    if (id)
     {
-        Font* f = __fontCache[i];
-        GP_ASSERT(f);
-        if (f->_path == path && (id == NULL || f->_id == id))
-        {
-            // Found a match.
-            f->addRef();
-            return f;
-        }
+        key += '#';
+        key += id;
+    }
+    Font* font = static_cast<Font*>(ResourceCache::find(ResourceCache::FONT, key));
+    if (font)
+    {
+        // Found a match.
+        font->addRef();
+        return font;
     }
 
     // Load the bundle.
@@ -84,30 +203,39 @@ Font* Font::create(const char* path, const char* id)
         return NULL;
     }
 
-    Font* font = NULL;
     if (id == NULL)
     {
         // Get the ID of the first object in the bundle (assume it's a Font).
-        const char* id;
         if ((id = bundle->getObjectId(0)) == NULL)
         {
             GP_ERROR("Failed to load font without explicit id; the first object in the font bundle has a null id.");
+            SAFE_RELEASE(bundle);
             return NULL;
         }
+    }
 
-        // Load the font using the ID of the first object in the bundle.
-        font = bundle->loadFont(bundle->getObjectId(0));
+    // The font may already be loaded with its explicit ID.
+    std::string idKey = pathKey + '#' + id;
+    font = static_cast<Font*>(ResourceCache::find(ResourceCache::FONT, idKey));
+    if (font)
+    {
+        font->addRef();
     }
     else
     {
         // Load the font with the given ID.
         font = bundle->loadFont(id);
+        if (font)
+        {
+            // Add this font to the cache.
+            size_t size = font->_texture ? (size_t)font->_texture->getWidth() * font->_texture->getHeight() : 0;
+            ResourceCache::add(ResourceCache::FONT, idKey, font, size);
+        }
     }
 
-    if (font)
+    if (font && key != idKey)
     {
-        // Add this font to the cache.
-        __fontCache.push_back(font);
+        ResourceCache::add(ResourceCache::FONT, key, font, 0);
     }
 
     SAFE_RELEASE(bundle);
@@ -115,17 +243,19 @@ Font* Font::create(const char* path, const char* id)
     return font;
 }
 
-Font* Font::create(const char* family, Style style, unsigned int size, Glyph* glyphs, int glyphCount, Texture* texture)
+Font* Font::create(const char* family, Style style, unsigned int size, Glyph* glyphs, int glyphCount, Texture* texture,
+                   Format format, unsigned int spread)
 {
     GP_ASSERT(family);
     GP_ASSERT(glyphs);
     GP_ASSERT(texture);
 
     // Create the effect for the font's sprite batch.
-    if (__fontEffect == NULL)
+    Effect*& effect = format == DISTANCE_FIELD ? __fontDistanceFieldEffect : __fontEffect;
+    if (effect == NULL)
     {
-        __fontEffect = Effect::createFromSource(FONT_VSH, FONT_FSH);
-        if (__fontEffect == NULL)
+        effect = Effect::createFromSource(FONT_VSH, format == DISTANCE_FIELD ? FONT_DISTANCE_FIELD_FSH : FONT_FSH);
+        if (effect == NULL)
         {
             GP_ERROR("Failed to create effect for font.");
             SAFE_RELEASE(texture);
@@ -134,14 +264,14 @@ Font* Font::create(const char* family, Style style, unsigned int size, Glyph* gl
     }
     else
     {
-        __fontEffect->addRef();
+        effect->addRef();
     }
 
     // Create batch for the font.
-    SpriteBatch* batch = SpriteBatch::create(texture, __fontEffect, 128);
+    SpriteBatch* batch = SpriteBatch::create(texture, effect, 128);
     
-    // Release __fontEffect since the SpriteBatch keeps a reference to it
-    SAFE_RELEASE(__fontEffect);
+    // Release the effect since the SpriteBatch keeps a reference to it
+    SAFE_RELEASE(effect);
 
     if (batch == NULL)
     {
@@ -153,6 +283,16 @@ Font* Font::create(const char* family, Style style, unsigned int size, Glyph* gl
     Texture::Sampler* sampler = batch->getSampler();
     sampler->setFilterMode(Texture::LINEAR, Texture::LINEAR);
 
+    // Draw distance field glyphs without an outline or a shadow until they are set.
+    if (format == DISTANCE_FIELD)
+    {
+        Material* material = batch->getMaterial();
+        material->getParameter("u_outlineColor")->setValue(Vector4::zero());
+        material->getParameter("u_outlineWidth")->setValue(0.0f);
+        material->getParameter("u_shadowColor")->setValue(Vector4::zero());
+        material->getParameter("u_shadowOffset")->setValue(Vector2::zero());
+    }
+
     // Increase the ref count of the texture to retain it.
     texture->addRef();
 
@@ -160,6 +300,8 @@ Font* Font::create(const char* family, Style style, unsigned int size, Glyph* gl
     font->_family = family;
     font->_style = style;
     font->_size = size;
+    font->_format = format;
+    font->_spread = format == DISTANCE_FIELD ? spread : 0;
     font->_texture = texture;
     font->_batch = batch;
 
@@ -168,6 +310,24 @@ Font* Font::create(const char* family, Style style, unsigned int size, Glyph* gl
     memcpy(font->_glyphs, glyphs, sizeof(Glyph) * glyphCount);
     font->_glyphCount = glyphCount;
 
+    // Index the glyphs by code in a table of blocks of codes, allocating only the blocks
+    // that have glyphs, so that the characters of any script are looked up directly.
+    for (int i = 0; i < glyphCount; ++i)
+    {
+        unsigned int code = glyphs[i].code;
+        if (code == 0)
+            continue;
+        unsigned int block = code / FONT_GLYPH_BLOCK_SIZE;
+        if (block >= font->_glyphBlocks.size())
+            font->_glyphBlocks.resize(block + 1, NULL);
+        if (font->_glyphBlocks[block] == NULL)
+        {
+            font->_glyphBlocks[block] = new int[FONT_GLYPH_BLOCK_SIZE];
+            std::fill(font->_glyphBlocks[block], font->_glyphBlocks[block] + FONT_GLYPH_BLOCK_SIZE, -1);
+        }
+        font->_glyphBlocks[block][code % FONT_GLYPH_BLOCK_SIZE] = i;
+    }
+
     return font;
 }
 
@@ -176,6 +336,11 @@ unsigned int Font::getSize()
     return _size;
 }
 
+Font::Format Font::getFormat() const
+{
+    return _format;
+}
+
 void Font::start()
 {
     GP_ASSERT(_batch);
@@ -193,6 +358,7 @@ Font::Text* Font::createText(const char* text, const Rectangle& area, const Vect
         size = _size;
     GP_ASSERT(_size);
     float scale = (float)size / _size;
+    float pad = _spread * scale;
     int yPos = area.y;
     const float areaHeight = area.height - size;
     std::vector<int> xPositions;
@@ -203,6 +369,7 @@ Font::Text* Font::createText(const char* text, const Rectangle& area, const Vect
     Text* batch = new Text(text);
     GP_ASSERT(batch->_vertices);
     GP_ASSERT(batch->_indices);
+    batch->_color = color;
 
     int xPos = area.x;
     std::vector<int>::const_iterator xPositionsIt = xPositions.begin();
@@ -272,7 +439,7 @@ Font::Text* Font::createText(const char* text, const Rectangle& area, const Vect
         }
 
         bool draw = true;
-        if (yPos < area.y)
+        if (yPos < area.y - size)
         {
             // Skip drawing until line break or wrap.
             draw = false;
@@ -285,14 +452,10 @@ Font::Text* Font::createText(const char* text, const Rectangle& area, const Vect
 
         for (int i = startIndex; i < (int)tokenLength && i >= 0; i += iteration)
         {
-            char c = token[i];
-            int glyphIndex = c - 32; // HACK for ASCII
-        
-            if (glyphIndex >= 0 && glyphIndex < (int)_glyphCount)
+            const Glyph* g = getGlyph(decodeCharacter(&token[i]));
+            if (g)
             {
-                Glyph& g = _glyphs[glyphIndex];
-
-                if (xPos + (int)(g.width*scale) > area.x + area.width)
+                if (xPos + (int)(g->width*scale) > area.x + area.width)
                 {
                     // Truncate this line and go on to the next one.
                     truncated = true;
@@ -300,17 +463,18 @@ Font::Text* Font::createText(const char* text, const Rectangle& area, const Vect
                 }
                 else if (xPos >= area.x)
                 {
-                    // Draw this character.
-                    if (draw)
+                    // Draw this character, unless it is clipped out entirely, with the spread around distance field glyphs.
+                    float x = xPos - pad;
+                    float y = yPos - pad;
+                    float width = g->width * scale + 2 * pad;
+                    float height = size + 2 * pad;
+                    float u1 = g->uvs[0];
+                    float v1 = g->uvs[1];
+                    float u2 = g->uvs[2];
+                    float v2 = g->uvs[3];
+                    if (draw && (clip == NULL || _batch->clipSprite(*clip, x, y, width, height, u1, v1, u2, v2)))
                     {
-                        if (clip)
-                        {
-                            _batch->addSprite(xPos, yPos, g.width * scale, size, g.uvs[0], g.uvs[1], g.uvs[2], g.uvs[3], color, *clip, &batch->_vertices[batch->_vertexCount]);
-                        }
-                        else
-                        {
-                            _batch->addSprite(xPos, yPos, g.width * scale, size, g.uvs[0], g.uvs[1], g.uvs[2], g.uvs[3], color, &batch->_vertices[batch->_vertexCount]);
-                        }
+                        _batch->addSprite(x, y, width, height, u1, v1, u2, v2, color, &batch->_vertices[batch->_vertexCount]);
 
                         if (batch->_vertexCount == 0)
                         {
@@ -342,7 +506,7 @@ Font::Text* Font::createText(const char* text, const Rectangle& area, const Vect
 
                     }
                 }
-                xPos += (int)(g.width)*scale + (size >> 3);
+                xPos += (int)(g->width)*scale + (size >> 3);
             }
         }
 
@@ -417,6 +581,8 @@ void Font::drawText(Text* text)
     GP_ASSERT(_batch);
     GP_ASSERT(text->_vertices);
     GP_ASSERT(text->_indices);
+    if (text->_vertexCount == 0)
+        return;
     _batch->draw(text->_vertices, text->_vertexCount, text->_indices, text->_indexCount);
 }
 
@@ -427,6 +593,7 @@ void Font::drawText(const char* text, int x, int y, const Vector4& color, unsign
     GP_ASSERT(_size);
     GP_ASSERT(text);
     float scale = (float)size / _size;
+    float pad = _spread * scale;
     const char* cursor = NULL;
 
     if (rightToLeft)
@@ -517,12 +684,11 @@ void Font::drawText(const char* text, int x, int y, const Vector4& color, unsign
                 xPos += (size >> 1)*4;
                 break;
             default:
-                int index = c - 32; // HACK for ASCII
-                if (index >= 0 && index < (int)_glyphCount)
+                const Glyph* g = getGlyph(decodeCharacter(rightToLeft ? &cursor[i] : &text[i]));
+                if (g)
                 {
-                    Glyph& g = _glyphs[index];
-                    _batch->draw(xPos, yPos, g.width * scale, size, g.uvs[0], g.uvs[1], g.uvs[2], g.uvs[3], color);
-                    xPos += floor(g.width * scale + (float)(size >> 3));
+                    _batch->draw(xPos - pad, yPos - pad, g->width * scale + 2 * pad, size + 2 * pad, g->uvs[0], g->uvs[1], g->uvs[2], g->uvs[3], color);
+                    xPos += floor(g->width * scale + (float)(size >> 3));
                     break;
                 }
                 break;
@@ -552,7 +718,15 @@ void Font::drawText(const char* text, const Rectangle& area, const Vector4& colo
     if (size == 0)
         size = _size;
     GP_ASSERT(_size);
+
+    if (_layoutCacheSize > 0)
+    {
+        if (text[0] != 0)
+            drawText(getLayout(text, area, color, size, justify, wrap, rightToLeft, clip));
+        return;
+    }
     float scale = (float)size / _size;
+    float pad = _spread * scale;
     int yPos = area.y;
     const float areaHeight = area.height - size;
     std::vector<int> xPositions;
@@ -644,14 +818,10 @@ void Font::drawText(const char* text, const Rectangle& area, const Vector4& colo
         GP_ASSERT(_batch);
         for (int i = startIndex; i < (int)tokenLength && i >= 0; i += iteration)
         {
-            char c = token[i];
-            int glyphIndex = c - 32; // HACK for ASCII
-        
-            if (glyphIndex >= 0 && glyphIndex < (int)_glyphCount)
+            const Glyph* g = getGlyph(decodeCharacter(&token[i]));
+            if (g)
             {
-                Glyph& g = _glyphs[glyphIndex];
-
-                if (xPos + (int)(g.width*scale) > area.x + area.width)
+                if (xPos + (int)(g->width*scale) > area.x + area.width)
                 {
                     // Truncate this line and go on to the next one.
                     truncated = true;
@@ -664,15 +834,15 @@ void Font::drawText(const char* text, const Rectangle& area, const Vector4& colo
                     {
                         if (clip)
                         {
-                            _batch->draw(xPos, yPos, g.width * scale, size, g.uvs[0], g.uvs[1], g.uvs[2], g.uvs[3], color, *clip);
+                            _batch->draw(xPos - pad, yPos - pad, g->width * scale + 2 * pad, size + 2 * pad, g->uvs[0], g->uvs[1], g->uvs[2], g->uvs[3], color, *clip);
                         }
                         else
                         {
-                            _batch->draw(xPos, yPos, g.width * scale, size, g.uvs[0], g.uvs[1], g.uvs[2], g.uvs[3], color);
+                            _batch->draw(xPos - pad, yPos - pad, g->width * scale + 2 * pad, size + 2 * pad, g->uvs[0], g->uvs[1], g->uvs[2], g->uvs[3], color);
                         }
                     }
                 }
-                xPos += (int)(g.width)*scale + (size >> 3);
+                xPos += (int)(g->width)*scale + (size >> 3);
             }
         }
 
@@ -746,6 +916,50 @@ void Font::finish()
     _batch->finish();
 }
 
+void Font::setLayoutCacheSize(unsigned int size)
+{
+    _layoutCacheSize = size;
+    trimLayouts(size);
+}
+
+unsigned int Font::getLayoutCacheSize() const
+{
+    return _layoutCacheSize;
+}
+
+void Font::setOutline(const Vector4& color, float width)
+{
+    if (_format != DISTANCE_FIELD)
+    {
+        GP_WARN("Outlines are only drawn for fonts of distance fields (font '%s').", _path.c_str());
+        return;
+    }
+
+    // Map the width to distance field values, which fall by 0.5 over the spread from the outline of the glyphs.
+    GP_ASSERT(_batch);
+    width = std::min(std::max(width, 0.0f), (float)_spread);
+    _batch->getMaterial()->getParameter("u_outlineColor")->setValue(color);
+    _batch->getMaterial()->getParameter("u_outlineWidth")->setValue(width / (2 * _spread));
+}
+
+void Font::setShadow(const Vector4& color, const Vector2& offset)
+{
+    if (_format != DISTANCE_FIELD)
+    {
+        GP_WARN("Shadows are only drawn for fonts of distance fields (font '%s').", _path.c_str());
+        return;
+    }
+
+    // Map the offset to texture coordinates, where the rows of the glyphs run down the texture.
+    GP_ASSERT(_batch);
+    GP_ASSERT(_texture);
+    float spread = (float)_spread;
+    Vector2 uvOffset(std::min(std::max(offset.x, -spread), spread) / _texture->getWidth(),
+                     std::min(std::max(offset.y, -spread), spread) / _texture->getHeight());
+    _batch->getMaterial()->getParameter("u_shadowColor")->setValue(color);
+    _batch->getMaterial()->getParameter("u_shadowOffset")->setValue(uvOffset);
+}
+
 void Font::measureText(const char* text, unsigned int size, unsigned int* width, unsigned int* height)
 {
     GP_ASSERT(_size);
@@ -1124,6 +1338,20 @@ void Font::getMeasurementInfo(const char* text, const Rectangle& area, unsigned
     GP_ASSERT(_size);
     GP_ASSERT(text);
     GP_ASSERT(yPosition);
+    GP_ASSERT(xPositions && xPositions->empty());
+    GP_ASSERT(lineLengths && lineLengths->empty());
+
+    // Reuse the measurement of the last text if it is measured again the same way.
+    Measurement& m = _measurement;
+    if (_measured && m.size == size && m.justify == justify && m.wrap == wrap && m.rightToLeft == rightToLeft &&
+        m.yStart == *yPosition && equals(m.area, area) && m.text == text)
+    {
+        *xPositions = m.xPositions;
+        *yPosition = m.yPosition;
+        *lineLengths = m.lineLengths;
+        return;
+    }
+    m.yStart = *yPosition;
 
     float scale = (float)size / _size;
 
@@ -1300,6 +1528,17 @@ void Font::getMeasurementInfo(const char* text, const Rectangle& area, unsigned
             *yPosition = area.y;
         }
     }
+
+    m.text = text;
+    m.area = area;
+    m.size = size;
+    m.justify = justify;
+    m.wrap = wrap;
+    m.rightToLeft = rightToLeft;
+    m.xPositions = *xPositions;
+    m.yPosition = *yPosition;
+    m.lineLengths = *lineLengths;
+    _measured = true;
 }
 
 int Font::getIndexAtLocation(const char* text, const Rectangle& area, unsigned int size, const Vector2& inLocation, Vector2* outLocation,
@@ -1434,14 +1673,10 @@ int Font::getIndexOrLocation(const char* text, const Rectangle& area, unsigned i
         GP_ASSERT(_glyphs);
         for (int i = startIndex; i < (int)tokenLength && i >= 0; i += iteration)
         {
-            char c = token[i];
-            int glyphIndex = c - 32; // HACK for ASCII
-        
-            if (glyphIndex >= 0 && glyphIndex < (int)_glyphCount)
+            const Glyph* g = getGlyph(decodeCharacter(&token[i]));
+            if (g)
             {
-                Glyph& g = _glyphs[glyphIndex];
-
-                if (xPos + (int)(g.width*scale) > area.x + area.width)
+                if (xPos + (int)(g->width*scale) > area.x + area.width)
                 {
                     // Truncate this line and go on to the next one.
                     truncated = true;
@@ -1451,7 +1686,7 @@ int Font::getIndexOrLocation(const char* text, const Rectangle& area, unsigned i
                 // Check against inLocation.
                 if (destIndex == (int)charIndex ||
                     (destIndex == -1 &&
-                    inLocation.x >= xPos && inLocation.x < floor(xPos + g.width*scale + (float)(size >> 3)) &&
+                    inLocation.x >= xPos && inLocation.x < floor(xPos + g->width*scale + (float)(size >> 3)) &&
                     inLocation.y >= yPos && inLocation.y < yPos + size))
                 {
                     outLocation->x = xPos;
@@ -1459,9 +1694,11 @@ int Font::getIndexOrLocation(const char* text, const Rectangle& area, unsigned i
                     return charIndex;
                 }
 
-                xPos += floor(g.width*scale + (float)(size >> 3));
-                charIndex++;
+                xPos += floor(g->width*scale + (float)(size >> 3));
             }
+
+            // Count every byte, so that indices are byte offsets into UTF-8 text.
+            charIndex++;
         }
 
         if (!truncated)
@@ -1563,11 +1800,10 @@ unsigned int Font::getTokenWidth(const char* token, unsigned int length, unsigne
             tokenWidth += (size >> 1)*4;
             break;
         default:
-            int glyphIndex = c - 32;
-            if (glyphIndex >= 0 && glyphIndex < (int)_glyphCount)
+            const Glyph* g = getGlyph(decodeCharacter(&token[i]));
+            if (g)
             {
-                Glyph& g = _glyphs[glyphIndex];
-                tokenWidth += floor(g.width * scale + (float)(size >> 3));
+                tokenWidth += floor(g->width * scale + (float)(size >> 3));
             }
             break;
         }
@@ -1705,6 +1941,107 @@ void Font::addLineInfo(const Rectangle& area, int lineWidth, int lineLength, Jus
     }
 }
 
+const Font::Glyph* Font::getGlyph(unsigned int code) const
+{
+    unsigned int block = code / FONT_GLYPH_BLOCK_SIZE;
+    if (block < _glyphBlocks.size() && _glyphBlocks[block])
+    {
+        int index = _glyphBlocks[block][code % FONT_GLYPH_BLOCK_SIZE];
+        if (index >= 0)
+            return &_glyphs[index];
+    }
+    return NULL;
+}
+
+Font::Text* Font::getLayout(const char* text, const Rectangle& area, const Vector4& color, unsigned int size,
+                            Justify justify, bool wrap, bool rightToLeft, const Rectangle* clip)
+{
+    unsigned int key = hashLayout(text, area, size, justify, wrap, rightToLeft, clip);
+    std::map<unsigned int, Layout>::iterator itr = _layouts.find(key);
+    if (itr != _layouts.end())
+    {
+        Layout& layout = itr->second;
+        if (layout.size == size && layout.justify == justify && layout.wrap == wrap && layout.rightToLeft == rightToLeft &&
+            layout.clipped == (clip != NULL) && equals(layout.area, area) && (clip == NULL || equals(layout.clip, *clip)) &&
+            layout.text->_text == text)
+        {
+            // Only the color of the vertices needs to change to draw the layout in another color.
+            Text* t = layout.text;
+            if (t->_color != color)
+            {
+                for (unsigned int i = 0; i < t->_vertexCount; ++i)
+                {
+                    t->_vertices[i].r = color.x;
+                    t->_vertices[i].g = color.y;
+                    t->_vertices[i].b = color.z;
+                    t->_vertices[i].a = color.w;
+                }
+                t->_color = color;
+            }
+            layout.lastUse = ++_layoutUse;
+            return t;
+        }
+
+        // Replace the layout of another text with the same key.
+        SAFE_DELETE(layout.text);
+        _layouts.erase(itr);
+    }
+
+    // Make room by dropping the older half of the layouts, which drops the layouts of text
+    // that changes every frame without scanning the cache for each of them.
+    if (_layouts.size() >= _layoutCacheSize)
+    {
+        trimLayouts(_layoutCacheSize / 2);
+    }
+
+    Layout& layout = _layouts[key];
+    layout.text = createText(text, area, color, size, justify, wrap, rightToLeft, clip);
+    layout.size = size;
+    layout.area = area;
+    layout.clipped = clip != NULL;
+    if (clip)
+        layout.clip = *clip;
+    layout.justify = justify;
+    layout.wrap = wrap;
+    layout.rightToLeft = rightToLeft;
+    layout.lastUse = ++_layoutUse;
+    return layout.text;
+}
+
+void Font::trimLayouts(unsigned int count)
+{
+    if (_layouts.size() <= count)
+        return;
+
+    // Find the last use of the least recently drawn layout to keep.
+    unsigned int minUse = UINT_MAX;
+    if (count > 0)
+    {
+        std::vector<unsigned int> uses;
+        uses.reserve(_layouts.size());
+        for (std::map<unsigned int, Layout>::const_iterator itr = _layouts.begin(); itr != _layouts.end(); ++itr)
+        {
+            uses.push_back(itr->second.lastUse);
+        }
+        std::nth_element(uses.begin(), uses.end() - count, uses.end());
+        minUse = *(uses.end() - count);
+    }
+
+    std::map<unsigned int, Layout>::iterator itr = _layouts.begin();
+    while (itr != _layouts.end())
+    {
+        if (count == 0 || itr->second.lastUse < minUse)
+        {
+            SAFE_DELETE(itr->second.text);
+            _layouts.erase(itr++);
+        }
+        else
+        {
+            ++itr;
+        }
+    }
+}
+
 SpriteBatch* Font::getSpriteBatch() const
 {
     return _batch;
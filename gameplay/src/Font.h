@@ -8,6 +8,13 @@ namespace gameplay
 
 /**
  * Defines a font for text rendering.
+ *
+ * Text is encoded in UTF-8. Characters that the font has no glyph for are not drawn.
+ *
+ * The glyphs of a font are either bitmaps, which are drawn best at the size they were
+ * rendered at, or signed distance fields, which hold the distance of each pixel to the
+ * outline of the glyph and are drawn sharply at any size from the same texture. Fonts
+ * of distance fields can also draw text with an outline and a shadow.
  */
 class Font : public Ref
 {
@@ -27,6 +34,15 @@ public:
         BOLD_ITALIC = 4
     };
 
+    /**
+     * Defines the formats of the glyphs of a font.
+     */
+    enum Format
+    {
+        BITMAP = 0,
+        DISTANCE_FIELD = 1
+    };
+
     /**
      * Defines the set of allowable alignments when drawing text.
      */
@@ -111,6 +127,13 @@ public:
      */
     unsigned int getSize();
 
+    /**
+     * Returns the format of the glyphs of this font.
+     *
+     * @return The format of the glyphs.
+     */
+    Format getFormat() const;
+
     /**
      * Starts text drawing for this font.
      */
@@ -191,6 +214,51 @@ public:
      */
     void finish();
 
+    /**
+     * Sets the number of text layouts this font keeps to draw the same text again.
+     *
+     * Text drawn within an area is laid out into sprite vertices, which are kept with the
+     * text, size, area, justification, wrapping and clip they were laid out for. Text that
+     * is drawn again unchanged, such as the text of a label every frame, is then drawn from
+     * its vertices without being measured and wrapped again. The least recently drawn
+     * layouts are dropped when the cache is full.
+     *
+     * @param size The number of layouts to keep, or 0 to lay out text every time it is drawn.
+     */
+    void setLayoutCacheSize(unsigned int size);
+
+    /**
+     * Gets the number of text layouts this font keeps to draw the same text again.
+     *
+     * @return The number of layouts kept.
+     */
+    unsigned int getLayoutCacheSize() const;
+
+    /**
+     * Sets the outline drawn around text by this font, for fonts of distance fields.
+     *
+     * The outline applies to all text drawn with this font, including text that was already
+     * laid out, and scales with the size text is drawn at. It is limited to the spread of the
+     * distance fields, beyond which the distance to the glyphs is not known.
+     *
+     * @param color The color of the outline, or a transparent color for no outline.
+     * @param width The width of the outline, in pixels at the size of the font.
+     */
+    void setOutline(const Vector4& color, float width);
+
+    /**
+     * Sets the shadow drawn under text by this font, for fonts of distance fields.
+     *
+     * The shadow is the shape of the text and its outline, offset and drawn under them.
+     * Like the outline, it applies to all text drawn with this font, scales with the size
+     * text is drawn at and is limited to the spread of the distance fields.
+     *
+     * @param color The color of the shadow, or a transparent color for no shadow.
+     * @param offset The offset of the shadow, in pixels at the size of the font, down
+     *      and to the right for positive coordinates.
+     */
+    void setShadow(const Vector4& color, const Vector2& offset);
+
     /**
      * Measures a string's width and height without alignment, wrapping or clipping.
      *
@@ -254,7 +322,7 @@ private:
     {
     public:
         /**
-         * Glyph character code (decimal value).
+         * Glyph character code (Unicode code point).
          */
         unsigned int code;
 
@@ -269,6 +337,40 @@ private:
         float uvs[4];
     };
 
+    /**
+     * A layout of text drawn within an area, kept to draw the same text again.
+     */
+    struct Layout
+    {
+        Text* text;
+        unsigned int size;
+        Rectangle area;
+        Rectangle clip;
+        bool clipped;
+        Justify justify;
+        bool wrap;
+        bool rightToLeft;
+        unsigned int lastUse;
+    };
+
+    /**
+     * The measurement of the last text measured within an area, which is often measured
+     * again next, as when a text box finds an index and then its location.
+     */
+    struct Measurement
+    {
+        std::string text;
+        Rectangle area;
+        unsigned int size;
+        Justify justify;
+        bool wrap;
+        bool rightToLeft;
+        int yStart;
+        std::vector<int> xPositions;
+        int yPosition;
+        std::vector<unsigned int> lineLengths;
+    };
+
     /**
      * Constructor.
      */
@@ -301,10 +403,14 @@ private:
      * @param glyphs An array of font glyphs, defining each character in the font within the texture map.
      * @param glyphCount The number of items in the glyph array.
      * @param texture A texture map containing rendered glyphs.
+     * @param format The format of the glyphs in the texture map.
+     * @param spread The distance, in pixels of the texture map, covered by distance field glyphs
+     *      on each side of their outlines.
      * 
      * @return The new Font.
      */
-    static Font* create(const char* family, Style style, unsigned int size, Glyph* glyphs, int glyphCount, Texture* texture);
+    static Font* create(const char* family, Style style, unsigned int size, Glyph* glyphs, int glyphCount, Texture* texture,
+                        Format format = BITMAP, unsigned int spread = 0);
 
     void getMeasurementInfo(const char* text, const Rectangle& area, unsigned int size, Justify justify, bool wrap, bool rightToLeft,
                             std::vector<int>* xPositions, int* yPosition, std::vector<unsigned int>* lineLengths);
@@ -323,16 +429,44 @@ private:
     void addLineInfo(const Rectangle& area, int lineWidth, int lineLength, Justify hAlign,
                      std::vector<int>* xPositions, std::vector<unsigned int>* lineLengths, bool rightToLeft);
 
+    /**
+     * Gets the glyph of a character.
+     *
+     * @param code The Unicode code point of the character.
+     *
+     * @return The glyph of the character, or NULL if the font has none.
+     */
+    const Glyph* getGlyph(unsigned int code) const;
+
+    /**
+     * Gets the layout of text drawn within an area, laying it out if it is not in the cache.
+     */
+    Text* getLayout(const char* text, const Rectangle& area, const Vector4& color, unsigned int size,
+                    Justify justify, bool wrap, bool rightToLeft, const Rectangle* clip);
+
+    /**
+     * Drops the least recently drawn layouts, keeping the given number of layouts.
+     */
+    void trimLayouts(unsigned int count);
+
     std::string _path;
     std::string _id;
     std::string _family;
     Style _style;
     unsigned int _size;
+    Format _format;
+    unsigned int _spread;
     Glyph* _glyphs;
     unsigned int _glyphCount;
+    std::vector<int*> _glyphBlocks;
     Texture* _texture;
     SpriteBatch* _batch;
     Rectangle _viewport;
+    std::map<unsigned int, Layout> _layouts;
+    unsigned int _layoutCacheSize;
+    unsigned int _layoutUse;
+    Measurement _measurement;
+    bool _measured;
 };
 
 }
@@ -541,6 +541,7 @@ void Form::draw()
     // to render the contents of the framebuffer directly to the display.
 
     // Check whether this form has changed since the last call to draw() and if so, render into the framebuffer.
+    // Only the region covered by the controls that changed is cleared and drawn again, unless the form itself changed.
     if (isDirty())
     {
         GP_ASSERT(_frameBuffer);
@@ -550,10 +551,30 @@ void Form::draw()
         Rectangle prevViewport = game->getViewport();
         game->setViewport(Rectangle(0, 0, _bounds.width, _bounds.height));
 
+        Rectangle bounds(0, 0, _bounds.width, _bounds.height);
+        Rectangle region(bounds);
+        if (!_dirty)
+        {
+            Rectangle dirtyRegion = Rectangle::empty();
+            getDirtyRegion(&dirtyRegion);
+
+            // Cover whole pixels of the framebuffer, within the form.
+            float x = std::max(floor(dirtyRegion.x), 0.0f);
+            float y = std::max(floor(dirtyRegion.y), 0.0f);
+            float x2 = std::min(ceil(dirtyRegion.x + dirtyRegion.width), bounds.width);
+            float y2 = std::min(ceil(dirtyRegion.y + dirtyRegion.height), bounds.height);
+            region.set(x, y, std::max(x2 - x, 0.0f), std::max(y2 - y, 0.0f));
+        }
+
+        GL_ASSERT( glEnable(GL_SCISSOR_TEST) );
+        GL_ASSERT( glScissor(region.x, _bounds.height - region.y - region.height, region.width, region.height) );
+        game->clear(Game::CLEAR_COLOR, Vector4::zero(), 1.0f, 0);
+
         GP_ASSERT(_theme);
         _theme->setProjectionMatrix(_projectionMatrix);
-        Container::draw(_theme->getSpriteBatch(), Rectangle(0, 0, _bounds.width, _bounds.height), _skin != NULL, false, _bounds.height);
+        Container::draw(_theme->getSpriteBatch(), bounds, region);
         _theme->setProjectionMatrix(_defaultProjectionMatrix);
+        GL_ASSERT( glDisable(GL_SCISSOR_TEST) );
 
         // Rebind the default framebuffer and game viewport.
         FrameBuffer::bindDefault();
@@ -5,6 +5,11 @@
 #include "FileSystem.h"
 #include "FrameBuffer.h"
 #include "SceneLoader.h"
+#include "Profiler.h"
+#include "Bundle.h"
+#include "ResourceCache.h"
+#include "ResourceLoader.h"
+#include "RenderQueue.h"
 
 /** @script{ignore} */
 GLenum __gl_error_code = GL_NO_ERROR;
@@ -17,13 +22,15 @@ namespace gameplay
 static Game* __gameInstance = NULL;
 double Game::_pausedTimeLast = 0.0;
 double Game::_pausedTimeTotal = 0.0;
+double Game::_fixedTimeStep = 0.0;
+double Game::_fixedTimeAbsolute = 0.0;
 
 Game::Game()
     : _initialized(false), _state(UNINITIALIZED), _pausedCount(0),
       _frameLastFPS(0), _frameCount(0), _frameRate(0),
       _clearDepth(1.0f), _clearStencil(0), _properties(NULL),
       _animationController(NULL), _audioController(NULL),
-      _physicsController(NULL), _aiController(NULL), _audioListener(NULL),
+      _physicsController(NULL), _aiController(NULL), _resourceLoader(NULL), _audioListener(NULL),
       _gamepads(NULL), _timeEvents(NULL), _scriptController(NULL), _scriptListeners(NULL)
 {
     GP_ASSERT(__gameInstance == NULL);
@@ -66,12 +73,39 @@ Game* Game::getInstance()
 
 double Game::getAbsoluteTime()
 {
+    if (_fixedTimeStep > 0.0)
+        return _fixedTimeAbsolute;
+
     return Platform::getAbsoluteTime();
 }
 
 double Game::getGameTime()
 {
-    return Platform::getAbsoluteTime() - _pausedTimeTotal;
+    return getAbsoluteTime() - _pausedTimeTotal;
+}
+
+void Game::setFixedTimeStep(double timeStep)
+{
+    if (timeStep < 0.0)
+        timeStep = 0.0;
+
+    if (timeStep > 0.0 && _fixedTimeStep == 0.0)
+    {
+        // Continue from the current platform time so the game clock does not jump.
+        _fixedTimeAbsolute = Platform::getAbsoluteTime();
+    }
+    else if (timeStep == 0.0 && _fixedTimeStep > 0.0)
+    {
+        // Account for the difference between the simulated and the platform clock
+        // as paused time so game time keeps moving forward from where it was.
+        _pausedTimeTotal += Platform::getAbsoluteTime() - _fixedTimeAbsolute;
+    }
+    _fixedTimeStep = timeStep;
+}
+
+double Game::getFixedTimeStep()
+{
+    return _fixedTimeStep;
 }
 
 void Game::setVsync(bool enable)
@@ -91,6 +125,13 @@ int Game::run()
 
     loadConfig();
 
+    // Read the optional fixed time step of the game clock.
+    Properties* time = _properties->getNamespace("time", true);
+    if (time && time->exists("fixedStep"))
+    {
+        setFixedTimeStep(time->getFloat("fixedStep"));
+    }
+
     _width = Platform::getDisplayWidth();
     _height = Platform::getDisplayHeight();
 
@@ -127,9 +168,48 @@ bool Game::startup()
     _aiController = new AIController();
     _aiController->initialize();
 
+    _resourceLoader = new ResourceLoader();
+
     _scriptController = new ScriptController();
     _scriptController->initialize();
 
+    // Configure the frame profiler.
+    if (_properties)
+    {
+        Properties* profiler = _properties->getNamespace("profiler", true);
+        if (profiler)
+        {
+            if (profiler->getInt("frames") > 0)
+                Profiler::setFrameHistory(profiler->getInt("frames"));
+            Profiler::setEnabled(profiler->getBool("enabled"));
+        }
+
+        // Set the number of threads evaluating animations.
+        Properties* animation = _properties->getNamespace("animation", true);
+        if (animation && animation->exists("threads"))
+            _animationController->setThreadCount((unsigned int)animation->getInt("threads"));
+
+        // Set whether bundles are memory mapped.
+        Properties* bundle = _properties->getNamespace("bundle", true);
+        if (bundle && bundle->exists("mmap"))
+            Bundle::setMemoryMappingEnabled(bundle->getBool("mmap"));
+
+        // Configure the background resource loader.
+        Properties* loader = _properties->getNamespace("loader", true);
+        if (loader)
+        {
+            if (loader->exists("threads"))
+                _resourceLoader->setThreadCount((unsigned int)loader->getInt("threads"));
+            if (loader->exists("budget"))
+                _resourceLoader->setTimeBudget(loader->getFloat("budget"));
+        }
+
+        // Set the memory budget for keeping unused resources, in megabytes.
+        Properties* cache = _properties->getNamespace("cache", true);
+        if (cache && cache->exists("budget"))
+            ResourceCache::setMemoryBudget((size_t)(cache->getFloat("budget") * 1024.0f * 1024.0f));
+    }
+
     // Set the script callback functions.
     if (_properties)
     {
@@ -196,6 +276,12 @@ void Game::shutdown()
 
         _scriptController->finalizeGame();
 
+        _resourceLoader->finalize();
+        SAFE_DELETE(_resourceLoader);
+
+        // Destroy the unused resources kept in the resource cache.
+        ResourceCache::setMemoryBudget(0);
+
         _animationController->finalize();
         SAFE_DELETE(_animationController);
 
@@ -210,6 +296,15 @@ void Game::shutdown()
         // Note: we do not clean up the script controller here
         // because users can call Game::exit() from a script.
 
+        // Write out the recorded profiler frames if requested in the config.
+        if (_properties && Profiler::getFrameCount() > 0)
+        {
+            Properties* profiler = _properties->getNamespace("profiler", true);
+            if (profiler && profiler->getString("trace"))
+                Profiler::writeChromeTrace(profiler->getString("trace"));
+        }
+        Profiler::finalize();
+
         SAFE_DELETE(_audioListener);
 
         RenderState::finalize();
@@ -229,7 +324,7 @@ void Game::pause()
         GP_ASSERT(_physicsController);
         GP_ASSERT(_aiController);
         _state = PAUSED;
-        _pausedTimeLast = Platform::getAbsoluteTime();
+        _pausedTimeLast = getAbsoluteTime();
         _animationController->pause();
         _audioController->pause();
         _physicsController->pause();
@@ -252,7 +347,7 @@ void Game::resume()
 			GP_ASSERT(_physicsController);
 			GP_ASSERT(_aiController);
 			_state = RUNNING;
-			_pausedTimeTotal += Platform::getAbsoluteTime() - _pausedTimeLast;
+			_pausedTimeTotal += getAbsoluteTime() - _pausedTimeLast;
 			_animationController->resume();
 			_audioController->resume();
 			_physicsController->resume();
@@ -268,8 +363,11 @@ void Game::exit()
 
 void Game::frame()
 {
+    Profiler::beginFrame();
+
     if (!_initialized)
     {
+        Profiler::Scope scope("Game::initialize");
         initialize();
         _scriptController->initializeGame();
         _initialized = true;
@@ -283,38 +381,65 @@ void Game::frame()
         GP_ASSERT(_physicsController);
         GP_ASSERT(_aiController);
 
+        // Advance the game clock when running with a fixed time step.
+        if (_fixedTimeStep > 0.0)
+            _fixedTimeAbsolute += _fixedTimeStep;
+
         // Update Time.
         static double lastFrameTime = Game::getGameTime();
         double frameTime = getGameTime();
         float elapsedTime = (frameTime - lastFrameTime);
         lastFrameTime = frameTime;
 
+        // Finish resources loaded in the background.
+        Profiler::begin("ResourceLoader::update");
+        _resourceLoader->update();
+        Profiler::end();
+
         // Update the scheduled and running animations.
+        Profiler::begin("AnimationController::update");
         _animationController->update(elapsedTime);
+        Profiler::end();
 
         // Fire time events to scheduled TimeListeners
+        Profiler::begin("Game::fireTimeEvents");
         fireTimeEvents(frameTime);
+        Profiler::end();
 
         // Update the physics.
+        Profiler::begin("PhysicsController::update");
         _physicsController->update(elapsedTime);
+        Profiler::end();
 
         // Update AI.
+        Profiler::begin("AIController::update");
         _aiController->update(elapsedTime);
+        Profiler::end();
 
         // Application Update.
+        Profiler::begin("Game::update");
         update(elapsedTime);
+        Profiler::end();
 
         // Run script update.
+        Profiler::begin("ScriptController::update");
         _scriptController->update(elapsedTime);
+        Profiler::end();
 
         // Audio Rendering.
+        Profiler::begin("AudioController::update");
         _audioController->update(elapsedTime);
+        Profiler::end();
 
         // Graphics Rendering.
+        Profiler::begin("Game::render");
         render(elapsedTime);
+        Profiler::end();
 
         // Run script render.
+        Profiler::begin("ScriptController::render");
         _scriptController->render(elapsedTime);
+        Profiler::end();
 
         // Update FPS.
         ++_frameCount;
@@ -328,17 +453,28 @@ void Game::frame()
     else
     {
         // Application Update.
+        Profiler::begin("Game::update");
         update(0);
+        Profiler::end();
 
         // Script update.
+        Profiler::begin("ScriptController::update");
         _scriptController->update(0);
+        Profiler::end();
 
         // Graphics Rendering.
+        Profiler::begin("Game::render");
         render(0);
+        Profiler::end();
 
         // Script render.
+        Profiler::begin("ScriptController::render");
         _scriptController->render(0);
+        Profiler::end();
     }
+
+    RenderQueue::endFrame();
+    Profiler::endFrame();
 }
 
 void Game::renderOnce(const char* function)
@@ -361,6 +497,7 @@ void Game::updateOnce()
     lastFrameTime = frameTime;
 
     // Update the internal controllers.
+    _resourceLoader->update();
     _animationController->update(elapsedTime);
     _physicsController->update(elapsedTime);
     _aiController->update(elapsedTime);
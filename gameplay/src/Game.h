@@ -22,6 +22,7 @@ namespace gameplay
 {
 
 class ScriptController;
+class ResourceLoader;
 
 /**
  * Defines the basic game initialization, logic and platform delegates.
@@ -100,6 +101,28 @@ public:
      */
     static double getGameTime();
 
+    /**
+     * Sets a fixed time step (in milliseconds) for the game clock.
+     *
+     * When the time step is greater than zero the game clock is decoupled from the
+     * platform clock and advances by exactly this amount every time a frame is run.
+     * This makes the simulation deterministic and lets it run as fast as the CPU allows,
+     * which is useful for headless servers, soak tests and benchmarks.
+     *
+     * A time step of zero (the default) makes the game clock follow the platform clock.
+     * The time step can also be set from the game config with time.fixedStep.
+     *
+     * @param timeStep The fixed time step (in milliseconds), or zero to use the platform clock.
+     */
+    static void setFixedTimeStep(double timeStep);
+
+    /**
+     * Gets the fixed time step (in milliseconds) of the game clock.
+     *
+     * @return The fixed time step (in milliseconds), or zero if the game clock follows the platform clock.
+     */
+    static double getFixedTimeStep();
+
     /**
      * Gets the game state.
      *
@@ -253,6 +276,13 @@ public:
      */
     inline AIController* getAIController() const;
 
+    /**
+     * Gets the resource loader for loading resources in the background.
+     *
+     * @return The resource loader for this game.
+     */
+    inline ResourceLoader* getResourceLoader() const;
+
     /**
      * Gets the script controller for managing control of Lua scripts
      * associated with the game.
@@ -671,6 +701,8 @@ private:
     unsigned int _pausedCount;                  // Number of times pause() has been called.
     static double _pausedTimeLast;              // The last time paused.
     static double _pausedTimeTotal;             // The total time paused.
+    static double _fixedTimeStep;               // The fixed time step of the game clock (zero follows the platform clock).
+    static double _fixedTimeAbsolute;           // The absolute time of the game clock when running with a fixed time step.
     double _frameLastFPS;                       // The last time the frame count was updated.
     unsigned int _frameCount;                   // The current frame count.
     unsigned int _frameRate;                    // The current frame rate.
@@ -685,6 +717,7 @@ private:
     AudioController* _audioController;          // Controls audio sources that are playing in the game.
     PhysicsController* _physicsController;      // Controls the simulation of a physics scene and entities.
     AIController* _aiController;                // Controls AI simulation.
+    ResourceLoader* _resourceLoader;            // Loads resources in the background.
     AudioListener* _audioListener;              // The audio listener in 3D space.
     std::vector<Gamepad*>* _gamepads;           // The connected gamepads.
     std::priority_queue<TimeEvent, std::vector<TimeEvent>, std::less<TimeEvent> >* _timeEvents;     // Contains the scheduled time events.
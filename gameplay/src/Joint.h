@@ -70,14 +70,6 @@ protected:
      */
     void setInverseBindPose(const Matrix& m);
 
-    /**
-     * Updates the joint matrix.
-     * 
-     * @param bindShape The bind shape matrix.
-     * @param matrixPalette The matrix palette to update.
-     */
-    void updateJointMatrix(const Matrix& bindShape, Vector4* matrixPalette);
-
     /**
      * Called when this Joint's transform changes.
      */
@@ -111,6 +103,11 @@ protected:
      * The number of MeshSkin's influencing the Joint.
      */
     unsigned int _skinCount;
+
+    /**
+     * Incremented whenever the bind pose changes, so MeshSkin can cache matrices derived from it.
+     */
+    unsigned int _bindPoseVersion;
 };
 
 }
@@ -69,6 +69,20 @@ void Layout::align(Control* control, const Container* container)
     }
 }
 
+void Layout::updateControl(Control* control, const Container* container, const Vector2& offset)
+{
+    GP_ASSERT(control);
+    GP_ASSERT(container);
+
+    if (control->isDirty() ||
+        control->_updateViewportBounds != container->_viewportBounds ||
+        control->_updateClip != container->_viewportClipBounds ||
+        control->_updateOffset != offset)
+    {
+        control->update(container, offset);
+    }
+}
+
 bool Layout::touchEvent(Touch::TouchEvent evt, int x, int y, unsigned int contactIndex)
 {
     return false;
@@ -73,6 +73,18 @@ protected:
      */
     virtual void align(Control* control, const Container* container);
 
+    /**
+     * Updates a control within a container, after it has been positioned.
+     *
+     * Controls that have not changed since they were last updated, within a container
+     * whose viewport and clip have not changed, are skipped along with their children.
+     *
+     * @param control The control to update.
+     * @param container The container of the control.
+     * @param offset The update offset.
+     */
+    void updateControl(Control* control, const Container* container, const Vector2& offset);
+
     /**
      * Touch callback on touch events.  Coordinates are given relative to the container's
      * content area.
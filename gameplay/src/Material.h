@@ -25,6 +25,7 @@ class Material : public RenderState
     friend class RenderState;
     friend class Node;
     friend class Model;
+    friend class ModelBatch;
 
 public:
 
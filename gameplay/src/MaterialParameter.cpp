@@ -1,12 +1,16 @@
 #include "Base.h"
 #include "MaterialParameter.h"
 #include "Node.h"
+#include "RenderQueue.h"
 
 namespace gameplay
 {
 
+static unsigned int __parameterVersion = 0;
+
 MaterialParameter::MaterialParameter(const char* name) :
-    _type(MaterialParameter::NONE), _count(1), _dynamic(false), _name(name ? name : ""), _uniform(NULL)
+    _type(MaterialParameter::NONE), _count(1), _dynamic(false), _name(name ? name : ""), _handle(Effect::getUniformHandle(_name.c_str())),
+    _uniform(NULL), _version(0)
 {
     clearValue();
 }
@@ -61,6 +65,7 @@ void MaterialParameter::clearValue()
 
     memset(&_value, 0, sizeof(_value));
     _type = MaterialParameter::NONE;
+    _version = ++__parameterVersion;
 }
 
 const char* MaterialParameter::getName() const
@@ -68,6 +73,11 @@ const char* MaterialParameter::getName() const
     return _name.c_str();
 }
 
+unsigned int MaterialParameter::getHandle() const
+{
+    return _handle;
+}
+
 Texture::Sampler* MaterialParameter::getSampler() const
 {
     if (_type == MaterialParameter::SAMPLER)
@@ -193,6 +203,7 @@ void MaterialParameter::setValue(const Matrix& value)
     }
 
     memcpy(_value.floatPtrValue, value.m, sizeof(float) * 16);
+    _version = ++__parameterVersion;
 
     _dynamic = true;
     _count = 1;
@@ -238,22 +249,23 @@ Texture::Sampler* MaterialParameter::setValue(const char* texturePath, bool gene
     return NULL;
 }
 
-void MaterialParameter::bind(Effect* effect)
+void MaterialParameter::bind(Effect* effect, Uniform* uniform)
 {
     GP_ASSERT(effect);
+    GP_ASSERT(uniform && uniform->getEffect() == effect);
 
-    // If we had a Uniform cached that is not from the passed in effect,
-    // we need to update our uniform to point to the new effect's uniform.
-    if (!_uniform || _uniform->getEffect() != effect)
-    {
-        _uniform = effect->getUniform(_name.c_str());
+    // Method bindings set their values through the uniform cached here.
+    _uniform = uniform;
 
-        if (!_uniform)
-        {
-            // This parameter was not found in the specified effect, so do nothing.
-            GP_WARN("Warning: Material parameter '%s' not found in effect '%s'.", _name.c_str(), effect->getId());
-            return;
-        }
+    // Values held by the parameter only change through its setters, which give it a new version,
+    // so they are not compared again while the uniform still holds that version. Values read
+    // through pointers or methods may change at any time.
+    bool versioned = _type != MaterialParameter::METHOD && _type != MaterialParameter::SAMPLER &&
+        (_dynamic || ((_type == MaterialParameter::FLOAT || _type == MaterialParameter::INT) && _count == 1));
+    if (versioned && _uniform->_version == _version)
+    {
+        ++RenderQueue::_frameCounters.skippedUniformUploads;
+        return;
     }
 
     switch (_type)
@@ -301,6 +313,11 @@ void MaterialParameter::bind(Effect* effect)
         GP_ERROR("Unsupported material parameter type (%d).", _type);
         break;
     }
+
+    if (versioned)
+    {
+        _uniform->_version = _version;
+    }
 }
 
 void MaterialParameter::bindValue(Node* node, const char* binding)
@@ -497,6 +514,7 @@ void MaterialParameter::setAnimationPropertyValue(int propertyId, AnimationValue
     {
         case ANIMATE_UNIFORM:
         {
+            _version = ++__parameterVersion;
             switch (_type)
             {
                 case FLOAT:
@@ -44,6 +44,14 @@ public:
      */
     const char* getName() const;
 
+    /**
+     * Returns the handle of this material parameter's name.
+     *
+     * @return The name handle of the parameter.
+     * @see Effect::getUniformHandle
+     */
+    unsigned int getHandle() const;
+
     /**
      * Returns the texture sampler or NULL if this MaterialParameter is not a sampler type.
      * 
@@ -279,7 +287,10 @@ private:
 
     void clearValue();
 
-    void bind(Effect* effect);
+    /**
+     * Applies the parameter's value to the uniform it resolves to in an effect.
+     */
+    void bind(Effect* effect, Uniform* uniform);
 
     void applyAnimationValue(AnimationValue* value, float blendWeight, int components);
 
@@ -317,7 +328,9 @@ private:
     unsigned int _count;
     bool _dynamic;
     std::string _name;
+    unsigned int _handle;
     Uniform* _uniform;
+    unsigned int _version;
 };
 
 template <class ClassType, class ParameterType>
@@ -1,6 +1,10 @@
 #include "Base.h"
 #include "MathUtil.h"
 
+#if defined(USE_SSE) && defined(__AVX__)
+#include <immintrin.h>
+#endif
+
 namespace gameplay
 {
 
@@ -26,4 +30,56 @@ void MathUtil::smooth(float* x, float target, float elapsedTime, float riseTime,
     }
 }
 
+void MathUtil::transformVector3Array(const float* m, const float* v, unsigned int count, float w, float* dst)
+{
+    GP_ASSERT(m);
+    GP_ASSERT(count == 0 || (v && dst));
+
+#ifdef USE_SSE
+    // Keep the columns in registers across the whole array, folding w into the translation.
+    __m128 c0 = _mm_loadu_ps(m);
+    __m128 c1 = _mm_loadu_ps(m + 4);
+    __m128 c2 = _mm_loadu_ps(m + 8);
+    __m128 c3 = _mm_mul_ps(_mm_loadu_ps(m + 12), _mm_set1_ps(w));
+    for (unsigned int i = 0; i < count; ++i, v += 3, dst += 3)
+    {
+        __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(v[0])), _mm_mul_ps(c1, _mm_set1_ps(v[1]))),
+                              _mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(v[2])), c3));
+        _mm_storel_pi((__m64*)dst, r);
+        _mm_store_ss(dst + 2, _mm_movehl_ps(r, r));
+    }
+#else
+    for (unsigned int i = 0; i < count; ++i, v += 3, dst += 3)
+    {
+        transformVector4(m, v[0], v[1], v[2], w, dst);
+    }
+#endif
+}
+
+void MathUtil::transformVector4Array(const float* m, const float* v, unsigned int count, float* dst)
+{
+    GP_ASSERT(m);
+    GP_ASSERT(count == 0 || (v && dst));
+
+    unsigned int i = 0;
+#if defined(USE_SSE) && defined(__AVX__)
+    // Transform two vectors per iteration, one in each 128-bit lane.
+    __m256 c0 = _mm256_broadcast_ps((const __m128*)m);
+    __m256 c1 = _mm256_broadcast_ps((const __m128*)(m + 4));
+    __m256 c2 = _mm256_broadcast_ps((const __m128*)(m + 8));
+    __m256 c3 = _mm256_broadcast_ps((const __m128*)(m + 12));
+    for (; i + 2 <= count; i += 2, v += 8, dst += 8)
+    {
+        __m256 p = _mm256_loadu_ps(v);
+        __m256 r = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(c0, _mm256_permute_ps(p, 0x00)), _mm256_mul_ps(c1, _mm256_permute_ps(p, 0x55))),
+                                 _mm256_add_ps(_mm256_mul_ps(c2, _mm256_permute_ps(p, 0xAA)), _mm256_mul_ps(c3, _mm256_permute_ps(p, 0xFF))));
+        _mm256_storeu_ps(dst, r);
+    }
+#endif
+    for (; i < count; ++i, v += 4, dst += 4)
+    {
+        transformVector4(m, v, dst);
+    }
+}
+
 }
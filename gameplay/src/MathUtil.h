@@ -64,6 +64,18 @@ private:
 
     inline static void crossVector3(const float* v1, const float* v2, float* dst);
 
+    /**
+     * Transforms an array of 3-component vectors, extended with the given w, by the matrix m
+     * and stores the first three components of each result in dst. v may be the same array as dst.
+     */
+    static void transformVector3Array(const float* m, const float* v, unsigned int count, float w, float* dst);
+
+    /**
+     * Transforms an array of 4-component vectors by the matrix m and stores the results in dst.
+     * v may be the same array as dst.
+     */
+    static void transformVector4Array(const float* m, const float* v, unsigned int count, float* dst);
+
     MathUtil();
 };
 
@@ -71,8 +83,10 @@ private:
 
 #define MATRIX_SIZE ( sizeof(float) * 16)
 
-#ifdef USE_NEON
+#if defined(USE_NEON)
 #include "MathUtilNeon.inl"
+#elif defined(USE_SSE)
+#include "MathUtilSSE.inl"
 #else
 #include "MathUtil.inl"
 #endif
@@ -858,6 +858,21 @@ void Matrix::transformVector(const Vector4& vector, Vector4* dst) const
     MathUtil::transformVector4(m, (const float*) &vector, (float*)dst);
 }
 
+void Matrix::transformPoints(const Vector3* points, unsigned int count, Vector3* dst) const
+{
+    MathUtil::transformVector3Array(m, (const float*)points, count, 1.0f, (float*)dst);
+}
+
+void Matrix::transformVectors(const Vector3* vectors, unsigned int count, Vector3* dst) const
+{
+    MathUtil::transformVector3Array(m, (const float*)vectors, count, 0.0f, (float*)dst);
+}
+
+void Matrix::transformVectors(const Vector4* vectors, unsigned int count, Vector4* dst) const
+{
+    MathUtil::transformVector4Array(m, (const float*)vectors, count, (float*)dst);
+}
+
 void Matrix::translate(float x, float y, float z)
 {
     translate(x, y, z, this);
@@ -1,18 +1,62 @@
 #include "Base.h"
 #include "MeshBatch.h"
+#include "RenderQueue.h"
+
+// The number of vertices that 16-bit indices can reach.
+#define SEGMENT_VERTEX_LIMIT (USHRT_MAX + 1)
 
 namespace gameplay
 {
 
+/**
+ * Uploads data to the start of a streaming buffer, orphaning the previous contents of the buffer.
+ */
+static void uploadStreamData(GLenum target, const void* data, unsigned int size, unsigned int capacity, unsigned int& bufferSize)
+{
+#ifdef USE_MAP_BUFFER_RANGE
+    if (glMapBufferRange)
+    {
+        // Invalidating the mapped buffer orphans it, so it is only reallocated when it grows.
+        if (bufferSize != capacity)
+        {
+            GL_ASSERT( glBufferData(target, capacity, NULL, GL_STREAM_DRAW) );
+            bufferSize = capacity;
+        }
+        void* buffer = NULL;
+        GL_ASSERT( buffer = glMapBufferRange(target, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT) );
+        if (buffer)
+        {
+            memcpy(buffer, data, size);
+            GL_ASSERT( glUnmapBuffer(target) );
+            return;
+        }
+    }
+#endif
+
+    GL_ASSERT( glBufferData(target, capacity, NULL, GL_STREAM_DRAW) );
+    GL_ASSERT( glBufferSubData(target, 0, size, data) );
+    bufferSize = capacity;
+}
+
 MeshBatch::MeshBatch(const VertexFormat& vertexFormat, Mesh::PrimitiveType primitiveType, Material* material, bool indexed, unsigned int initialCapacity, unsigned int growSize)
     : _vertexFormat(vertexFormat), _primitiveType(primitiveType), _material(material), _indexed(indexed), _capacity(0), _growSize(growSize),
-      _vertexCapacity(0), _indexCapacity(0), _vertexCount(0), _indexCount(0), _vertices(NULL), _verticesPtr(NULL), _indices(NULL), _indicesPtr(NULL)
+      _vertexCapacity(0), _indexCapacity(0), _vertexCount(0), _indexCount(0), _vertices(NULL), _verticesPtr(NULL), _indices(NULL), _indicesPtr(NULL),
+      _streaming(false), _streamDirty(false), _vertexBuffer(0), _indexBuffer(0), _vertexBufferSize(0), _indexBufferSize(0)
 {
     resize(initialCapacity);
 }
 
 MeshBatch::~MeshBatch()
 {
+    releaseStreamBindings();
+    if (_vertexBuffer)
+    {
+        GL_ASSERT( glDeleteBuffers(1, &_vertexBuffer) );
+    }
+    if (_indexBuffer)
+    {
+        GL_ASSERT( glDeleteBuffers(1, &_indexBuffer) );
+    }
     SAFE_RELEASE(_material);
     SAFE_DELETE_ARRAY(_vertices);
     SAFE_DELETE_ARRAY(_indices);
@@ -55,6 +99,13 @@ void MeshBatch::updateVertexAttributeBinding()
         {
             Pass* p = t->getPassByIndex(j);
             GP_ASSERT(p);
+
+            // Streaming batches bind their passes to their vertex buffer when they are drawn.
+            if (_streaming)
+            {
+                p->setVertexAttributeBinding(NULL);
+                continue;
+            }
             VertexAttributeBinding* b = VertexAttributeBinding::create(_vertexFormat, _vertices, p->getEffect());
             p->setVertexAttributeBinding(b);
             SAFE_RELEASE(b);
@@ -72,6 +123,26 @@ void MeshBatch::setCapacity(unsigned int capacity)
     resize(capacity);
 }
 
+bool MeshBatch::isStreaming() const
+{
+    return _streaming;
+}
+
+void MeshBatch::setStreaming(bool streaming)
+{
+    if (streaming == _streaming)
+        return;
+
+    _streaming = streaming;
+    _streamDirty = true;
+    if (!_streaming)
+    {
+        releaseStreamBindings();
+        _segments.clear();
+    }
+    updateVertexAttributeBinding();
+}
+
 bool MeshBatch::resize(unsigned int capacity)
 {
     if (capacity == 0)
@@ -114,7 +185,7 @@ bool MeshBatch::resize(unsigned int capacity)
     // (we only know how many indices will be stored). Assume the worst case
     // for now, which is the same number of vertices as indices.
     unsigned int indexCapacity = vertexCapacity;
-    if (_indexed && indexCapacity > USHRT_MAX)
+    if (_indexed && !_streaming && indexCapacity > USHRT_MAX)
     {
         GP_ERROR("Index capacity is greater than the maximum unsigned short value (%d > %d).", indexCapacity, USHRT_MAX);
         return false;
@@ -151,21 +222,143 @@ bool MeshBatch::resize(unsigned int capacity)
     _indexCapacity = indexCapacity;
 
     // Update our vertex attribute bindings now that our client array pointers have changed
-    updateVertexAttributeBinding();
+    if (!_streaming)
+        updateVertexAttributeBinding();
 
     return true;
 }
     
+void MeshBatch::add(const void* vertices, size_t vertexSize, unsigned int vertexCount, const unsigned short* indices, unsigned int indexCount)
+{
+    GP_ASSERT(vertices);
+    GP_ASSERT(vertexSize == _vertexFormat.getVertexSize());
+
+    unsigned char* data = addVertices(vertexCount, indices, indexCount);
+    if (data)
+        memcpy(data, vertices, vertexCount * vertexSize);
+}
+
+unsigned char* MeshBatch::addVertices(unsigned int vertexCount, const unsigned short* indices, unsigned int indexCount)
+{
+    // Indices are relative to the first vertex of the current segment of a streaming batch,
+    // which starts a new segment when they would not reach the new vertices.
+    unsigned int firstVertex = 0;
+    bool newSegment = false;
+    if (_streaming && _indexed)
+    {
+        GP_ASSERT(vertexCount <= SEGMENT_VERTEX_LIMIT);
+        if (!_segments.empty())
+            firstVertex = _segments.back().firstVertex;
+        if (_vertexCount - firstVertex + vertexCount > SEGMENT_VERTEX_LIMIT)
+        {
+            firstVertex = _vertexCount;
+            newSegment = true;
+        }
+    }
+    unsigned int baseVertex = _vertexCount - firstVertex;
+
+    unsigned int newVertexCount = _vertexCount + vertexCount;
+    unsigned int newIndexCount = _indexCount + indexCount;
+    if (_primitiveType == Mesh::TRIANGLE_STRIP && baseVertex > 0)
+        newIndexCount += 2; // need an extra 2 indices for connecting strips with degenerate triangles
+
+    // Do we need to grow the batch? Streaming batches at least double in size.
+    while (newVertexCount > _vertexCapacity || (_indexed && newIndexCount > _indexCapacity))
+    {
+        if (_growSize == 0)
+            return NULL; // growing disabled, just clip batch
+        if (!resize(_capacity + (_streaming ? std::max(_growSize, _capacity) : _growSize)))
+            return NULL; // failed to grow
+    }
+
+    if (newSegment)
+    {
+        Segment segment;
+        segment.firstVertex = _vertexCount;
+        segment.firstIndex = _indexCount;
+        _segments.push_back(segment);
+    }
+
+    // Copy index data.
+    if (_indexed)
+    {
+        GP_ASSERT(indices);
+        GP_ASSERT(_indicesPtr);
+
+        if (baseVertex == 0)
+        {
+            // Simply copy values directly into the start of the index array.
+            memcpy(_indicesPtr, indices, indexCount * sizeof(unsigned short));
+        }
+        else
+        {
+            if (_primitiveType == Mesh::TRIANGLE_STRIP)
+            {
+                // Create a degenerate triangle to connect separate triangle strips
+                // by duplicating the previous and next vertices.
+                _indicesPtr[0] = *(_indicesPtr-1);
+                _indicesPtr[1] = baseVertex;
+                _indicesPtr += 2;
+            }
+
+            // Loop through all indices and insert them, with their values offset by
+            // 'baseVertex' so that they are relative to the first newly inserted vertex.
+            for (unsigned int i = 0; i < indexCount; ++i)
+            {
+                _indicesPtr[i] = indices[i] + baseVertex;
+            }
+        }
+        _indicesPtr += indexCount;
+        _indexCount = newIndexCount;
+    }
+
+    GP_ASSERT(_verticesPtr);
+    unsigned char* vertices = _verticesPtr;
+    _verticesPtr += vertexCount * _vertexFormat.getVertexSize();
+    _vertexCount = newVertexCount;
+    _streamDirty = true;
+    return vertices;
+}
+
 void MeshBatch::start()
 {
     _vertexCount = 0;
     _indexCount = 0;
     _verticesPtr = _vertices;
     _indicesPtr = _indices;
+    _segments.clear();
+    _streamDirty = true;
 }
 
 void MeshBatch::finish()
 {
+    if (!_streaming || !_streamDirty)
+        return;
+    _streamDirty = false;
+
+    if (_vertexCount == 0)
+        return;
+
+    // Upload the batch to the buffers, which grow with the capacity of the batch.
+    if (_vertexBuffer == 0)
+    {
+        GL_ASSERT( glGenBuffers(1, &_vertexBuffer) );
+    }
+    unsigned int vertexSize = _vertexFormat.getVertexSize();
+    GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer) );
+    uploadStreamData(GL_ARRAY_BUFFER, _vertices, _vertexCount * vertexSize, _vertexCapacity * vertexSize, _vertexBufferSize);
+    GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, 0) );
+
+    if (_indexed && _indexCount > 0)
+    {
+        if (_indexBuffer == 0)
+        {
+            GL_ASSERT( glGenBuffers(1, &_indexBuffer) );
+        }
+        GL_ASSERT( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer) );
+        uploadStreamData(GL_ELEMENT_ARRAY_BUFFER, _indices, _indexCount * sizeof(unsigned short), _indexCapacity * sizeof(unsigned short), _indexBufferSize);
+        GL_ASSERT( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0) );
+    }
 }
 
 void MeshBatch::draw()
@@ -173,11 +366,18 @@ void MeshBatch::draw()
     if (_vertexCount == 0 || (_indexed && _indexCount == 0))
         return; // nothing to draw
 
+    GP_ASSERT(_material);
+    if (_streaming)
+    {
+        finish();
+        drawStream();
+        return;
+    }
+
     // Not using VBOs, so unbind the element array buffer.
     // ARRAY_BUFFER will be unbound automatically during pass->bind().
     GL_ASSERT( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0 ) );
 
-    GP_ASSERT(_material);
     if (_indexed)
         GP_ASSERT(_indices);
 
@@ -199,10 +399,93 @@ void MeshBatch::draw()
         {
             GL_ASSERT( glDrawArrays(_primitiveType, 0, _vertexCount) );
         }
+        ++RenderQueue::_frameCounters.drawCalls;
 
         pass->unbind();
     }
 }
-    
+
+void MeshBatch::drawStream()
+{
+    Technique* technique = _material->getTechnique();
+    GP_ASSERT(technique);
+    unsigned int segmentCount = (unsigned int)_segments.size() + 1;
+    for (unsigned int i = 0, passCount = technique->getPassCount(); i < passCount; ++i)
+    {
+        Pass* pass = technique->getPassByIndex(i);
+        GP_ASSERT(pass);
+        pass->getEffect()->bind();
+        pass->RenderState::bind(pass);
+
+        for (unsigned int j = 0; j < segmentCount; ++j)
+        {
+            VertexAttributeBinding* binding = getStreamBinding(pass, j);
+            if (binding == NULL)
+                continue;
+            binding->bind();
+
+            if (_indexed)
+            {
+                // The index buffer binding is part of the state of a vertex array object.
+                unsigned int firstIndex = j > 0 ? _segments[j - 1].firstIndex : 0;
+                unsigned int lastIndex = j + 1 < segmentCount ? _segments[j].firstIndex : _indexCount;
+                GL_ASSERT( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer) );
+                GL_ASSERT( glDrawElements(_primitiveType, lastIndex - firstIndex, GL_UNSIGNED_SHORT, (GLvoid*)(firstIndex * sizeof(unsigned short))) );
+            }
+            else
+            {
+                GL_ASSERT( glDrawArrays(_primitiveType, 0, _vertexCount) );
+            }
+            ++RenderQueue::_frameCounters.drawCalls;
+
+            binding->unbind();
+        }
+    }
+    GL_ASSERT( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0) );
+}
+
+VertexAttributeBinding* MeshBatch::getStreamBinding(Pass* pass, unsigned int segment)
+{
+    GP_ASSERT(pass);
+    GP_ASSERT(_vertexBuffer);
+
+    // Segments start at the same vertices from batch to batch unless the sizes of the added
+    // primitives change, in which case the binding of the segment is replaced.
+    unsigned int firstVertex = segment > 0 ? _segments[segment - 1].firstVertex : 0;
+    StreamBinding* streamBinding = NULL;
+    for (size_t i = 0, count = _streamBindings.size(); i < count; ++i)
+    {
+        StreamBinding& b = _streamBindings[i];
+        if (b.pass == pass && b.segment == segment)
+        {
+            if (b.firstVertex == firstVertex)
+                return b.binding;
+            streamBinding = &b;
+            SAFE_RELEASE(streamBinding->binding);
+            break;
+        }
+    }
+    if (streamBinding == NULL)
+    {
+        StreamBinding b;
+        b.pass = pass;
+        b.segment = segment;
+        b.binding = NULL;
+        _streamBindings.push_back(b);
+        streamBinding = &_streamBindings.back();
+    }
+    streamBinding->firstVertex = firstVertex;
+    streamBinding->binding = VertexAttributeBinding::create(_vertexBuffer, _vertexFormat, firstVertex * _vertexFormat.getVertexSize(), pass->getEffect());
+    return streamBinding->binding;
+}
+
+void MeshBatch::releaseStreamBindings()
+{
+    for (size_t i = 0, count = _streamBindings.size(); i < count; ++i)
+    {
+        SAFE_RELEASE(_streamBindings[i].binding);
+    }
+    _streamBindings.clear();
+}
 
 }
@@ -12,6 +12,9 @@ namespace gameplay
  */
 class MeshBatch
 {
+    friend class ModelBatch;
+    friend class SpriteBatch;
+
 public:
 
     /**
@@ -63,6 +66,29 @@ public:
      */
     void setCapacity(unsigned int capacity);
 
+    /**
+     * Determines if the batch streams its primitives to buffers on the graphics device.
+     *
+     * @return true if the batch is streaming, false if it draws from client memory.
+     */
+    bool isStreaming() const;
+
+    /**
+     * Sets whether the batch streams its primitives to buffers on the graphics device.
+     *
+     * By default a batch draws its primitives from client memory on every draw. A streaming
+     * batch instead uploads them once per batch, when it is finished, to vertex and index
+     * buffers whose previous contents are orphaned so that the upload does not wait for the
+     * previous batch to be drawn. The buffers are written through glMapBufferRange where it
+     * is available.
+     *
+     * A streaming batch grows geometrically, at least by its grow size, and is not limited
+     * to 16-bit indices: its primitives are drawn in one draw call per 65536 vertices.
+     *
+     * @param streaming true to stream the batch, false to draw it from client memory.
+     */
+    void setStreaming(bool streaming);
+
     /**
      * Returns the material for this mesh batch.
      *
@@ -131,10 +157,58 @@ private:
      */
     MeshBatch& operator=(const MeshBatch&);
 
+    /**
+     * The start of a range of a streaming batch that is drawn by a single draw call, where
+     * indices are relative to the first vertex of the range.
+     */
+    struct Segment
+    {
+        unsigned int firstVertex;
+        unsigned int firstIndex;
+    };
+
+    /**
+     * The binding of a pass to the vertices of a segment of the vertex buffer.
+     */
+    struct StreamBinding
+    {
+        Pass* pass;
+        unsigned int segment;
+        unsigned int firstVertex;
+        VertexAttributeBinding* binding;
+    };
+
+    /**
+     * Adds vertices of the batch's vertex format, given as raw bytes, and their indices.
+     */
+    void add(const void* vertices, size_t vertexSize, unsigned int vertexCount, const unsigned short* indices, unsigned int indexCount);
+
+    /**
+     * Adds indices and space for their vertices to the batch.
+     *
+     * @return The vertices to write, or NULL if the batch is full and cannot grow.
+     */
+    unsigned char* addVertices(unsigned int vertexCount, const unsigned short* indices, unsigned int indexCount);
+
     void updateVertexAttributeBinding();
 
     bool resize(unsigned int capacity);
 
+    /**
+     * Draws a streaming batch from its buffers.
+     */
+    void drawStream();
+
+    /**
+     * Gets the binding of a pass to the vertices of a segment, creating it if needed.
+     */
+    VertexAttributeBinding* getStreamBinding(Pass* pass, unsigned int segment);
+
+    /**
+     * Releases the bindings of the passes to the vertex buffer.
+     */
+    void releaseStreamBindings();
+
     const VertexFormat _vertexFormat;
     Mesh::PrimitiveType _primitiveType;
     Material* _material;
@@ -149,6 +223,14 @@ private:
     unsigned char* _verticesPtr;
     unsigned short* _indices;
     unsigned short* _indicesPtr;
+    bool _streaming;
+    bool _streamDirty;
+    VertexBufferHandle _vertexBuffer;
+    IndexBufferHandle _indexBuffer;
+    unsigned int _vertexBufferSize;
+    unsigned int _indexBufferSize;
+    std::vector<Segment> _segments;
+    std::vector<StreamBinding> _streamBindings;
 
 };
 
@@ -1,15 +1,81 @@
 #include "Base.h"
 #include "MeshSkin.h"
 #include "Joint.h"
+#include "Model.h"
+
+#if defined(USE_NEON)
+#include <arm_neon.h>
+#elif defined(USE_SSE)
+#include <xmmintrin.h>
+#endif
 
 // The number of rows in each palette matrix.
 #define PALETTE_ROWS 3
 
+// The maximum number of joints influencing a vertex.
+#define SKIN_MAX_INFLUENCES 4
+
 namespace gameplay
 {
 
+/**
+ * Allocates an array of floats aligned to 16 bytes. The returned data pointer must be deleted.
+ */
+static float* allocateAligned(unsigned int count, float** data)
+{
+    GP_ASSERT(data);
+    *data = new float[count + 3];
+    return (float*)(((size_t)*data + 15) & ~(size_t)15);
+}
+
+/**
+ * Computes the first three rows of the product of a (column-major) world matrix and a skin matrix
+ * stored as four aligned rows, and writes them as three aligned rows to the palette.
+ */
+static void multiplyPaletteRows(const float* world, const float* skinRows, float* palette)
+{
+#if defined(USE_NEON)
+    float32x4_t s0 = vld1q_f32(skinRows);
+    float32x4_t s1 = vld1q_f32(skinRows + 4);
+    float32x4_t s2 = vld1q_f32(skinRows + 8);
+    float32x4_t s3 = vld1q_f32(skinRows + 12);
+    for (unsigned int r = 0; r < PALETTE_ROWS; ++r)
+    {
+        float32x4_t row = vmulq_n_f32(s0, world[r]);
+        row = vmlaq_n_f32(row, s1, world[4 + r]);
+        row = vmlaq_n_f32(row, s2, world[8 + r]);
+        row = vmlaq_n_f32(row, s3, world[12 + r]);
+        vst1q_f32(palette + r * 4, row);
+    }
+#elif defined(USE_SSE)
+    __m128 s0 = _mm_load_ps(skinRows);
+    __m128 s1 = _mm_load_ps(skinRows + 4);
+    __m128 s2 = _mm_load_ps(skinRows + 8);
+    __m128 s3 = _mm_load_ps(skinRows + 12);
+    for (unsigned int r = 0; r < PALETTE_ROWS; ++r)
+    {
+        __m128 row = _mm_mul_ps(s0, _mm_set1_ps(world[r]));
+        row = _mm_add_ps(row, _mm_mul_ps(s1, _mm_set1_ps(world[4 + r])));
+        row = _mm_add_ps(row, _mm_mul_ps(s2, _mm_set1_ps(world[8 + r])));
+        row = _mm_add_ps(row, _mm_mul_ps(s3, _mm_set1_ps(world[12 + r])));
+        _mm_store_ps(palette + r * 4, row);
+    }
+#else
+    for (unsigned int r = 0; r < PALETTE_ROWS; ++r)
+    {
+        for (unsigned int c = 0; c < 4; ++c)
+        {
+            palette[r * 4 + c] = world[r] * skinRows[c] + world[4 + r] * skinRows[4 + c] +
+                                 world[8 + r] * skinRows[8 + c] + world[12 + r] * skinRows[12 + c];
+        }
+    }
+#endif
+}
+
 MeshSkin::MeshSkin()
-    : _rootJoint(NULL), _rootNode(NULL), _matrixPalette(NULL), _model(NULL)
+    : _rootJoint(NULL), _rootNode(NULL), _matrixPalette(NULL), _matrixPaletteData(NULL),
+      _skinMatrices(NULL), _skinMatricesData(NULL), _skinMatricesDirty(true),
+      _bindPoseVertices(NULL), _skinnedVertices(NULL), _vertexCount(0), _model(NULL)
 {
 }
 
@@ -17,7 +83,10 @@ MeshSkin::~MeshSkin()
 {
     clearJoints();
 
-    SAFE_DELETE_ARRAY(_matrixPalette);
+    SAFE_DELETE_ARRAY(_matrixPaletteData);
+    SAFE_DELETE_ARRAY(_skinMatricesData);
+    SAFE_DELETE_ARRAY(_bindPoseVertices);
+    SAFE_DELETE_ARRAY(_skinnedVertices);
 }
 
 const Matrix& MeshSkin::getBindShape() const
@@ -28,6 +97,7 @@ const Matrix& MeshSkin::getBindShape() const
 void MeshSkin::setBindShape(const float* matrix)
 {
     _bindShape.set(matrix);
+    _skinMatricesDirty = true;
 }
 
 unsigned int MeshSkin::getJointCount() const
@@ -61,6 +131,15 @@ MeshSkin* MeshSkin::clone(NodeCloneContext &context) const
 {
     MeshSkin* skin = new MeshSkin();
     skin->_bindShape = _bindShape;
+    if (_bindPoseVertices)
+    {
+        GP_ASSERT(_model && _model->getMesh());
+        unsigned int floatCount = _vertexCount * _model->getMesh()->getVertexSize() / sizeof(float);
+        skin->_vertexCount = _vertexCount;
+        skin->_bindPoseVertices = new float[floatCount];
+        skin->_skinnedVertices = new float[floatCount];
+        memcpy(skin->_bindPoseVertices, _bindPoseVertices, floatCount * sizeof(float));
+    }
     if (_rootNode && _rootJoint)
     {
         const unsigned int jointCount = getJointCount();
@@ -121,11 +200,18 @@ void MeshSkin::setJointCount(unsigned int jointCount)
     }
 
     // Rebuild the matrix palette. Each matrix is 3 rows of Vector4.
-    SAFE_DELETE_ARRAY(_matrixPalette);
+    SAFE_DELETE_ARRAY(_matrixPaletteData);
+    SAFE_DELETE_ARRAY(_skinMatricesData);
+    _matrixPalette = NULL;
+    _skinMatrices = NULL;
+    _skinMatrixVersions.clear();
+    _skinMatricesDirty = true;
 
     if (jointCount > 0)
     {
-        _matrixPalette = new Vector4[jointCount * PALETTE_ROWS];
+        _matrixPalette = (Vector4*)allocateAligned(jointCount * PALETTE_ROWS * 4, &_matrixPaletteData);
+        _skinMatrices = allocateAligned(jointCount * 16, &_skinMatricesData);
+        _skinMatrixVersions.resize(jointCount, 0);
         for (unsigned int i = 0; i < jointCount * PALETTE_ROWS; i+=PALETTE_ROWS)
         {
             _matrixPalette[i+0].set(1.0f, 0.0f, 0.0f, 0.0f);
@@ -146,11 +232,13 @@ void MeshSkin::setJoint(Joint* joint, unsigned int index)
     }
 
     _joints[index] = joint;
+    _skinMatricesDirty = true;
 
     if (joint)
     {
         joint->addRef();
         joint->_skinCount++;
+        joint->_jointMatrixDirty = true;
     }
 }
 
@@ -158,12 +246,42 @@ Vector4* MeshSkin::getMatrixPalette() const
 {
     GP_ASSERT(_matrixPalette);
 
+    updateMatrixPalette();
+    return _matrixPalette;
+}
+
+void MeshSkin::updateMatrixPalette() const
+{
+    GP_ASSERT(_matrixPalette && _skinMatrices);
+
+    Matrix skinMatrix;
+    float* palette = (float*)_matrixPalette;
     for (size_t i = 0, count = _joints.size(); i < count; i++)
     {
-        GP_ASSERT(_joints[i]);
-        _joints[i]->updateJointMatrix(getBindShape(), &_matrixPalette[i * PALETTE_ROWS]);
+        Joint* joint = _joints[i];
+        GP_ASSERT(joint);
+
+        // Cache the product of the joint's inverse bind pose and the bind shape, which
+        // only changes when either of them is set, as rows for the SIMD multiply below.
+        float* skinRows = _skinMatrices + i * 16;
+        if (_skinMatricesDirty || _skinMatrixVersions[i] != joint->_bindPoseVersion)
+        {
+            Matrix::multiply(joint->getInverseBindPose(), _bindShape, &skinMatrix);
+            skinMatrix.transpose();
+            memcpy(skinRows, skinMatrix.m, 16 * sizeof(float));
+            _skinMatrixVersions[i] = joint->_bindPoseVersion;
+            joint->_jointMatrixDirty = true;
+        }
+
+        // Note: If more than one MeshSkin influences this Joint, we need to skip
+        // the _jointMatrixDirty optimization since the palette of each skin is different.
+        if (joint->_skinCount > 1 || joint->_jointMatrixDirty)
+        {
+            joint->_jointMatrixDirty = false;
+            multiplyPaletteRows(joint->getWorldMatrix().m, skinRows, palette + i * PALETTE_ROWS * 4);
+        }
     }
-    return _matrixPalette;
+    _skinMatricesDirty = false;
 }
 
 unsigned int MeshSkin::getMatrixPaletteSize() const
@@ -176,6 +294,154 @@ Model* MeshSkin::getModel() const
     return _model;
 }
 
+bool MeshSkin::isCpuSkinning() const
+{
+    return _bindPoseVertices != NULL;
+}
+
+void MeshSkin::setCpuSkinning(const float* vertexData)
+{
+    SAFE_DELETE_ARRAY(_bindPoseVertices);
+    SAFE_DELETE_ARRAY(_skinnedVertices);
+    _vertexCount = 0;
+
+    if (vertexData)
+    {
+        GP_ASSERT(_model && _model->getMesh());
+        Mesh* mesh = _model->getMesh();
+        unsigned int floatCount = mesh->getVertexCount() * mesh->getVertexSize() / sizeof(float);
+        _vertexCount = mesh->getVertexCount();
+        _bindPoseVertices = new float[floatCount];
+        _skinnedVertices = new float[floatCount];
+        memcpy(_bindPoseVertices, vertexData, floatCount * sizeof(float));
+    }
+
+    if (_model && _model->getNode())
+    {
+        _model->getNode()->setBoundsDirty();
+    }
+}
+
+void MeshSkin::skinVertices()
+{
+    GP_ASSERT(_bindPoseVertices && _skinnedVertices);
+    GP_ASSERT(_model && _model->getMesh());
+
+    Mesh* mesh = _model->getMesh();
+    GP_ASSERT(mesh->getVertexCount() == _vertexCount);
+
+    // Locate the elements of the vertex format to skin.
+    const VertexFormat& format = mesh->getVertexFormat();
+    int position = -1;
+    int normal = -1;
+    int tangent = -1;
+    int binormal = -1;
+    int weights = -1;
+    int indices = -1;
+    unsigned int influenceCount = 0;
+    unsigned int offset = 0;
+    for (unsigned int i = 0, count = format.getElementCount(); i < count; ++i)
+    {
+        const VertexFormat::Element& element = format.getElement(i);
+        switch (element.usage)
+        {
+        case VertexFormat::POSITION:
+            position = offset;
+            break;
+        case VertexFormat::NORMAL:
+            normal = offset;
+            break;
+        case VertexFormat::TANGENT:
+            tangent = offset;
+            break;
+        case VertexFormat::BINORMAL:
+            binormal = offset;
+            break;
+        case VertexFormat::BLENDWEIGHTS:
+            weights = offset;
+            influenceCount = std::min(element.size, (unsigned int)SKIN_MAX_INFLUENCES);
+            break;
+        case VertexFormat::BLENDINDICES:
+            indices = offset;
+            break;
+        default:
+            break;
+        }
+        offset += element.size;
+    }
+    if (position < 0 || weights < 0 || indices < 0)
+    {
+        GP_WARN("Failed to skin mesh on the CPU; its vertex format has no position, blend weights or blend indices.");
+        return;
+    }
+
+    const float* palette = (const float*)getMatrixPalette();
+    unsigned int jointCount = (unsigned int)_joints.size();
+    unsigned int vertexStride = offset;
+    memcpy(_skinnedVertices, _bindPoseVertices, _vertexCount * vertexStride * sizeof(float));
+
+    Vector3 min(FLT_MAX, FLT_MAX, FLT_MAX);
+    Vector3 max(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    for (unsigned int v = 0; v < _vertexCount; ++v)
+    {
+        const float* src = _bindPoseVertices + v * vertexStride;
+        float* dst = _skinnedVertices + v * vertexStride;
+
+        // Blend the palette matrices of the joints influencing the vertex.
+        float m[PALETTE_ROWS * 4];
+        memset(m, 0, sizeof(m));
+        for (unsigned int i = 0; i < influenceCount; ++i)
+        {
+            float weight = src[weights + i];
+            unsigned int joint = (unsigned int)src[indices + i];
+            if (weight == 0.0f || joint >= jointCount)
+                continue;
+
+            const float* jointMatrix = palette + joint * PALETTE_ROWS * 4;
+            for (unsigned int j = 0; j < PALETTE_ROWS * 4; ++j)
+                m[j] += jointMatrix[j] * weight;
+        }
+
+        const float* p = src + position;
+        float x = m[0] * p[0] + m[1] * p[1] + m[2] * p[2] + m[3];
+        float y = m[4] * p[0] + m[5] * p[1] + m[6] * p[2] + m[7];
+        float z = m[8] * p[0] + m[9] * p[1] + m[10] * p[2] + m[11];
+        dst[position] = x;
+        dst[position + 1] = y;
+        dst[position + 2] = z;
+
+        min.set(std::min(min.x, x), std::min(min.y, y), std::min(min.z, z));
+        max.set(std::max(max.x, x), std::max(max.y, y), std::max(max.z, z));
+
+        // Directions are only rotated.
+        int directions[3] = { normal, tangent, binormal };
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+            if (directions[i] < 0)
+                continue;
+
+            const float* d = src + directions[i];
+            float* out = dst + directions[i];
+            out[0] = m[0] * d[0] + m[1] * d[1] + m[2] * d[2];
+            out[1] = m[4] * d[0] + m[5] * d[1] + m[6] * d[2];
+            out[2] = m[8] * d[0] + m[9] * d[1] + m[10] * d[2];
+        }
+    }
+
+    mesh->setVertexData(_skinnedVertices, 0, _vertexCount);
+
+    // Update the bounds of the model's node from the skinned vertices.
+    if (_vertexCount > 0)
+    {
+        _skinnedBounds.center.set((min.x + max.x) * 0.5f, (min.y + max.y) * 0.5f, (min.z + max.z) * 0.5f);
+        _skinnedBounds.radius = _skinnedBounds.center.distance(max);
+    }
+    if (_model->getNode())
+    {
+        _model->getNode()->setBoundsDirty();
+    }
+}
+
 Joint* MeshSkin::getRootJoint() const
 {
     return _rootJoint;
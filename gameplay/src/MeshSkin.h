@@ -3,6 +3,7 @@
 
 #include "Matrix.h"
 #include "Transform.h"
+#include "BoundingSphere.h"
 
 namespace gameplay
 {
@@ -21,6 +22,8 @@ class MeshSkin : public Transform::Listener
     friend class Model;
     friend class Joint;
     friend class Node;
+    friend class NodeIndex;
+    friend class RenderQueue;
 
 public:
 
@@ -86,6 +89,9 @@ public:
 
     /**
      * Returns the pointer to the Vector4 array for the purpose of binding to a shader.
+     *
+     * The palette matrices of all joints that have changed are rebuilt in a single pass,
+     * using SIMD instructions where available. The array is aligned to 16 bytes.
      * 
      * @return The pointer to the matrix palette.
      */
@@ -105,6 +111,32 @@ public:
      */
     Model* getModel() const;
 
+    /**
+     * Determines if the skin is applied to the mesh vertices on the CPU.
+     *
+     * @return true if the mesh is skinned on the CPU, false if it is skinned in the vertex shader.
+     */
+    bool isCpuSkinning() const;
+
+    /**
+     * Enables or disables skinning the mesh vertices on the CPU instead of in the vertex shader.
+     *
+     * When enabled, the vertices of the model's mesh are transformed by the joints and written
+     * into the mesh's vertex buffer each time the model is drawn. The mesh should be dynamic and
+     * the materials of the model must not use a skinning vertex shader (the SKINNING define).
+     * This helps with GL drivers that cannot hold the matrix palette of the skin in their vertex
+     * shader uniforms, and the bounds of the model's node follow the skinned vertices.
+     *
+     * Models loaded from a bundle are skinned on the CPU when skinning.cpu is set to true in the
+     * game config.
+     *
+     * The skin must be set on a model before enabling CPU skinning.
+     *
+     * @param vertexData The vertices of the mesh in its bind pose, in the mesh's vertex format,
+     *      or NULL to skin the mesh in the vertex shader.
+     */
+    void setCpuSkinning(const float* vertexData);
+
     /**
      * Handles transform change events for joints.
      */
@@ -169,6 +201,16 @@ private:
      */
     void clearJoints();
 
+    /**
+     * Rebuilds the palette matrices of the joints that have changed.
+     */
+    void updateMatrixPalette() const;
+
+    /**
+     * Transforms the bind pose vertices by the joints into the model's mesh. Called by Model::draw().
+     */
+    void skinVertices();
+
     Matrix _bindShape;
     std::vector<Joint*> _joints;
     Joint* _rootJoint;
@@ -183,6 +225,20 @@ private:
     // Each 4x3 row-wise matrix is represented as 3 Vector4's.
     // The number of Vector4's is (_joints.size() * 3).
     Vector4* _matrixPalette;
+    float* _matrixPaletteData;
+
+    // The inverse bind pose of each joint multiplied by the bind shape,
+    // stored as 4 rows of floats aligned to 16 bytes.
+    float* _skinMatrices;
+    float* _skinMatricesData;
+    mutable std::vector<unsigned int> _skinMatrixVersions;
+    mutable bool _skinMatricesDirty;
+
+    // The bind pose vertices and the skinned vertices of the mesh when skinning on the CPU.
+    float* _bindPoseVertices;
+    float* _skinnedVertices;
+    unsigned int _vertexCount;
+    BoundingSphere _skinnedBounds;
     Model* _model;
 };
 
@@ -1,16 +1,20 @@
 #include "Base.h"
 #include "Model.h"
+#include "Camera.h"
 #include "MeshPart.h"
 #include "Scene.h"
 #include "Technique.h"
 #include "Pass.h"
 #include "Node.h"
+#include "Profiler.h"
+#include "RenderQueue.h"
 
 namespace gameplay
 {
 
 Model::Model(Mesh* mesh) :
-    _mesh(mesh), _material(NULL), _partCount(0), _partMaterials(NULL), _node(NULL), _skin(NULL)
+    _mesh(mesh), _material(NULL), _partCount(0), _partMaterials(NULL), _node(NULL), _skin(NULL),
+    _level(0), _fixedLevel(-1), _levelHysteresis(0.1f)
 {
     GP_ASSERT(mesh);
     _partCount = mesh->getPartCount();
@@ -29,6 +33,12 @@ Model::~Model()
         SAFE_DELETE_ARRAY(_partMaterials);
     }
 
+    releaseLevelBindings();
+    for (size_t i = 0, count = _levels.size(); i < count; ++i)
+    {
+        SAFE_RELEASE(_levels[i].mesh);
+    }
+
     SAFE_RELEASE(_mesh);
 
     SAFE_DELETE(_skin);
@@ -124,6 +134,9 @@ void Model::setMaterial(Material* material, int partIndex)
     // Release existing material and binding.
     if (oldMaterial)
     {
+        // Level bindings are created again for the effects of the new material.
+        releaseLevelBindings();
+
         for (unsigned int i = 0, tCount = oldMaterial->getTechniqueCount(); i < tCount; ++i)
         {
             Technique* t = oldMaterial->getTechniqueByIndex(i);
@@ -255,9 +268,21 @@ void Model::setNode(Node* node)
 
 void Model::draw(bool wireframe)
 {
+    Profiler::Scope profilerScope("Model::draw");
+
     GP_ASSERT(_mesh);
 
-    unsigned int partCount = _mesh->getPartCount();
+    if (_skin && _skin->isCpuSkinning())
+    {
+        _skin->skinVertices();
+    }
+
+    unsigned int level = updateLevel();
+    Mesh* mesh = getLevelMesh(level);
+    GP_ASSERT(mesh);
+
+    // Passes are bound with the vertex attribute binding of the level's mesh.
+    unsigned int partCount = mesh->getPartCount();
     if (partCount == 0)
     {
         // No mesh parts (index buffers).
@@ -270,21 +295,15 @@ void Model::draw(bool wireframe)
             {
                 Pass* pass = technique->getPassByIndex(i);
                 GP_ASSERT(pass);
-                pass->bind();
+                VertexAttributeBinding* binding = getLevelBinding(level, pass);
+                pass->getEffect()->bind();
+                pass->RenderState::bind(pass);
+                if (binding)
+                    binding->bind();
                 GL_ASSERT( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0) );
-                if (wireframe && (_mesh->getPrimitiveType() == Mesh::TRIANGLES || _mesh->getPrimitiveType() == Mesh::TRIANGLE_STRIP))
-                {
-                    unsigned int vertexCount = _mesh->getVertexCount();
-                    for (unsigned int j = 0; j < vertexCount; j += 3)
-                    {
-                        GL_ASSERT( glDrawArrays(GL_LINE_LOOP, j, 3) );
-                    }
-                }
-                else
-                {
-                    GL_ASSERT( glDrawArrays(_mesh->getPrimitiveType(), 0, _mesh->getVertexCount()) );
-                }
-                pass->unbind();
+                drawPart(mesh, NULL, wireframe);
+                if (binding)
+                    binding->unbind();
             }
         }
     }
@@ -292,11 +311,11 @@ void Model::draw(bool wireframe)
     {
         for (unsigned int i = 0; i < partCount; ++i)
         {
-            MeshPart* part = _mesh->getPart(i);
+            MeshPart* part = mesh->getPart(i);
             GP_ASSERT(part);
 
             // Get the material for this mesh part.
-            Material* material = getMaterial(i);
+            Material* material = getPartMaterial(i);
             if (material)
             {
                 Technique* technique = material->getTechnique();
@@ -306,44 +325,227 @@ void Model::draw(bool wireframe)
                 {
                     Pass* pass = technique->getPassByIndex(j);
                     GP_ASSERT(pass);
-                    pass->bind();
+                    VertexAttributeBinding* binding = getLevelBinding(level, pass);
+                    pass->getEffect()->bind();
+                    pass->RenderState::bind(pass);
+                    if (binding)
+                        binding->bind();
                     GL_ASSERT( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, part->_indexBuffer) );
-                    if (wireframe && (_mesh->getPrimitiveType() == Mesh::TRIANGLES || _mesh->getPrimitiveType() == Mesh::TRIANGLE_STRIP))
-                    {
-                        unsigned int indexCount = part->getIndexCount();
-                        unsigned int indexSize = 0;
-                        switch (part->getIndexFormat())
-                        {
-                        case Mesh::INDEX8:
-                            indexSize = 1;
-                            break;
-                        case Mesh::INDEX16:
-                            indexSize = 2;
-                            break;
-                        case Mesh::INDEX32:
-                            indexSize = 4;
-                            break;
-                        default:
-                            GP_ERROR("Unsupported index format (%d).", part->getIndexFormat());
-                            continue;
-                        }
-
-                        for (unsigned int k = 0; k < indexCount; k += 3)
-                        {
-                            GL_ASSERT( glDrawElements(GL_LINE_LOOP, 3, part->getIndexFormat(), ((const GLvoid*)(k*indexSize))) );
-                        }
-                    }
-                    else
-                    {
-                        GL_ASSERT( glDrawElements(part->getPrimitiveType(), part->getIndexCount(), part->getIndexFormat(), 0) );
-                    }
-                    pass->unbind();
+                    drawPart(mesh, part, wireframe);
+                    if (binding)
+                        binding->unbind();
                 }
             }
         }
     }
 }
 
+unsigned int Model::addLevel(Mesh* mesh, float screenSize)
+{
+    GP_ASSERT(mesh);
+    GP_ASSERT(screenSize > 0.0f);
+    GP_ASSERT(_levels.empty() || screenSize < _levels.back().screenSize);
+
+    mesh->addRef();
+    Level level;
+    level.mesh = mesh;
+    level.screenSize = screenSize;
+    _levels.push_back(level);
+    return (unsigned int)_levels.size();
+}
+
+unsigned int Model::getLevelCount() const
+{
+    return (unsigned int)_levels.size() + 1;
+}
+
+Mesh* Model::getLevelMesh(unsigned int level) const
+{
+    GP_ASSERT(level <= _levels.size());
+    return level == 0 ? _mesh : _levels[level - 1].mesh;
+}
+
+float Model::getLevelScreenSize(unsigned int level) const
+{
+    GP_ASSERT(level > 0 && level <= _levels.size());
+    return _levels[level - 1].screenSize;
+}
+
+unsigned int Model::getLevel() const
+{
+    return _level;
+}
+
+void Model::setLevel(int level)
+{
+    GP_ASSERT(level < (int)getLevelCount());
+
+    _fixedLevel = level;
+    if (level >= 0)
+    {
+        _level = (unsigned int)level;
+    }
+}
+
+unsigned int Model::selectLevel(const Camera* camera)
+{
+    GP_ASSERT(camera);
+
+    if (_levels.empty())
+        return 0;
+
+    // The levels share the bounding sphere of the model's mesh.
+    BoundingSphere sphere(_mesh->getBoundingSphere());
+    if (_node)
+    {
+        sphere.transform(_node->getWorldMatrix());
+    }
+    float size = camera->getScreenSize(sphere);
+
+    // Move to a coarser level once the model is clearly smaller than its screen size, and
+    // back to a finer level once the model is clearly larger than the current one's.
+    unsigned int levelCount = (unsigned int)_levels.size();
+    while (_level < levelCount && size < _levels[_level].screenSize * (1.0f - _levelHysteresis))
+    {
+        ++_level;
+    }
+    while (_level > 0 && size > _levels[_level - 1].screenSize * (1.0f + _levelHysteresis))
+    {
+        --_level;
+    }
+    return _level;
+}
+
+float Model::getLevelHysteresis() const
+{
+    return _levelHysteresis;
+}
+
+void Model::setLevelHysteresis(float hysteresis)
+{
+    GP_ASSERT(hysteresis >= 0.0f && hysteresis < 1.0f);
+    _levelHysteresis = hysteresis;
+}
+
+Material* Model::getPartMaterial(unsigned int partIndex) const
+{
+    if (partIndex < _partCount && _partMaterials && _partMaterials[partIndex])
+    {
+        return _partMaterials[partIndex];
+    }
+    return _material;
+}
+
+unsigned int Model::updateLevel()
+{
+    if (_levels.empty())
+        return 0;
+
+    // Skinning on the CPU only updates the vertices of the model's mesh.
+    if (_skin && _skin->isCpuSkinning())
+        return 0;
+
+    if (_fixedLevel < 0 && _node)
+    {
+        Scene* scene = _node->getScene();
+        if (scene && scene->getActiveCamera())
+        {
+            selectLevel(scene->getActiveCamera());
+        }
+    }
+    return _level;
+}
+
+VertexAttributeBinding* Model::getLevelBinding(unsigned int level, Pass* pass)
+{
+    GP_ASSERT(pass);
+
+    if (level == 0)
+        return pass->getVertexAttributeBinding();
+
+    // Bindings are created the first time a level is drawn with an effect.
+    Level& l = _levels[level - 1];
+    Effect* effect = pass->getEffect();
+    for (size_t i = 0, count = l.bindings.size(); i < count; ++i)
+    {
+        if (l.bindings[i].effect == effect)
+            return l.bindings[i].binding;
+    }
+    LevelBinding b;
+    b.effect = effect;
+    b.binding = VertexAttributeBinding::create(l.mesh, effect);
+    l.bindings.push_back(b);
+    return b.binding;
+}
+
+void Model::releaseLevelBindings()
+{
+    for (size_t i = 0, count = _levels.size(); i < count; ++i)
+    {
+        std::vector<LevelBinding>& bindings = _levels[i].bindings;
+        for (size_t j = 0, bindingCount = bindings.size(); j < bindingCount; ++j)
+        {
+            SAFE_RELEASE(bindings[j].binding);
+        }
+        bindings.clear();
+    }
+}
+
+void Model::drawPart(Mesh* mesh, MeshPart* part, bool wireframe)
+{
+    GP_ASSERT(mesh);
+
+    bool drawWireframe = wireframe && (mesh->getPrimitiveType() == Mesh::TRIANGLES || mesh->getPrimitiveType() == Mesh::TRIANGLE_STRIP);
+    if (part == NULL)
+    {
+        if (drawWireframe)
+        {
+            unsigned int vertexCount = mesh->getVertexCount();
+            for (unsigned int j = 0; j < vertexCount; j += 3)
+            {
+                GL_ASSERT( glDrawArrays(GL_LINE_LOOP, j, 3) );
+                ++RenderQueue::_frameCounters.drawCalls;
+            }
+        }
+        else
+        {
+            GL_ASSERT( glDrawArrays(mesh->getPrimitiveType(), 0, mesh->getVertexCount()) );
+            ++RenderQueue::_frameCounters.drawCalls;
+        }
+    }
+    else if (drawWireframe)
+    {
+        unsigned int indexCount = part->getIndexCount();
+        unsigned int indexSize = 0;
+        switch (part->getIndexFormat())
+        {
+        case Mesh::INDEX8:
+            indexSize = 1;
+            break;
+        case Mesh::INDEX16:
+            indexSize = 2;
+            break;
+        case Mesh::INDEX32:
+            indexSize = 4;
+            break;
+        default:
+            GP_ERROR("Unsupported index format (%d).", part->getIndexFormat());
+            return;
+        }
+
+        for (unsigned int k = 0; k < indexCount; k += 3)
+        {
+            GL_ASSERT( glDrawElements(GL_LINE_LOOP, 3, part->getIndexFormat(), ((const GLvoid*)(k*indexSize))) );
+            ++RenderQueue::_frameCounters.drawCalls;
+        }
+    }
+    else
+    {
+        GL_ASSERT( glDrawElements(part->getPrimitiveType(), part->getIndexCount(), part->getIndexFormat(), 0) );
+        ++RenderQueue::_frameCounters.drawCalls;
+    }
+}
+
 void Model::validatePartCount()
 {
     GP_ASSERT(_mesh);
@@ -385,6 +587,13 @@ Model* Model::clone(NodeCloneContext &context)
     {
         model->setSkin(getSkin()->clone(context));
     }
+    for (size_t i = 0, count = _levels.size(); i < count; ++i)
+    {
+        model->addLevel(_levels[i].mesh, _levels[i].screenSize);
+    }
+    model->_fixedLevel = _fixedLevel;
+    model->_level = _level;
+    model->_levelHysteresis = _levelHysteresis;
     if (getMaterial())
     {
         Material* materialClone = getMaterial()->clone(context);
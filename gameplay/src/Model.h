@@ -9,6 +9,7 @@ namespace gameplay
 {
 
 class Bundle;
+class Camera;
 class MeshSkin;
 class Node;
 class NodeCloneContext;
@@ -22,6 +23,8 @@ class Model : public Ref
     friend class Node;
     friend class Mesh;
     friend class Bundle;
+    friend class ModelBatch;
+    friend class RenderQueue;
 
 public:
 
@@ -146,8 +149,118 @@ public:
      */
     void draw(bool wireframe = false);
 
+    /**
+     * Adds a level of detail, a simpler mesh that is drawn in place of the mesh of this
+     * model while the model is small on screen.
+     *
+     * The mesh of the model is level 0, and each level added must be less detailed and
+     * have a smaller screen size than the level before it. The parts of a level are drawn
+     * with the material of the part of the model's mesh at the same index, or the shared
+     * material, so the mesh must have the vertex attributes these materials use. Levels
+     * of skinned models must be skinned by the same joints, and are not drawn while the
+     * skin is skinned on the CPU.
+     *
+     * @param mesh The mesh of the level.
+     * @param screenSize The size on screen of the model's bounding sphere, as a fraction
+     *      of the viewport height, below which the level is drawn.
+     *
+     * @return The index of the level.
+     */
+    unsigned int addLevel(Mesh* mesh, float screenSize);
+
+    /**
+     * Returns the number of levels of detail, including the mesh of this model.
+     *
+     * @return The number of levels of detail.
+     */
+    unsigned int getLevelCount() const;
+
+    /**
+     * Returns the mesh of a level of detail.
+     *
+     * @param level The index of the level, 0 for the mesh of this model.
+     *
+     * @return The mesh of the level.
+     */
+    Mesh* getLevelMesh(unsigned int level) const;
+
+    /**
+     * Returns the screen size below which a level of detail is drawn.
+     *
+     * @param level The index of the level, 1 or greater.
+     *
+     * @return The screen size of the level, as a fraction of the viewport height.
+     */
+    float getLevelScreenSize(unsigned int level) const;
+
+    /**
+     * Returns the level of detail this model is drawn with.
+     *
+     * @return The index of the level.
+     */
+    unsigned int getLevel() const;
+
+    /**
+     * Sets the level of detail this model is drawn with.
+     *
+     * By default, the level is selected each time the model is drawn, or added to a render
+     * queue, from the active camera of the scene of its node.
+     *
+     * @param level The index of the level to always draw, or -1 to select it from the camera.
+     */
+    void setLevel(int level);
+
+    /**
+     * Selects the level of detail to draw from the size on screen of the bounding sphere
+     * of this model through a camera.
+     *
+     * The model only moves to another level once its size is past the screen size of the
+     * level by a fraction of that size, the hysteresis, so that a model that moves back
+     * and forth around the screen size does not switch between levels each frame.
+     *
+     * @param camera The camera to select the level for.
+     *
+     * @return The index of the selected level.
+     */
+    unsigned int selectLevel(const Camera* camera);
+
+    /**
+     * Returns the hysteresis of the level of detail selection.
+     *
+     * @return The fraction of the screen size of a level by which the size of the model must
+     *      pass it to switch levels.
+     */
+    float getLevelHysteresis() const;
+
+    /**
+     * Sets the hysteresis of the level of detail selection, 0.1 by default.
+     *
+     * @param hysteresis The fraction of the screen size of a level by which the size of the
+     *      model must pass it to switch levels.
+     */
+    void setLevelHysteresis(float hysteresis);
+
 private:
 
+    /**
+     * The vertex attribute binding of a level of detail for an effect.
+     */
+    struct LevelBinding
+    {
+        Effect* effect;
+        VertexAttributeBinding* binding;
+    };
+
+    /**
+     * A level of detail after the mesh of the model.
+     */
+    struct Level
+    {
+        Mesh* mesh;
+        float screenSize;
+        std::vector<LevelBinding> bindings;
+    };
+
     /**
      * Constructor.
      */
@@ -184,6 +297,38 @@ private:
 
     void validatePartCount();
 
+    /**
+     * Returns the material of a part of the mesh of any level, or the shared material
+     * if the part has none.
+     */
+    Material* getPartMaterial(unsigned int partIndex) const;
+
+    /**
+     * Selects the level of detail from the active camera of the scene of the node, unless
+     * a level is set, and returns the level to draw.
+     */
+    unsigned int updateLevel();
+
+    /**
+     * Returns the vertex attribute binding of the mesh of a level for a pass.
+     */
+    VertexAttributeBinding* getLevelBinding(unsigned int level, Pass* pass);
+
+    /**
+     * Releases the vertex attribute bindings of the levels of detail.
+     */
+    void releaseLevelBindings();
+
+    /**
+     * Draws a mesh part, or the whole mesh if the part is NULL, with the pass and
+     * index buffer already bound.
+     *
+     * @param mesh The mesh of the level of detail being drawn.
+     * @param part The mesh part to draw, or NULL if the mesh has no parts.
+     * @param wireframe If true, draw the model in wireframe mode.
+     */
+    void drawPart(Mesh* mesh, MeshPart* part, bool wireframe);
+
     /**
      * Clones the model and returns a new model.
      * 
@@ -198,6 +343,10 @@ private:
     Material** _partMaterials;
     Node* _node;
     MeshSkin* _skin;
+    std::vector<Level> _levels;
+    unsigned int _level;
+    int _fixedLevel;
+    float _levelHysteresis;
 };
 
 }
@@ -0,0 +1,512 @@
+#include "Base.h"
+#include "ModelBatch.h"
+#include "MeshBatch.h"
+#include "MeshPart.h"
+#include "Node.h"
+#include "RenderQueue.h"
+#include "Technique.h"
+
+// The number of floats of an instance: a column-major world matrix followed by a color.
+#define INSTANCE_SIZE 20
+
+// The number of vertices and indices a mesh batch draws at a time, leaving room for the
+// capacity of a batch to be rounded up to whole primitives.
+#define BATCH_VERTEX_LIMIT (USHRT_MAX - 2)
+
+namespace gameplay
+{
+
+static int __instancingSupported = -1;
+
+static const char* __instanceAttributeNames[] =
+{
+    "a_instanceMatrix0",
+    "a_instanceMatrix1",
+    "a_instanceMatrix2",
+    "a_instanceMatrix3",
+    "a_instanceColor"
+};
+
+static const float __identityColumns[16] =
+{
+    1.0f, 0.0f, 0.0f, 0.0f,
+    0.0f, 1.0f, 0.0f, 0.0f,
+    0.0f, 0.0f, 1.0f, 0.0f,
+    0.0f, 0.0f, 0.0f, 1.0f
+};
+
+/**
+ * Gets the number of primitives a mesh batch must hold for a number of vertices and indices.
+ */
+static unsigned int __getBatchCapacity(Mesh::PrimitiveType primitiveType, unsigned int count)
+{
+    switch (primitiveType)
+    {
+    case Mesh::TRIANGLES:
+        return (count + 2) / 3;
+    case Mesh::TRIANGLE_STRIP:
+        return count > 2 ? count - 2 : 1;
+    case Mesh::LINES:
+        return (count + 1) / 2;
+    case Mesh::LINE_STRIP:
+        return count > 1 ? count - 1 : 1;
+    default:
+        return count;
+    }
+}
+
+/**
+ * Sets the instance attributes of the passes of a material to constant values, for
+ * vertices that are already in world space.
+ */
+static void __setInstanceConstants(Material* material, const float* color)
+{
+    Technique* technique = material->getTechnique();
+    GP_ASSERT(technique);
+    for (unsigned int i = 0, passCount = technique->getPassCount(); i < passCount; ++i)
+    {
+        Effect* effect = technique->getPassByIndex(i)->getEffect();
+        GP_ASSERT(effect);
+        for (unsigned int j = 0; j < 5; ++j)
+        {
+            VertexAttribute attrib = effect->getVertexAttribute(__instanceAttributeNames[j]);
+            if (attrib != -1)
+            {
+                GL_ASSERT( glVertexAttrib4fv(attrib, j < 4 ? &__identityColumns[j * 4] : color) );
+            }
+        }
+    }
+}
+
+ModelBatch::ModelBatch(Model* model, unsigned int initialCapacity)
+    : _model(model), _instanceCount(0), _instanceBuffer(0), _instanceBufferCapacity(0), _instanceBufferDirty(false),
+      _meshData(NULL), _meshDataLoaded(false)
+{
+    _instances.reserve(initialCapacity * INSTANCE_SIZE);
+}
+
+ModelBatch::~ModelBatch()
+{
+    if (_instanceBuffer)
+    {
+        GL_ASSERT( glDeleteBuffers(1, &_instanceBuffer) );
+        _instanceBuffer = 0;
+    }
+    for (size_t i = 0, count = _partBatches.size(); i < count; ++i)
+    {
+        SAFE_DELETE(_partBatches[i]);
+    }
+    SAFE_DELETE(_meshData);
+    SAFE_RELEASE(_model);
+}
+
+ModelBatch* ModelBatch::create(Model* model, unsigned int initialCapacity)
+{
+    GP_ASSERT(model);
+    GP_ASSERT(model->getMesh());
+
+    if (model->getSkin())
+    {
+        GP_ERROR("Model batches do not support skinned models.");
+        return NULL;
+    }
+
+    model->addRef();
+    return new ModelBatch(model, initialCapacity);
+}
+
+Model* ModelBatch::getModel() const
+{
+    return _model;
+}
+
+bool ModelBatch::isInstancingSupported()
+{
+    if (__instancingSupported < 0)
+    {
+#ifdef __APPLE__
+        // The instancing functions are linked directly, so check for the extensions.
+        const char* extensions = (const char*)glGetString(GL_EXTENSIONS);
+        __instancingSupported = extensions && (strstr(extensions, "GL_EXT_instanced_arrays") ||
+            (strstr(extensions, "GL_ARB_instanced_arrays") && strstr(extensions, "GL_ARB_draw_instanced"))) ? 1 : 0;
+#else
+        __instancingSupported = (glDrawArraysInstanced && glDrawElementsInstanced && glVertexAttribDivisor) ? 1 : 0;
+#endif
+    }
+    return __instancingSupported == 1;
+}
+
+void ModelBatch::start()
+{
+    _instances.clear();
+    _instanceCount = 0;
+    _instanceBufferDirty = true;
+}
+
+void ModelBatch::add(Node* node, const Vector4& color)
+{
+    GP_ASSERT(node);
+
+    add(node->getWorldMatrix(), color);
+}
+
+void ModelBatch::add(const Matrix& worldMatrix, const Vector4& color)
+{
+    _instances.insert(_instances.end(), worldMatrix.m, worldMatrix.m + 16);
+    _instances.push_back(color.x);
+    _instances.push_back(color.y);
+    _instances.push_back(color.z);
+    _instances.push_back(color.w);
+    ++_instanceCount;
+    _instanceBufferDirty = true;
+}
+
+unsigned int ModelBatch::getInstanceCount() const
+{
+    return _instanceCount;
+}
+
+void ModelBatch::finish()
+{
+    if (!_instanceBufferDirty || _instanceCount == 0 || !isInstancingSupported())
+        return;
+
+    if (_instanceBuffer == 0)
+    {
+        GL_ASSERT( glGenBuffers(1, &_instanceBuffer) );
+    }
+    GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, _instanceBuffer) );
+
+    // Grow the buffer to fit the instances, or update its contents in place.
+    if (_instanceCount > _instanceBufferCapacity)
+    {
+        GL_ASSERT( glBufferData(GL_ARRAY_BUFFER, _instances.size() * sizeof(float), &_instances[0], GL_DYNAMIC_DRAW) );
+        _instanceBufferCapacity = _instanceCount;
+    }
+    else
+    {
+        GL_ASSERT( glBufferSubData(GL_ARRAY_BUFFER, 0, _instances.size() * sizeof(float), &_instances[0]) );
+    }
+    GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, 0) );
+
+    _instanceBufferDirty = false;
+}
+
+void ModelBatch::draw()
+{
+    if (_instanceCount == 0)
+        return;
+
+    Mesh* mesh = _model->getMesh();
+    GP_ASSERT(mesh);
+
+    bool instancing = isInstancingSupported();
+    unsigned int partCount = mesh->getPartCount();
+    for (unsigned int i = 0, count = partCount > 0 ? partCount : 1; i < count; ++i)
+    {
+        Material* material = partCount > 0 ? _model->getMaterial(i) : _model->getMaterial();
+        if (material == NULL)
+            continue;
+
+        if (instancing && hasInstanceAttributes(material))
+        {
+            finish();
+            drawInstanced(partCount > 0 ? mesh->getPart(i) : NULL, material);
+        }
+        else
+        {
+            drawBatched(i, material);
+        }
+    }
+}
+
+bool ModelBatch::hasInstanceAttributes(Material* material)
+{
+    GP_ASSERT(material);
+
+    Technique* technique = material->getTechnique();
+    GP_ASSERT(technique);
+    for (unsigned int i = 0, passCount = technique->getPassCount(); i < passCount; ++i)
+    {
+        Effect* effect = technique->getPassByIndex(i)->getEffect();
+        GP_ASSERT(effect);
+        if (effect->getVertexAttribute(__instanceAttributeNames[0]) == -1)
+            return false;
+    }
+    return true;
+}
+
+void ModelBatch::drawInstanced(MeshPart* part, Material* material)
+{
+    Mesh* mesh = _model->getMesh();
+    Technique* technique = material->getTechnique();
+    GP_ASSERT(technique);
+    for (unsigned int i = 0, passCount = technique->getPassCount(); i < passCount; ++i)
+    {
+        Pass* pass = technique->getPassByIndex(i);
+        GP_ASSERT(pass);
+        pass->bind();
+        bindInstanceAttributes(pass->getEffect(), true);
+
+        if (part)
+        {
+            GL_ASSERT( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, part->getIndexBuffer()) );
+            GL_ASSERT( glDrawElementsInstanced(part->getPrimitiveType(), part->getIndexCount(), part->getIndexFormat(), 0, _instanceCount) );
+        }
+        else
+        {
+            GL_ASSERT( glDrawArraysInstanced(mesh->getPrimitiveType(), 0, mesh->getVertexCount(), _instanceCount) );
+        }
+        ++RenderQueue::_frameCounters.drawCalls;
+
+        bindInstanceAttributes(pass->getEffect(), false);
+        pass->unbind();
+    }
+}
+
+void ModelBatch::bindInstanceAttributes(Effect* effect, bool enable)
+{
+    GP_ASSERT(effect);
+
+    // The attributes are left as they were found, since vertex array objects are shared
+    // with the model's regular draws.
+    if (enable)
+    {
+        GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, _instanceBuffer) );
+    }
+    for (unsigned int i = 0; i < 5; ++i)
+    {
+        VertexAttribute attrib = effect->getVertexAttribute(__instanceAttributeNames[i]);
+        if (attrib == -1)
+            continue;
+
+        if (enable)
+        {
+            GL_ASSERT( glVertexAttribPointer(attrib, 4, GL_FLOAT, GL_FALSE, INSTANCE_SIZE * sizeof(float), (GLvoid*)(i * 4 * sizeof(float))) );
+            GL_ASSERT( glEnableVertexAttribArray(attrib) );
+            GL_ASSERT( glVertexAttribDivisor(attrib, 1) );
+        }
+        else
+        {
+            GL_ASSERT( glVertexAttribDivisor(attrib, 0) );
+            GL_ASSERT( glDisableVertexAttribArray(attrib) );
+        }
+    }
+}
+
+void ModelBatch::drawBatched(unsigned int partIndex, Material* material)
+{
+    if (!loadMeshData())
+        return;
+    GP_ASSERT(partIndex < _partBatches.size());
+
+    // Mesh batches set their own vertex attribute bindings on the passes of their material,
+    // so they draw with a copy of the model's material.
+    MeshBatch* batch = _partBatches[partIndex];
+    if (batch == NULL)
+    {
+        Mesh::PrimitiveType primitiveType = _meshData->parts.empty() ? _meshData->primitiveType : _meshData->parts[partIndex]->primitiveType;
+        NodeCloneContext context;
+        Material* batchMaterial = material->clone(context);
+        _model->setMaterialNodeBinding(batchMaterial);
+        batch = MeshBatch::create(_meshData->vertexFormat, primitiveType, batchMaterial, true, 1, 0);
+        SAFE_RELEASE(batchMaterial);
+        _partBatches[partIndex] = batch;
+    }
+
+    // Instance colors are constant attributes, so they split the batch when they change.
+    Material* batchMaterial = batch->getMaterial();
+    bool instanceColors = false;
+    Technique* technique = batchMaterial->getTechnique();
+    for (unsigned int i = 0, passCount = technique->getPassCount(); i < passCount && !instanceColors; ++i)
+    {
+        instanceColors = technique->getPassByIndex(i)->getEffect()->getVertexAttribute(__instanceAttributeNames[4]) != -1;
+    }
+
+    // Indices are 16-bit, so the instances are drawn in chunks of up to 64K vertices.
+    const std::vector<unsigned short>& indices = _partIndices[partIndex];
+    unsigned int vertexCount = _meshData->vertexCount;
+    unsigned int indexCount = (unsigned int)indices.size();
+    unsigned int vertexSize = _meshData->vertexFormat.getVertexSize();
+    unsigned int instanceSize = std::max(vertexCount, indexCount + 2);
+    unsigned int chunkSize = std::min(_instanceCount, BATCH_VERTEX_LIMIT / instanceSize);
+    unsigned int capacity = __getBatchCapacity(batch->_primitiveType, chunkSize * instanceSize);
+    if (batch->getCapacity() < capacity)
+    {
+        batch->setCapacity(capacity);
+    }
+
+    const float* color = &_instances[16];
+    unsigned int chunkCount = 0;
+    batch->start();
+    for (unsigned int i = 0; i < _instanceCount; ++i)
+    {
+        const float* instance = &_instances[i * INSTANCE_SIZE];
+        if (chunkCount == chunkSize || (instanceColors && memcmp(color, instance + 16, 4 * sizeof(float)) != 0))
+        {
+            batch->finish();
+            __setInstanceConstants(batchMaterial, color);
+            batch->draw();
+            batch->start();
+            chunkCount = 0;
+        }
+
+        transformVertices(instance, &_vertices[0]);
+        batch->add(&_vertices[0], vertexSize, vertexCount, &indices[0], indexCount);
+        color = instance + 16;
+        ++chunkCount;
+    }
+    batch->finish();
+    __setInstanceConstants(batchMaterial, color);
+    batch->draw();
+}
+
+bool ModelBatch::loadMeshData()
+{
+    if (_meshDataLoaded)
+        return _meshData != NULL;
+    _meshDataLoaded = true;
+
+    Mesh* mesh = _model->getMesh();
+    const char* url = mesh->getUrl();
+    if (url == NULL || strlen(url) == 0)
+    {
+        GP_WARN("Cannot batch instances of a mesh without a bundle URL, when instancing is not used.");
+        return false;
+    }
+
+    _meshData = Bundle::readMeshData(url);
+    if (_meshData == NULL)
+    {
+        GP_WARN("Failed to load mesh data from url '%s' to batch instances.", url);
+        return false;
+    }
+
+    unsigned int vertexCount = _meshData->vertexCount;
+    size_t partCount = _meshData->parts.size();
+    if (vertexCount + 2 > BATCH_VERTEX_LIMIT || partCount != mesh->getPartCount())
+    {
+        GP_WARN("Cannot batch instances of mesh '%s' with %u vertices.", url, vertexCount);
+        SAFE_DELETE(_meshData);
+        return false;
+    }
+
+    // Batches are indexed with 16-bit indices; meshes without parts draw their vertices in order.
+    if (partCount == 0)
+    {
+        _partIndices.resize(1);
+        _partIndices[0].resize(vertexCount);
+        for (unsigned int i = 0; i < vertexCount; ++i)
+            _partIndices[0][i] = (unsigned short)i;
+    }
+    else
+    {
+        _partIndices.resize(partCount);
+        for (size_t i = 0; i < partCount; ++i)
+        {
+            const Bundle::MeshPartData* part = _meshData->parts[i];
+            GP_ASSERT(part);
+            if (part->indexCount + 2 > BATCH_VERTEX_LIMIT)
+            {
+                GP_WARN("Cannot batch instances of mesh '%s' with %u indices in a part.", url, part->indexCount);
+                SAFE_DELETE(_meshData);
+                return false;
+            }
+
+            std::vector<unsigned short>& indices = _partIndices[i];
+            indices.resize(part->indexCount);
+            for (unsigned int j = 0; j < part->indexCount; ++j)
+            {
+                switch (part->indexFormat)
+                {
+                case Mesh::INDEX8:
+                    indices[j] = part->indexData[j];
+                    break;
+                case Mesh::INDEX16:
+                    indices[j] = ((const unsigned short*)part->indexData)[j];
+                    break;
+                case Mesh::INDEX32:
+                    indices[j] = (unsigned short)((const unsigned int*)part->indexData)[j];
+                    break;
+                }
+            }
+        }
+    }
+    _partBatches.resize(_partIndices.size(), NULL);
+    _vertices.resize(vertexCount * _meshData->vertexFormat.getVertexSize());
+
+    return true;
+}
+
+void ModelBatch::transformVertices(const float* instance, unsigned char* vertices) const
+{
+    GP_ASSERT(_meshData);
+
+    // Normals are transformed by the inverse transpose, tangents and binormals by the world matrix.
+    Matrix worldMatrix(instance);
+    Matrix normalMatrix;
+    if (worldMatrix.invert(&normalMatrix))
+        normalMatrix.transpose();
+    else
+        normalMatrix = worldMatrix;
+
+    const VertexFormat& vertexFormat = _meshData->vertexFormat;
+    unsigned int vertexSize = vertexFormat.getVertexSize();
+    unsigned int vertexCount = _meshData->vertexCount;
+    memcpy(vertices, _meshData->vertexData, vertexCount * vertexSize);
+
+    unsigned int offset = 0;
+    for (unsigned int i = 0, elementCount = vertexFormat.getElementCount(); i < elementCount; ++i)
+    {
+        const VertexFormat::Element& e = vertexFormat.getElement(i);
+        const Matrix* matrix = NULL;
+        bool point = false;
+        switch (e.usage)
+        {
+        case VertexFormat::POSITION:
+            matrix = &worldMatrix;
+            point = true;
+            break;
+        case VertexFormat::NORMAL:
+            matrix = &normalMatrix;
+            break;
+        case VertexFormat::TANGENT:
+        case VertexFormat::BINORMAL:
+            matrix = &worldMatrix;
+            break;
+        default:
+            break;
+        }
+
+        if (matrix && e.size >= 3)
+        {
+            for (unsigned int j = 0; j < vertexCount; ++j)
+            {
+                float* v = (float*)(vertices + j * vertexSize + offset);
+                if (point && e.size == 4)
+                {
+                    Vector4 position(v);
+                    matrix->transformVector(&position);
+                    memcpy(v, &position.x, 4 * sizeof(float));
+                }
+                else
+                {
+                    Vector3 vector(v);
+                    if (point)
+                    {
+                        matrix->transformPoint(&vector);
+                    }
+                    else
+                    {
+                        matrix->transformVector(&vector);
+                        vector.normalize();
+                    }
+                    memcpy(v, &vector.x, 3 * sizeof(float));
+                }
+            }
+        }
+        offset += e.size * sizeof(float);
+    }
+}
+
+}
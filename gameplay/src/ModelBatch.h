@@ -0,0 +1,181 @@
+#ifndef MODELBATCH_H_
+#define MODELBATCH_H_
+
+#include "Model.h"
+#include "Bundle.h"
+
+namespace gameplay
+{
+
+class MeshBatch;
+
+/**
+ * Defines a class for drawing many copies of a model, each with its own world matrix
+ * and color, with one draw call per mesh part and pass.
+ *
+ * The world matrices and colors of the instances are packed into a per-instance vertex
+ * stream and drawn with hardware instancing. This requires the effects of the model's
+ * materials to declare the instance attributes, which the built-in shaders do when
+ * compiled with the INSTANCED define:
+ *
+ * @code
+ * material
+ * {
+ *     technique
+ *     {
+ *         pass
+ *         {
+ *             defines = INSTANCED
+ *             ...
+ *         }
+ *     }
+ * }
+ * @endcode
+ *
+ * Instances are drawn through the model's materials, so the model must be attached to a node,
+ * which provides the camera for the view and projection auto-bindings. The node's transform
+ * should be the identity: instance matrices take vertices to world space. Instance matrices are
+ * assumed to have a uniform scale, since normals are transformed by their rotation.
+ *
+ * Where instancing is not supported, or the materials do not declare the instance attributes,
+ * the instances are transformed on the CPU and drawn through a mesh batch. This requires the
+ * mesh data, so the model's mesh must have been loaded from a bundle. Skinned models are not
+ * supported.
+ */
+class ModelBatch
+{
+public:
+
+    /**
+     * Creates a new model batch.
+     *
+     * @param model The model to draw instances of.
+     * @param initialCapacity The initial number of instances the batch holds.
+     *
+     * @return A new model batch.
+     * @script{create}
+     */
+    static ModelBatch* create(Model* model, unsigned int initialCapacity = 64);
+
+    /**
+     * Destructor.
+     */
+    ~ModelBatch();
+
+    /**
+     * Gets the model drawn by this batch.
+     *
+     * @return The model.
+     */
+    Model* getModel() const;
+
+    /**
+     * Determines if the graphics device supports hardware instancing.
+     *
+     * @return true if instanced drawing is supported, false otherwise.
+     */
+    static bool isInstancingSupported();
+
+    /**
+     * Starts batching, removing all instances from the batch.
+     */
+    void start();
+
+    /**
+     * Adds an instance at the world transform of a node.
+     *
+     * @param node The node that positions the instance.
+     * @param color The color the instance is multiplied by.
+     */
+    void add(Node* node, const Vector4& color = Vector4::one());
+
+    /**
+     * Adds an instance with a world matrix.
+     *
+     * @param worldMatrix The matrix that takes the vertices of the instance to world space.
+     * @param color The color the instance is multiplied by.
+     */
+    void add(const Matrix& worldMatrix, const Vector4& color = Vector4::one());
+
+    /**
+     * Gets the number of instances in the batch.
+     *
+     * @return The number of instances.
+     */
+    unsigned int getInstanceCount() const;
+
+    /**
+     * Indicates that batching is complete and uploads the instances for drawing.
+     */
+    void finish();
+
+    /**
+     * Draws the instances currently in the batch.
+     */
+    void draw();
+
+private:
+
+    /**
+     * Constructor.
+     */
+    ModelBatch(Model* model, unsigned int initialCapacity);
+
+    /**
+     * Hidden copy constructor.
+     */
+    ModelBatch(const ModelBatch& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    ModelBatch& operator=(const ModelBatch&);
+
+    /**
+     * Determines if every pass of a material declares the instance matrix attributes.
+     */
+    static bool hasInstanceAttributes(Material* material);
+
+    /**
+     * Draws the instances of a mesh part, or of the mesh when part is NULL, with hardware instancing.
+     */
+    void drawInstanced(MeshPart* part, Material* material);
+
+    /**
+     * Sets or clears the per-instance attribute pointers of an effect.
+     */
+    void bindInstanceAttributes(Effect* effect, bool enable);
+
+    /**
+     * Draws the instances of the mesh part at an index, or of the mesh when it has no parts,
+     * pre-transformed through a mesh batch.
+     */
+    void drawBatched(unsigned int partIndex, Material* material);
+
+    /**
+     * Loads the mesh data and the 16-bit indices used to batch the mesh, returning false if
+     * they are not available.
+     */
+    bool loadMeshData();
+
+    /**
+     * Transforms the vertices of the mesh by the world matrix of an instance into a buffer.
+     */
+    void transformVertices(const float* instance, unsigned char* vertices) const;
+
+    Model* _model;
+    std::vector<float> _instances;
+    unsigned int _instanceCount;
+    VertexBufferHandle _instanceBuffer;
+    unsigned int _instanceBufferCapacity;
+    bool _instanceBufferDirty;
+    Bundle::MeshData* _meshData;
+    bool _meshDataLoaded;
+    std::vector<std::vector<unsigned short> > _partIndices;
+    std::vector<MeshBatch*> _partBatches;
+    std::vector<unsigned char> _vertices;
+};
+
+}
+
+#endif
@@ -9,6 +9,9 @@
 #include "PhysicsGhostObject.h"
 #include "PhysicsCharacter.h"
 #include "Game.h"
+#include "TransformHierarchy.h"
+#include "BoundsHierarchy.h"
+#include "NodeIndex.h"
 
 // Node dirty flags
 #define NODE_DIRTY_WORLD 1
@@ -21,7 +24,8 @@ namespace gameplay
 Node::Node(const char* id)
     : _scene(NULL), _firstChild(NULL), _nextSibling(NULL), _prevSibling(NULL), _parent(NULL), _childCount(0),
     _tags(NULL), _camera(NULL), _light(NULL), _model(NULL), _form(NULL), _audioSource(NULL), _particleEmitter(NULL),
-    _collisionObject(NULL), _agent(NULL), _dirtyBits(NODE_DIRTY_ALL), _notifyHierarchyChanged(true), _userData(NULL)
+    _collisionObject(NULL), _agent(NULL), _dirtyBits(NODE_DIRTY_ALL), _worldVersion(1), _hierarchy(NULL), _hierarchyIndex(0),
+    _boundsHierarchy(NULL), _boundsProxy(-1), _notifyHierarchyChanged(true), _userData(NULL)
 {
     if (id)
     {
@@ -77,7 +81,20 @@ void Node::setId(const char* id)
 {
     if (id)
     {
+        // Move the node to its new id in the index of our scene.
+        Scene* scene = getScene();
+        NodeIndex* index = scene ? scene->_nodeIndex : NULL;
+        if (index)
+        {
+            index->erase(this);
+        }
+
         _id = id;
+
+        if (index)
+        {
+            index->add(this);
+        }
     }
 }
 
@@ -124,6 +141,19 @@ void Node::addChild(Node* child)
 
     ++_childCount;
 
+    // The flattened transforms of our scene must include the new child.
+    if (_hierarchy)
+    {
+        _hierarchy->invalidate();
+    }
+
+    // So must the bounding volume hierarchy and the node index.
+    Scene* scene = getScene();
+    if (scene)
+    {
+        scene->nodeAdded(child);
+    }
+
     if (_notifyHierarchyChanged)
     {
         hierarchyChanged();
@@ -159,6 +189,13 @@ void Node::removeAllChildren()
 
 void Node::remove()
 {
+    // Leave the bounding volume hierarchy and the node index of our scene.
+    Scene* scene = getScene();
+    if (scene)
+    {
+        scene->nodeRemoved(this);
+    }
+
     // Re-link our neighbours.
     if (_prevSibling)
     {
@@ -185,6 +222,13 @@ void Node::remove()
     _prevSibling = NULL;
     _parent = NULL;
 
+    // Leave the flattened transforms of our scene.
+    if (_hierarchy)
+    {
+        _hierarchy->invalidate();
+        detachTransformHierarchy();
+    }
+
     if (parent && parent->_notifyHierarchyChanged)
     {
         parent->hierarchyChanged();
@@ -304,7 +348,18 @@ Node* Node::findNode(const char* id, bool recursive, bool exactMatch) const
             return match;
         }
     }
-    
+
+    // Look the id up in the index of our scene, unless several nodes match.
+    Scene* scene = getScene();
+    if (scene && scene->_nodeIndex)
+    {
+        Node* match;
+        if (scene->_nodeIndex->findNode(id, this, recursive, exactMatch, &match))
+        {
+            return match;
+        }
+    }
+
     // Search immediate children first.
     for (Node* child = getFirstChild(); child != NULL; child = child->getNextSibling())
     {
@@ -334,7 +389,13 @@ Node* Node::findNode(const char* id, bool recursive, bool exactMatch) const
 unsigned int Node::findNodes(const char* id, std::vector<Node*>& nodes, bool recursive, bool exactMatch) const
 {
     GP_ASSERT(id);
-    
+
+    Scene* scene = getScene();
+    if (scene && scene->_nodeIndex)
+    {
+        return scene->_nodeIndex->findNodes(id, this, recursive, exactMatch, nodes);
+    }
+
     unsigned int count = 0;
 
     // Search immediate children first.
@@ -386,6 +447,14 @@ Node* Node::getRootNode() const
 
 const Matrix& Node::getWorldMatrix() const
 {
+    if (_hierarchy)
+    {
+        // The world matrices of a scene with flattened transforms are all updated together.
+        if (_hierarchy->isDirty())
+            _hierarchy->update();
+        return _world;
+    }
+
     if (_dirtyBits & NODE_DIRTY_WORLD)
     {
         // Clear our dirty flag immediately to prevent this block from being entered if our
@@ -415,31 +484,74 @@ const Matrix& Node::getWorldMatrix() const
     return _world;
 }
 
-const Matrix& Node::getWorldViewMatrix() const
+unsigned int Node::getCameraVersion() const
 {
-    static Matrix worldView;
+    Scene* scene = getScene();
+    Camera* camera = scene ? scene->getActiveCamera() : NULL;
+    return camera ? camera->getVersion() : 0;
+}
 
-    Matrix::multiply(getViewMatrix(), getWorldMatrix(), &worldView);
+bool Node::updateCachedMatrix(CachedMatrix& cached, unsigned int cameraVersion) const
+{
+    // Bring our world matrix up to date first, since it may change our version.
+    getWorldMatrix();
+
+    if (cached.worldVersion == _worldVersion && cached.cameraVersion == cameraVersion)
+        return false;
+
+    cached.worldVersion = _worldVersion;
+    cached.cameraVersion = cameraVersion;
+    return true;
+}
+
+const Matrix& Node::getWorldViewMatrix() const
+{
+    if (updateCachedMatrix(_worldViewMatrix, getCameraVersion()))
+    {
+        getWorldViewMatrix(&_worldViewMatrix.matrix);
+    }
+    return _worldViewMatrix.matrix;
+}
 
-    return worldView;
+void Node::getWorldViewMatrix(Matrix* dst) const
+{
+    GP_ASSERT(dst);
+    Matrix::multiply(getViewMatrix(), getWorldMatrix(), dst);
 }
 
 const Matrix& Node::getInverseTransposeWorldViewMatrix() const
 {
-    static Matrix invTransWorldView;
-    Matrix::multiply(getViewMatrix(), getWorldMatrix(), &invTransWorldView);
-    invTransWorldView.invert();
-    invTransWorldView.transpose();
-    return invTransWorldView;
+    if (updateCachedMatrix(_inverseTransposeWorldViewMatrix, getCameraVersion()))
+    {
+        getInverseTransposeWorldViewMatrix(&_inverseTransposeWorldViewMatrix.matrix);
+    }
+    return _inverseTransposeWorldViewMatrix.matrix;
+}
+
+void Node::getInverseTransposeWorldViewMatrix(Matrix* dst) const
+{
+    GP_ASSERT(dst);
+    Matrix::multiply(getViewMatrix(), getWorldMatrix(), dst);
+    dst->invert();
+    dst->transpose();
 }
 
 const Matrix& Node::getInverseTransposeWorldMatrix() const
 {
-    static Matrix invTransWorld;
-    invTransWorld = getWorldMatrix();
-    invTransWorld.invert();
-    invTransWorld.transpose();
-    return invTransWorld;
+    // The inverse transpose world matrix does not depend on the camera.
+    if (updateCachedMatrix(_inverseTransposeWorldMatrix, 0))
+    {
+        getInverseTransposeWorldMatrix(&_inverseTransposeWorldMatrix.matrix);
+    }
+    return _inverseTransposeWorldMatrix.matrix;
+}
+
+void Node::getInverseTransposeWorldMatrix(Matrix* dst) const
+{
+    GP_ASSERT(dst);
+    *dst = getWorldMatrix();
+    dst->invert();
+    dst->transpose();
 }
 
 const Matrix& Node::getViewMatrix() const
@@ -512,13 +624,18 @@ const Matrix& Node::getInverseViewProjectionMatrix() const
 
 const Matrix& Node::getWorldViewProjectionMatrix() const
 {
-    static Matrix worldViewProj;
-
-    // Always re-calculate worldViewProjection matrix since it's extremely difficult
-    // to track whether the camera has changed (it may frequently change every frame).
-    Matrix::multiply(getViewProjectionMatrix(), getWorldMatrix(), &worldViewProj);
+    // The camera's version tells when its view or projection changed since the matrix was cached.
+    if (updateCachedMatrix(_worldViewProjectionMatrix, getCameraVersion()))
+    {
+        getWorldViewProjectionMatrix(&_worldViewProjectionMatrix.matrix);
+    }
+    return _worldViewProjectionMatrix.matrix;
+}
 
-    return worldViewProj;
+void Node::getWorldViewProjectionMatrix(Matrix* dst) const
+{
+    GP_ASSERT(dst);
+    Matrix::multiply(getViewProjectionMatrix(), getWorldMatrix(), dst);
 }
 
 Vector3 Node::getTranslationWorld() const
@@ -613,6 +730,54 @@ void Node::transformChanged()
 {
     // Our local transform was changed, so mark our world matrices dirty.
     _dirtyBits |= NODE_DIRTY_WORLD | NODE_DIRTY_BOUNDS;
+    ++_worldVersion;
+    if (_boundsHierarchy)
+    {
+        _boundsHierarchy->setDirty(this);
+    }
+
+    if (_hierarchy && _hierarchy->_valid)
+    {
+        // Our descendants are being notified by an ancestor.
+        if (_hierarchy->_notifying == this)
+        {
+            Transform::transformChanged();
+            return;
+        }
+
+        // Mark our subtree dirty in the flattened transforms and notify our descendants,
+        // which follow us in the flattened order, without recursing.
+        TransformHierarchy* hierarchy = _hierarchy;
+        unsigned int index = _hierarchyIndex;
+        hierarchy->setDirty(index);
+        Node* notifying = hierarchy->_notifying;
+        for (unsigned int i = index + 1, end = hierarchy->_ends[index]; i < end && hierarchy->_valid; )
+        {
+            Node* n = hierarchy->_nodes[i];
+            if (Transform::isTransformChangedSuspended())
+            {
+                // Skip the subtree if the DIRTY_NOTIFY bit is set
+                if (n->isDirty(Transform::DIRTY_NOTIFY))
+                {
+                    i = hierarchy->_ends[i];
+                    continue;
+                }
+                hierarchy->_notifying = n;
+                n->transformChanged();
+                suspendTransformChange(n);
+            }
+            else
+            {
+                hierarchy->_notifying = n;
+                n->transformChanged();
+            }
+            ++i;
+        }
+        hierarchy->_notifying = notifying;
+
+        Transform::transformChanged();
+        return;
+    }
 
     // Notify our children that their transform has also changed (since transforms are inherited).
     for (Node* n = getFirstChild(); n != NULL; n = n->getNextSibling())
@@ -635,10 +800,31 @@ void Node::transformChanged()
     Transform::transformChanged();
 }
 
+void Node::setFlattenedWorldMatrix(const Matrix& world) const
+{
+    _world = world;
+    _dirtyBits &= ~NODE_DIRTY_WORLD;
+}
+
+void Node::detachTransformHierarchy()
+{
+    _hierarchy = NULL;
+    _dirtyBits |= NODE_DIRTY_WORLD | NODE_DIRTY_BOUNDS;
+    ++_worldVersion;
+    for (Node* child = getFirstChild(); child != NULL; child = child->getNextSibling())
+    {
+        child->detachTransformHierarchy();
+    }
+}
+
 void Node::setBoundsDirty()
 {
     // Mark ourself and our parent nodes as dirty
     _dirtyBits |= NODE_DIRTY_BOUNDS;
+    if (_boundsHierarchy)
+    {
+        _boundsHierarchy->setDirty(this);
+    }
 
     // Mark our parent bounds as dirty as well
     if (_parent)
@@ -772,6 +958,18 @@ void Node::setModel(Model* model)
             _model->addRef();
             _model->setNode(this);
         }
+
+        // Only nodes with models are held by the bounding volume hierarchy of our scene,
+        // and the index of our scene keeps the nodes with skinned models.
+        Scene* scene = getScene();
+        if (scene && scene->_boundsHierarchy)
+        {
+            scene->_boundsHierarchy->modelChanged(this);
+        }
+        if (scene && scene->_nodeIndex)
+        {
+            scene->_nodeIndex->modelChanged(this);
+        }
     }
 }
 
@@ -811,55 +1009,16 @@ const BoundingSphere& Node::getBoundingSphere() const
     {
         _dirtyBits &= ~NODE_DIRTY_BOUNDS;
 
-        const Matrix& worldMatrix = getWorldMatrix();
-
         // Start with our local bounding sphere
         // TODO: Incorporate bounds from entities other than mesh (i.e. emitters, audiosource, etc)
-        bool empty = true;
-        if (_model && _model->getMesh())
-        {
-            _bounds.set(_model->getMesh()->getBoundingSphere());
-            empty = false;
-        }
-        else
+        bool empty = !computeModelBounds(&_bounds);
+        if (empty)
         {
             // Empty bounding sphere, set the world translation with zero radius
-            worldMatrix.getTranslation(&_bounds.center);
+            getWorldMatrix().getTranslation(&_bounds.center);
             _bounds.radius = 0;
         }
 
-        // Transform the sphere (if not empty) into world space.
-        if (!empty)
-        {
-            bool applyWorldTransform = true;
-            if (_model && _model->getSkin())
-            {
-                // Special case: If the root joint of our mesh skin is parented by any nodes, 
-                // multiply the world matrix of the root joint's parent by this node's
-                // world matrix. This computes a final world matrix used for transforming this
-                // node's bounding volume. This allows us to store a much smaller bounding
-                // volume approximation than would otherwise be possible for skinned meshes,
-                // since joint parent nodes that are not in the matrix palette do not need to
-                // be considered as directly transforming vertices on the GPU (they can instead
-                // be applied directly to the bounding volume transformation below).
-                GP_ASSERT(_model->getSkin()->getRootJoint());
-                Node* jointParent = _model->getSkin()->getRootJoint()->getParent();
-                if (jointParent)
-                {
-                    // TODO: Should we protect against the case where joints are nested directly
-                    // in the node hierachy of the model (this is normally not the case)?
-                    Matrix boundsMatrix;
-                    Matrix::multiply(getWorldMatrix(), jointParent->getWorldMatrix(), &boundsMatrix);
-                    _bounds.transform(boundsMatrix);
-                    applyWorldTransform = false;
-                }
-            }
-            if (applyWorldTransform)
-            {
-                _bounds.transform(getWorldMatrix());
-            }
-        }
-
         // Merge this world-space bounding sphere with our childrens' bounding volumes.
         for (Node* n = getFirstChild(); n != NULL; n = n->getNextSibling())
         {
@@ -882,6 +1041,54 @@ const BoundingSphere& Node::getBoundingSphere() const
     return _bounds;
 }
 
+bool Node::computeModelBounds(BoundingSphere* bounds) const
+{
+    GP_ASSERT(bounds);
+
+    bool cpuSkinned = _model && _model->getSkin() && _model->getSkin()->isCpuSkinning() &&
+                      !_model->getSkin()->_skinnedBounds.isEmpty();
+    if (cpuSkinned)
+    {
+        // Vertices skinned on the CPU are already posed by the joints, so their bounds
+        // only need to be transformed by our world matrix.
+        bounds->set(_model->getSkin()->_skinnedBounds);
+    }
+    else if (_model && _model->getMesh())
+    {
+        bounds->set(_model->getMesh()->getBoundingSphere());
+    }
+    else
+    {
+        return false;
+    }
+
+    // Transform the sphere into world space.
+    if (_model->getSkin() && !cpuSkinned)
+    {
+        // Special case: If the root joint of our mesh skin is parented by any nodes, 
+        // multiply the world matrix of the root joint's parent by this node's
+        // world matrix. This computes a final world matrix used for transforming this
+        // node's bounding volume. This allows us to store a much smaller bounding
+        // volume approximation than would otherwise be possible for skinned meshes,
+        // since joint parent nodes that are not in the matrix palette do not need to
+        // be considered as directly transforming vertices on the GPU (they can instead
+        // be applied directly to the bounding volume transformation below).
+        GP_ASSERT(_model->getSkin()->getRootJoint());
+        Node* jointParent = _model->getSkin()->getRootJoint()->getParent();
+        if (jointParent)
+        {
+            // TODO: Should we protect against the case where joints are nested directly
+            // in the node hierachy of the model (this is normally not the case)?
+            Matrix boundsMatrix;
+            Matrix::multiply(getWorldMatrix(), jointParent->getWorldMatrix(), &boundsMatrix);
+            bounds->transform(boundsMatrix);
+            return true;
+        }
+    }
+    bounds->transform(getWorldMatrix());
+    return true;
+}
+
 
 Node* Node::clone() const
 {
@@ -17,9 +17,12 @@ namespace gameplay
 {
 
 class AudioSource;
+class BoundsHierarchy;
 class Bundle;
 class Scene;
 class Form;
+class NodeIndex;
+class TransformHierarchy;
 
 /**
  * Defines a basic hierarchical structure of transformation spaces.
@@ -29,6 +32,9 @@ class Node : public Transform, public Ref
     friend class Scene;
     friend class Bundle;
     friend class MeshSkin;
+    friend class TransformHierarchy;
+    friend class BoundsHierarchy;
+    friend class NodeIndex;
 
 public:
 
@@ -240,28 +246,60 @@ public:
     /**
      * Gets the world view matrix corresponding to this node.
      *
+     * The matrix is cached by the node and only recomputed after the node or the
+     * scene's active camera changes. Different nodes can be queried concurrently
+     * once their world matrices and the camera's matrices are up to date.
+     *
      * @return The world view matrix of this node.
      */
     const Matrix& getWorldViewMatrix() const;
 
+    /**
+     * Computes the world view matrix corresponding to this node.
+     *
+     * This does not modify the node, so it can be called concurrently for the same
+     * node once its world matrix and the camera's matrices are up to date.
+     *
+     * @param dst A matrix to store the world view matrix of this node in.
+     */
+    void getWorldViewMatrix(Matrix* dst) const;
+
     /**
      * Gets the inverse transpose world matrix corresponding to this node.
      *
      * This matrix is typically used to transform normal vectors into world space.
+     * It is cached by the node like the world view matrix.
      *
      * @return The inverse world matrix of this node.
      */
     const Matrix& getInverseTransposeWorldMatrix() const;
 
+    /**
+     * Computes the inverse transpose world matrix corresponding to this node.
+     *
+     * @param dst A matrix to store the inverse transpose world matrix of this node in.
+     * @see getWorldViewMatrix(Matrix*)
+     */
+    void getInverseTransposeWorldMatrix(Matrix* dst) const;
+
     /**
      * Gets the inverse transpose world view matrix corresponding to this node.
      *
      * This matrix is typically used to transform normal vectors into view space.
+     * It is cached by the node like the world view matrix.
      *
      * @return The inverse world view matrix of this node.
      */
     const Matrix& getInverseTransposeWorldViewMatrix() const;
 
+    /**
+     * Computes the inverse transpose world view matrix corresponding to this node.
+     *
+     * @param dst A matrix to store the inverse transpose world view matrix of this node in.
+     * @see getWorldViewMatrix(Matrix*)
+     */
+    void getInverseTransposeWorldViewMatrix(Matrix* dst) const;
+
     /**
      * Gets the view matrix corresponding to this node based
      * on the scene's active camera.
@@ -306,10 +344,21 @@ public:
      * Gets the world * view * projection matrix corresponding to this node based
      * on the scene's active camera.
      *
+     * The matrix is cached by the node like the world view matrix.
+     *
      * @return The world * view * projection matrix of this node.
      */
     const Matrix& getWorldViewProjectionMatrix() const;
 
+    /**
+     * Computes the world * view * projection matrix corresponding to this node based
+     * on the scene's active camera.
+     *
+     * @param dst A matrix to store the world * view * projection matrix of this node in.
+     * @see getWorldViewMatrix(Matrix*)
+     */
+    void getWorldViewProjectionMatrix(Matrix* dst) const;
+
     /**
      * Gets the translation vector (or position) of this Node in world space.
      *
@@ -681,6 +730,46 @@ protected:
 
 private:
 
+    /**
+     * A matrix computed from the world matrix of this node and the active camera,
+     * with the versions of both it was computed for.
+     */
+    struct CachedMatrix
+    {
+        CachedMatrix() : worldVersion(0), cameraVersion(0) {}
+
+        Matrix matrix;
+        unsigned int worldVersion;
+        unsigned int cameraVersion;
+    };
+
+    /**
+     * Gets the version of the active camera of the scene, or zero if there is none.
+     */
+    unsigned int getCameraVersion() const;
+
+    /**
+     * Determines if a cached matrix must be recomputed, and stamps it with the current versions if so.
+     */
+    bool updateCachedMatrix(CachedMatrix& cached, unsigned int cameraVersion) const;
+
+    /**
+     * Sets the world matrix of this node, as computed by the flattened transforms of its scene.
+     */
+    void setFlattenedWorldMatrix(const Matrix& world) const;
+
+    /**
+     * Removes this node and its descendants from the flattened transforms of their scene.
+     */
+    void detachTransformHierarchy();
+
+    /**
+     * Computes the world-space bounding sphere of this node's model, without its children.
+     *
+     * @return false if the node has no model, in which case the sphere is left unchanged.
+     */
+    bool computeModelBounds(BoundingSphere* bounds) const;
+
     /**
      * Hidden copy constructor.
      */
@@ -803,6 +892,39 @@ protected:
      * Dirty bits flag for the Node.
      */
     mutable int _dirtyBits;
+
+    /**
+     * Version of the world matrix of the Node, incremented whenever it changes.
+     */
+    unsigned int _worldVersion;
+
+    /**
+     * Matrices computed from the world matrix, cached until the Node or the active camera changes.
+     */
+    mutable CachedMatrix _worldViewMatrix;
+    mutable CachedMatrix _worldViewProjectionMatrix;
+    mutable CachedMatrix _inverseTransposeWorldMatrix;
+    mutable CachedMatrix _inverseTransposeWorldViewMatrix;
+
+    /**
+     * The flattened transforms of the scene containing the Node, or NULL if they are not used.
+     */
+    TransformHierarchy* _hierarchy;
+
+    /**
+     * The index of the Node in the flattened transforms of its scene.
+     */
+    unsigned int _hierarchyIndex;
+
+    /**
+     * The bounding volume hierarchy holding the bounds of the Node's model, or NULL if there is none.
+     */
+    BoundsHierarchy* _boundsHierarchy;
+
+    /**
+     * The index of the leaf holding the Node in the bounding volume hierarchy of its scene.
+     */
+    int _boundsProxy;
     
     /**
      * A flag indicating if the Node's hierarchy has changed.
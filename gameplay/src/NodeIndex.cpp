@@ -0,0 +1,305 @@
+#include "Base.h"
+#include "NodeIndex.h"
+#include "Node.h"
+#include "Scene.h"
+#include "Model.h"
+#include "MeshSkin.h"
+
+namespace gameplay
+{
+
+/**
+ * Hashes an id with FNV-1a.
+ */
+static unsigned int hashId(const char* id)
+{
+    unsigned int hash = 2166136261u;
+    for (const char* c = id; *c; ++c)
+    {
+        hash ^= (unsigned char)*c;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * Orders a node before the nodes whose ids start with an id prefix, for binary searches of the sorted index.
+ */
+static bool isBeforePrefix(const Node* node, const char* prefix)
+{
+    return strcmp(node->getId(), prefix) < 0;
+}
+
+NodeIndex::NodeIndex(Scene* scene) : _count(0), _sortedValid(false)
+{
+    GP_ASSERT(scene);
+
+    for (Node* node = scene->getFirstNode(); node != NULL; node = node->getNextSibling())
+    {
+        insert(node);
+    }
+}
+
+NodeIndex::~NodeIndex()
+{
+    for (size_t i = 0, count = _buckets.size(); i < count; ++i)
+    {
+        Entry* entry = _buckets[i];
+        while (entry)
+        {
+            Entry* next = entry->next;
+            delete entry;
+            entry = next;
+        }
+    }
+}
+
+void NodeIndex::insert(Node* node)
+{
+    GP_ASSERT(node);
+
+    add(node);
+    for (Node* child = node->getFirstChild(); child != NULL; child = child->getNextSibling())
+    {
+        insert(child);
+    }
+}
+
+void NodeIndex::remove(Node* node)
+{
+    GP_ASSERT(node);
+
+    erase(node);
+    for (Node* child = node->getFirstChild(); child != NULL; child = child->getNextSibling())
+    {
+        remove(child);
+    }
+}
+
+void NodeIndex::add(Node* node)
+{
+    if (_count >= _buckets.size())
+        rehash(_buckets.empty() ? 64 : _buckets.size() * 2);
+
+    Entry* entry = new Entry();
+    entry->hash = hashId(node->_id.c_str());
+    entry->node = node;
+    size_t bucket = entry->hash & (_buckets.size() - 1);
+    entry->next = _buckets[bucket];
+    _buckets[bucket] = entry;
+    ++_count;
+    _sortedValid = false;
+
+    if (getSkinRootNode(node))
+    {
+        _skinnedNodes.push_back(node);
+    }
+}
+
+void NodeIndex::erase(Node* node)
+{
+    std::vector<Node*>::iterator itr = std::find(_skinnedNodes.begin(), _skinnedNodes.end(), node);
+    if (itr != _skinnedNodes.end())
+    {
+        _skinnedNodes.erase(itr);
+    }
+
+    if (_buckets.empty())
+        return;
+
+    unsigned int hash = hashId(node->_id.c_str());
+    for (Entry** link = &_buckets[hash & (_buckets.size() - 1)]; *link != NULL; link = &(*link)->next)
+    {
+        Entry* entry = *link;
+        if (entry->node == node)
+        {
+            *link = entry->next;
+            delete entry;
+            --_count;
+            _sortedValid = false;
+            return;
+        }
+    }
+}
+
+void NodeIndex::modelChanged(Node* node)
+{
+    GP_ASSERT(node);
+
+    std::vector<Node*>::iterator itr = std::find(_skinnedNodes.begin(), _skinnedNodes.end(), node);
+    if (itr != _skinnedNodes.end())
+    {
+        _skinnedNodes.erase(itr);
+    }
+    if (getSkinRootNode(node))
+    {
+        _skinnedNodes.push_back(node);
+    }
+}
+
+bool NodeIndex::findNode(const char* id, const Node* parent, bool recursive, bool exactMatch, Node** match)
+{
+    GP_ASSERT(id);
+    GP_ASSERT(match);
+
+    *match = NULL;
+    findCandidates(id, exactMatch);
+    for (size_t i = 0, count = _candidates.size(); i < count; ++i)
+    {
+        Node* node = _candidates[i];
+        if (isBelow(node, parent, recursive))
+        {
+            if (*match)
+            {
+                *match = NULL;
+                return false;
+            }
+            *match = node;
+        }
+    }
+
+    // The joints of mesh skins are not part of the scene, so they are searched for in the
+    // joint hierarchies of the skinned nodes that a recursive search would reach.
+    if (recursive)
+    {
+        for (size_t i = 0, count = _skinnedNodes.size(); i < count; ++i)
+        {
+            Node* node = _skinnedNodes[i];
+            Node* rootNode = getSkinRootNode(node);
+            if (rootNode && (node == parent || isBelow(node, parent, true)) && !findJoint(rootNode, id, exactMatch, match))
+            {
+                *match = NULL;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool NodeIndex::findJoint(Node* node, const char* id, bool exactMatch, Node** match)
+{
+    if ((exactMatch && node->_id == id) || (!exactMatch && node->_id.find(id) == 0))
+    {
+        // Several skins may share a joint hierarchy.
+        if (*match && *match != node)
+            return false;
+        *match = node;
+    }
+    for (Node* child = node->getFirstChild(); child != NULL; child = child->getNextSibling())
+    {
+        if (!findJoint(child, id, exactMatch, match))
+            return false;
+    }
+    return true;
+}
+
+unsigned int NodeIndex::findNodes(const char* id, const Node* parent, bool recursive, bool exactMatch, std::vector<Node*>& nodes)
+{
+    GP_ASSERT(id);
+
+    unsigned int found = 0;
+    findCandidates(id, exactMatch);
+    for (size_t i = 0, count = _candidates.size(); i < count; ++i)
+    {
+        Node* node = _candidates[i];
+        if (isBelow(node, parent, recursive))
+        {
+            nodes.push_back(node);
+            ++found;
+        }
+    }
+    return found;
+}
+
+void NodeIndex::findCandidates(const char* id, bool exactMatch)
+{
+    _candidates.clear();
+
+    if (exactMatch)
+    {
+        if (_buckets.empty())
+            return;
+
+        unsigned int hash = hashId(id);
+        for (Entry* entry = _buckets[hash & (_buckets.size() - 1)]; entry != NULL; entry = entry->next)
+        {
+            if (entry->hash == hash && entry->node->_id == id)
+            {
+                _candidates.push_back(entry->node);
+            }
+        }
+        return;
+    }
+
+    // Ids starting with a prefix are contiguous in the sorted index, which is
+    // only sorted again after nodes were added, removed or renamed.
+    if (!_sortedValid)
+    {
+        _sorted.clear();
+        _sorted.reserve(_count);
+        for (size_t i = 0, count = _buckets.size(); i < count; ++i)
+        {
+            for (Entry* entry = _buckets[i]; entry != NULL; entry = entry->next)
+            {
+                _sorted.push_back(entry->node);
+            }
+        }
+        std::sort(_sorted.begin(), _sorted.end(), compareIds);
+        _sortedValid = true;
+    }
+
+    size_t length = strlen(id);
+    std::vector<Node*>::iterator itr = std::lower_bound(_sorted.begin(), _sorted.end(), id, isBeforePrefix);
+    for (; itr != _sorted.end() && (*itr)->_id.compare(0, length, id) == 0; ++itr)
+    {
+        _candidates.push_back(*itr);
+    }
+}
+
+void NodeIndex::rehash(size_t bucketCount)
+{
+    std::vector<Entry*> buckets(bucketCount, (Entry*)NULL);
+    for (size_t i = 0, count = _buckets.size(); i < count; ++i)
+    {
+        Entry* entry = _buckets[i];
+        while (entry)
+        {
+            Entry* next = entry->next;
+            size_t bucket = entry->hash & (bucketCount - 1);
+            entry->next = buckets[bucket];
+            buckets[bucket] = entry;
+            entry = next;
+        }
+    }
+    _buckets.swap(buckets);
+}
+
+bool NodeIndex::isBelow(const Node* node, const Node* parent, bool recursive)
+{
+    if (!recursive)
+        return node->_parent == parent;
+
+    if (parent == NULL)
+        return true;
+
+    for (const Node* n = node->_parent; n != NULL; n = n->_parent)
+    {
+        if (n == parent)
+            return true;
+    }
+    return false;
+}
+
+Node* NodeIndex::getSkinRootNode(const Node* node)
+{
+    Model* model = node->getModel();
+    MeshSkin* skin = model ? model->getSkin() : NULL;
+    return skin ? skin->_rootNode : NULL;
+}
+
+bool NodeIndex::compareIds(const Node* node1, const Node* node2)
+{
+    return node1->_id < node2->_id;
+}
+
+}
@@ -0,0 +1,153 @@
+#ifndef NODEINDEX_H_
+#define NODEINDEX_H_
+
+namespace gameplay
+{
+
+class Node;
+class Scene;
+
+/**
+ * Defines an index of the nodes of a scene by their ids.
+ *
+ * Nodes are held in a hash table by id, for exact lookups, and in a vector sorted by id,
+ * for prefix lookups. The index is kept up to date as nodes are added to and removed from
+ * the scene and change their ids. The sorted vector is only sorted again when a prefix
+ * lookup follows such a change.
+ *
+ * The joints of mesh skins are usually not part of the scene, so the index also keeps the
+ * nodes whose models have mesh skins, and searches their joint hierarchies when finding a
+ * node recursively.
+ */
+class NodeIndex
+{
+    friend class Node;
+    friend class Scene;
+
+private:
+
+    /**
+     * A node in a bucket of the hash table.
+     */
+    struct Entry
+    {
+        unsigned int hash;
+        Node* node;
+        Entry* next;
+    };
+
+    /**
+     * Constructor, indexing the nodes of a scene.
+     *
+     * @param scene The scene whose nodes are indexed.
+     */
+    NodeIndex(Scene* scene);
+
+    /**
+     * Destructor.
+     */
+    ~NodeIndex();
+
+    /**
+     * Hidden copy constructor.
+     */
+    NodeIndex(const NodeIndex& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    NodeIndex& operator=(const NodeIndex&);
+
+    /**
+     * Adds a node and its descendants to the index.
+     */
+    void insert(Node* node);
+
+    /**
+     * Removes a node and its descendants from the index.
+     */
+    void remove(Node* node);
+
+    /**
+     * Adds a node, without its descendants, to the index.
+     */
+    void add(Node* node);
+
+    /**
+     * Removes a node, without its descendants, from the index.
+     */
+    void erase(Node* node);
+
+    /**
+     * Updates whether a node is kept for the mesh skin of its model, after its model changed.
+     */
+    void modelChanged(Node* node);
+
+    /**
+     * Finds the node with an id below a node, or at the root of the scene when the node is NULL.
+     *
+     * Recursive searches also find the joints of the mesh skins of the parent and of the nodes
+     * below it.
+     *
+     * @param id The id, or id prefix, to find.
+     * @param parent The node to search below, or NULL to search the scene.
+     * @param recursive false to only find the children of the parent.
+     * @param exactMatch false to find ids that start with the id.
+     * @param match Set to the node found, or NULL if there is none.
+     *
+     * @return false if several nodes match, in which case the node to return depends on the
+     *      order of the hierarchy, which the index does not hold.
+     */
+    bool findNode(const char* id, const Node* parent, bool recursive, bool exactMatch, Node** match);
+
+    /**
+     * Finds the node with an id in a joint hierarchy, setting the match unless it is already set.
+     *
+     * @return false if the hierarchy holds a node with the id other than the match.
+     */
+    static bool findJoint(Node* node, const char* id, bool exactMatch, Node** match);
+
+    /**
+     * Finds the nodes with an id below a node, or at the root of the scene when the node is NULL.
+     *
+     * @return The number of nodes appended to the vector.
+     */
+    unsigned int findNodes(const char* id, const Node* parent, bool recursive, bool exactMatch, std::vector<Node*>& nodes);
+
+    /**
+     * Appends the nodes with an id, or id prefix, to the candidates.
+     */
+    void findCandidates(const char* id, bool exactMatch);
+
+    /**
+     * Resizes the hash table to a number of buckets, a power of two.
+     */
+    void rehash(size_t bucketCount);
+
+    /**
+     * Determines if a node is a child, or descendant when recursive, of a node, or a node at the
+     * root of the scene, or any node in the scene when recursive, when the parent is NULL.
+     */
+    static bool isBelow(const Node* node, const Node* parent, bool recursive);
+
+    /**
+     * Gets the root of the joint hierarchy of the mesh skin of a node's model, or NULL if it has none.
+     */
+    static Node* getSkinRootNode(const Node* node);
+
+    /**
+     * Compares nodes by id, for the sorted index.
+     */
+    static bool compareIds(const Node* node1, const Node* node2);
+
+    std::vector<Entry*> _buckets;
+    unsigned int _count;
+    std::vector<Node*> _sorted;
+    bool _sortedValid;
+    std::vector<Node*> _candidates;
+    std::vector<Node*> _skinnedNodes;
+};
+
+}
+
+#endif
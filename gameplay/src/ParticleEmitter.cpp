@@ -10,11 +10,45 @@
 #define PARTICLE_EMISSION_RATE                   10
 #define PARTICLE_EMISSION_RATE_TIME_INTERVAL     1000.0f / (float)PARTICLE_EMISSION_RATE
 
+// Four-wide float operations used to update four particles at a time.
+#if defined(USE_NEON)
+#include <arm_neon.h>
+typedef float32x4_t float4;
+typedef uint32x4_t mask4;
+#define FLOAT4_LOAD(p)              vld1q_f32(p)
+#define FLOAT4_STORE(p, a)          vst1q_f32(p, a)
+#define FLOAT4_SET(x)               vdupq_n_f32(x)
+#define FLOAT4_ADD(a, b)            vaddq_f32(a, b)
+#define FLOAT4_SUB(a, b)            vsubq_f32(a, b)
+#define FLOAT4_MUL(a, b)            vmulq_f32(a, b)
+#define FLOAT4_MADD(a, b, c)        vmlaq_f32(c, a, b)
+#define FLOAT4_GT(a, b)             vcgtq_f32(a, b)
+#define MASK4_AND(a, b)             vandq_u32(a, b)
+#define MASK4_SELECT(m, a)          vreinterpretq_f32_u32(vandq_u32(m, vreinterpretq_u32_f32(a)))
+#elif defined(USE_SSE)
+#include <xmmintrin.h>
+typedef __m128 float4;
+typedef __m128 mask4;
+#define FLOAT4_LOAD(p)              _mm_load_ps(p)
+#define FLOAT4_STORE(p, a)          _mm_store_ps(p, a)
+#define FLOAT4_SET(x)               _mm_set1_ps(x)
+#define FLOAT4_ADD(a, b)            _mm_add_ps(a, b)
+#define FLOAT4_SUB(a, b)            _mm_sub_ps(a, b)
+#define FLOAT4_MUL(a, b)            _mm_mul_ps(a, b)
+#define FLOAT4_MADD(a, b, c)        _mm_add_ps(_mm_mul_ps(a, b), c)
+#define FLOAT4_GT(a, b)             _mm_cmpgt_ps(a, b)
+#define MASK4_AND(a, b)             _mm_and_ps(a, b)
+#define MASK4_SELECT(m, a)          _mm_and_ps(m, a)
+#endif
+
+// Particle arrays are padded to a multiple of four so whole groups of four can be processed.
+#define PARTICLE_ARRAY_ALIGNMENT    4
+
 namespace gameplay
 {
 
 ParticleEmitter::ParticleEmitter(SpriteBatch* batch, unsigned int particleCountMax) :
-    _particleCountMax(particleCountMax), _particleCount(0), _particles(NULL),
+    _particleCountMax(particleCountMax), _particleCount(0), _particleCapacity(0), _particleData(NULL), _particleDataAligned(NULL),
     _emissionRate(PARTICLE_EMISSION_RATE), _started(false), _ellipsoid(false),
     _sizeStartMin(1.0f), _sizeStartMax(1.0f), _sizeEndMin(1.0f), _sizeEndMax(1.0f),
     _energyMin(1000L), _energyMax(1000L),
@@ -24,14 +58,21 @@ ParticleEmitter::ParticleEmitter(SpriteBatch* batch, unsigned int particleCountM
     _acceleration(Vector3::zero()), _accelerationVar(Vector3::zero()),
     _rotationPerParticleSpeedMin(0.0f), _rotationPerParticleSpeedMax(0.0f),
     _rotationSpeedMin(0.0f), _rotationSpeedMax(0.0f),
-    _rotationAxis(Vector3::zero()), _rotation(Matrix::identity()),
+    _rotationAxis(Vector3::zero()),
     _spriteBatch(batch), _spriteTextureBlending(BLEND_TRANSPARENT),  _spriteTextureWidth(0), _spriteTextureHeight(0), _spriteTextureWidthRatio(0), _spriteTextureHeightRatio(0), _spriteTextureCoords(NULL),
     _spriteAnimated(false),  _spriteLooped(false), _spriteFrameCount(1), _spriteFrameRandomOffset(0),_spriteFrameDuration(0L), _spriteFrameDurationSecs(0.0f), _spritePercentPerFrame(0.0f),
     _node(NULL), _orbitPosition(false), _orbitVelocity(false), _orbitAcceleration(false),
     _timePerEmission(PARTICLE_EMISSION_RATE_TIME_INTERVAL), _timeRunning(0)
 {
     GP_ASSERT(particleCountMax);
-    _particles = new Particle[particleCountMax];
+
+    // Allocate all particle arrays in one block aligned to 16 bytes and zero them,
+    // so the padding at the end of each array always holds valid values.
+    _particleCapacity = (particleCountMax + PARTICLE_ARRAY_ALIGNMENT - 1) & ~(PARTICLE_ARRAY_ALIGNMENT - 1);
+    unsigned int dataSize = _particleCapacity * PARTICLE_ARRAY_COUNT;
+    _particleData = new float[dataSize + PARTICLE_ARRAY_ALIGNMENT - 1];
+    memset(_particleData, 0, (dataSize + PARTICLE_ARRAY_ALIGNMENT - 1) * sizeof(float));
+    _particleDataAligned = (float*)(((size_t)_particleData + 15) & ~(size_t)15);
 
     GP_ASSERT(_spriteBatch);
     GP_ASSERT(_spriteBatch->getStateBlock());
@@ -42,7 +83,7 @@ ParticleEmitter::ParticleEmitter(SpriteBatch* batch, unsigned int particleCountM
 ParticleEmitter::~ParticleEmitter()
 {
     SAFE_DELETE(_spriteBatch);
-    SAFE_DELETE_ARRAY(_particles);
+    SAFE_DELETE_ARRAY(_particleData);
     SAFE_DELETE_ARRAY(_spriteTextureCoords);
 }
 
@@ -248,24 +289,20 @@ bool ParticleEmitter::isActive() const
     if (!_node)
         return false;
 
-    GP_ASSERT(_particles);
-    bool active = false;
+    const float* energy = getParticleArray(ENERGY);
     for (unsigned int i = 0; i < _particleCount; i++)
     {
-        if (_particles[i]._energy > 0)
-        {
-            active = true;
-            break;
-        }
+        if (energy[i] > 0.0f)
+            return true;
     }
 
-    return active;
+    return false;
 }
 
 void ParticleEmitter::emitOnce(unsigned int particleCount)
 {
     GP_ASSERT(_node);
-    GP_ASSERT(_particles);
+    GP_ASSERT(_particleDataAligned);
 
     // Limit particleCount so as not to go over _particleCountMax.
     if (particleCount + _particleCount > _particleCountMax)
@@ -283,64 +320,100 @@ void ParticleEmitter::emitOnce(unsigned int particleCount)
     world.m[14] = 0.0f;
 
     // Emit the new particles.
+    Vector4 colorStart;
+    Vector4 colorEnd;
+    Vector3 position;
+    Vector3 velocity;
+    Vector3 acceleration;
+    Vector3 rotationAxis;
     for (unsigned int i = 0; i < particleCount; i++)
     {
-        Particle* p = &_particles[_particleCount];
-        p->_visible = true;
+        unsigned int index = _particleCount;
 
-        generateColor(_colorStart, _colorStartVar, &p->_colorStart);
-        generateColor(_colorEnd, _colorEndVar, &p->_colorEnd);
-        p->_color.set(p->_colorStart);
+        generateColor(_colorStart, _colorStartVar, &colorStart);
+        generateColor(_colorEnd, _colorEndVar, &colorEnd);
 
-        p->_energy = p->_energyStart = generateScalar(_energyMin, _energyMax);
-        p->_size = p->_sizeStart = generateScalar(_sizeStartMin, _sizeStartMax);
-        p->_sizeEnd = generateScalar(_sizeEndMin, _sizeEndMax);
-        p->_rotationPerParticleSpeed = generateScalar(_rotationPerParticleSpeedMin, _rotationPerParticleSpeedMax);
-        p->_angle = generateScalar(0.0f, p->_rotationPerParticleSpeed);
-        p->_rotationSpeed = generateScalar(_rotationSpeedMin, _rotationSpeedMax);
+        long energy = generateScalar((long)_energyMin, (long)_energyMax);
+        float size = generateScalar(_sizeStartMin, _sizeStartMax);
+        float rotationPerParticleSpeed = generateScalar(_rotationPerParticleSpeedMin, _rotationPerParticleSpeedMax);
+        float rotationSpeed = generateScalar(_rotationSpeedMin, _rotationSpeedMax);
 
         // Only initial position can be generated within an ellipsoidal domain.
-        generateVector(_position, _positionVar, &p->_position, _ellipsoid);
-        generateVector(_velocity, _velocityVar, &p->_velocity, false);
-        generateVector(_acceleration, _accelerationVar, &p->_acceleration, false);
-        generateVector(_rotationAxis, _rotationAxisVar, &p->_rotationAxis, false);
+        generateVector(_position, _positionVar, &position, _ellipsoid);
+        generateVector(_velocity, _velocityVar, &velocity, false);
+        generateVector(_acceleration, _accelerationVar, &acceleration, false);
+        generateVector(_rotationAxis, _rotationAxisVar, &rotationAxis, false);
 
         // Initial position, velocity and acceleration can all be relative to the emitter's transform.
         // Rotate specified properties by the node's rotation.
         if (_orbitPosition)
         {
-            world.transformPoint(p->_position, &p->_position);
+            world.transformPoint(position, &position);
         }
 
         if (_orbitVelocity)
         {
-            world.transformPoint(p->_velocity, &p->_velocity);
+            world.transformPoint(velocity, &velocity);
         }
 
         if (_orbitAcceleration)
         {
-            world.transformPoint(p->_acceleration, &p->_acceleration);
+            world.transformPoint(acceleration, &acceleration);
         }
 
-        // The rotation axis always orbits the node.
-        if (p->_rotationSpeed != 0.0f && !p->_rotationAxis.isZero())
+        // The rotation axis always orbits the node. It is stored normalized for updateRotation().
+        if (rotationSpeed != 0.0f && !rotationAxis.isZero())
         {
-            world.transformPoint(p->_rotationAxis, &p->_rotationAxis);
+            world.transformPoint(rotationAxis, &rotationAxis);
+            rotationAxis.normalize();
+        }
+        else
+        {
+            rotationSpeed = 0.0f;
         }
 
         // Translate position relative to the node's world space.
-        p->_position.add(translation);
+        position.add(translation);
+
+        getParticleArray(POSITION_X)[index] = position.x;
+        getParticleArray(POSITION_Y)[index] = position.y;
+        getParticleArray(POSITION_Z)[index] = position.z;
+        getParticleArray(VELOCITY_X)[index] = velocity.x;
+        getParticleArray(VELOCITY_Y)[index] = velocity.y;
+        getParticleArray(VELOCITY_Z)[index] = velocity.z;
+        getParticleArray(ACCELERATION_X)[index] = acceleration.x;
+        getParticleArray(ACCELERATION_Y)[index] = acceleration.y;
+        getParticleArray(ACCELERATION_Z)[index] = acceleration.z;
+        getParticleArray(COLOR_START_R)[index] = getParticleArray(COLOR_R)[index] = colorStart.x;
+        getParticleArray(COLOR_START_G)[index] = getParticleArray(COLOR_G)[index] = colorStart.y;
+        getParticleArray(COLOR_START_B)[index] = getParticleArray(COLOR_B)[index] = colorStart.z;
+        getParticleArray(COLOR_START_A)[index] = getParticleArray(COLOR_A)[index] = colorStart.w;
+        getParticleArray(COLOR_END_R)[index] = colorEnd.x;
+        getParticleArray(COLOR_END_G)[index] = colorEnd.y;
+        getParticleArray(COLOR_END_B)[index] = colorEnd.z;
+        getParticleArray(COLOR_END_A)[index] = colorEnd.w;
+        getParticleArray(ROTATION_PER_PARTICLE_SPEED)[index] = rotationPerParticleSpeed;
+        getParticleArray(ROTATION_AXIS_X)[index] = rotationAxis.x;
+        getParticleArray(ROTATION_AXIS_Y)[index] = rotationAxis.y;
+        getParticleArray(ROTATION_AXIS_Z)[index] = rotationAxis.z;
+        getParticleArray(ROTATION_SPEED)[index] = rotationSpeed;
+        getParticleArray(ANGLE)[index] = generateScalar(0.0f, rotationPerParticleSpeed);
+        getParticleArray(ENERGY)[index] = (float)energy;
+        getParticleArray(ENERGY_START_INVERSE)[index] = energy > 0 ? 1.0f / (float)energy : 0.0f;
+        getParticleArray(SIZE_START)[index] = getParticleArray(SIZE)[index] = size;
+        getParticleArray(SIZE_END)[index] = generateScalar(_sizeEndMin, _sizeEndMax);
+        getParticleArray(VISIBLE)[index] = 1.0f;
 
         // Initial sprite frame.
         if (_spriteFrameRandomOffset > 0)
         {
-            p->_frame = rand() % _spriteFrameRandomOffset;
+            getParticleArray(FRAME)[index] = (float)(rand() % _spriteFrameRandomOffset);
         }
         else
         {
-            p->_frame = 0;
+            getParticleArray(FRAME)[index] = 0.0f;
         }
-        p->_timeOnCurrentFrame = 0.0f;
+        getParticleArray(TIME_ON_CURRENT_FRAME)[index] = 0.0f;
 
         ++_particleCount;
     }
@@ -790,6 +863,20 @@ ParticleEmitter::TextureBlending ParticleEmitter::getTextureBlendingFromString(c
     }
 }
 
+float* ParticleEmitter::getParticleArray(ParticleArray array) const
+{
+    return _particleDataAligned + array * _particleCapacity;
+}
+
+void ParticleEmitter::moveParticle(unsigned int src, unsigned int dst)
+{
+    for (unsigned int i = 0; i < PARTICLE_ARRAY_COUNT; ++i)
+    {
+        float* data = _particleDataAligned + i * _particleCapacity;
+        data[dst] = data[src];
+    }
+}
+
 void ParticleEmitter::update(float elapsedTime)
 {
     if (!isActive())
@@ -822,94 +909,230 @@ void ParticleEmitter::update(float elapsedTime)
     GP_ASSERT(_node && _node->getScene() && _node->getScene()->getActiveCamera());
     const Frustum& frustum = _node->getScene()->getActiveCamera()->getFrustum();
 
-    // Now update all currently living particles.
-    GP_ASSERT(_particles);
-    for (unsigned int particlesIndex = 0; particlesIndex < _particleCount; ++particlesIndex)
+    // Remove the particles that die this frame. Move the particle furthest from the start of the
+    // arrays down to take its place, so all living particles stay packed at the start of the arrays.
+    GP_ASSERT(_particleDataAligned);
+    float* energy = getParticleArray(ENERGY);
+    for (unsigned int i = 0; i < _particleCount; )
     {
-        Particle* p = &_particles[particlesIndex];
-        p->_energy -= elapsedTime;
-
-        if (p->_energy > 0L)
+        energy[i] -= elapsedTime;
+        if (energy[i] > 0.0f)
+        {
+            ++i;
+        }
+        else
         {
-            if (p->_rotationSpeed != 0.0f && !p->_rotationAxis.isZero())
+            --_particleCount;
+            if (i != _particleCount)
             {
-                Matrix::createRotation(p->_rotationAxis, p->_rotationSpeed * elapsedSecs, &_rotation);
-
-                _rotation.transformPoint(p->_velocity, &p->_velocity);
-                _rotation.transformPoint(p->_acceleration, &p->_acceleration);
+                // The moved particle has not been aged yet; it is processed on the next iteration.
+                moveParticle(_particleCount, i);
             }
+        }
+    }
+
+    if (_particleCount == 0)
+        return;
+
+    if (_rotationSpeedMin != 0.0f || _rotationSpeedMax != 0.0f)
+    {
+        updateRotation(elapsedSecs);
+    }
+
+    updateParticles(elapsedSecs, frustum);
+
+    if (_spriteAnimated)
+    {
+        updateSpriteFrames(elapsedSecs);
+    }
+}
+
+void ParticleEmitter::updateRotation(float elapsedSecs)
+{
+    const float* rotationSpeed = getParticleArray(ROTATION_SPEED);
+    const float* axisX = getParticleArray(ROTATION_AXIS_X);
+    const float* axisY = getParticleArray(ROTATION_AXIS_Y);
+    const float* axisZ = getParticleArray(ROTATION_AXIS_Z);
+    float* vectorX[2] = { getParticleArray(VELOCITY_X), getParticleArray(ACCELERATION_X) };
+    float* vectorY[2] = { getParticleArray(VELOCITY_Y), getParticleArray(ACCELERATION_Y) };
+    float* vectorZ[2] = { getParticleArray(VELOCITY_Z), getParticleArray(ACCELERATION_Z) };
 
-            // Particle is still alive.
-            p->_velocity.x += p->_acceleration.x * elapsedSecs;
-            p->_velocity.y += p->_acceleration.y * elapsedSecs;
-            p->_velocity.z += p->_acceleration.z * elapsedSecs;
+    for (unsigned int i = 0; i < _particleCount; ++i)
+    {
+        if (rotationSpeed[i] == 0.0f)
+            continue;
+
+        // Rotate the velocity and acceleration around the (normalized) axis using Rodrigues' formula,
+        // which is equivalent to transforming them by Matrix::createRotation(axis, angle).
+        float angle = rotationSpeed[i] * elapsedSecs;
+        float c = cos(angle);
+        float s = sin(angle);
+        float t = 1.0f - c;
+        float x = axisX[i];
+        float y = axisY[i];
+        float z = axisZ[i];
+        for (unsigned int j = 0; j < 2; ++j)
+        {
+            float vx = vectorX[j][i];
+            float vy = vectorY[j][i];
+            float vz = vectorZ[j][i];
+            float d = t * (x * vx + y * vy + z * vz);
+            vectorX[j][i] = vx * c + (y * vz - z * vy) * s + x * d;
+            vectorY[j][i] = vy * c + (z * vx - x * vz) * s + y * d;
+            vectorZ[j][i] = vz * c + (x * vy - y * vx) * s + z * d;
+        }
+    }
+}
 
-            p->_position.x += p->_velocity.x * elapsedSecs;
-            p->_position.y += p->_velocity.y * elapsedSecs;
-            p->_position.z += p->_velocity.z * elapsedSecs;
+void ParticleEmitter::updateParticles(float elapsedSecs, const Frustum& frustum)
+{
+    float* positionX = getParticleArray(POSITION_X);
+    float* positionY = getParticleArray(POSITION_Y);
+    float* positionZ = getParticleArray(POSITION_Z);
+    float* velocityX = getParticleArray(VELOCITY_X);
+    float* velocityY = getParticleArray(VELOCITY_Y);
+    float* velocityZ = getParticleArray(VELOCITY_Z);
+    const float* accelerationX = getParticleArray(ACCELERATION_X);
+    const float* accelerationY = getParticleArray(ACCELERATION_Y);
+    const float* accelerationZ = getParticleArray(ACCELERATION_Z);
+    const float* rotationPerParticleSpeed = getParticleArray(ROTATION_PER_PARTICLE_SPEED);
+    float* angle = getParticleArray(ANGLE);
+    const float* energy = getParticleArray(ENERGY);
+    const float* energyStartInverse = getParticleArray(ENERGY_START_INVERSE);
+    const float* sizeStart = getParticleArray(SIZE_START);
+    const float* sizeEnd = getParticleArray(SIZE_END);
+    float* size = getParticleArray(SIZE);
+    float* visible = getParticleArray(VISIBLE);
+    const float* colorStart[4] = { getParticleArray(COLOR_START_R), getParticleArray(COLOR_START_G), getParticleArray(COLOR_START_B), getParticleArray(COLOR_START_A) };
+    const float* colorEnd[4] = { getParticleArray(COLOR_END_R), getParticleArray(COLOR_END_G), getParticleArray(COLOR_END_B), getParticleArray(COLOR_END_A) };
+    float* color[4] = { getParticleArray(COLOR_R), getParticleArray(COLOR_G), getParticleArray(COLOR_B), getParticleArray(COLOR_A) };
+
+    const Plane* planes[6] = { &frustum.getNear(), &frustum.getFar(), &frustum.getLeft(), &frustum.getRight(), &frustum.getTop(), &frustum.getBottom() };
+
+#if defined(USE_SSE) || defined(USE_NEON)
+    const float4 dt = FLOAT4_SET(elapsedSecs);
+    const float4 zero = FLOAT4_SET(0.0f);
+    const float4 one = FLOAT4_SET(1.0f);
+    float4 planeX[6], planeY[6], planeZ[6], planeD[6];
+    for (unsigned int j = 0; j < 6; ++j)
+    {
+        planeX[j] = FLOAT4_SET(planes[j]->getNormal().x);
+        planeY[j] = FLOAT4_SET(planes[j]->getNormal().y);
+        planeZ[j] = FLOAT4_SET(planes[j]->getNormal().z);
+        planeD[j] = FLOAT4_SET(planes[j]->getDistance());
+    }
+
+    // The arrays are padded to a multiple of four, so the last group may include unused slots.
+    for (unsigned int i = 0; i < _particleCount; i += 4)
+    {
+        // Integrate the motion.
+        float4 vx = FLOAT4_MADD(FLOAT4_LOAD(accelerationX + i), dt, FLOAT4_LOAD(velocityX + i));
+        float4 vy = FLOAT4_MADD(FLOAT4_LOAD(accelerationY + i), dt, FLOAT4_LOAD(velocityY + i));
+        float4 vz = FLOAT4_MADD(FLOAT4_LOAD(accelerationZ + i), dt, FLOAT4_LOAD(velocityZ + i));
+        float4 px = FLOAT4_MADD(vx, dt, FLOAT4_LOAD(positionX + i));
+        float4 py = FLOAT4_MADD(vy, dt, FLOAT4_LOAD(positionY + i));
+        float4 pz = FLOAT4_MADD(vz, dt, FLOAT4_LOAD(positionZ + i));
+        FLOAT4_STORE(velocityX + i, vx);
+        FLOAT4_STORE(velocityY + i, vy);
+        FLOAT4_STORE(velocityZ + i, vz);
+        FLOAT4_STORE(positionX + i, px);
+        FLOAT4_STORE(positionY + i, py);
+        FLOAT4_STORE(positionZ + i, pz);
+
+        // A particle is visible when it is on the positive side of all frustum planes.
+        mask4 inside = FLOAT4_GT(FLOAT4_MADD(planeX[0], px, FLOAT4_MADD(planeY[0], py, FLOAT4_MADD(planeZ[0], pz, planeD[0]))), zero);
+        for (unsigned int j = 1; j < 6; ++j)
+        {
+            float4 distance = FLOAT4_MADD(planeX[j], px, FLOAT4_MADD(planeY[j], py, FLOAT4_MADD(planeZ[j], pz, planeD[j])));
+            inside = MASK4_AND(inside, FLOAT4_GT(distance, zero));
+        }
+        FLOAT4_STORE(visible + i, MASK4_SELECT(inside, one));
 
-            if (!frustum.intersects(p->_position))
+        FLOAT4_STORE(angle + i, FLOAT4_MADD(FLOAT4_LOAD(rotationPerParticleSpeed + i), dt, FLOAT4_LOAD(angle + i)));
+
+        // Simple linear interpolation of color and size.
+        float4 percent = FLOAT4_SUB(one, FLOAT4_MUL(FLOAT4_LOAD(energy + i), FLOAT4_LOAD(energyStartInverse + i)));
+        for (unsigned int j = 0; j < 4; ++j)
+        {
+            float4 start = FLOAT4_LOAD(colorStart[j] + i);
+            FLOAT4_STORE(color[j] + i, FLOAT4_MADD(FLOAT4_SUB(FLOAT4_LOAD(colorEnd[j] + i), start), percent, start));
+        }
+        float4 start = FLOAT4_LOAD(sizeStart + i);
+        FLOAT4_STORE(size + i, FLOAT4_MADD(FLOAT4_SUB(FLOAT4_LOAD(sizeEnd + i), start), percent, start));
+    }
+#else
+    for (unsigned int i = 0; i < _particleCount; ++i)
+    {
+        velocityX[i] += accelerationX[i] * elapsedSecs;
+        velocityY[i] += accelerationY[i] * elapsedSecs;
+        velocityZ[i] += accelerationZ[i] * elapsedSecs;
+
+        positionX[i] += velocityX[i] * elapsedSecs;
+        positionY[i] += velocityY[i] * elapsedSecs;
+        positionZ[i] += velocityZ[i] * elapsedSecs;
+
+        visible[i] = 1.0f;
+        for (unsigned int j = 0; j < 6; ++j)
+        {
+            const Vector3& normal = planes[j]->getNormal();
+            if (normal.x * positionX[i] + normal.y * positionY[i] + normal.z * positionZ[i] + planes[j]->getDistance() <= 0.0f)
             {
-                p->_visible = false;
-                continue;
+                visible[i] = 0.0f;
+                break;
             }
+        }
 
-            p->_angle += p->_rotationPerParticleSpeed * elapsedSecs;
-
-            // Simple linear interpolation of color and size.
-            float percent = 1.0f - ((float)p->_energy / (float)p->_energyStart);
+        angle[i] += rotationPerParticleSpeed[i] * elapsedSecs;
 
-            p->_color.x = p->_colorStart.x + (p->_colorEnd.x - p->_colorStart.x) * percent;
-            p->_color.y = p->_colorStart.y + (p->_colorEnd.y - p->_colorStart.y) * percent;
-            p->_color.z = p->_colorStart.z + (p->_colorEnd.z - p->_colorStart.z) * percent;
-            p->_color.w = p->_colorStart.w + (p->_colorEnd.w - p->_colorStart.w) * percent;
+        // Simple linear interpolation of color and size.
+        float percent = 1.0f - energy[i] * energyStartInverse[i];
+        for (unsigned int j = 0; j < 4; ++j)
+        {
+            color[j][i] = colorStart[j][i] + (colorEnd[j][i] - colorStart[j][i]) * percent;
+        }
+        size[i] = sizeStart[i] + (sizeEnd[i] - sizeStart[i]) * percent;
+    }
+#endif
+}
 
-            p->_size = p->_sizeStart + (p->_sizeEnd - p->_sizeStart) * percent;
+void ParticleEmitter::updateSpriteFrames(float elapsedSecs)
+{
+    float* frame = getParticleArray(FRAME);
+    float* timeOnCurrentFrame = getParticleArray(TIME_ON_CURRENT_FRAME);
 
-            // Handle sprite animations.
-            if (_spriteAnimated)
+    if (!_spriteLooped)
+    {
+        // The last frame should finish exactly when the particle dies.
+        const float* energy = getParticleArray(ENERGY);
+        const float* energyStartInverse = getParticleArray(ENERGY_START_INVERSE);
+        float lastFrame = (float)(_spriteFrameCount - 1);
+        for (unsigned int i = 0; i < _particleCount; ++i)
+        {
+            float percent = 1.0f - energy[i] * energyStartInverse[i];
+            timeOnCurrentFrame[i] = percent - frame[i] * _spritePercentPerFrame;
+            if (frame[i] < lastFrame && timeOnCurrentFrame[i] >= _spritePercentPerFrame)
             {
-                if (!_spriteLooped)
-                {
-                    // The last frame should finish exactly when the particle dies.
-                    float percentSpent = 0.0f;
-                    for (unsigned int i = 0; i < p->_frame; i++)
-                    {
-                        percentSpent += _spritePercentPerFrame;
-                    }
-                    p->_timeOnCurrentFrame = percent - percentSpent;
-                    if (p->_frame < _spriteFrameCount - 1 &&
-                        p->_timeOnCurrentFrame >= _spritePercentPerFrame)
-                    {
-                        ++p->_frame;
-                    }
-                }
-                else
-                {
-                    // _spriteFrameDurationSecs is an absolute time measured in seconds,
-                    // and the animation repeats indefinitely.
-                    p->_timeOnCurrentFrame += elapsedSecs;
-                    if (p->_timeOnCurrentFrame >= _spriteFrameDurationSecs)
-                    {
-                        p->_timeOnCurrentFrame -= _spriteFrameDurationSecs;
-                        ++p->_frame;
-                        if (p->_frame == _spriteFrameCount)
-                        {
-                            p->_frame = 0;
-                        }
-                    }
-                }
+                frame[i] += 1.0f;
             }
         }
-        else
+    }
+    else
+    {
+        // _spriteFrameDurationSecs is an absolute time measured in seconds,
+        // and the animation repeats indefinitely.
+        float frameCount = (float)_spriteFrameCount;
+        for (unsigned int i = 0; i < _particleCount; ++i)
         {
-            // Particle is dead.  Move the particle furthest from the start of the array
-            // down to take its place, and re-use the slot at the end of the list of living particles.
-            if (particlesIndex != _particleCount - 1)
+            timeOnCurrentFrame[i] += elapsedSecs;
+            if (timeOnCurrentFrame[i] >= _spriteFrameDurationSecs)
             {
-                _particles[particlesIndex] = _particles[_particleCount - 1];
+                timeOnCurrentFrame[i] -= _spriteFrameDurationSecs;
+                frame[i] += 1.0f;
+                if (frame[i] == frameCount)
+                {
+                    frame[i] = 0.0f;
+                }
             }
-            --_particleCount;
         }
     }
 }
@@ -924,7 +1147,7 @@ void ParticleEmitter::draw()
     if (_particleCount > 0)
     {
         GP_ASSERT(_spriteBatch);
-        GP_ASSERT(_particles);
+        GP_ASSERT(_particleDataAligned);
         GP_ASSERT(_spriteTextureCoords);
 
         // Set our node's view projection matrix to this emitter's effect.
@@ -948,15 +1171,26 @@ void ParticleEmitter::draw()
         Vector3 up;
         cameraWorldMatrix.getUpVector(&up);
 
+        const float* positionX = getParticleArray(POSITION_X);
+        const float* positionY = getParticleArray(POSITION_Y);
+        const float* positionZ = getParticleArray(POSITION_Z);
+        const float* colorR = getParticleArray(COLOR_R);
+        const float* colorG = getParticleArray(COLOR_G);
+        const float* colorB = getParticleArray(COLOR_B);
+        const float* colorA = getParticleArray(COLOR_A);
+        const float* size = getParticleArray(SIZE);
+        const float* angle = getParticleArray(ANGLE);
+        const float* frame = getParticleArray(FRAME);
+        const float* visible = getParticleArray(VISIBLE);
+
         for (unsigned int i = 0; i < _particleCount; i++)
         {
-            Particle* p = &_particles[i];
-
-            if (p->_visible)
+            if (visible[i] != 0.0f)
             {
-                _spriteBatch->draw(p->_position, right, up, p->_size, p->_size,
-                                   _spriteTextureCoords[p->_frame * 4], _spriteTextureCoords[p->_frame * 4 + 1], _spriteTextureCoords[p->_frame * 4 + 2], _spriteTextureCoords[p->_frame * 4 + 3],
-                                   p->_color, pivot, p->_angle);
+                const float* texCoords = &_spriteTextureCoords[(unsigned int)frame[i] * 4];
+                _spriteBatch->draw(Vector3(positionX[i], positionY[i], positionZ[i]), right, up, size[i], size[i],
+                                   texCoords[0], texCoords[1], texCoords[2], texCoords[3],
+                                   Vector4(colorR[i], colorG[i], colorB[i], colorA[i]), pivot, angle[i]);
             }
         }
 
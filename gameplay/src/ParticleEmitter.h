@@ -9,6 +9,7 @@
 #include "Rectangle.h"
 #include "SpriteBatch.h"
 #include "Properties.h"
+#include "Frustum.h"
 
 namespace gameplay
 {
@@ -667,35 +668,82 @@ private:
     void generateColor(const Vector4& base, const Vector4& variance, Vector4* dst);
 
     /**
-     * Defines the data for a single particle in the system.
+     * Defines the arrays holding the data of the particles in the system.
+     *
+     * Particles are stored as a structure of arrays: each property of every particle
+     * lives in its own contiguous array of floats. This allows the update to process
+     * four particles at a time using SIMD instructions (SSE or NEON).
      */
-    class Particle
+    enum ParticleArray
     {
-
-    public:
-        Vector3 _position;
-        Vector3 _velocity;
-        Vector3 _acceleration;
-        Vector4 _colorStart;
-        Vector4 _colorEnd;
-        Vector4 _color;
-        float _rotationPerParticleSpeed;
-        Vector3 _rotationAxis;
-        float _rotationSpeed;
-        float _angle;
-        long _energyStart;
-        long _energy;
-        float _sizeStart;
-        float _sizeEnd;
-        float _size;
-        unsigned int _frame;
-        float _timeOnCurrentFrame;
-        bool _visible;
+        POSITION_X,
+        POSITION_Y,
+        POSITION_Z,
+        VELOCITY_X,
+        VELOCITY_Y,
+        VELOCITY_Z,
+        ACCELERATION_X,
+        ACCELERATION_Y,
+        ACCELERATION_Z,
+        COLOR_START_R,
+        COLOR_START_G,
+        COLOR_START_B,
+        COLOR_START_A,
+        COLOR_END_R,
+        COLOR_END_G,
+        COLOR_END_B,
+        COLOR_END_A,
+        COLOR_R,
+        COLOR_G,
+        COLOR_B,
+        COLOR_A,
+        ROTATION_PER_PARTICLE_SPEED,
+        ROTATION_AXIS_X,
+        ROTATION_AXIS_Y,
+        ROTATION_AXIS_Z,
+        ROTATION_SPEED,
+        ANGLE,
+        ENERGY,
+        ENERGY_START_INVERSE,
+        SIZE_START,
+        SIZE_END,
+        SIZE,
+        FRAME,
+        TIME_ON_CURRENT_FRAME,
+        VISIBLE,
+        PARTICLE_ARRAY_COUNT
     };
 
+    /**
+     * Gets the array of the specified particle property.
+     */
+    float* getParticleArray(ParticleArray array) const;
+
+    /**
+     * Moves the particle at index src to index dst, overwriting the particle at dst.
+     */
+    void moveParticle(unsigned int src, unsigned int dst);
+
+    /**
+     * Rotates the velocity and acceleration of the particles that rotate around an axis.
+     */
+    void updateRotation(float elapsedSecs);
+
+    /**
+     * Integrates the motion, culls against the frustum and interpolates the color and size of all particles.
+     */
+    void updateParticles(float elapsedSecs, const Frustum& frustum);
+
+    /**
+     * Advances the sprite animation frames of all particles.
+     */
+    void updateSpriteFrames(float elapsedSecs);
+
     unsigned int _particleCountMax;
     unsigned int _particleCount;
-    Particle* _particles;
+    unsigned int _particleCapacity;
+    float* _particleData;
+    float* _particleDataAligned;
     unsigned int _emissionRate;
     bool _started;
     bool _ellipsoid;
@@ -721,7 +769,6 @@ private:
     float _rotationSpeedMax;
     Vector3 _rotationAxis;
     Vector3 _rotationAxisVar;
-    Matrix _rotation;
     SpriteBatch* _spriteBatch;
     TextureBlending _spriteTextureBlending;
     float _spriteTextureWidth;
@@ -30,6 +30,8 @@ static Window   __window;
 static int __windowSize[2];
 static GLXContext __context;
 static Window __attachToWindow;
+static bool __headless = false;
+static GLuint __headlessName = 0;
 
 namespace gameplay
 {
@@ -355,6 +357,181 @@ static Keyboard::Key getKey(KeySym sym)
     }
 }
 
+// No-op OpenGL entry points installed in place of the GLEW and OpenGL 1.1 function
+// pointers when running headless. Object creation returns unique names, status queries
+// report success and other queries fill in plausible values, so resources can still be
+// created without a GL context.
+static void GLAPIENTRY headlessGenNames(GLsizei n, GLuint* names)
+{
+    for (GLsizei i = 0; i < n; ++i)
+        names[i] = ++__headlessName;
+}
+static GLuint GLAPIENTRY headlessCreateName() { return ++__headlessName; }
+static GLuint GLAPIENTRY headlessCreateShader(GLenum) { return ++__headlessName; }
+static void GLAPIENTRY headlessDeleteNames(GLsizei, const GLuint*) { }
+static void GLAPIENTRY headlessEnum(GLenum) { }
+static void GLAPIENTRY headlessUint(GLuint) { }
+static void GLAPIENTRY headlessUintUint(GLuint, GLuint) { }
+static void GLAPIENTRY headlessEnumUint(GLenum, GLuint) { }
+static GLboolean GLAPIENTRY headlessIsName(GLuint) { return GL_TRUE; }
+static GLenum GLAPIENTRY headlessCheckFramebufferStatus(GLenum) { return GL_FRAMEBUFFER_COMPLETE; }
+static void GLAPIENTRY headlessBindAttribLocation(GLuint, GLuint, const GLchar*) { }
+static void GLAPIENTRY headlessBufferData(GLenum, GLsizeiptr, const GLvoid*, GLenum) { }
+static void GLAPIENTRY headlessBufferSubData(GLenum, GLintptr, GLsizeiptr, const GLvoid*) { }
+static void GLAPIENTRY headlessCompressedTexImage2D(GLenum, GLint, GLenum, GLsizei, GLsizei, GLint, GLsizei, const GLvoid*) { }
+static void GLAPIENTRY headlessFramebufferRenderbuffer(GLenum, GLenum, GLenum, GLuint) { }
+static void GLAPIENTRY headlessFramebufferTexture2D(GLenum, GLenum, GLenum, GLuint, GLint) { }
+static void GLAPIENTRY headlessRenderbufferStorage(GLenum, GLenum, GLsizei, GLsizei) { }
+static void GLAPIENTRY headlessShaderSource(GLuint, GLsizei, const GLchar**, const GLint*) { }
+static void GLAPIENTRY headlessGetActive(GLuint, GLuint, GLsizei maxLength, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+{
+    if (length)
+        *length = 0;
+    if (size)
+        *size = 0;
+    if (name && maxLength > 0)
+        name[0] = '\0';
+}
+static GLint GLAPIENTRY headlessGetLocation(GLuint, const GLchar*) { return -1; }
+static void GLAPIENTRY headlessGetInfoLog(GLuint, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+{
+    if (length)
+        *length = 0;
+    if (infoLog && bufSize > 0)
+        infoLog[0] = '\0';
+}
+static void GLAPIENTRY headlessGetObjectiv(GLuint, GLenum pname, GLint* param)
+{
+    // Report successful compiles/links and no active attributes, uniforms or logs.
+    *param = (pname == GL_COMPILE_STATUS || pname == GL_LINK_STATUS) ? GL_TRUE : 0;
+}
+static void GLAPIENTRY headlessUniformf(GLint, GLfloat) { }
+static void GLAPIENTRY headlessUniformi(GLint, GLint) { }
+static void GLAPIENTRY headlessUniform2f(GLint, GLfloat, GLfloat) { }
+static void GLAPIENTRY headlessUniform3f(GLint, GLfloat, GLfloat, GLfloat) { }
+static void GLAPIENTRY headlessUniform4f(GLint, GLfloat, GLfloat, GLfloat, GLfloat) { }
+static void GLAPIENTRY headlessUniformfv(GLint, GLsizei, const GLfloat*) { }
+static void GLAPIENTRY headlessUniformiv(GLint, GLsizei, const GLint*) { }
+static void GLAPIENTRY headlessUniformMatrixfv(GLint, GLsizei, GLboolean, const GLfloat*) { }
+static void GLAPIENTRY headlessVertexAttribPointer(GLuint, GLint, GLenum, GLboolean, GLsizei, const GLvoid*) { }
+static void GLAPIENTRY headlessVertexAttribfv(GLuint, const GLfloat*) { }
+static void GLAPIENTRY headlessEnumEnum(GLenum, GLenum) { }
+static void GLAPIENTRY headlessEnumInt(GLenum, GLint) { }
+static void GLAPIENTRY headlessEnumEnumInt(GLenum, GLenum, GLint) { }
+static void GLAPIENTRY headlessInt(GLint) { }
+static void GLAPIENTRY headlessBoolean(GLboolean) { }
+static void GLAPIENTRY headlessClearColor(GLclampf, GLclampf, GLclampf, GLclampf) { }
+static void GLAPIENTRY headlessClearDepth(GLclampd) { }
+static void GLAPIENTRY headlessRect(GLint, GLint, GLsizei, GLsizei) { }
+static void GLAPIENTRY headlessDrawArrays(GLenum, GLint, GLsizei) { }
+static void GLAPIENTRY headlessDrawElements(GLenum, GLsizei, GLenum, const GLvoid*) { }
+static void GLAPIENTRY headlessTexImage2D(GLenum, GLint, GLint, GLsizei, GLsizei, GLint, GLenum, GLenum, const GLvoid*) { }
+static void GLAPIENTRY headlessTexSubImage2D(GLenum, GLint, GLint, GLint, GLsizei, GLsizei, GLenum, GLenum, const GLvoid*) { }
+static GLenum GLAPIENTRY headlessGetError() { return GL_NO_ERROR; }
+static const GLubyte* GLAPIENTRY headlessGetString(GLenum) { return (const GLubyte*)""; }
+static void GLAPIENTRY headlessGetIntegerv(GLenum pname, GLint* params)
+{
+    // Report the default framebuffer bound and the minimum limits OpenGL requires.
+    switch (pname)
+    {
+    case GL_MAX_COLOR_ATTACHMENTS:
+        *params = 4;
+        break;
+    case GL_MAX_VERTEX_ATTRIBS:
+        *params = 16;
+        break;
+    case GL_MAX_TEXTURE_SIZE:
+        *params = 1024;
+        break;
+    default:
+        *params = 0;
+        break;
+    }
+}
+
+// Installs the headless OpenGL entry points.
+static void initializeHeadlessGL()
+{
+    __glewActiveTexture = headlessEnum;
+    __glewAttachShader = headlessUintUint;
+    __glewBindAttribLocation = headlessBindAttribLocation;
+    __glewBindBuffer = headlessEnumUint;
+    __glewBindFramebuffer = headlessEnumUint;
+    __glewBindRenderbuffer = headlessEnumUint;
+    __glewBindVertexArray = headlessUint;
+    __glewBufferData = headlessBufferData;
+    __glewBufferSubData = headlessBufferSubData;
+    __glewCheckFramebufferStatus = headlessCheckFramebufferStatus;
+    __glewCompileShader = headlessUint;
+    __glewCompressedTexImage2D = headlessCompressedTexImage2D;
+    __glewCreateProgram = headlessCreateName;
+    __glewCreateShader = headlessCreateShader;
+    __glewDeleteBuffers = headlessDeleteNames;
+    __glewDeleteFramebuffers = headlessDeleteNames;
+    __glewDeleteRenderbuffers = headlessDeleteNames;
+    __glewDeleteProgram = headlessUint;
+    __glewDeleteShader = headlessUint;
+    __glewDeleteVertexArrays = headlessDeleteNames;
+    __glewDisableVertexAttribArray = headlessUint;
+    __glewEnableVertexAttribArray = headlessUint;
+    __glewFramebufferRenderbuffer = headlessFramebufferRenderbuffer;
+    __glewFramebufferTexture2D = headlessFramebufferTexture2D;
+    __glewGenBuffers = headlessGenNames;
+    __glewGenFramebuffers = headlessGenNames;
+    __glewGenRenderbuffers = headlessGenNames;
+    __glewGenVertexArrays = headlessGenNames;
+    __glewGenerateMipmap = headlessEnum;
+    __glewGetActiveAttrib = headlessGetActive;
+    __glewGetActiveUniform = headlessGetActive;
+    __glewGetAttribLocation = headlessGetLocation;
+    __glewGetProgramInfoLog = headlessGetInfoLog;
+    __glewGetProgramiv = headlessGetObjectiv;
+    __glewGetShaderInfoLog = headlessGetInfoLog;
+    __glewGetShaderiv = headlessGetObjectiv;
+    __glewGetUniformLocation = headlessGetLocation;
+    __glewIsVertexArray = headlessIsName;
+    __glewLinkProgram = headlessUint;
+    __glewRenderbufferStorage = headlessRenderbufferStorage;
+    __glewShaderSource = headlessShaderSource;
+    __glewUniform1f = headlessUniformf;
+    __glewUniform1fv = headlessUniformfv;
+    __glewUniform1i = headlessUniformi;
+    __glewUniform1iv = headlessUniformiv;
+    __glewUniform2f = headlessUniform2f;
+    __glewUniform2fv = headlessUniformfv;
+    __glewUniform3f = headlessUniform3f;
+    __glewUniform3fv = headlessUniformfv;
+    __glewUniform4f = headlessUniform4f;
+    __glewUniform4fv = headlessUniformfv;
+    __glewUniformMatrix4fv = headlessUniformMatrixfv;
+    __glewUseProgram = headlessUint;
+    __glewVertexAttrib4fv = headlessVertexAttribfv;
+    __glewVertexAttribPointer = headlessVertexAttribPointer;
+
+    __gpBindTexture = headlessEnumUint;
+    __gpBlendFunc = headlessEnumEnum;
+    __gpClear = headlessUint;
+    __gpClearColor = headlessClearColor;
+    __gpClearDepth = headlessClearDepth;
+    __gpClearStencil = headlessInt;
+    __gpDeleteTextures = headlessDeleteNames;
+    __gpDepthMask = headlessBoolean;
+    __gpDisable = headlessEnum;
+    __gpDrawArrays = headlessDrawArrays;
+    __gpDrawElements = headlessDrawElements;
+    __gpEnable = headlessEnum;
+    __gpGenTextures = headlessGenNames;
+    __gpGetError = headlessGetError;
+    __gpGetIntegerv = headlessGetIntegerv;
+    __gpGetString = headlessGetString;
+    __gpPixelStorei = headlessEnumInt;
+    __gpScissor = headlessRect;
+    __gpTexImage2D = headlessTexImage2D;
+    __gpTexParameteri = headlessEnumEnumInt;
+    __gpTexSubImage2D = headlessTexSubImage2D;
+    __gpViewport = headlessRect;
+}
+
 extern void print(const char* format, ...)
 {
     GP_ASSERT(format);
@@ -381,6 +558,29 @@ Platform* Platform::create(Game* game, void* attachToWindow)
     FileSystem::setResourcePath("./");
     Platform* platform = new Platform(game);
 
+    // Read window settings from config.
+    __windowSize[0] = 1280;
+    __windowSize[1] = 720;
+    if (game->getConfig())
+    {
+        Properties* config = game->getConfig()->getNamespace("window", true);
+        if (config)
+        {
+            __headless = config->getBool("headless");
+            if (config->getInt("width") > 0)
+                __windowSize[0] = config->getInt("width");
+            if (config->getInt("height") > 0)
+                __windowSize[1] = config->getInt("height");
+        }
+    }
+
+    // Run without a display or GL context. The message pump drives frames as fast as possible.
+    if (__headless)
+    {
+        initializeHeadlessGL();
+        return platform;
+    }
+
     // Get the display and initialize.
     __display = XOpenDisplay(NULL);
     if (__display == NULL)
@@ -450,7 +650,7 @@ Platform* Platform::create(Game* game, void* attachToWindow)
     GLint winMask;
     winMask = CWBorderPixel | CWBitGravity | CWEventMask| CWColormap;
    
-    __window = XCreateWindow(__display, DefaultRootWindow(__display), 0, 0, 1280, 720, 0, 
+    __window = XCreateWindow(__display, DefaultRootWindow(__display), 0, 0, __windowSize[0], __windowSize[1], 0, 
                             visualInfo->depth, InputOutput, visualInfo->visual, winMask,
                             &winAttribs); 
     
@@ -489,6 +689,9 @@ Platform* Platform::create(Game* game, void* attachToWindow)
 
 void cleanupX11()
 {
+    if (__headless)
+        return;
+
     if (__display)
     {
         glXMakeCurrent(__display, None, NULL);
@@ -510,6 +713,8 @@ double timespec2millis(struct timespec *a)
 
 void updateWindowSize()    
 {    
+    if (__headless)
+        return;
     GP_ASSERT(__display);    
     GP_ASSERT(__window);
     XWindowAttributes windowAttrs;    
@@ -540,6 +745,16 @@ int Platform::enterMessagePump()
     // Run the game.
     _game->run();
 
+    if (__headless)
+    {
+        // No events to process; run frames until the game exits.
+        while (_game->getState() != Game::UNINITIALIZED)
+        {
+            _game->frame();
+        }
+        return 0;
+    }
+
     // Setup select for message handling (to allow non-blocking)    
     int x11_fd = ConnectionNumber(__display);
     
@@ -748,6 +963,8 @@ void Platform::setVsync(bool enable)
 
 void Platform::swapBuffers()
 {
+    if (__headless)
+        return;
     glXSwapBuffers(__display, __window);
 }
 
@@ -777,7 +994,7 @@ void Platform::getAccelerometerValues(float* pitch, float* roll)
 
 bool Platform::hasMouse()
 {
-    return true;
+    return !__headless;
 }
 
 void Platform::setMouseCaptured(bool captured)
@@ -793,7 +1010,7 @@ bool Platform::isMouseCaptured()
 
 void Platform::setCursorVisible(bool visible)
 {
-    if (visible != __cursorVisible)
+    if (visible != __cursorVisible && __display)
     {
         if (visible)
         {
@@ -931,4 +1148,51 @@ float Platform::getGamepadTriggerValue(unsigned int gamepadHandle, unsigned int
 
 }
 
+// The OpenGL 1.1 function pointers declared in Base.h, which point to the functions of
+// the GL library unless headless stubs replace them.
+#undef glBindTexture
+#undef glBlendFunc
+#undef glClear
+#undef glClearColor
+#undef glClearDepth
+#undef glClearStencil
+#undef glDeleteTextures
+#undef glDepthMask
+#undef glDisable
+#undef glDrawArrays
+#undef glDrawElements
+#undef glEnable
+#undef glGenTextures
+#undef glGetError
+#undef glGetIntegerv
+#undef glGetString
+#undef glPixelStorei
+#undef glScissor
+#undef glTexImage2D
+#undef glTexParameteri
+#undef glTexSubImage2D
+#undef glViewport
+void (GLAPIENTRY *__gpBindTexture)(GLenum, GLuint) = glBindTexture;
+void (GLAPIENTRY *__gpBlendFunc)(GLenum, GLenum) = glBlendFunc;
+void (GLAPIENTRY *__gpClear)(GLbitfield) = glClear;
+void (GLAPIENTRY *__gpClearColor)(GLclampf, GLclampf, GLclampf, GLclampf) = glClearColor;
+void (GLAPIENTRY *__gpClearDepth)(GLclampd) = glClearDepth;
+void (GLAPIENTRY *__gpClearStencil)(GLint) = glClearStencil;
+void (GLAPIENTRY *__gpDeleteTextures)(GLsizei, const GLuint*) = glDeleteTextures;
+void (GLAPIENTRY *__gpDepthMask)(GLboolean) = glDepthMask;
+void (GLAPIENTRY *__gpDisable)(GLenum) = glDisable;
+void (GLAPIENTRY *__gpDrawArrays)(GLenum, GLint, GLsizei) = glDrawArrays;
+void (GLAPIENTRY *__gpDrawElements)(GLenum, GLsizei, GLenum, const GLvoid*) = glDrawElements;
+void (GLAPIENTRY *__gpEnable)(GLenum) = glEnable;
+void (GLAPIENTRY *__gpGenTextures)(GLsizei, GLuint*) = glGenTextures;
+GLenum (GLAPIENTRY *__gpGetError)(void) = glGetError;
+void (GLAPIENTRY *__gpGetIntegerv)(GLenum, GLint*) = glGetIntegerv;
+const GLubyte* (GLAPIENTRY *__gpGetString)(GLenum) = glGetString;
+void (GLAPIENTRY *__gpPixelStorei)(GLenum, GLint) = glPixelStorei;
+void (GLAPIENTRY *__gpScissor)(GLint, GLint, GLsizei, GLsizei) = glScissor;
+void (GLAPIENTRY *__gpTexImage2D)(GLenum, GLint, GLint, GLsizei, GLsizei, GLint, GLenum, GLenum, const GLvoid*) = glTexImage2D;
+void (GLAPIENTRY *__gpTexParameteri)(GLenum, GLenum, GLint) = glTexParameteri;
+void (GLAPIENTRY *__gpTexSubImage2D)(GLenum, GLint, GLint, GLint, GLsizei, GLsizei, GLenum, GLenum, const GLvoid*) = glTexSubImage2D;
+void (GLAPIENTRY *__gpViewport)(GLint, GLint, GLsizei, GLsizei) = glViewport;
+
 #endif
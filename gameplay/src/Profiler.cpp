@@ -0,0 +1,349 @@
+#include "Base.h"
+#include "Profiler.h"
+#include "Platform.h"
+#include "FileSystem.h"
+
+#define PROFILER_DEFAULT_FRAME_HISTORY 300
+
+namespace gameplay
+{
+
+/**
+ * A scope recorded in a frame.
+ */
+struct ProfilerEvent
+{
+    const char* name;
+    unsigned int depth;
+    double start;
+    double duration;
+};
+
+/**
+ * A recorded frame.
+ */
+struct ProfilerFrame
+{
+    double start;
+    double duration;
+    std::vector<ProfilerEvent> events;
+};
+
+bool Profiler::_enabled = false;
+
+static std::vector<ProfilerFrame>* __frames = NULL;
+static unsigned int __frameHistory = PROFILER_DEFAULT_FRAME_HISTORY;
+static unsigned int __frameNext = 0;
+static unsigned int __frameCount = 0;
+static ProfilerFrame* __frame = NULL;
+static std::vector<unsigned int>* __openEvents = NULL;
+
+// Gets the frame that is currently being recorded, creating the ring buffer on first use.
+static ProfilerFrame* getCurrentFrame()
+{
+    if (__frames == NULL)
+    {
+        __frames = new std::vector<ProfilerFrame>(__frameHistory);
+        __openEvents = new std::vector<unsigned int>();
+    }
+    if (__frame == NULL)
+    {
+        __frame = &(*__frames)[__frameNext];
+        __frame->start = Platform::getAbsoluteTime();
+        __frame->duration = 0.0;
+        __frame->events.clear();
+        __openEvents->clear();
+    }
+    return __frame;
+}
+
+// Gets the recorded frame at the specified index, where zero is the oldest recorded frame.
+static const ProfilerFrame& getRecordedFrame(unsigned int index)
+{
+    GP_ASSERT(__frames && index < __frameCount);
+    return (*__frames)[(__frameNext + __frameHistory - __frameCount + index) % __frameHistory];
+}
+
+// Gets the value at the given percentile of a sorted vector using the nearest rank method.
+static double getPercentile(const std::vector<double>& sorted, double percentile)
+{
+    GP_ASSERT(!sorted.empty());
+    unsigned int rank = (unsigned int)ceil(percentile * sorted.size());
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+Profiler::Stats::Stats() : frames(0), calls(0.0f), average(0.0), p50(0.0), p99(0.0), max(0.0)
+{
+}
+
+Profiler::Scope::Scope(const char* name) : _active(Profiler::_enabled)
+{
+    if (_active)
+        Profiler::begin(name);
+}
+
+Profiler::Scope::~Scope()
+{
+    if (_active)
+        Profiler::end();
+}
+
+bool Profiler::isEnabled()
+{
+    return _enabled;
+}
+
+void Profiler::setEnabled(bool enabled)
+{
+    if (!enabled)
+        __frame = NULL;
+    _enabled = enabled;
+}
+
+unsigned int Profiler::getFrameHistory()
+{
+    return __frameHistory;
+}
+
+void Profiler::setFrameHistory(unsigned int frameCount)
+{
+    GP_ASSERT(frameCount > 0);
+
+    SAFE_DELETE(__frames);
+    SAFE_DELETE(__openEvents);
+    __frame = NULL;
+    __frameHistory = frameCount;
+    __frameNext = 0;
+    __frameCount = 0;
+}
+
+unsigned int Profiler::getFrameCount()
+{
+    return __frameCount;
+}
+
+void Profiler::beginFrame()
+{
+    if (!_enabled)
+        return;
+
+    getCurrentFrame();
+}
+
+void Profiler::endFrame()
+{
+    if (!_enabled || __frame == NULL)
+        return;
+
+    // Close any scopes left open at the end of the frame.
+    while (!__openEvents->empty())
+        end();
+
+    __frame->duration = Platform::getAbsoluteTime() - __frame->start;
+    __frame = NULL;
+    __frameNext = (__frameNext + 1) % __frameHistory;
+    if (__frameCount < __frameHistory)
+        ++__frameCount;
+}
+
+void Profiler::begin(const char* name)
+{
+    if (!_enabled)
+        return;
+
+    GP_ASSERT(name);
+    ProfilerFrame* frame = getCurrentFrame();
+
+    ProfilerEvent event;
+    event.name = name;
+    event.depth = (unsigned int)__openEvents->size();
+    event.duration = 0.0;
+    __openEvents->push_back((unsigned int)frame->events.size());
+    event.start = Platform::getAbsoluteTime();
+    frame->events.push_back(event);
+}
+
+void Profiler::end()
+{
+    if (!_enabled || __frame == NULL || __openEvents->empty())
+        return;
+
+    ProfilerEvent& event = __frame->events[__openEvents->back()];
+    event.duration = Platform::getAbsoluteTime() - event.start;
+    __openEvents->pop_back();
+}
+
+bool Profiler::getStats(const char* name, Stats* stats)
+{
+    GP_ASSERT(stats);
+
+    *stats = Stats();
+    if (__frameCount == 0)
+        return false;
+
+    std::vector<double> times;
+    times.reserve(__frameCount);
+    unsigned int calls = 0;
+    for (unsigned int i = 0; i < __frameCount; ++i)
+    {
+        const ProfilerFrame& frame = getRecordedFrame(i);
+        if (name == NULL)
+        {
+            times.push_back(frame.duration);
+            ++calls;
+            continue;
+        }
+
+        // Sum the time of all top level occurrences of the scope in this frame,
+        // ignoring recursive occurrences nested inside another one.
+        double time = 0.0;
+        unsigned int frameCalls = 0;
+        double nestedEnd = 0.0;
+        for (size_t j = 0, count = frame.events.size(); j < count; ++j)
+        {
+            const ProfilerEvent& event = frame.events[j];
+            if (strcmp(event.name, name) == 0)
+            {
+                ++frameCalls;
+                if (event.start >= nestedEnd)
+                {
+                    time += event.duration;
+                    nestedEnd = event.start + event.duration;
+                }
+            }
+        }
+        if (frameCalls > 0)
+        {
+            times.push_back(time);
+            calls += frameCalls;
+        }
+    }
+
+    if (times.empty())
+        return false;
+
+    double total = 0.0;
+    for (size_t i = 0, count = times.size(); i < count; ++i)
+        total += times[i];
+    std::sort(times.begin(), times.end());
+
+    stats->frames = (unsigned int)times.size();
+    stats->calls = (float)calls / (float)times.size();
+    stats->average = total / times.size();
+    stats->p50 = getPercentile(times, 0.5);
+    stats->p99 = getPercentile(times, 0.99);
+    stats->max = times.back();
+    return true;
+}
+
+void Profiler::printStats()
+{
+    Stats stats;
+    if (!getStats(NULL, &stats))
+    {
+        GP_WARN("No frames have been recorded by the profiler.");
+        return;
+    }
+
+    Logger::log(Logger::LEVEL_INFO, "%-32s %8s %10s %10s %10s %10s\n", "Scope (ms per frame)", "calls", "avg", "p50", "p99", "max");
+    Logger::log(Logger::LEVEL_INFO, "%-32s %8.1f %10.3f %10.3f %10.3f %10.3f\n", "Frame", stats.calls, stats.average, stats.p50, stats.p99, stats.max);
+
+    // Gather the unique scope names in the order they were first recorded, indented by depth.
+    std::vector<const char*> names;
+    std::vector<unsigned int> depths;
+    for (unsigned int i = 0; i < __frameCount; ++i)
+    {
+        const ProfilerFrame& frame = getRecordedFrame(i);
+        for (size_t j = 0, count = frame.events.size(); j < count; ++j)
+        {
+            const ProfilerEvent& event = frame.events[j];
+            bool found = false;
+            for (size_t k = 0, nameCount = names.size(); k < nameCount && !found; ++k)
+                found = strcmp(names[k], event.name) == 0;
+            if (!found)
+            {
+                names.push_back(event.name);
+                depths.push_back(event.depth);
+            }
+        }
+    }
+
+    for (size_t i = 0, count = names.size(); i < count; ++i)
+    {
+        if (getStats(names[i], &stats))
+        {
+            std::string label(2 * (depths[i] + 1), ' ');
+            label += names[i];
+            Logger::log(Logger::LEVEL_INFO, "%-32s %8.1f %10.3f %10.3f %10.3f %10.3f\n", label.c_str(), stats.calls, stats.average, stats.p50, stats.p99, stats.max);
+        }
+    }
+}
+
+// Writes a string to the file as a JSON string literal.
+static void writeJSONString(FILE* file, const char* str)
+{
+    fputc('"', file);
+    for (const char* c = str; *c; ++c)
+    {
+        if (*c == '"' || *c == '\\')
+            fputc('\\', file);
+        if ((unsigned char)*c >= 0x20)
+            fputc(*c, file);
+    }
+    fputc('"', file);
+}
+
+bool Profiler::writeChromeTrace(const char* path)
+{
+    GP_ASSERT(path);
+
+    FILE* file = FileSystem::openFile(path, "w");
+    if (file == NULL)
+    {
+        GP_WARN("Failed to open file '%s' for writing the profiler trace.", path);
+        return false;
+    }
+
+    // Write each frame and scope as a complete ("X") event with times in microseconds.
+    fprintf(file, "{\"traceEvents\":[");
+    bool first = true;
+    for (unsigned int i = 0; i < __frameCount; ++i)
+    {
+        const ProfilerFrame& frame = getRecordedFrame(i);
+        fprintf(file, "%s\n{\"name\":\"Frame\",\"cat\":\"gameplay\",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":%.3f,\"dur\":%.3f}",
+            first ? "" : ",", frame.start * 1000.0, frame.duration * 1000.0);
+        first = false;
+
+        for (size_t j = 0, count = frame.events.size(); j < count; ++j)
+        {
+            const ProfilerEvent& event = frame.events[j];
+            fprintf(file, ",\n{\"name\":");
+            writeJSONString(file, event.name);
+            fprintf(file, ",\"cat\":\"gameplay\",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":%.3f,\"dur\":%.3f}",
+                event.start * 1000.0, event.duration * 1000.0);
+        }
+    }
+    fprintf(file, "\n],\"displayTimeUnit\":\"ms\"}\n");
+
+    bool result = ferror(file) == 0;
+    if (fclose(file) != 0)
+        result = false;
+    if (!result)
+        GP_WARN("Failed to write the profiler trace to file '%s'.", path);
+    return result;
+}
+
+void Profiler::clear()
+{
+    __frame = NULL;
+    __frameNext = 0;
+    __frameCount = 0;
+}
+
+void Profiler::finalize()
+{
+    _enabled = false;
+    setFrameHistory(__frameHistory);
+}
+
+}
@@ -0,0 +1,200 @@
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+namespace gameplay
+{
+
+/**
+ * Defines a lightweight hierarchical CPU profiler for the game.
+ *
+ * The profiler records named, nested timing scopes for each frame into a ring
+ * buffer holding the most recent frames. Game::frame() records a scope for every
+ * stage of the frame (animation, time events, physics, AI, update, scripts, audio
+ * and render) and a number of engine hot spots are instrumented as well. Games can
+ * add their own scopes using Profiler::Scope.
+ *
+ * Statistics (average, median, 99th percentile and maximum time per frame) can be
+ * queried for any scope over the recorded frames, and the recorded frames can be
+ * written out in the Chrome trace event format for viewing in chrome://tracing.
+ *
+ * The profiler is disabled by default, in which case recording a scope costs a
+ * single branch. It can be enabled in code or with profiler.enabled in the game config.
+ */
+class Profiler
+{
+    friend class Game;
+
+public:
+
+    /**
+     * Records the time spent between its construction and destruction
+     * as a named scope in the current frame.
+     */
+    class Scope
+    {
+    public:
+
+        /**
+         * Constructor. Begins a profiler scope.
+         *
+         * @param name The name of the scope. This must be a string literal or a string that
+         *      outlives the recorded frames, since only the pointer is stored.
+         */
+        Scope(const char* name);
+
+        /**
+         * Destructor. Ends the profiler scope.
+         */
+        ~Scope();
+
+    private:
+
+        Scope(const Scope& copy);
+        Scope& operator=(const Scope&);
+
+        bool _active;
+    };
+
+    /**
+     * Defines the statistics of a profiler scope over the recorded frames.
+     *
+     * All times are in milliseconds and are the total time spent in the scope per frame.
+     */
+    struct Stats
+    {
+        /**
+         * Constructor.
+         */
+        Stats();
+
+        /** The number of frames in which the scope was recorded. */
+        unsigned int frames;
+        /** The average number of times the scope was entered per frame. */
+        float calls;
+        /** The average time spent in the scope per frame. */
+        double average;
+        /** The median (50th percentile) time spent in the scope per frame. */
+        double p50;
+        /** The 99th percentile time spent in the scope per frame. */
+        double p99;
+        /** The maximum time spent in the scope in a single frame. */
+        double max;
+    };
+
+    /**
+     * Determines if the profiler is recording.
+     *
+     * @return true if the profiler is enabled, false otherwise.
+     */
+    static bool isEnabled();
+
+    /**
+     * Enables or disables the profiler.
+     *
+     * @param enabled true to start recording frames, false to stop.
+     */
+    static void setEnabled(bool enabled);
+
+    /**
+     * Gets the maximum number of frames kept by the profiler.
+     *
+     * @return The number of frames in the profiler ring buffer.
+     */
+    static unsigned int getFrameHistory();
+
+    /**
+     * Sets the maximum number of frames kept by the profiler. Once the
+     * ring buffer is full the oldest frame is overwritten. This clears all
+     * recorded frames.
+     *
+     * @param frameCount The number of frames to keep (default is 300).
+     */
+    static void setFrameHistory(unsigned int frameCount);
+
+    /**
+     * Gets the number of frames currently recorded.
+     *
+     * @return The number of recorded frames.
+     */
+    static unsigned int getFrameCount();
+
+    /**
+     * Begins recording a new frame. Called by Game::frame().
+     */
+    static void beginFrame();
+
+    /**
+     * Ends recording the current frame and stores it in the ring buffer. Called by Game::frame().
+     */
+    static void endFrame();
+
+    /**
+     * Begins a named scope. Each call must be matched by a call to end().
+     *
+     * @param name The name of the scope (see Scope::Scope).
+     */
+    static void begin(const char* name);
+
+    /**
+     * Ends the most recently begun scope.
+     */
+    static void end();
+
+    /**
+     * Gets the statistics of a scope over the recorded frames.
+     *
+     * @param name The name of the scope, or NULL for the whole frame.
+     * @param stats Populated with the statistics of the scope.
+     *
+     * @return true if the scope was recorded in at least one frame, false otherwise.
+     * @script{ignore}
+     */
+    static bool getStats(const char* name, Stats* stats);
+
+    /**
+     * Prints the statistics of the whole frame and of every recorded scope to the log.
+     */
+    static void printStats();
+
+    /**
+     * Writes the recorded frames to a file in the Chrome trace event (JSON) format.
+     *
+     * @param path The path of the file to write.
+     *
+     * @return true if the file was written, false otherwise.
+     */
+    static bool writeChromeTrace(const char* path);
+
+    /**
+     * Clears all recorded frames.
+     */
+    static void clear();
+
+private:
+
+    /**
+     * Hidden constructor.
+     */
+    Profiler();
+
+    /**
+     * Hidden copy constructor.
+     */
+    Profiler(const Profiler& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    Profiler& operator=(const Profiler&);
+
+    /**
+     * Releases the recorded frames. Called by Game on shutdown.
+     */
+    static void finalize();
+
+    static bool _enabled;
+};
+
+}
+
+#endif
@@ -0,0 +1,236 @@
+#include "Base.h"
+#include "RenderQueue.h"
+#include "MeshPart.h"
+#include "MeshSkin.h"
+#include "Node.h"
+#include "Pass.h"
+#include "Profiler.h"
+#include "Scene.h"
+#include "Technique.h"
+
+namespace gameplay
+{
+
+RenderQueue::Stats RenderQueue::_frameStats;
+RenderQueue::Stats RenderQueue::_frameCounters;
+
+RenderQueue::Stats::Stats()
+    : drawCalls(0), programSwitches(0), textureBinds(0), uniformUploads(0), skippedUniformUploads(0)
+{
+}
+
+RenderQueue::RenderQueue() : _sorted(true)
+{
+}
+
+RenderQueue::~RenderQueue()
+{
+    clear();
+}
+
+RenderQueue* RenderQueue::create()
+{
+    return new RenderQueue();
+}
+
+void RenderQueue::add(Model* model, bool wireframe)
+{
+    GP_ASSERT(model);
+
+    // Skin the vertices once, however many items the model has.
+    if (model->_skin && model->_skin->isCpuSkinning())
+    {
+        model->_skin->skinVertices();
+    }
+
+    // The items draw the level of detail selected when they are added.
+    unsigned int level = model->updateLevel();
+    Mesh* mesh = model->getLevelMesh(level);
+    GP_ASSERT(mesh);
+
+    // The view depth of the node orders items front-to-back or back-to-front.
+    float depth = 0.0f;
+    Node* node = model->getNode();
+    if (node)
+    {
+        const Matrix& view = node->getViewMatrix();
+        Vector3 translation = node->getTranslationWorld();
+        depth = -(view.m[2] * translation.x + view.m[6] * translation.y + view.m[10] * translation.z + view.m[14]);
+    }
+
+    unsigned int itemCount = (unsigned int)_items.size();
+    unsigned int partCount = mesh->getPartCount();
+    if (partCount == 0)
+    {
+        addItems(model, level, mesh, NULL, model->getMaterial(), depth, wireframe);
+    }
+    else
+    {
+        for (unsigned int i = 0; i < partCount; ++i)
+        {
+            addItems(model, level, mesh, mesh->getPart(i), model->getPartMaterial(i), depth, wireframe);
+        }
+    }
+
+    if (_items.size() > itemCount)
+    {
+        model->addRef();
+        _models.push_back(model);
+        _sorted = false;
+    }
+}
+
+void RenderQueue::add(Scene* scene, bool wireframe)
+{
+    GP_ASSERT(scene);
+
+    _nodes.clear();
+    scene->cull(_nodes);
+    for (size_t i = 0, count = _nodes.size(); i < count; ++i)
+    {
+        add(_nodes[i]->getModel(), wireframe);
+    }
+    _nodes.clear();
+}
+
+void RenderQueue::addItems(Model* model, unsigned int level, Mesh* mesh, MeshPart* part, Material* material, float depth, bool wireframe)
+{
+    if (material == NULL)
+        return;
+
+    Technique* technique = material->getTechnique();
+    GP_ASSERT(technique);
+    unsigned int passCount = technique->getPassCount();
+    if (passCount == 0)
+        return;
+
+    // The passes of a technique are drawn in order, so they share the sort key of the first
+    // pass and are drawn with blended items if any of them blends.
+    Pass* first = technique->getPassByIndex(0);
+    GP_ASSERT(first);
+    Item item;
+    item.model = model;
+    item.mesh = mesh;
+    item.part = part;
+    item.effect = first->getEffect();
+    item.texture = first->getFirstTexture();
+    item.blend = false;
+    item.state = first->getStateKey(&item.blend);
+    item.depth = depth;
+    item.wireframe = wireframe;
+    for (unsigned int i = 1; i < passCount && !item.blend; ++i)
+    {
+        technique->getPassByIndex(i)->getStateKey(&item.blend);
+    }
+
+    for (unsigned int i = 0; i < passCount; ++i)
+    {
+        item.pass = technique->getPassByIndex(i);
+        GP_ASSERT(item.pass);
+        item.binding = model->getLevelBinding(level, item.pass);
+        _items.push_back(item);
+    }
+}
+
+unsigned int RenderQueue::getItemCount() const
+{
+    return (unsigned int)_items.size();
+}
+
+void RenderQueue::clear()
+{
+    _items.clear();
+    for (size_t i = 0, count = _models.size(); i < count; ++i)
+    {
+        SAFE_RELEASE(_models[i]);
+    }
+    _models.clear();
+    _sorted = true;
+}
+
+bool RenderQueue::compareItems(const Item& item1, const Item& item2)
+{
+    // Blended items are drawn last, back-to-front.
+    if (item1.blend != item2.blend)
+        return item2.blend;
+    if (item1.blend && item1.depth != item2.depth)
+        return item1.depth > item2.depth;
+
+    if (item1.effect != item2.effect)
+        return item1.effect < item2.effect;
+    if (item1.texture != item2.texture)
+        return item1.texture < item2.texture;
+    if (item1.state != item2.state)
+        return item1.state < item2.state;
+
+    // Opaque items are drawn front-to-back to reject hidden fragments early.
+    if (item1.depth != item2.depth)
+        return item1.depth < item2.depth;
+    return false;
+}
+
+void RenderQueue::draw()
+{
+    Profiler::Scope profilerScope("RenderQueue::draw");
+
+    // A stable sort keeps the passes of each mesh part in order.
+    if (!_sorted)
+    {
+        std::stable_sort(_items.begin(), _items.end(), &RenderQueue::compareItems);
+        _sorted = true;
+    }
+
+    VertexAttributeBinding* binding = NULL;
+    IndexBufferHandle indexBuffer = 0;
+    bool indexBufferBound = false;
+    for (size_t i = 0, count = _items.size(); i < count; ++i)
+    {
+        const Item& item = _items[i];
+        Pass* pass = item.pass;
+
+        // Effects skip binding when they are already bound.
+        pass->getEffect()->bind();
+        pass->RenderState::bind(pass);
+
+        VertexAttributeBinding* itemBinding = item.binding;
+        if (itemBinding != binding)
+        {
+            if (binding)
+                binding->unbind();
+            if (itemBinding)
+                itemBinding->bind();
+            binding = itemBinding;
+
+            // Vertex array objects hold the element array buffer binding.
+            indexBufferBound = false;
+        }
+
+        IndexBufferHandle itemIndexBuffer = item.part ? item.part->getIndexBuffer() : 0;
+        if (!indexBufferBound || itemIndexBuffer != indexBuffer)
+        {
+            GL_ASSERT( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, itemIndexBuffer) );
+            indexBuffer = itemIndexBuffer;
+            indexBufferBound = true;
+        }
+
+        item.model->drawPart(item.mesh, item.part, item.wireframe);
+    }
+
+    if (binding)
+    {
+        binding->unbind();
+    }
+}
+
+const RenderQueue::Stats& RenderQueue::getFrameStats()
+{
+    return _frameStats;
+}
+
+void RenderQueue::endFrame()
+{
+    _frameStats = _frameCounters;
+    _frameCounters = Stats();
+}
+
+}
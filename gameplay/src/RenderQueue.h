@@ -0,0 +1,196 @@
+#ifndef RENDERQUEUE_H_
+#define RENDERQUEUE_H_
+
+#include "Model.h"
+
+namespace gameplay
+{
+
+class MeshPart;
+class Pass;
+class Scene;
+class Texture;
+
+/**
+ * Defines a queue of draw calls that are sorted to minimize render state changes
+ * before they are submitted.
+ *
+ * Models are added as one draw item per mesh part and pass. When the queue is drawn,
+ * opaque items are sorted by effect, texture, fixed-function state and front-to-back
+ * depth, followed by the items that enable blending sorted back-to-front. Items are
+ * then drawn in order, binding the effect, vertex attribute binding and index buffer
+ * only when they differ from the previous item.
+ *
+ * The renderer also counts the draw calls, program switches, texture binds and uniform
+ * uploads made in each frame, whether or not they come from a render queue.
+ */
+class RenderQueue
+{
+    friend class Effect;
+    friend class Game;
+    friend class MaterialParameter;
+    friend class MeshBatch;
+    friend class Model;
+    friend class ModelBatch;
+    friend class Texture;
+    friend class Uniform;
+
+public:
+
+    /**
+     * Defines the rendering counters of a frame.
+     */
+    struct Stats
+    {
+        /**
+         * Constructor.
+         */
+        Stats();
+
+        /**
+         * The number of draw calls.
+         */
+        unsigned int drawCalls;
+
+        /**
+         * The number of times the bound shader program changed.
+         */
+        unsigned int programSwitches;
+
+        /**
+         * The number of textures bound to texture units.
+         */
+        unsigned int textureBinds;
+
+        /**
+         * The number of uniform values uploaded to shader programs.
+         */
+        unsigned int uniformUploads;
+
+        /**
+         * The number of uniform uploads skipped because the program already held the value.
+         */
+        unsigned int skippedUniformUploads;
+    };
+
+    /**
+     * Creates an empty render queue.
+     *
+     * @return A new render queue.
+     * @script{create}
+     */
+    static RenderQueue* create();
+
+    /**
+     * Destructor.
+     */
+    ~RenderQueue();
+
+    /**
+     * Adds the draw items of a model, one for each mesh part and pass of its materials.
+     *
+     * The model is referenced by the queue until it is cleared.
+     *
+     * @param model The model to draw.
+     * @param wireframe If true, draw the model in wireframe mode.
+     */
+    void add(Model* model, bool wireframe = false);
+
+    /**
+     * Adds the models of all nodes in a scene. When the scene has an active camera,
+     * models whose bounds are outside of the camera's view frustum are skipped.
+     *
+     * @see Scene::cull
+     *
+     * @param scene The scene to draw.
+     * @param wireframe If true, draw the models in wireframe mode.
+     */
+    void add(Scene* scene, bool wireframe = false);
+
+    /**
+     * Gets the number of draw items in the queue.
+     *
+     * @return The number of draw items.
+     */
+    unsigned int getItemCount() const;
+
+    /**
+     * Removes all draw items from the queue.
+     */
+    void clear();
+
+    /**
+     * Sorts the draw items, if items were added since they were last sorted, and draws them.
+     *
+     * The items remain in the queue, so that they can be drawn again, until the queue is cleared.
+     */
+    void draw();
+
+    /**
+     * Gets the rendering counters of the last complete frame.
+     *
+     * @return The counters of the last frame.
+     */
+    static const Stats& getFrameStats();
+
+private:
+
+    /**
+     * A draw call of a mesh part with a pass.
+     */
+    struct Item
+    {
+        Model* model;
+        Mesh* mesh;
+        MeshPart* part;
+        Pass* pass;
+        VertexAttributeBinding* binding;
+        Effect* effect;
+        Texture* texture;
+        unsigned int state;
+        float depth;
+        bool blend;
+        bool wireframe;
+    };
+
+    /**
+     * Constructor.
+     */
+    RenderQueue();
+
+    /**
+     * Hidden copy constructor.
+     */
+    RenderQueue(const RenderQueue& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    RenderQueue& operator=(const RenderQueue&);
+
+    /**
+     * Adds the items of a material for a part of the mesh of a level of detail.
+     */
+    void addItems(Model* model, unsigned int level, Mesh* mesh, MeshPart* part, Material* material, float depth, bool wireframe);
+
+    /**
+     * Compares items for drawing order.
+     */
+    static bool compareItems(const Item& item1, const Item& item2);
+
+    /**
+     * Moves the counters of the frame that ended to the frame stats. Called by the game at the end of each frame.
+     */
+    static void endFrame();
+
+    std::vector<Item> _items;
+    std::vector<Model*> _models;
+    std::vector<Node*> _nodes;
+    bool _sorted;
+    static Stats _frameStats;
+    static Stats _frameCounters;
+};
+
+}
+
+#endif
@@ -3,6 +3,7 @@
 #include "Node.h"
 #include "Pass.h"
 #include "Technique.h"
+#include "Profiler.h"
 #include "Node.h"
 
 // Render state override bits
@@ -32,6 +33,11 @@ RenderState::~RenderState()
     {
         SAFE_RELEASE(_parameters[i]);
     }
+
+    for (size_t i = 0, count = _effectUniforms.size(); i < count; ++i)
+    {
+        SAFE_RELEASE(_effectUniforms[i].effect);
+    }
 }
 
 void RenderState::initialize()
@@ -56,25 +62,78 @@ MaterialParameter* RenderState::getParameter(const char* name) const
 {
     GP_ASSERT(name);
 
-    // Search for an existing parameter with this name.
-    MaterialParameter* param;
-    for (size_t i = 0, count = _parameters.size(); i < count; ++i)
+    return getParameter(Effect::getUniformHandle(name));
+}
+
+MaterialParameter* RenderState::getParameter(unsigned int handle) const
+{
+    // Look up an existing parameter with this name.
+    if (handle < _parametersByHandle.size() && _parametersByHandle[handle])
     {
-        param = _parameters[i];
-        GP_ASSERT(param);
-        if (strcmp(param->getName(), name) == 0)
-        {
-            return param;
-        }
+        return _parametersByHandle[handle];
     }
 
+    const char* name = Effect::getUniformName(handle);
+    GP_ASSERT(name);
+
     // Create a new parameter and store it in our list.
-    param = new MaterialParameter(name);
-    _parameters.push_back(param);
+    MaterialParameter* param = new MaterialParameter(name);
+    addParameter(param);
 
     return param;
 }
 
+void RenderState::addParameter(MaterialParameter* param) const
+{
+    GP_ASSERT(param);
+
+    _parameters.push_back(param);
+    if (param->_handle >= _parametersByHandle.size())
+    {
+        _parametersByHandle.resize(param->_handle + 1, NULL);
+    }
+    _parametersByHandle[param->_handle] = param;
+}
+
+const std::vector<Uniform*>& RenderState::getUniforms(Effect* effect)
+{
+    GP_ASSERT(effect);
+
+    // A RenderState is usually bound with a single effect, or one per pass of a material.
+    EffectUniforms* effectUniforms = NULL;
+    for (size_t i = 0, count = _effectUniforms.size(); i < count; ++i)
+    {
+        if (_effectUniforms[i].effect == effect)
+        {
+            effectUniforms = &_effectUniforms[i];
+            break;
+        }
+    }
+    if (!effectUniforms)
+    {
+        // Hold a reference so that another effect cannot be created at the same address.
+        effect->addRef();
+        _effectUniforms.push_back(EffectUniforms());
+        effectUniforms = &_effectUniforms.back();
+        effectUniforms->effect = effect;
+    }
+
+    // Parameters are only ever added, so only those added since the last bind need resolving.
+    std::vector<Uniform*>& uniforms = effectUniforms->uniforms;
+    for (size_t i = uniforms.size(), count = _parameters.size(); i < count; ++i)
+    {
+        Uniform* uniform = effect->getUniformByHandle(_parameters[i]->_handle);
+        if (!uniform)
+        {
+            // This parameter was not found in the specified effect, so it is not bound.
+            GP_WARN("Warning: Material parameter '%s' not found in effect '%s'.", _parameters[i]->getName(), effect->getId());
+        }
+        uniforms.push_back(uniform);
+    }
+
+    return uniforms;
+}
+
 /**
  * @script{ignore}
  */
@@ -269,6 +328,8 @@ void RenderState::applyAutoBinding(const char* uniformName, const char* autoBind
 
 void RenderState::bind(Pass* pass)
 {
+    Profiler::Scope profilerScope("RenderState::bind");
+
     GP_ASSERT(pass);
 
     // Get the combined modified state bits for our RenderState hierarchy.
@@ -291,10 +352,14 @@ void RenderState::bind(Pass* pass)
     Effect* effect = pass->getEffect();
     while ((rs = getTopmost(rs)))
     {
+        const std::vector<Uniform*>& uniforms = rs->getUniforms(effect);
         for (size_t i = 0, count = rs->_parameters.size(); i < count; ++i)
         {
             GP_ASSERT(rs->_parameters[i]);
-            rs->_parameters[i]->bind(effect);
+            if (uniforms[i])
+            {
+                rs->_parameters[i]->bind(effect, uniforms[i]);
+            }
         }
 
         if (rs->_state)
@@ -326,6 +391,62 @@ RenderState* RenderState::getTopmost(RenderState* below)
     return NULL;
 }
 
+Texture* RenderState::getFirstTexture() const
+{
+    for (const RenderState* rs = this; rs != NULL; rs = rs->_parent)
+    {
+        for (size_t i = 0, count = rs->_parameters.size(); i < count; ++i)
+        {
+            Texture::Sampler* sampler = rs->_parameters[i]->getSampler();
+            if (sampler)
+                return sampler->getTexture();
+        }
+    }
+    return NULL;
+}
+
+unsigned int RenderState::getStateKey(bool* blend) const
+{
+    GP_ASSERT(blend);
+
+    // Start from the default state and apply the states of the hierarchy top-down,
+    // as bind() does.
+    bool blendEnabled = false;
+    unsigned int blendSrc = BLEND_ONE;
+    unsigned int blendDst = BLEND_ZERO;
+    bool cullFaceEnabled = false;
+    bool depthTestEnabled = false;
+    bool depthWriteEnabled = true;
+    RenderState* rs = NULL;
+    while ((rs = const_cast<RenderState*>(this)->getTopmost(rs)))
+    {
+        StateBlock* state = rs->_state;
+        if (state == NULL)
+            continue;
+        if (state->_bits & RS_BLEND)
+            blendEnabled = state->_blendEnabled;
+        if (state->_bits & RS_BLEND_FUNC)
+        {
+            blendSrc = state->_blendSrc;
+            blendDst = state->_blendDst;
+        }
+        if (state->_bits & RS_CULL_FACE)
+            cullFaceEnabled = state->_cullFaceEnabled;
+        if (state->_bits & RS_DEPTH_TEST)
+            depthTestEnabled = state->_depthTestEnabled;
+        if (state->_bits & RS_DEPTH_WRITE)
+            depthWriteEnabled = state->_depthWriteEnabled;
+    }
+
+    *blend = blendEnabled;
+
+    // Blend factors are folded into twelve bits each; a collision only affects how draw calls are grouped.
+    unsigned int key = (blendEnabled ? 1 : 0) | (cullFaceEnabled ? 2 : 0) | (depthTestEnabled ? 4 : 0) | (depthWriteEnabled ? 8 : 0);
+    if (blendEnabled)
+        key |= ((blendSrc & 0xFFF) << 4) | ((blendDst & 0xFFF) << 16);
+    return key;
+}
+
 void RenderState::cloneInto(RenderState* renderState, NodeCloneContext& context) const
 {
     GP_ASSERT(renderState);
@@ -342,7 +463,7 @@ void RenderState::cloneInto(RenderState* renderState, NodeCloneContext& context)
         MaterialParameter* paramCopy = new MaterialParameter(param->getName());
         param->cloneInto(paramCopy);
 
-        renderState->_parameters.push_back(paramCopy);
+        renderState->addParameter(paramCopy);
     }
     renderState->_parent = _parent;
     if (_state)
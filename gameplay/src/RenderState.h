@@ -6,10 +6,13 @@
 namespace gameplay
 {
 
+class Effect;
 class MaterialParameter;
 class Node;
 class NodeCloneContext;
 class Pass;
+class Texture;
+class Uniform;
 
 /**
  * Defines the render state of the graphics device.
@@ -21,6 +24,8 @@ class RenderState : public Ref
     friend class Technique;
     friend class Pass;
     friend class Model;
+    friend class MeshBatch;
+    friend class RenderQueue;
 
 public:
 
@@ -257,6 +262,18 @@ public:
      */
     MaterialParameter* getParameter(const char* name) const;
 
+    /**
+     * Returns a MaterialParameter for the specified name handle.
+     *
+     * This is equivalent to getParameter(const char*) with the name of the handle, but does
+     * not compare names, which suits code that looks parameters up every frame.
+     *
+     * @param handle Material parameter (uniform) name handle, from Effect::getUniformHandle.
+     *
+     * @return A MaterialParameter for the specified handle.
+     */
+    MaterialParameter* getParameter(unsigned int handle) const;
+
     /**
      * Sets a material parameter auto-binding.
      *
@@ -388,6 +405,20 @@ protected:
      */
     RenderState* getTopmost(RenderState* below);
 
+    /**
+     * Returns the texture of the first sampler parameter of this RenderState or its
+     * nearest parent that has one, or NULL if there is none. Used to sort draw calls.
+     */
+    Texture* getFirstTexture() const;
+
+    /**
+     * Returns a key identifying the fixed-function state of this RenderState and its parents
+     * combined, where states with the same key are equal. Used to sort draw calls.
+     *
+     * @param blend Set to true if the combined state enables blending.
+     */
+    unsigned int getStateKey(bool* blend) const;
+
     /**
      * Copies the data from this RenderState into the given RenderState.
      * 
@@ -408,6 +439,26 @@ private:
      */
     RenderState& operator=(const RenderState&);
 
+    /**
+     * The uniforms the parameters of a RenderState resolve to in an effect.
+     */
+    struct EffectUniforms
+    {
+        Effect* effect;
+        std::vector<Uniform*> uniforms;
+    };
+
+    /**
+     * Adds a parameter to the collection of parameters and the index of their name handles.
+     */
+    void addParameter(MaterialParameter* param) const;
+
+    /**
+     * Returns the uniforms the parameters resolve to in an effect, by parameter index,
+     * resolving the parameters not seen with the effect before.
+     */
+    const std::vector<Uniform*>& getUniforms(Effect* effect);
+
 protected:
 
     /**
@@ -415,6 +466,16 @@ protected:
      */
     mutable std::vector<MaterialParameter*> _parameters;
 
+    /**
+     * MaterialParameter's indexed by their name handles, NULL where there is none.
+     */
+    mutable std::vector<MaterialParameter*> _parametersByHandle;
+
+    /**
+     * The uniforms of the parameters in each effect the RenderState was bound with.
+     */
+    std::vector<EffectUniforms> _effectUniforms;
+
     /**
      * Map of parameter names to auto binding strings.
      */
@@ -0,0 +1,353 @@
+#include "Base.h"
+#include "ResourceCache.h"
+#include "FileSystem.h"
+
+namespace gameplay
+{
+
+struct ResourceKey;
+
+/**
+ * A resource in the registry.
+ */
+struct ResourceRecord
+{
+    Ref* resource;
+    ResourceCache::Type type;
+    size_t size;
+    unsigned int lastUsed;
+    bool retained;
+    std::vector<ResourceKey*> keys;
+};
+
+/**
+ * A key of a resource, chained in a bucket of the hash table.
+ */
+struct ResourceKey
+{
+    unsigned int hash;
+    ResourceCache::Type type;
+    std::string key;
+    ResourceRecord* record;
+    ResourceKey* next;
+};
+
+static std::vector<ResourceKey*> __buckets;
+static unsigned int __keyCount = 0;
+static std::map<Ref*, ResourceRecord*> __records;
+static unsigned int __resourceCounts[ResourceCache::TYPE_COUNT];
+static size_t __memoryUsage[ResourceCache::TYPE_COUNT];
+static size_t __memoryBudget = 0;
+static unsigned int __useCounter = 0;
+
+static unsigned int __hash(ResourceCache::Type type, const std::string& key)
+{
+    // FNV-1a, seeded with the type.
+    unsigned int hash = 2166136261u ^ (unsigned int)type;
+    for (size_t i = 0, length = key.length(); i < length; ++i)
+    {
+        hash ^= (unsigned char)key[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static void __rehash(size_t bucketCount)
+{
+    std::vector<ResourceKey*> buckets(bucketCount, (ResourceKey*)NULL);
+    for (size_t i = 0, count = __buckets.size(); i < count; ++i)
+    {
+        ResourceKey* key = __buckets[i];
+        while (key)
+        {
+            ResourceKey* next = key->next;
+            size_t bucket = key->hash & (bucketCount - 1);
+            key->next = buckets[bucket];
+            buckets[bucket] = key;
+            key = next;
+        }
+    }
+    __buckets.swap(buckets);
+}
+
+static bool __isUnused(const ResourceRecord* record)
+{
+    return record->retained && record->resource->getRefCount() == 1;
+}
+
+static bool __compareLastUsed(const ResourceRecord* r1, const ResourceRecord* r2)
+{
+    return r1->lastUsed < r2->lastUsed;
+}
+
+ResourceCache::ResourceCache()
+{
+}
+
+unsigned int ResourceCache::getResourceCount(Type type)
+{
+    GP_ASSERT(type < TYPE_COUNT);
+    return __resourceCounts[type];
+}
+
+size_t ResourceCache::getMemoryUsage(Type type)
+{
+    GP_ASSERT(type < TYPE_COUNT);
+    return __memoryUsage[type];
+}
+
+size_t ResourceCache::getMemoryUsage()
+{
+    size_t usage = 0;
+    for (unsigned int i = 0; i < TYPE_COUNT; ++i)
+        usage += __memoryUsage[i];
+    return usage;
+}
+
+size_t ResourceCache::getMemoryBudget()
+{
+    return __memoryBudget;
+}
+
+void ResourceCache::setMemoryBudget(size_t bytes)
+{
+    __memoryBudget = bytes;
+
+    // Take or give up the registry's reference to the measured resources.
+    std::vector<ResourceRecord*> released;
+    for (std::map<Ref*, ResourceRecord*>::iterator itr = __records.begin(); itr != __records.end(); ++itr)
+    {
+        ResourceRecord* record = itr->second;
+        if (bytes > 0 && !record->retained && record->size > 0)
+        {
+            record->resource->addRef();
+            record->retained = true;
+        }
+        else if (bytes == 0 && record->retained)
+        {
+            released.push_back(record);
+        }
+    }
+    for (size_t i = 0, count = released.size(); i < count; ++i)
+    {
+        // Releasing the last reference removes the record.
+        released[i]->retained = false;
+        released[i]->resource->release();
+    }
+
+    trim();
+}
+
+void ResourceCache::trim()
+{
+    if (__memoryBudget == 0 || getMemoryUsage() <= __memoryBudget)
+        return;
+
+    std::vector<ResourceRecord*> unused;
+    for (std::map<Ref*, ResourceRecord*>::iterator itr = __records.begin(); itr != __records.end(); ++itr)
+    {
+        if (__isUnused(itr->second))
+            unused.push_back(itr->second);
+    }
+    std::sort(unused.begin(), unused.end(), __compareLastUsed);
+
+    std::vector<Ref*> resources;
+    for (size_t i = 0, count = unused.size(); i < count; ++i)
+        resources.push_back(unused[i]->resource);
+
+    for (size_t i = 0, count = resources.size(); i < count && getMemoryUsage() > __memoryBudget; ++i)
+    {
+        // Destroying a resource may release others, so check that it is still unused.
+        std::map<Ref*, ResourceRecord*>::iterator itr = __records.find(resources[i]);
+        if (itr != __records.end() && __isUnused(itr->second))
+        {
+            itr->second->retained = false;
+            resources[i]->release();
+        }
+    }
+}
+
+void ResourceCache::releaseUnused()
+{
+    // Releasing a resource may leave others unused, so repeat until none are left.
+    while (true)
+    {
+        std::vector<Ref*> unused;
+        for (std::map<Ref*, ResourceRecord*>::iterator itr = __records.begin(); itr != __records.end(); ++itr)
+        {
+            if (__isUnused(itr->second))
+                unused.push_back(itr->first);
+        }
+        if (unused.empty())
+            break;
+
+        for (size_t i = 0, count = unused.size(); i < count; ++i)
+        {
+            std::map<Ref*, ResourceRecord*>::iterator itr = __records.find(unused[i]);
+            if (itr != __records.end() && __isUnused(itr->second))
+            {
+                itr->second->retained = false;
+                unused[i]->release();
+            }
+        }
+    }
+}
+
+std::string ResourceCache::getPathKey(const char* path)
+{
+    GP_ASSERT(path);
+
+    std::string resolved = FileSystem::resolvePath(path);
+    for (size_t i = 0, length = resolved.length(); i < length; ++i)
+    {
+        if (resolved[i] == '\\')
+            resolved[i] = '/';
+    }
+
+    // Rebuild the path from its components, dropping "." and resolving "..".
+    std::vector<std::string> components;
+    size_t start = 0;
+    while (start <= resolved.length())
+    {
+        size_t end = resolved.find('/', start);
+        if (end == std::string::npos)
+            end = resolved.length();
+        std::string component = resolved.substr(start, end - start);
+        if (component == "..")
+        {
+            if (!components.empty() && components.back() != ".." && !components.back().empty())
+                components.pop_back();
+            else
+                components.push_back(component);
+        }
+        else if (component != "." && (!component.empty() || components.empty()))
+        {
+            components.push_back(component);
+        }
+        start = end + 1;
+    }
+
+    std::string key;
+    for (size_t i = 0, count = components.size(); i < count; ++i)
+    {
+        if (i > 0)
+            key += '/';
+        key += components[i];
+    }
+    return key;
+}
+
+Ref* ResourceCache::find(Type type, const std::string& key)
+{
+    if (__buckets.empty())
+        return NULL;
+
+    unsigned int hash = __hash(type, key);
+    for (ResourceKey* k = __buckets[hash & (__buckets.size() - 1)]; k != NULL; k = k->next)
+    {
+        if (k->hash == hash && k->type == type && k->key == key)
+        {
+            k->record->lastUsed = ++__useCounter;
+            return k->record->resource;
+        }
+    }
+    return NULL;
+}
+
+void ResourceCache::add(Type type, const std::string& key, Ref* resource, size_t size)
+{
+    GP_ASSERT(type < TYPE_COUNT);
+    GP_ASSERT(resource);
+    GP_ASSERT(find(type, key) == NULL);
+
+    ResourceRecord* record;
+    std::map<Ref*, ResourceRecord*>::iterator itr = __records.find(resource);
+    if (itr != __records.end())
+    {
+        // Another key for a resource already in the registry.
+        record = itr->second;
+        GP_ASSERT(record->type == type);
+    }
+    else
+    {
+        record = new ResourceRecord();
+        record->resource = resource;
+        record->type = type;
+        record->size = size;
+        record->retained = false;
+        __records[resource] = record;
+        ++__resourceCounts[type];
+        __memoryUsage[type] += size;
+
+        if (__memoryBudget > 0 && size > 0)
+        {
+            resource->addRef();
+            record->retained = true;
+        }
+    }
+    record->lastUsed = ++__useCounter;
+
+    if (__keyCount >= __buckets.size())
+        __rehash(__buckets.empty() ? 64 : __buckets.size() * 2);
+
+    ResourceKey* k = new ResourceKey();
+    k->hash = __hash(type, key);
+    k->type = type;
+    k->key = key;
+    k->record = record;
+    size_t bucket = k->hash & (__buckets.size() - 1);
+    k->next = __buckets[bucket];
+    __buckets[bucket] = k;
+    record->keys.push_back(k);
+    ++__keyCount;
+
+    if (record->retained)
+        trim();
+}
+
+void ResourceCache::setSize(Ref* resource, size_t size)
+{
+    std::map<Ref*, ResourceRecord*>::iterator itr = __records.find(resource);
+    if (itr == __records.end())
+        return;
+
+    ResourceRecord* record = itr->second;
+    __memoryUsage[record->type] -= record->size;
+    __memoryUsage[record->type] += size;
+    record->size = size;
+
+    if (__memoryBudget > 0 && size > 0 && !record->retained)
+    {
+        resource->addRef();
+        record->retained = true;
+    }
+
+    if (record->retained)
+        trim();
+}
+
+void ResourceCache::remove(Ref* resource)
+{
+    std::map<Ref*, ResourceRecord*>::iterator itr = __records.find(resource);
+    if (itr == __records.end())
+        return;
+
+    ResourceRecord* record = itr->second;
+    for (size_t i = 0, count = record->keys.size(); i < count; ++i)
+    {
+        ResourceKey* k = record->keys[i];
+        ResourceKey** link = &__buckets[k->hash & (__buckets.size() - 1)];
+        while (*link != k)
+            link = &(*link)->next;
+        *link = k->next;
+        SAFE_DELETE(k);
+        --__keyCount;
+    }
+
+    --__resourceCounts[record->type];
+    __memoryUsage[record->type] -= record->size;
+    __records.erase(itr);
+    SAFE_DELETE(record);
+}
+
+}
@@ -0,0 +1,164 @@
+#ifndef RESOURCECACHE_H_
+#define RESOURCECACHE_H_
+
+#include "Ref.h"
+
+namespace gameplay
+{
+
+/**
+ * Defines the registry of shared resources, such as textures, effects and fonts,
+ * that lets resources loaded more than once be shared.
+ *
+ * Resources are indexed in a hash table by type and key, where the key of a resource
+ * loaded from a file is its path after resolving aliases and relative components. The
+ * registry also accounts for the memory used by the resources it can measure: texture
+ * and font images, and audio data.
+ *
+ * By default a resource is destroyed as soon as it is released by its last owner. When
+ * a memory budget is set, measured resources are kept in the registry after they are
+ * released, so that loading them again does not read their file. Unused resources are
+ * then destroyed in least recently used order once the memory used exceeds the budget.
+ *
+ * The registry is not thread-safe and must only be used on the main thread.
+ */
+class ResourceCache
+{
+    friend class AudioBuffer;
+    friend class Bundle;
+    friend class Effect;
+    friend class Font;
+    friend class Texture;
+    friend class Theme;
+    friend class VertexAttributeBinding;
+
+public:
+
+    /**
+     * The types of resources in the registry.
+     */
+    enum Type
+    {
+        AUDIO_BUFFER,
+        BUNDLE,
+        EFFECT,
+        FONT,
+        TEXTURE,
+        THEME,
+        VERTEX_ATTRIBUTE_BINDING,
+        TYPE_COUNT
+    };
+
+    /**
+     * Gets the number of resources of a type in the registry.
+     *
+     * @param type The type of resource.
+     *
+     * @return The number of resources.
+     */
+    static unsigned int getResourceCount(Type type);
+
+    /**
+     * Gets the memory used by the resources of a type in the registry.
+     *
+     * @param type The type of resource.
+     *
+     * @return The memory used, in bytes.
+     */
+    static size_t getMemoryUsage(Type type);
+
+    /**
+     * Gets the memory used by all resources in the registry.
+     *
+     * @return The memory used, in bytes.
+     */
+    static size_t getMemoryUsage();
+
+    /**
+     * Gets the memory budget for unused resources.
+     *
+     * @return The memory budget in bytes, or zero if unused resources are not kept.
+     */
+    static size_t getMemoryBudget();
+
+    /**
+     * Sets the memory budget up to which unused resources are kept in the registry.
+     *
+     * A budget of zero, which is the default, destroys resources as soon as they are released
+     * and destroys the unused resources currently kept. The budget can also be set in
+     * megabytes with cache.budget in the game config.
+     *
+     * @param bytes The memory budget in bytes.
+     */
+    static void setMemoryBudget(size_t bytes);
+
+    /**
+     * Destroys unused resources, least recently used first, until the memory used is
+     * within the budget. This is done automatically when resources are added.
+     */
+    static void trim();
+
+    /**
+     * Destroys all unused resources kept in the registry.
+     */
+    static void releaseUnused();
+
+private:
+
+    /**
+     * Constructor.
+     */
+    ResourceCache();
+
+    /**
+     * Gets the key of a resource loaded from a file, which is its path after resolving
+     * aliases, converting backslashes and removing "." and ".." components.
+     *
+     * @param path The path of the file.
+     *
+     * @return The key of the file.
+     */
+    static std::string getPathKey(const char* path);
+
+    /**
+     * Finds a resource and marks it as the most recently used. The reference
+     * count of the resource is not changed.
+     *
+     * @param type The type of resource.
+     * @param key The key of the resource.
+     *
+     * @return The resource, or NULL if there is no resource with the key.
+     */
+    static Ref* find(Type type, const std::string& key);
+
+    /**
+     * Adds a resource under a key. A resource can be added under several keys,
+     * in which case it is accounted for once.
+     *
+     * @param type The type of resource.
+     * @param key The key of the resource.
+     * @param resource The resource.
+     * @param size The memory used by the resource in bytes, or zero if it is not measured.
+     */
+    static void add(Type type, const std::string& key, Ref* resource, size_t size);
+
+    /**
+     * Changes the memory used by a resource in the registry, such as after generating
+     * mipmaps for a texture. Does nothing if the resource is not in the registry.
+     *
+     * @param resource The resource.
+     * @param size The memory used by the resource in bytes, or zero if it is not measured.
+     */
+    static void setSize(Ref* resource, size_t size);
+
+    /**
+     * Removes a resource and all of its keys. Called by resources when they are destroyed.
+     *
+     * @param resource The resource.
+     */
+    static void remove(Ref* resource);
+};
+
+}
+
+#endif
@@ -0,0 +1,620 @@
+#include "Base.h"
+#include "ResourceLoader.h"
+#include "AudioBuffer.h"
+#include "Bundle.h"
+#include "FileSystem.h"
+#include "Image.h"
+#include "Platform.h"
+#include "Properties.h"
+#include "Scene.h"
+#include "SceneLoader.h"
+#include "Texture.h"
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+namespace gameplay
+{
+
+/**
+ * The request queues and synchronization state shared with the loader threads.
+ */
+struct ResourceLoader::Context
+{
+#ifdef WIN32
+    CRITICAL_SECTION lock;
+    CONDITION_VARIABLE workReady;
+    CONDITION_VARIABLE workDone;
+    std::vector<HANDLE> threads;
+#else
+    pthread_mutex_t lock;
+    pthread_cond_t workReady;
+    pthread_cond_t workDone;
+    std::vector<pthread_t> threads;
+#endif
+    std::vector<Request*> pending;
+    std::vector<Request*> loading;
+    std::vector<Request*> loaded;
+    bool exiting;
+};
+
+#ifdef WIN32
+#define RESOURCELOADER_LOCK(c)          EnterCriticalSection(&(c)->lock)
+#define RESOURCELOADER_UNLOCK(c)        LeaveCriticalSection(&(c)->lock)
+#define RESOURCELOADER_WAIT(c, cond)    SleepConditionVariableCS(&(c)->cond, &(c)->lock, INFINITE)
+#define RESOURCELOADER_SIGNAL(c, cond)  WakeConditionVariable(&(c)->cond)
+#define RESOURCELOADER_BROADCAST(c, cond) WakeAllConditionVariable(&(c)->cond)
+#else
+#define RESOURCELOADER_LOCK(c)          pthread_mutex_lock(&(c)->lock)
+#define RESOURCELOADER_UNLOCK(c)        pthread_mutex_unlock(&(c)->lock)
+#define RESOURCELOADER_WAIT(c, cond)    pthread_cond_wait(&(c)->cond, &(c)->lock)
+#define RESOURCELOADER_SIGNAL(c, cond)  pthread_cond_signal(&(c)->cond)
+#define RESOURCELOADER_BROADCAST(c, cond) pthread_cond_broadcast(&(c)->cond)
+#endif
+
+/**
+ * Removes the request with the highest priority from a queue, or the oldest one among
+ * requests of equal priority. The context lock must be held.
+ */
+static ResourceLoader::Request* __takeNext(std::vector<ResourceLoader::Request*>& queue)
+{
+    if (queue.empty())
+        return NULL;
+
+    size_t next = 0;
+    for (size_t i = 1, count = queue.size(); i < count; ++i)
+    {
+        if (queue[i]->getPriority() > queue[next]->getPriority())
+            next = i;
+    }
+    ResourceLoader::Request* request = queue[next];
+    queue.erase(queue.begin() + next);
+    return request;
+}
+
+/**
+ * Removes a request from a queue. The context lock must be held.
+ */
+static bool __remove(std::vector<ResourceLoader::Request*>& queue, ResourceLoader::Request* request)
+{
+    std::vector<ResourceLoader::Request*>::iterator itr = std::find(queue.begin(), queue.end(), request);
+    if (itr == queue.end())
+        return false;
+    queue.erase(itr);
+    return true;
+}
+
+static bool __isPNG(const char* path)
+{
+    const char* ext = strrchr(FileSystem::resolvePath(path), '.');
+    return ext && strlen(ext) == 4 &&
+        tolower(ext[1]) == 'p' && tolower(ext[2]) == 'n' && tolower(ext[3]) == 'g';
+}
+
+ResourceLoader::Request::Request(ResourceLoader* loader, Type type, const char* path, int priority, Listener* listener)
+    : _loader(loader), _type(type), _path(path), _priority(priority), _listener(listener), _state(PENDING),
+      _cancelled(false), _failed(false), _generateMipmaps(false), _bundle(NULL), _image(NULL), _texture(NULL),
+      _alBuffer(0), _audioBuffer(NULL), _properties(NULL), _scene(NULL)
+{
+}
+
+ResourceLoader::Request::~Request()
+{
+    discard();
+    SAFE_RELEASE(_texture);
+    SAFE_RELEASE(_audioBuffer);
+    SAFE_RELEASE(_scene);
+}
+
+ResourceLoader::Type ResourceLoader::Request::getType() const
+{
+    return _type;
+}
+
+const char* ResourceLoader::Request::getPath() const
+{
+    return _path.c_str();
+}
+
+ResourceLoader::State ResourceLoader::Request::getState() const
+{
+    if (_loader == NULL)
+        return _state;
+
+    RESOURCELOADER_LOCK(_loader->_context);
+    State state = _cancelled ? CANCELLED : _state;
+    RESOURCELOADER_UNLOCK(_loader->_context);
+    return state;
+}
+
+bool ResourceLoader::Request::isDone() const
+{
+    State state = getState();
+    return state == COMPLETE || state == FAILED || state == CANCELLED;
+}
+
+int ResourceLoader::Request::getPriority() const
+{
+    return _priority;
+}
+
+void ResourceLoader::Request::setPriority(int priority)
+{
+    if (_loader == NULL)
+    {
+        _priority = priority;
+        return;
+    }
+
+    RESOURCELOADER_LOCK(_loader->_context);
+    _priority = priority;
+    RESOURCELOADER_UNLOCK(_loader->_context);
+}
+
+void ResourceLoader::Request::cancel()
+{
+    if (_loader)
+        _loader->cancel(this);
+}
+
+void ResourceLoader::Request::wait()
+{
+    if (_loader)
+        _loader->wait(this);
+}
+
+Bundle* ResourceLoader::Request::getBundle() const
+{
+    return _state == COMPLETE ? _bundle : NULL;
+}
+
+Texture* ResourceLoader::Request::getTexture() const
+{
+    return _state == COMPLETE ? _texture : NULL;
+}
+
+Properties* ResourceLoader::Request::getProperties() const
+{
+    return _state == COMPLETE ? _properties : NULL;
+}
+
+Scene* ResourceLoader::Request::getScene() const
+{
+    return _state == COMPLETE ? _scene : NULL;
+}
+
+void ResourceLoader::Request::discard()
+{
+    SAFE_RELEASE(_bundle);
+    SAFE_RELEASE(_image);
+    SAFE_DELETE(_properties);
+    if (_alBuffer)
+    {
+        AL_CHECK( alDeleteBuffers(1, &_alBuffer) );
+        _alBuffer = 0;
+    }
+}
+
+ResourceLoader::ResourceLoader()
+    : _context(NULL), _threadCount(1), _timeBudget(4.0f)
+{
+    _context = new Context();
+    _context->exiting = false;
+#ifdef WIN32
+    InitializeCriticalSection(&_context->lock);
+    InitializeConditionVariable(&_context->workReady);
+    InitializeConditionVariable(&_context->workDone);
+#else
+    pthread_mutex_init(&_context->lock, NULL);
+    pthread_cond_init(&_context->workReady, NULL);
+    pthread_cond_init(&_context->workDone, NULL);
+#endif
+}
+
+ResourceLoader::~ResourceLoader()
+{
+    finalize();
+
+#ifdef WIN32
+    DeleteCriticalSection(&_context->lock);
+#else
+    pthread_cond_destroy(&_context->workDone);
+    pthread_cond_destroy(&_context->workReady);
+    pthread_mutex_destroy(&_context->lock);
+#endif
+    SAFE_DELETE(_context);
+}
+
+void ResourceLoader::finalize()
+{
+    stopThreads();
+    cancelAll();
+}
+
+ResourceLoader::Request* ResourceLoader::loadBundle(const char* path, Listener* listener, int priority)
+{
+    GP_ASSERT(path);
+    return submit(new Request(this, BUNDLE, path, priority, listener));
+}
+
+ResourceLoader::Request* ResourceLoader::loadTexture(const char* path, bool generateMipmaps, Listener* listener, int priority)
+{
+    GP_ASSERT(path);
+    Request* request = new Request(this, TEXTURE, path, priority, listener);
+    request->_generateMipmaps = generateMipmaps;
+    return submit(request);
+}
+
+ResourceLoader::Request* ResourceLoader::loadAudio(const char* path, Listener* listener, int priority)
+{
+    GP_ASSERT(path);
+    return submit(new Request(this, AUDIO, path, priority, listener));
+}
+
+ResourceLoader::Request* ResourceLoader::loadProperties(const char* url, Listener* listener, int priority)
+{
+    GP_ASSERT(url);
+    return submit(new Request(this, PROPERTIES, url, priority, listener));
+}
+
+ResourceLoader::Request* ResourceLoader::loadScene(const char* url, Listener* listener, int priority)
+{
+    GP_ASSERT(url);
+    return submit(new Request(this, SCENE, url, priority, listener));
+}
+
+ResourceLoader::Request* ResourceLoader::submit(Request* request)
+{
+    // The loader holds a reference to the request until it is done.
+    request->addRef();
+
+    RESOURCELOADER_LOCK(_context);
+    _context->pending.push_back(request);
+    RESOURCELOADER_SIGNAL(_context, workReady);
+    RESOURCELOADER_UNLOCK(_context);
+
+    startThreads();
+
+    return request;
+}
+
+void ResourceLoader::cancel(Request* request)
+{
+    GP_ASSERT(request);
+
+    RESOURCELOADER_LOCK(_context);
+    request->_cancelled = true;
+    bool pending = __remove(_context->pending, request);
+    RESOURCELOADER_UNLOCK(_context);
+
+    // Requests being read are dropped once their loader thread is done with them.
+    if (pending)
+    {
+        request->_state = CANCELLED;
+        request->_loader = NULL;
+        request->release();
+    }
+}
+
+void ResourceLoader::cancelAll()
+{
+    RESOURCELOADER_LOCK(_context);
+    std::vector<Request*> requests;
+    requests.insert(requests.end(), _context->pending.begin(), _context->pending.end());
+    requests.insert(requests.end(), _context->loaded.begin(), _context->loaded.end());
+    _context->pending.clear();
+    _context->loaded.clear();
+    RESOURCELOADER_UNLOCK(_context);
+
+    for (size_t i = 0, count = requests.size(); i < count; ++i)
+    {
+        Request* request = requests[i];
+        request->_cancelled = true;
+        finish(request);
+    }
+
+    // Requests being read on the loader threads are dropped once they are read.
+    RESOURCELOADER_LOCK(_context);
+    for (size_t i = 0, count = _context->loading.size(); i < count; ++i)
+        _context->loading[i]->_cancelled = true;
+    RESOURCELOADER_UNLOCK(_context);
+}
+
+void ResourceLoader::wait(Request* request)
+{
+    GP_ASSERT(request);
+
+    RESOURCELOADER_LOCK(_context);
+    if (__remove(_context->pending, request))
+    {
+        // Read the request on this thread rather than waiting for a loader thread.
+        request->_state = LOADING;
+        RESOURCELOADER_UNLOCK(_context);
+        read(request);
+        finish(request);
+        return;
+    }
+
+    while (request->_state == LOADING)
+        RESOURCELOADER_WAIT(_context, workDone);
+    bool loaded = __remove(_context->loaded, request);
+    RESOURCELOADER_UNLOCK(_context);
+
+    if (loaded)
+        finish(request);
+}
+
+void ResourceLoader::update()
+{
+    // The game time stands still within a frame, so the budget is measured in real time.
+    double startTime = Platform::getAbsoluteTime();
+    bool first = true;
+    while (first || Platform::getAbsoluteTime() - startTime < _timeBudget)
+    {
+        RESOURCELOADER_LOCK(_context);
+        Request* request = __takeNext(_context->loaded);
+
+        // Without loader threads, pending requests are read here.
+        if (request == NULL && _context->threads.empty())
+        {
+            request = __takeNext(_context->pending);
+            if (request)
+                request->_state = LOADING;
+        }
+        RESOURCELOADER_UNLOCK(_context);
+
+        if (request == NULL)
+            break;
+        if (request->_state == LOADING)
+            read(request);
+
+        finish(request);
+        first = false;
+    }
+}
+
+void ResourceLoader::finish(Request* request)
+{
+    GP_ASSERT(request);
+
+    if (request->_cancelled)
+    {
+        request->discard();
+        request->_state = CANCELLED;
+        request->_loader = NULL;
+        request->release();
+        return;
+    }
+
+    // Finish the parts of the load that must run on the main thread.
+    bool loaded = !request->_failed;
+    if (loaded)
+    {
+        const char* path = request->_path.c_str();
+        switch (request->_type)
+        {
+        case BUNDLE:
+            {
+                // Share the bundle if it was opened while this request was read.
+                Bundle* bundle = Bundle::findCached(path);
+                if (bundle)
+                {
+                    SAFE_RELEASE(request->_bundle);
+                    request->_bundle = bundle;
+                }
+                else
+                {
+                    request->_bundle->addToCache();
+                }
+            }
+            break;
+
+        case PROPERTIES:
+            break;
+
+        case TEXTURE:
+            request->_texture = Texture::findCached(path, request->_generateMipmaps);
+            if (request->_texture == NULL)
+            {
+                if (request->_image)
+                {
+                    request->_texture = Texture::create(request->_image, request->_generateMipmaps);
+                    if (request->_texture)
+                        request->_texture->addToCache(path);
+                }
+                else
+                {
+                    request->_texture = Texture::create(path, request->_generateMipmaps);
+                }
+            }
+            SAFE_RELEASE(request->_image);
+            loaded = request->_texture != NULL;
+            break;
+
+        case AUDIO:
+            // The request keeps the buffer cached for audio sources created from the file.
+            request->_audioBuffer = AudioBuffer::create(path, request->_alBuffer);
+            request->_alBuffer = 0;
+            break;
+
+        case SCENE:
+            {
+                Properties* properties = request->_properties;
+                request->_properties = NULL;
+                request->_scene = SceneLoader::load(path, properties);
+                loaded = request->_scene != NULL;
+            }
+            break;
+        }
+    }
+
+    request->_state = loaded ? COMPLETE : FAILED;
+    request->_loader = NULL;
+
+    if (request->_listener)
+        request->_listener->resourceLoaded(request);
+
+    request->release();
+}
+
+void ResourceLoader::read(Request* request)
+{
+    GP_ASSERT(request);
+
+    const char* path = request->_path.c_str();
+    switch (request->_type)
+    {
+    case BUNDLE:
+        request->_bundle = Bundle::open(path);
+        request->_failed = request->_bundle == NULL;
+        break;
+
+    case TEXTURE:
+        // Compressed textures are read on the main thread as they are uploaded.
+        if (__isPNG(path))
+        {
+            request->_image = Image::create(path);
+            request->_failed = request->_image == NULL;
+        }
+        break;
+
+    case AUDIO:
+        request->_alBuffer = AudioBuffer::loadBuffer(path);
+        request->_failed = request->_alBuffer == 0;
+        break;
+
+    case PROPERTIES:
+    case SCENE:
+        request->_properties = Properties::create(path);
+        request->_failed = request->_properties == NULL;
+        break;
+    }
+}
+
+unsigned int ResourceLoader::getRequestCount() const
+{
+    RESOURCELOADER_LOCK(_context);
+    unsigned int count = (unsigned int)(_context->pending.size() + _context->loading.size() + _context->loaded.size());
+    RESOURCELOADER_UNLOCK(_context);
+    return count;
+}
+
+float ResourceLoader::getTimeBudget() const
+{
+    return _timeBudget;
+}
+
+void ResourceLoader::setTimeBudget(float milliseconds)
+{
+    _timeBudget = milliseconds;
+}
+
+unsigned int ResourceLoader::getThreadCount() const
+{
+    return _threadCount;
+}
+
+void ResourceLoader::setThreadCount(unsigned int threadCount)
+{
+    if (threadCount == _threadCount)
+        return;
+
+    stopThreads();
+    _threadCount = threadCount;
+
+    RESOURCELOADER_LOCK(_context);
+    bool pending = !_context->pending.empty();
+    RESOURCELOADER_UNLOCK(_context);
+    if (pending)
+        startThreads();
+}
+
+void ResourceLoader::startThreads()
+{
+    if (!_context->threads.empty() || _threadCount == 0)
+        return;
+
+    for (unsigned int i = 0; i < _threadCount; ++i)
+    {
+#ifdef WIN32
+        HANDLE thread = CreateThread(NULL, 0, &ResourceLoader::loaderThread, this, 0, NULL);
+        if (thread == NULL)
+#else
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, &ResourceLoader::loaderThread, this) != 0)
+#endif
+        {
+            GP_WARN("Failed to create resource loader thread %u of %u.", i + 1, _threadCount);
+            break;
+        }
+        RESOURCELOADER_LOCK(_context);
+        _context->threads.push_back(thread);
+        RESOURCELOADER_UNLOCK(_context);
+    }
+}
+
+void ResourceLoader::stopThreads()
+{
+    if (_context->threads.empty())
+        return;
+
+    RESOURCELOADER_LOCK(_context);
+    _context->exiting = true;
+    RESOURCELOADER_BROADCAST(_context, workReady);
+    RESOURCELOADER_UNLOCK(_context);
+
+    for (size_t i = 0, count = _context->threads.size(); i < count; ++i)
+    {
+#ifdef WIN32
+        WaitForSingleObject(_context->threads[i], INFINITE);
+        CloseHandle(_context->threads[i]);
+#else
+        pthread_join(_context->threads[i], NULL);
+#endif
+    }
+
+    RESOURCELOADER_LOCK(_context);
+    _context->threads.clear();
+    _context->exiting = false;
+    RESOURCELOADER_UNLOCK(_context);
+}
+
+#ifdef WIN32
+unsigned long __stdcall ResourceLoader::loaderThread(void* loader)
+#else
+void* ResourceLoader::loaderThread(void* loader)
+#endif
+{
+    ResourceLoader* resourceLoader = static_cast<ResourceLoader*>(loader);
+    Context* context = resourceLoader->_context;
+
+    RESOURCELOADER_LOCK(context);
+    while (true)
+    {
+        while (!context->exiting && context->pending.empty())
+            RESOURCELOADER_WAIT(context, workReady);
+        if (context->exiting)
+            break;
+
+        Request* request = __takeNext(context->pending);
+        request->_state = LOADING;
+        context->loading.push_back(request);
+        RESOURCELOADER_UNLOCK(context);
+
+        read(request);
+
+        RESOURCELOADER_LOCK(context);
+        request->_state = FINISHING;
+        __remove(context->loading, request);
+        context->loaded.push_back(request);
+        RESOURCELOADER_BROADCAST(context, workDone);
+    }
+    RESOURCELOADER_UNLOCK(context);
+
+    return 0;
+}
+
+}
@@ -0,0 +1,431 @@
+#ifndef RESOURCELOADER_H_
+#define RESOURCELOADER_H_
+
+#include "Ref.h"
+
+namespace gameplay
+{
+
+class AudioBuffer;
+class Bundle;
+class Image;
+class Texture;
+class Properties;
+class Scene;
+
+/**
+ * Defines a loader that reads resources on background threads, so that loading
+ * large assets does not stall the game loop.
+ *
+ * Each load returns a request that can be used to query its progress, change its
+ * priority, cancel it or wait for it. Reading and decoding files happens on the loader
+ * threads. The rest of the work, such as uploading textures to the graphics device, is
+ * finished on the main thread while the game updates, within a time budget per frame.
+ * Listeners are notified on the main thread once a request has completed or failed.
+ *
+ * The work done on the loader threads depends on the type of resource:
+ * - Bundles: opening the file and reading its reference table.
+ * - Textures: reading and decoding PNG files. Compressed DDS and PVR textures are
+ *   read on the main thread since their mipmap levels are uploaded as they are read.
+ * - Audio: reading and decoding the file into an OpenAL buffer.
+ * - Properties: reading and parsing the file.
+ * - Scenes: reading and parsing the scene file. The scene's bundle and the files it
+ *   references are loaded on the main thread, since loading them creates graphics objects.
+ *
+ * The resource caches are only accessed on the main thread, so a resource that is
+ * already loaded is shared as if it had been created directly.
+ */
+class ResourceLoader
+{
+    friend class Game;
+
+public:
+
+    class Request;
+
+    /**
+     * The type of resource loaded by a request.
+     */
+    enum Type
+    {
+        BUNDLE,
+        TEXTURE,
+        AUDIO,
+        PROPERTIES,
+        SCENE
+    };
+
+    /**
+     * The state of a request.
+     */
+    enum State
+    {
+        /** The request is waiting for a loader thread. */
+        PENDING,
+        /** The resource is being read on a loader thread. */
+        LOADING,
+        /** The resource is waiting to be finished on the main thread. */
+        FINISHING,
+        /** The resource has been loaded. */
+        COMPLETE,
+        /** The resource could not be loaded. */
+        FAILED,
+        /** The request was cancelled. */
+        CANCELLED
+    };
+
+    /**
+     * Defines an interface for receiving the result of a request.
+     */
+    class Listener
+    {
+    public:
+
+        /**
+         * Destructor.
+         */
+        virtual ~Listener() { }
+
+        /**
+         * Called on the main thread when a request has completed or failed.
+         * Cancelled requests are not reported.
+         *
+         * @param request The request, which is COMPLETE or FAILED.
+         */
+        virtual void resourceLoaded(Request* request) = 0;
+    };
+
+    /**
+     * Defines a request to load a resource.
+     *
+     * The request holds a reference to the loaded resource until it is destroyed.
+     * Add a reference to the resource to keep it after releasing the request.
+     */
+    class Request : public Ref
+    {
+        friend class ResourceLoader;
+
+    public:
+
+        /**
+         * Gets the type of resource loaded by this request.
+         *
+         * @return The type of resource.
+         */
+        Type getType() const;
+
+        /**
+         * Gets the path or URL of the resource.
+         *
+         * @return The path of the resource.
+         */
+        const char* getPath() const;
+
+        /**
+         * Gets the current state of this request.
+         *
+         * @return The state of the request.
+         */
+        State getState() const;
+
+        /**
+         * Determines if this request has completed, failed or was cancelled.
+         *
+         * @return true if the request is done, false otherwise.
+         */
+        bool isDone() const;
+
+        /**
+         * Gets the priority of this request.
+         *
+         * @return The priority of the request.
+         */
+        int getPriority() const;
+
+        /**
+         * Sets the priority of this request. Requests with a higher priority are
+         * read and finished before requests with a lower priority.
+         *
+         * @param priority The priority of the request.
+         */
+        void setPriority(int priority);
+
+        /**
+         * Cancels this request. The listener is not notified and any data
+         * already read for the request is discarded.
+         */
+        void cancel();
+
+        /**
+         * Blocks the calling thread until this request is done, finishing it
+         * immediately regardless of the time budget. Must be called on the main thread.
+         */
+        void wait();
+
+        /**
+         * Gets the loaded bundle.
+         *
+         * @return The bundle, or NULL if the request did not load a bundle or has not completed.
+         */
+        Bundle* getBundle() const;
+
+        /**
+         * Gets the loaded texture.
+         *
+         * @return The texture, or NULL if the request did not load a texture or has not completed.
+         */
+        Texture* getTexture() const;
+
+        /**
+         * Gets the loaded properties.
+         *
+         * The properties are owned by the request and are deleted with it.
+         *
+         * @return The properties, or NULL if the request did not load properties or has not completed.
+         */
+        Properties* getProperties() const;
+
+        /**
+         * Gets the loaded scene.
+         *
+         * @return The scene, or NULL if the request did not load a scene or has not completed.
+         */
+        Scene* getScene() const;
+
+    private:
+
+        /**
+         * Constructor.
+         */
+        Request(ResourceLoader* loader, Type type, const char* path, int priority, Listener* listener);
+
+        /**
+         * Destructor.
+         */
+        ~Request();
+
+        /**
+         * Hidden copy constructor.
+         */
+        Request(const Request& copy);
+
+        /**
+         * Hidden copy assignment operator.
+         */
+        Request& operator=(const Request&);
+
+        /**
+         * Releases the data read for the request without finishing it.
+         */
+        void discard();
+
+        ResourceLoader* _loader;
+        Type _type;
+        std::string _path;
+        int _priority;
+        Listener* _listener;
+        State _state;
+        bool _cancelled;
+        bool _failed;
+        bool _generateMipmaps;
+        Bundle* _bundle;
+        Image* _image;
+        Texture* _texture;
+        unsigned int _alBuffer;
+        AudioBuffer* _audioBuffer;
+        Properties* _properties;
+        Scene* _scene;
+    };
+
+    /**
+     * Loads a bundle in the background.
+     *
+     * @param path The path of the bundle file.
+     * @param listener The listener notified when the bundle is loaded, or NULL.
+     * @param priority The priority of the request.
+     *
+     * @return The request, which must be released when no longer needed.
+     * @script{create}
+     */
+    Request* loadBundle(const char* path, Listener* listener = NULL, int priority = 0);
+
+    /**
+     * Loads a texture in the background. Textures that are already loaded are
+     * shared with Texture::create.
+     *
+     * @param path The path of the texture file.
+     * @param generateMipmaps true to generate a full mipmap chain for the texture.
+     * @param listener The listener notified when the texture is loaded, or NULL.
+     * @param priority The priority of the request.
+     *
+     * @return The request, which must be released when no longer needed.
+     * @script{create}
+     */
+    Request* loadTexture(const char* path, bool generateMipmaps = false, Listener* listener = NULL, int priority = 0);
+
+    /**
+     * Loads the data of an audio file in the background. The data stays cached while
+     * the request is kept, so audio sources created for the file play it without reading it.
+     *
+     * @param path The path of the audio file.
+     * @param listener The listener notified when the audio is loaded, or NULL.
+     * @param priority The priority of the request.
+     *
+     * @return The request, which must be released when no longer needed.
+     * @script{create}
+     */
+    Request* loadAudio(const char* path, Listener* listener = NULL, int priority = 0);
+
+    /**
+     * Loads properties in the background.
+     *
+     * @param url The URL of the properties, as passed to Properties::create.
+     * @param listener The listener notified when the properties are loaded, or NULL.
+     * @param priority The priority of the request.
+     *
+     * @return The request, which must be released when no longer needed.
+     * @script{create}
+     */
+    Request* loadProperties(const char* url, Listener* listener = NULL, int priority = 0);
+
+    /**
+     * Loads a scene in the background.
+     *
+     * @param url The URL of the scene, as passed to Scene::load.
+     * @param listener The listener notified when the scene is loaded, or NULL.
+     * @param priority The priority of the request.
+     *
+     * @return The request, which must be released when no longer needed.
+     * @script{create}
+     */
+    Request* loadScene(const char* url, Listener* listener = NULL, int priority = 0);
+
+    /**
+     * Cancels all requests that are not done.
+     */
+    void cancelAll();
+
+    /**
+     * Gets the number of requests that are not done.
+     *
+     * @return The number of requests.
+     */
+    unsigned int getRequestCount() const;
+
+    /**
+     * Gets the time spent finishing requests on the main thread each frame.
+     *
+     * @return The time budget in milliseconds.
+     */
+    float getTimeBudget() const;
+
+    /**
+     * Sets the time spent finishing requests on the main thread each frame.
+     * At least one request is finished each frame. The default is 4 milliseconds,
+     * which can also be set with loader.budget in the game config.
+     *
+     * @param milliseconds The time budget in milliseconds.
+     */
+    void setTimeBudget(float milliseconds);
+
+    /**
+     * Gets the number of loader threads.
+     *
+     * @return The number of threads.
+     */
+    unsigned int getThreadCount() const;
+
+    /**
+     * Sets the number of loader threads. With no threads, requests are read on the
+     * main thread within the time budget. The default is one thread, which can also be
+     * set with loader.threads in the game config.
+     *
+     * Requests being read finish on the current threads before the new threads start.
+     *
+     * @param threadCount The number of threads.
+     */
+    void setThreadCount(unsigned int threadCount);
+
+private:
+
+    struct Context;
+
+    /**
+     * Constructor.
+     */
+    ResourceLoader();
+
+    /**
+     * Hidden copy constructor.
+     */
+    ResourceLoader(const ResourceLoader& copy);
+
+    /**
+     * Destructor.
+     */
+    ~ResourceLoader();
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    ResourceLoader& operator=(const ResourceLoader&);
+
+    /**
+     * Called by Game when it exits. Cancels all requests and stops the loader threads.
+     */
+    void finalize();
+
+    /**
+     * Called by Game each frame to finish loaded requests and notify their listeners.
+     */
+    void update();
+
+    /**
+     * Queues a request for the loader threads.
+     */
+    Request* submit(Request* request);
+
+    /**
+     * Cancels a request.
+     */
+    void cancel(Request* request);
+
+    /**
+     * Waits for a request and finishes it.
+     */
+    void wait(Request* request);
+
+    /**
+     * Finishes a request on the main thread and notifies its listener.
+     */
+    void finish(Request* request);
+
+    /**
+     * Starts the loader threads if they are not running.
+     */
+    void startThreads();
+
+    /**
+     * Stops the loader threads once they have read their current requests.
+     */
+    void stopThreads();
+
+    /**
+     * Reads the resource of a request. Called on the loader threads.
+     */
+    static void read(Request* request);
+
+#ifdef WIN32
+    static unsigned long __stdcall loaderThread(void* loader);
+#else
+    static void* loaderThread(void* loader);
+#endif
+
+    Context* _context;
+    unsigned int _threadCount;
+    float _timeBudget;
+};
+
+}
+
+#endif
@@ -4,11 +4,21 @@
 #include "SceneLoader.h"
 #include "MeshSkin.h"
 #include "Joint.h"
+#include "TransformHierarchy.h"
+#include "BoundsHierarchy.h"
+#include "NodeIndex.h"
+#include "RenderQueue.h"
+#include "ThreadPool.h"
+
+// The number of subtrees per thread a parallel visit splits the scene into, to balance the threads.
+#define VISIT_SUBTREES_PER_THREAD 8
 
 namespace gameplay
 {
 
-Scene::Scene() : _activeCamera(NULL), _firstNode(NULL), _lastNode(NULL), _nodeCount(0), _bindAudioListenerToCamera(true), _debugBatch(NULL)
+Scene::Scene() : _activeCamera(NULL), _firstNode(NULL), _lastNode(NULL), _nodeCount(0), _bindAudioListenerToCamera(true), _debugBatch(NULL),
+    _transformHierarchy(NULL), _boundsHierarchy(NULL), _renderQueue(NULL), _nodeIndex(NULL),
+    _visitThreadPool(NULL)
 {
 }
 
@@ -27,7 +37,12 @@ Scene::~Scene()
     }
 
     // Remove all nodes from the scene
+    SAFE_DELETE(_renderQueue);
+    SAFE_DELETE(_boundsHierarchy);
+    SAFE_DELETE(_nodeIndex);
     removeAllNodes();
+    SAFE_DELETE(_transformHierarchy);
+    SAFE_DELETE(_visitThreadPool);
     SAFE_DELETE(_debugBatch);
 }
 
@@ -58,6 +73,13 @@ Node* Scene::findNode(const char* id, bool recursive, bool exactMatch) const
 {
     GP_ASSERT(id);
 
+    // Look the id up in the index, unless several nodes match.
+    Node* match;
+    if (_nodeIndex && _nodeIndex->findNode(id, NULL, recursive, exactMatch, &match))
+    {
+        return match;
+    }
+
     // Search immediate children first.
     for (Node* child = getFirstNode(); child != NULL; child = child->getNextSibling())
     {
@@ -88,6 +110,11 @@ unsigned int Scene::findNodes(const char* id, std::vector<Node*>& nodes, bool re
 {
     GP_ASSERT(id);
 
+    if (_nodeIndex)
+    {
+        return _nodeIndex->findNodes(id, NULL, recursive, exactMatch, nodes);
+    }
+
     unsigned int count = 0;
 
     // Search immediate children first.
@@ -165,6 +192,15 @@ void Scene::addNode(Node* node)
 
     ++_nodeCount;
 
+    // The flattened transforms must include the new node.
+    if (_transformHierarchy)
+    {
+        _transformHierarchy->invalidate();
+    }
+
+    // So must the bounding volume hierarchy and the node index.
+    nodeAdded(node);
+
     // If we don't have an active camera set, then check for one and set it.
     if (_activeCamera == NULL)
     {
@@ -278,6 +314,236 @@ void Scene::setAmbientColor(float red, float green, float blue)
     _ambientColor.set(red, green, blue);
 }
 
+void Scene::setTransformsFlattened(bool flattened, unsigned int threadCount)
+{
+    // Recreate the hierarchy so that a new thread count takes effect.
+    SAFE_DELETE(_transformHierarchy);
+    if (flattened)
+    {
+        _transformHierarchy = new TransformHierarchy(this, threadCount);
+        _transformHierarchy->update();
+    }
+}
+
+bool Scene::isTransformsFlattened() const
+{
+    return _transformHierarchy != NULL;
+}
+
+void Scene::setNodesIndexed(bool indexed)
+{
+    if (indexed == (_nodeIndex != NULL))
+        return;
+
+    SAFE_DELETE(_nodeIndex);
+    if (indexed)
+    {
+        _nodeIndex = new NodeIndex(this);
+    }
+}
+
+bool Scene::isNodesIndexed() const
+{
+    return _nodeIndex != NULL;
+}
+
+void Scene::updateTransforms()
+{
+    if (_transformHierarchy && _transformHierarchy->isDirty())
+    {
+        _transformHierarchy->update();
+    }
+}
+
+BoundsHierarchy* Scene::getBoundsHierarchy() const
+{
+    if (!_boundsHierarchy)
+    {
+        _boundsHierarchy = new BoundsHierarchy(const_cast<Scene*>(this));
+    }
+    return _boundsHierarchy;
+}
+
+/**
+ * The subtrees of a parallel visit, shared by its jobs.
+ */
+struct Scene::ParallelVisit
+{
+    VisitFunction function;
+    const void* visitor;
+    Node* const* subtrees;
+    unsigned int subtreeCount;
+    unsigned int jobCount;
+};
+
+unsigned int Scene::getVisitThreadCount() const
+{
+    return _visitThreadPool ? _visitThreadPool->getThreadCount() : 1;
+}
+
+void Scene::setVisitThreadCount(unsigned int threadCount)
+{
+    if (threadCount == 0)
+        threadCount = ThreadPool::getProcessorCount();
+
+    if (threadCount == getVisitThreadCount())
+        return;
+
+    SAFE_DELETE(_visitThreadPool);
+    if (threadCount > 1)
+        _visitThreadPool = ThreadPool::create(threadCount);
+}
+
+void Scene::visitParallel(VisitFunction function, const void* visitor)
+{
+    GP_ASSERT(function);
+
+    unsigned int threadCount = getVisitThreadCount();
+    unsigned int jobCount = threadCount * VISIT_SUBTREES_PER_THREAD;
+
+    // Visit the nodes nearest the root on this thread, breadth first, until the
+    // hierarchy is split into enough subtrees for the threads to share.
+    _visitSubtrees.clear();
+    for (Node* node = getFirstNode(); node != NULL; node = node->getNextSibling())
+    {
+        _visitSubtrees.push_back(node);
+    }
+    size_t first = 0;
+    if (threadCount > 1)
+    {
+        while (first < _visitSubtrees.size() && _visitSubtrees.size() - first < jobCount)
+        {
+            Node* node = _visitSubtrees[first++];
+            if (function(visitor, node, 0))
+            {
+                for (Node* child = node->getFirstChild(); child != NULL; child = child->getNextSibling())
+                {
+                    _visitSubtrees.push_back(child);
+                }
+            }
+        }
+    }
+    if (first == _visitSubtrees.size())
+        return;
+
+    ParallelVisit visit;
+    visit.function = function;
+    visit.visitor = visitor;
+    visit.subtrees = &_visitSubtrees[first];
+    visit.subtreeCount = (unsigned int)(_visitSubtrees.size() - first);
+    if (_visitThreadPool)
+    {
+        visit.jobCount = std::min(visit.subtreeCount, jobCount);
+        _visitThreadPool->run(&Scene::visitSubtrees, &visit, visit.jobCount);
+    }
+    else
+    {
+        visit.jobCount = 1;
+        visitSubtrees(&visit, 0, 0);
+    }
+}
+
+void Scene::visitSubtrees(void* data, unsigned int index, unsigned int threadIndex)
+{
+    const ParallelVisit* visit = static_cast<const ParallelVisit*>(data);
+
+    // Each job visits an even share of the subtrees, one after the other.
+    unsigned int begin = (unsigned int)((unsigned long long)visit->subtreeCount * index / visit->jobCount);
+    unsigned int end = (unsigned int)((unsigned long long)visit->subtreeCount * (index + 1) / visit->jobCount);
+    for (unsigned int i = begin; i < end; ++i)
+    {
+        Node* root = visit->subtrees[i];
+        Node* node = root;
+        while (node)
+        {
+            Node* next = visit->function(visit->visitor, node, threadIndex) ? node->getFirstChild() : NULL;
+            if (next == NULL)
+            {
+                // Climb to the nearest ancestor below the root with a next sibling.
+                while (node != root && !node->getNextSibling())
+                    node = node->getParent();
+                next = node != root ? node->getNextSibling() : NULL;
+            }
+            node = next;
+        }
+    }
+}
+
+void Scene::nodeAdded(Node* node)
+{
+    if (_boundsHierarchy)
+    {
+        _boundsHierarchy->insert(node);
+    }
+    if (_nodeIndex)
+    {
+        _nodeIndex->insert(node);
+    }
+}
+
+void Scene::nodeRemoved(Node* node)
+{
+    if (_boundsHierarchy)
+    {
+        _boundsHierarchy->remove(node);
+    }
+    if (_nodeIndex)
+    {
+        _nodeIndex->remove(node);
+    }
+}
+
+unsigned int Scene::findNodes(const Frustum& frustum, std::vector<Node*>& nodes) const
+{
+    return getBoundsHierarchy()->find(frustum, nodes);
+}
+
+unsigned int Scene::findNodes(const BoundingSphere& sphere, std::vector<Node*>& nodes) const
+{
+    return getBoundsHierarchy()->find(sphere, nodes);
+}
+
+unsigned int Scene::findNodes(const BoundingBox& box, std::vector<Node*>& nodes) const
+{
+    return getBoundsHierarchy()->find(box, nodes);
+}
+
+unsigned int Scene::findNodes(const Ray& ray, std::vector<Node*>& nodes) const
+{
+    return getBoundsHierarchy()->find(ray, nodes);
+}
+
+unsigned int Scene::cull(std::vector<Node*>& nodes) const
+{
+    if (_activeCamera)
+    {
+        return findNodes(_activeCamera->getFrustum(), nodes);
+    }
+
+    // Without a camera every model is visible, which an infinite box finds.
+    BoundingBox box(-FLT_MAX, -FLT_MAX, -FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX);
+    return findNodes(box, nodes);
+}
+
+unsigned int Scene::drawVisible(bool wireframe)
+{
+    if (!_renderQueue)
+    {
+        _renderQueue = RenderQueue::create();
+    }
+
+    _visibleNodes.clear();
+    unsigned int count = cull(_visibleNodes);
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        _renderQueue->add(_visibleNodes[i]->getModel(), wireframe);
+    }
+    _visibleNodes.clear();
+    _renderQueue->draw();
+    _renderQueue->clear();
+    return count;
+}
+
 static Material* createDebugMaterial()
 {
     // Vertex shader for drawing colored lines.
@@ -4,15 +4,22 @@
 #include "Node.h"
 #include "MeshBatch.h"
 #include "ScriptController.h"
+#include "Frustum.h"
+#include "Ray.h"
 
 namespace gameplay
 {
 
+class RenderQueue;
+class ThreadPool;
+
 /**
  * Represents the root container for a hierarchy of nodes.
  */
 class Scene : public Ref
 {
+    friend class Node;
+
 public:
 
     /**
@@ -162,14 +169,143 @@ public:
      */
     void setAmbientColor(float red, float green, float blue);
 
+    /**
+     * Sets whether the world matrices of the nodes in the scene are updated from a flattened
+     * copy of the node hierarchy.
+     *
+     * When enabled, the nodes are kept in a depth-first array and the world matrices of all
+     * nodes whose transform changed are recomputed together, in one pass over contiguous
+     * memory, the first time a world matrix is requested after the change. Large subtrees
+     * are split across threads when more than one thread is used. This is faster than the
+     * default lazy per-node update for scenes with many moving nodes.
+     *
+     * @param flattened true to update world matrices from a flattened hierarchy.
+     * @param threadCount The number of threads computing world matrices, or zero for one per processor.
+     */
+    void setTransformsFlattened(bool flattened, unsigned int threadCount = 1);
+
+    /**
+     * Determines if the world matrices of the nodes in the scene are updated from a flattened
+     * copy of the node hierarchy.
+     *
+     * @return true if transforms are flattened.
+     */
+    bool isTransformsFlattened() const;
+
+    /**
+     * Updates the world matrices of all nodes whose transform changed, when transforms are flattened.
+     *
+     * This is done automatically the first time a world matrix is requested, but can be
+     * called explicitly, such as once per frame after updating animations.
+     */
+    void updateTransforms();
+
+    /**
+     * Sets whether the nodes in the scene are indexed by id.
+     *
+     * When enabled, findNode and findNodes look ids up in a hash table, and id prefixes in
+     * a sorted index, instead of searching the node hierarchy. The index is kept up to date
+     * as nodes are added, removed and renamed, at a small cost to each of these. When several
+     * nodes match, findNode searches the hierarchy to return the same node it would without
+     * the index, and findNodes returns them in an unspecified order.
+     *
+     * The joints of mesh skins that are not part of the scene are not indexed. Recursive calls
+     * to findNode search the joint hierarchies of the skinned models in the scene for them,
+     * as they do without the index. As without the index, findNodes does not find them.
+     *
+     * Scenes loaded from .scene files are indexed unless the file sets indexNodes to false.
+     *
+     * @param indexed true to index the nodes by id.
+     */
+    void setNodesIndexed(bool indexed);
+
+    /**
+     * Determines if the nodes in the scene are indexed by id.
+     *
+     * @return true if nodes are indexed.
+     */
+    bool isNodesIndexed() const;
+
+    /**
+     * Finds the nodes with models whose bounds intersect a frustum.
+     *
+     * Spatial queries test the bounds of the models of nodes, without their children.
+     * The first query builds a bounding volume hierarchy over these bounds, which is
+     * then kept up to date as nodes move and are added to and removed from the scene,
+     * so that queries only test the nodes near the query volume.
+     *
+     * @param frustum The frustum to test the nodes against.
+     * @param nodes The vector the nodes found are appended to.
+     *
+     * @return The number of nodes found.
+     */
+    unsigned int findNodes(const Frustum& frustum, std::vector<Node*>& nodes) const;
+
+    /**
+     * Finds the nodes with models whose bounds intersect a sphere.
+     *
+     * @param sphere The world-space sphere to test the nodes against.
+     * @param nodes The vector the nodes found are appended to.
+     *
+     * @return The number of nodes found.
+     * @see findNodes(const Frustum&, std::vector<Node*>&)
+     */
+    unsigned int findNodes(const BoundingSphere& sphere, std::vector<Node*>& nodes) const;
+
+    /**
+     * Finds the nodes with models whose bounds intersect a box.
+     *
+     * @param box The world-space box to test the nodes against.
+     * @param nodes The vector the nodes found are appended to.
+     *
+     * @return The number of nodes found.
+     * @see findNodes(const Frustum&, std::vector<Node*>&)
+     */
+    unsigned int findNodes(const BoundingBox& box, std::vector<Node*>& nodes) const;
+
+    /**
+     * Finds the nodes with models whose bounds a ray intersects, nearest first.
+     *
+     * @param ray The world-space ray to test the nodes against.
+     * @param nodes The vector the nodes found are appended to.
+     *
+     * @return The number of nodes found.
+     * @see findNodes(const Frustum&, std::vector<Node*>&)
+     */
+    unsigned int findNodes(const Ray& ray, std::vector<Node*>& nodes) const;
+
+    /**
+     * Finds the nodes with models visible to the active camera, or all nodes with
+     * models when there is no active camera.
+     *
+     * @param nodes The vector the visible nodes are appended to.
+     *
+     * @return The number of visible nodes.
+     * @see findNodes(const Frustum&, std::vector<Node*>&)
+     */
+    unsigned int cull(std::vector<Node*>& nodes) const;
+
+    /**
+     * Draws the models visible to the active camera, sorted to minimize state changes.
+     *
+     * @param wireframe If true, draw the models in wireframe mode.
+     *
+     * @return The number of models drawn.
+     * @see cull
+     */
+    unsigned int drawVisible(bool wireframe = false);
+
     /**
      * Visits each node in the scene and calls the specified method pointer.
      *
      * Calling this method invokes the specified method pointer for each node
-     * in the scene hierarchy.
+     * in the scene hierarchy, visiting each node before its children. The
+     * hierarchy is walked iteratively, so deep hierarchies do not grow the stack.
      *
      * The visitMethod parameter must be a pointer to a method that has a bool
-     * return type and accepts a single parameter of type Node*.
+     * return type and accepts a single parameter of type Node*. The scene
+     * traversal continues while visitMethod return true. Returning false will
+     * cause the traversal to stop.
      *
      * @param instance The pointer to an instance of the object that contains visitMethod.
      * @param visitMethod The pointer to the class method to call for each node in the scene.
@@ -209,6 +345,62 @@ public:
      */
     inline void visit(const char* visitMethod);
 
+    /**
+     * Visits each node in the scene in parallel and calls the specified const method pointer.
+     *
+     * The nodes nearest the root are visited on the calling thread until the hierarchy has
+     * been split into enough subtrees to share across the visit threads, which then visit
+     * the subtrees concurrently. Each node is still visited before its children, but nodes
+     * in different subtrees are visited in no particular order.
+     *
+     * The visitMethod parameter must be a pointer to a const method that has a bool return
+     * type and accepts a single parameter of type Node*. It is called from several threads at
+     * once, so it must not modify the scene or shared state. Returning false skips the
+     * children of the node, rather than stopping the traversal.
+     *
+     * @param instance The pointer to an instance of the object that contains visitMethod.
+     * @param visitMethod The pointer to the class method to call for each node in the scene.
+     * @see setVisitThreadCount
+     * @script{ignore}
+     */
+    template <class T>
+    void visitParallel(const T* instance, bool (T::*visitMethod)(Node*) const);
+
+    /**
+     * Visits each node in the scene in parallel and calls the specified const method pointer,
+     * passing the Node and the result of the thread visiting it.
+     *
+     * This is the same as the visitParallel method above, except that each thread accumulates
+     * the nodes it visits into its own element of the results vector, which needs no locking.
+     * The vector is resized to the number of visit threads, keeping existing elements so that
+     * their memory can be reused from one visit to the next, and the caller combines the
+     * elements once the visit returns.
+     *
+     * @param instance The pointer to an instance of the object that contains visitMethod.
+     * @param visitMethod The pointer to the class method to call for each node in the scene.
+     * @param results The results of the visit threads.
+     * @see setVisitThreadCount
+     * @script{ignore}
+     */
+    template <class T, class R>
+    void visitParallel(const T* instance, bool (T::*visitMethod)(Node*, R&) const, std::vector<R>& results);
+
+    /**
+     * Gets the number of threads visiting the nodes of the scene in visitParallel.
+     *
+     * @return The number of threads.
+     */
+    unsigned int getVisitThreadCount() const;
+
+    /**
+     * Sets the number of threads visiting the nodes of the scene in visitParallel.
+     *
+     * @param threadCount The number of threads, including the thread calling visitParallel.
+     *      The default of 1 visits all nodes on the calling thread, and 0 uses one thread
+     *      per processor.
+     */
+    void setVisitThreadCount(unsigned int threadCount);
+
     /**
      * Draws debugging information (bounding volumes, etc.) for the scene.
      *
@@ -240,21 +432,70 @@ private:
     Scene& operator=(const Scene&);
 
     /**
-     * Visits the given node and all of its children recursively.
+     * Defines the function visitParallel calls for each node, with the visitor and the index of the visiting thread.
+     */
+    typedef bool (*VisitFunction)(const void* visitor, Node* node, unsigned int threadIndex);
+
+    /**
+     * Calls a const visit method for a node.
      */
     template <class T>
-    bool visitNode(Node* node, T* instance, bool (T::*visitMethod)(Node*));
+    struct NodeVisitor
+    {
+        const T* instance;
+        bool (T::*visitMethod)(Node*) const;
+
+        static bool visit(const void* visitor, Node* node, unsigned int threadIndex);
+    };
 
     /**
-     * Visits the given node and all of its children recursively.
+     * Calls a const visit method for a node, with the result of the visiting thread.
      */
-    template <class T, class C>
-    bool visitNode(Node* node, T* instance, bool (T::*visitMethod)(Node*,C), C cookie);
+    template <class T, class R>
+    struct ResultVisitor
+    {
+        const T* instance;
+        bool (T::*visitMethod)(Node*, R&) const;
+        R* results;
+
+        static bool visit(const void* visitor, Node* node, unsigned int threadIndex);
+    };
 
     /**
-     * Visits the given node and all of its children recursively.
+     * The subtrees of a parallel visit, shared by its jobs.
      */
-    inline bool visitNode(Node* node, const char* visitMethod);
+    struct ParallelVisit;
+
+    /**
+     * Returns the node visited after a node, before its children and after its
+     * descendants, or NULL after the last node of the scene.
+     */
+    static Node* getNextNode(Node* node);
+
+    /**
+     * Visits the nodes of the scene in parallel with a visit function.
+     */
+    void visitParallel(VisitFunction function, const void* visitor);
+
+    /**
+     * Visits the subtrees of a job of a parallel visit.
+     */
+    static void visitSubtrees(void* data, unsigned int index, unsigned int threadIndex);
+
+    /**
+     * Returns the bounding volume hierarchy of the scene, building it on first use.
+     */
+    BoundsHierarchy* getBoundsHierarchy() const;
+
+    /**
+     * Adds a node and its descendants that joined the scene to the bounding volume hierarchy and the node index.
+     */
+    void nodeAdded(Node* node);
+
+    /**
+     * Removes a node and its descendants that are leaving the scene from the bounding volume hierarchy and the node index.
+     */
+    void nodeRemoved(Node* node);
 
     std::string _id;
     Camera* _activeCamera;
@@ -264,86 +505,88 @@ private:
     Vector3 _ambientColor;
     bool _bindAudioListenerToCamera;
     MeshBatch* _debugBatch;
+    TransformHierarchy* _transformHierarchy;
+    mutable BoundsHierarchy* _boundsHierarchy;
+    std::vector<Node*> _visibleNodes;
+    RenderQueue* _renderQueue;
+    NodeIndex* _nodeIndex;
+    ThreadPool* _visitThreadPool;
+    std::vector<Node*> _visitSubtrees;
 };
 
 template <class T>
 void Scene::visit(T* instance, bool (T::*visitMethod)(Node*))
 {
-    for (Node* node = getFirstNode(); node != NULL; node = node->getNextSibling())
+    for (Node* node = getFirstNode(); node != NULL; node = getNextNode(node))
     {
-        if (!visitNode(node, instance, visitMethod))
+        if (!(instance->*visitMethod)(node))
             return;
     }
 }
 
-
 template <class T, class C>
 void Scene::visit(T* instance, bool (T::*visitMethod)(Node*,C), C cookie)
 {
-    for (Node* node = getFirstNode(); node != NULL; node = node->getNextSibling())
+    for (Node* node = getFirstNode(); node != NULL; node = getNextNode(node))
     {
-        if (!visitNode(node, instance, visitMethod, cookie))
+        if (!(instance->*visitMethod)(node, cookie))
             return;
     }
 }
 
 inline void Scene::visit(const char* visitMethod)
 {
-    for (Node* node = getFirstNode(); node != NULL; node = node->getNextSibling())
+    for (Node* node = getFirstNode(); node != NULL; node = getNextNode(node))
     {
-        if (!visitNode(node, visitMethod))
+        if (!Game::getInstance()->getScriptController()->executeFunction<bool>(visitMethod, "<Node>", node))
             return;
     }
 }
 
 template <class T>
-bool Scene::visitNode(Node* node, T* instance, bool (T::*visitMethod)(Node*))
+void Scene::visitParallel(const T* instance, bool (T::*visitMethod)(Node*) const)
 {
-    // Invoke the visit method for this node.
-    if (!(instance->*visitMethod)(node))
-        return false;
-
-    // Recurse for all children.
-    for (Node* child = node->getFirstChild(); child != NULL; child = child->getNextSibling())
-    {
-        if (!visitNode(child, instance, visitMethod))
-            return false;
-    }
-
-    return true;
+    NodeVisitor<T> visitor;
+    visitor.instance = instance;
+    visitor.visitMethod = visitMethod;
+    visitParallel(&NodeVisitor<T>::visit, &visitor);
 }
 
-template <class T, class C>
-bool Scene::visitNode(Node* node, T* instance, bool (T::*visitMethod)(Node*,C), C cookie)
+template <class T, class R>
+void Scene::visitParallel(const T* instance, bool (T::*visitMethod)(Node*, R&) const, std::vector<R>& results)
 {
-    // Invoke the visit method for this node.
-    if (!(instance->*visitMethod)(node, cookie))
-        return false;
+    results.resize(getVisitThreadCount());
 
-    // Recurse for all children.
-    for (Node* child = node->getFirstChild(); child != NULL; child = child->getNextSibling())
-    {
-        if (!visitNode(child, instance, visitMethod, cookie))
-            return false;
-    }
+    ResultVisitor<T, R> visitor;
+    visitor.instance = instance;
+    visitor.visitMethod = visitMethod;
+    visitor.results = &results[0];
+    visitParallel(&ResultVisitor<T, R>::visit, &visitor);
+}
 
-    return true;
+template <class T>
+bool Scene::NodeVisitor<T>::visit(const void* visitor, Node* node, unsigned int threadIndex)
+{
+    const NodeVisitor<T>* v = static_cast<const NodeVisitor<T>*>(visitor);
+    return (v->instance->*v->visitMethod)(node);
 }
 
-inline bool Scene::visitNode(Node* node, const char* visitMethod)
+template <class T, class R>
+bool Scene::ResultVisitor<T, R>::visit(const void* visitor, Node* node, unsigned int threadIndex)
 {
-    // Invoke the visit method for this node.
-    if (!Game::getInstance()->getScriptController()->executeFunction<bool>(visitMethod, "<Node>", node))
-        return false;
+    const ResultVisitor<T, R>* v = static_cast<const ResultVisitor<T, R>*>(visitor);
+    return (v->instance->*v->visitMethod)(node, v->results[threadIndex]);
+}
 
-    // Recurse for all children.
-    for (Node* child = node->getFirstChild(); child != NULL; child = child->getNextSibling())
-    {
-        if (!Game::getInstance()->getScriptController()->executeFunction<bool>(visitMethod, "<Node>", child))
-            return false;
-    }
+inline Node* Scene::getNextNode(Node* node)
+{
+    if (node->getFirstChild())
+        return node->getFirstChild();
 
-    return true;
+    // Climb to the nearest ancestor with a next sibling, ending after the last root node.
+    while (node && !node->getNextSibling())
+        node = node->getParent();
+    return node ? node->getNextSibling() : NULL;
 }
 
 }
@@ -14,18 +14,25 @@ extern Properties* getPropertiesFromNamespacePath(Properties* properties, const
 Scene* SceneLoader::load(const char* url)
 {
     SceneLoader loader;
-    return loader.loadInternal(url);
+    return loader.loadInternal(url, NULL);
 }
 
-Scene* SceneLoader::loadInternal(const char* url)
+Scene* SceneLoader::load(const char* url, Properties* properties)
+{
+    SceneLoader loader;
+    return loader.loadInternal(url, properties);
+}
+
+Scene* SceneLoader::loadInternal(const char* url, Properties* properties)
 {
     // Get the file part of the url that we are loading the scene from.
     std::string urlStr = url ? url : "";
     std::string id;
     splitURL(urlStr, &_path, &id);
 
-    // Load the scene properties from file.
-    Properties* properties = Properties::create(url);
+    // Load the scene properties from file, unless they were loaded ahead of time.
+    if (properties == NULL)
+        properties = Properties::create(url);
     if (properties == NULL)
     {
         GP_ERROR("Failed to load scene file '%s'.", url);
@@ -57,6 +64,10 @@ Scene* SceneLoader::loadInternal(const char* url)
         return NULL;
     }
 
+    // Index the nodes by id, for the lookups below and at runtime, unless the scene opts out.
+    if (sceneProperties->getBool("indexNodes", true))
+        scene->setNodesIndexed(true);
+
     // First apply the node url properties. Following that,
     // apply the normal node properties and create the animations.
     // We apply physics properties after all other node properties
@@ -66,6 +77,7 @@ Scene* SceneLoader::loadInternal(const char* url)
     applyNodeProperties(scene, sceneProperties, 
         SceneNodeProperty::AUDIO | 
         SceneNodeProperty::MATERIAL | 
+        SceneNodeProperty::LOD |
         SceneNodeProperty::PARTICLE |
         SceneNodeProperty::ROTATE |
         SceneNodeProperty::SCALE |
@@ -176,6 +188,7 @@ void SceneLoader::applyNodeProperty(SceneNode& sceneNode, Node* node, const Prop
 {
     if (snp._type == SceneNodeProperty::AUDIO ||
         snp._type == SceneNodeProperty::MATERIAL ||
+        snp._type == SceneNodeProperty::LOD ||
         snp._type == SceneNodeProperty::PARTICLE ||
         snp._type == SceneNodeProperty::COLLISION_OBJECT)
     {
@@ -212,6 +225,56 @@ void SceneLoader::applyNodeProperty(SceneNode& sceneNode, Node* node, const Prop
                 SAFE_RELEASE(material);
             }
             break;
+        case SceneNodeProperty::LOD:
+        {
+            Model* model = node->getModel();
+            if (!model)
+            {
+                GP_ERROR("Attempting to add a level of detail to node '%s', which has no model.", sceneNode._nodeID);
+                return;
+            }
+
+            // Levels are listed from the most to the least detailed.
+            float screenSize = p->getFloat("screenSize");
+            unsigned int levelCount = model->getLevelCount();
+            if (screenSize <= 0.0f || (levelCount > 1 && screenSize >= model->getLevelScreenSize(levelCount - 1)))
+            {
+                GP_ERROR("Invalid screen size %f for level %d of node '%s'; levels need decreasing positive screen sizes.", screenSize, levelCount, sceneNode._nodeID);
+                return;
+            }
+
+            const char* url = p->getString("mesh");
+            if (!url)
+            {
+                GP_ERROR("Missing mesh for level %d of node '%s'.", levelCount, sceneNode._nodeID);
+                return;
+            }
+
+            // A mesh without a file is in the main scene bundle.
+            std::string file;
+            std::string id;
+            splitURL(url, &file, &id);
+            if (file.empty())
+                file = _gpbPath;
+            Mesh* mesh = NULL;
+            Bundle* bundle = Bundle::create(file.c_str());
+            if (bundle)
+            {
+                mesh = bundle->loadMesh(id.c_str());
+                SAFE_RELEASE(bundle);
+            }
+            if (!mesh)
+            {
+                GP_ERROR("Failed to load mesh '%s' for level %d of node '%s'.", url, levelCount, sceneNode._nodeID);
+                return;
+            }
+            model->addLevel(mesh, screenSize);
+            SAFE_RELEASE(mesh);
+
+            if (p->exists("hysteresis"))
+                model->setLevelHysteresis(p->getFloat("hysteresis"));
+            break;
+        }
         case SceneNodeProperty::PARTICLE:
         {
             ParticleEmitter* particleEmitter = ParticleEmitter::create(p);
@@ -230,7 +293,7 @@ void SceneLoader::applyNodeProperty(SceneNode& sceneNode, Node* node, const Prop
             else
             {
                 // If the scene file specifies a rigid body model, use it for creating the collision object.
-                Properties* np = sceneProperties->getNamespace(sceneNode._nodeID);
+                Properties* np = sceneNode._namespace;
                 const char* name = NULL;
 
                 // Allow both property names
@@ -289,7 +352,7 @@ void SceneLoader::applyNodeProperty(SceneNode& sceneNode, Node* node, const Prop
     else
     {
         // Handle scale, rotate and translate.
-        Properties* np = sceneProperties->getNamespace(sceneNode._nodeID);
+        Properties* np = sceneNode._namespace;
 
         switch (snp._type)
         {
@@ -495,6 +558,7 @@ void SceneLoader::buildReferenceTables(Properties* sceneProperties)
             _sceneNodes.resize(_sceneNodes.size() + 1);
             SceneNode& sceneNode = _sceneNodes[_sceneNodes.size()-1];
             sceneNode._nodeID = ns->getId();
+            sceneNode._namespace = ns;
 
             // Parse the node's sub-namespaces.
             Properties* subns;
@@ -513,6 +577,12 @@ void SceneLoader::buildReferenceTables(Properties* sceneProperties)
                     addSceneNodeProperty(sceneNode, SceneNodeProperty::MATERIAL, propertyUrl.c_str());
                     _properties[propertyUrl] = subns;
                 }
+                else if (strcmp(subns->getNamespace(), "lod") == 0)
+                {
+                    propertyUrl += "lod/" + std::string(subns->getId());
+                    addSceneNodeProperty(sceneNode, SceneNodeProperty::LOD, propertyUrl.c_str());
+                    _properties[propertyUrl] = subns;
+                }
                 else if (strcmp(subns->getNamespace(), "particle") == 0)
                 {
                     propertyUrl += "particle/" + std::string(subns->getId());
@@ -1097,7 +1167,7 @@ void splitURL(const std::string& url, std::string* file, std::string* id)
 }
 
 SceneLoader::SceneNode::SceneNode()
-    : _nodeID(""), _exactMatch(true)
+    : _nodeID(""), _namespace(NULL), _exactMatch(true)
 {
 }
 
@@ -17,6 +17,7 @@ namespace gameplay
 class SceneLoader
 {
     friend class Scene;
+    friend class ResourceLoader;
 
 private:
 
@@ -28,6 +29,14 @@ private:
      * @param url The URL pointing to the Properties object defining the scene.
      */
     static Scene* load(const char* url);
+
+    /**
+     * Loads a scene from a Properties object that was already loaded from the specified URL.
+     *
+     * @param url The URL the properties were loaded from.
+     * @param properties The properties loaded from the URL, which are deleted once the scene is loaded.
+     */
+    static Scene* load(const char* url, Properties* properties);
     
     /**
      * Helper structures and functions for SceneLoader::load(const char*).
@@ -53,7 +62,8 @@ private:
             TRANSLATE = 16,
             ROTATE = 32,
             SCALE = 64,
-            URL = 128
+            URL = 128,
+            LOD = 256
         };
 
         SceneNodeProperty(Type type, const std::string& url, int index);
@@ -68,13 +78,14 @@ private:
         SceneNode();
 
         const char* _nodeID;
+        Properties* _namespace;
         bool _exactMatch;
         std::vector<Node*> _nodes;
         std::vector<SceneNodeProperty> _properties;
         std::map<std::string, std::string> _tags;
     };
 
-    Scene* loadInternal(const char* url);
+    Scene* loadInternal(const char* url, Properties* properties);
 
     void addSceneAnimation(const char* animationID, const char* targetID, const char* url);
 
@@ -1,19 +1,22 @@
 #include "Base.h"
 #include "SpriteBatch.h"
 #include "Game.h"
+#include "Profiler.h"
 
 // Default size of a newly created sprite batch
 #define SPRITE_BATCH_DEFAULT_SIZE 128
 
-// Factor to grow a sprite batch by when its size is exceeded
-#define SPRITE_BATCH_GROW_FACTOR 2.0f
-
 // Macro for adding a sprite to the batch
 #define SPRITE_ADD_VERTEX(vtx, vx, vy, vz, vu, vv, vr, vg, vb, va) \
     vtx.x = vx; vtx.y = vy; vtx.z = vz; \
     vtx.u = vu; vtx.v = vv; \
     vtx.r = vr; vtx.g = vg; vtx.b = vb; vtx.a = va
 
+// Macro for getting a vertex of a sprite in the batch, which is followed by its texture index
+// in batches of several textures
+#define SPRITE_VERTEX(vertices, index) \
+    (*(SpriteVertex*)((unsigned char*)(vertices) + (index) * _vertexSize))
+
 // Default sprite vertex shader
 #define SPRITE_VSH \
     "uniform mat4 u_projectionMatrix;\n" \
@@ -42,30 +45,111 @@
         "gl_FragColor = v_color * texture2D(u_texture, v_texCoord);\n" \
     "}\n"
 
+// Default vertex shader for sprites of several textures
+#define SPRITE_TEXTURES_VSH \
+    "uniform mat4 u_projectionMatrix;\n" \
+    "attribute vec3 a_position;\n" \
+    "attribute vec2 a_texCoord;\n" \
+    "attribute float a_texCoord1;\n" \
+    "attribute vec4 a_color;\n" \
+    "varying vec2 v_texCoord;\n" \
+    "varying float v_textureIndex;\n" \
+    "varying vec4 v_color;\n" \
+    "void main()\n" \
+    "{\n" \
+        "gl_Position = u_projectionMatrix * vec4(a_position, 1);\n" \
+        "v_texCoord = a_texCoord;\n" \
+        "v_textureIndex = a_texCoord1;\n" \
+        "v_color = a_color;\n" \
+    "}\n"
+
+// Default fragment shader for sprites of TEXTURE_COUNT textures, which samples the texture
+// of a sprite's index, since sampler arrays can only be indexed by constants.
+#define SPRITE_TEXTURES_FSH \
+    "#ifdef OPENGL_ES\n" \
+    "precision highp float;\n" \
+    "#endif\n" \
+    "varying vec2 v_texCoord;\n" \
+    "varying float v_textureIndex;\n" \
+    "varying vec4 v_color;\n" \
+    "uniform sampler2D u_texture0;\n" \
+    "uniform sampler2D u_texture1;\n" \
+    "#if TEXTURE_COUNT > 2\n" \
+    "uniform sampler2D u_texture2;\n" \
+    "#endif\n" \
+    "#if TEXTURE_COUNT > 3\n" \
+    "uniform sampler2D u_texture3;\n" \
+    "#endif\n" \
+    "#if TEXTURE_COUNT > 4\n" \
+    "uniform sampler2D u_texture4;\n" \
+    "#endif\n" \
+    "#if TEXTURE_COUNT > 5\n" \
+    "uniform sampler2D u_texture5;\n" \
+    "#endif\n" \
+    "#if TEXTURE_COUNT > 6\n" \
+    "uniform sampler2D u_texture6;\n" \
+    "#endif\n" \
+    "#if TEXTURE_COUNT > 7\n" \
+    "uniform sampler2D u_texture7;\n" \
+    "#endif\n" \
+    "void main()\n" \
+    "{\n" \
+        "vec4 color;\n" \
+        "#if TEXTURE_COUNT > 7\n" \
+        "if (v_textureIndex > 6.5) color = texture2D(u_texture7, v_texCoord); else\n" \
+        "#endif\n" \
+        "#if TEXTURE_COUNT > 6\n" \
+        "if (v_textureIndex > 5.5) color = texture2D(u_texture6, v_texCoord); else\n" \
+        "#endif\n" \
+        "#if TEXTURE_COUNT > 5\n" \
+        "if (v_textureIndex > 4.5) color = texture2D(u_texture5, v_texCoord); else\n" \
+        "#endif\n" \
+        "#if TEXTURE_COUNT > 4\n" \
+        "if (v_textureIndex > 3.5) color = texture2D(u_texture4, v_texCoord); else\n" \
+        "#endif\n" \
+        "#if TEXTURE_COUNT > 3\n" \
+        "if (v_textureIndex > 2.5) color = texture2D(u_texture3, v_texCoord); else\n" \
+        "#endif\n" \
+        "#if TEXTURE_COUNT > 2\n" \
+        "if (v_textureIndex > 1.5) color = texture2D(u_texture2, v_texCoord); else\n" \
+        "#endif\n" \
+        "if (v_textureIndex > 0.5) color = texture2D(u_texture1, v_texCoord); else\n" \
+        "color = texture2D(u_texture0, v_texCoord);\n" \
+        "gl_FragColor = v_color * color;\n" \
+    "}\n"
+
 namespace gameplay
 {
 
-static Effect* __spriteEffect = NULL;
+// Default sprite effects, by number of textures
+static Effect* __spriteEffects[SPRITE_BATCH_MAX_TEXTURES] = { NULL };
+
+// Indices of the triangle strip of a sprite
+static const unsigned short __spriteIndices[4] = { 0, 1, 2, 3 };
 
 SpriteBatch::SpriteBatch()
-    : _batch(NULL), _sampler(NULL), _textureWidthRatio(0.0f), _textureHeightRatio(0.0f)
+    : _batch(NULL), _textureIndex(0), _vertexSize(sizeof(SpriteVertex)), _textureWidthRatio(0.0f), _textureHeightRatio(0.0f)
 {
 }
 
 SpriteBatch::~SpriteBatch()
 {
     SAFE_DELETE(_batch);
-    SAFE_RELEASE(_sampler);
+    for (size_t i = 0, count = _samplers.size(); i < count; ++i)
+    {
+        SAFE_RELEASE(_samplers[i]);
+    }
     if (!_customEffect)
     {
-        if (__spriteEffect && __spriteEffect->getRefCount() == 1)
+        Effect*& spriteEffect = __spriteEffects[_samplers.size() - 1];
+        if (spriteEffect && spriteEffect->getRefCount() == 1)
         {
-            __spriteEffect->release();
-            __spriteEffect = NULL;
+            spriteEffect->release();
+            spriteEffect = NULL;
         }
         else
         {
-            __spriteEffect->release();
+            spriteEffect->release();
         }
     }
 }
@@ -82,43 +166,80 @@ SpriteBatch* SpriteBatch::create(Texture* texture, Effect* effect, unsigned int
 {
     GP_ASSERT(texture != NULL);
 
+    return create(&texture, 1, effect, initialCapacity);
+}
+
+SpriteBatch* SpriteBatch::create(Texture** textures, unsigned int textureCount, Effect* effect, unsigned int initialCapacity)
+{
+    GP_ASSERT(textures);
+    GP_ASSERT(textureCount > 0 && textureCount <= SPRITE_BATCH_MAX_TEXTURES);
+
     bool customEffect = (effect != NULL);
     if (!customEffect)
     {
-        // Create our static sprite effect.
-        if (__spriteEffect == NULL)
+        // Create our static sprite effect for the number of textures.
+        Effect*& spriteEffect = __spriteEffects[textureCount - 1];
+        if (spriteEffect == NULL)
         {
-            __spriteEffect = Effect::createFromSource(SPRITE_VSH, SPRITE_FSH);
-            if (__spriteEffect == NULL)
+            if (textureCount == 1)
+            {
+                spriteEffect = Effect::createFromSource(SPRITE_VSH, SPRITE_FSH);
+            }
+            else
+            {
+                char defines[32];
+                sprintf(defines, "TEXTURE_COUNT %u", textureCount);
+                spriteEffect = Effect::createFromSource(SPRITE_TEXTURES_VSH, SPRITE_TEXTURES_FSH, defines);
+            }
+            if (spriteEffect == NULL)
             {
                 GP_ERROR("Unable to load sprite effect.");
                 return NULL;
             }
-            effect = __spriteEffect;
+            effect = spriteEffect;
         }
         else
         {
-            effect = __spriteEffect;
-            __spriteEffect->addRef();
+            effect = spriteEffect;
+            spriteEffect->addRef();
         }
     }
 
-    // Search for the first sampler uniform in the effect.
-    Uniform* samplerUniform = NULL;
-    for (unsigned int i = 0, count = effect->getUniformCount(); i < count; ++i)
+    // Search for the first sampler uniform in the effect, or the sampler uniform of each texture.
+    std::vector<Uniform*> samplerUniforms;
+    if (textureCount == 1)
     {
-        Uniform* uniform = effect->getUniform(i);
-        if (uniform && uniform->getType() == GL_SAMPLER_2D)
+        for (unsigned int i = 0, count = effect->getUniformCount(); i < count; ++i)
         {
-            samplerUniform = uniform;
-            break;
+            Uniform* uniform = effect->getUniform(i);
+            if (uniform && uniform->getType() == GL_SAMPLER_2D)
+            {
+                samplerUniforms.push_back(uniform);
+                break;
+            }
+        }
+        if (samplerUniforms.empty())
+        {
+            GP_ERROR("No uniform of type GL_SAMPLER_2D found in sprite effect.");
+            SAFE_RELEASE(effect);
+            return NULL;
         }
     }
-    if (!samplerUniform)
+    else
     {
-        GP_ERROR("No uniform of type GL_SAMPLER_2D found in sprite effect.");
-        SAFE_RELEASE(effect);
-        return NULL;
+        for (unsigned int i = 0; i < textureCount; ++i)
+        {
+            char name[20]; // "u_texture" followed by up to ten digits.
+            sprintf(name, "u_texture%u", i);
+            Uniform* uniform = effect->getUniform(name);
+            if (uniform == NULL || uniform->getType() != GL_SAMPLER_2D)
+            {
+                GP_ERROR("No uniform '%s' of type GL_SAMPLER_2D found in sprite effect.", name);
+                SAFE_RELEASE(effect);
+                return NULL;
+            }
+            samplerUniforms.push_back(uniform);
+        }
     }
 
     // Wrap the effect in a material
@@ -129,30 +250,38 @@ SpriteBatch* SpriteBatch::create(Texture* texture, Effect* effect, unsigned int
     material->getStateBlock()->setBlendSrc(RenderState::BLEND_SRC_ALPHA);
     material->getStateBlock()->setBlendDst(RenderState::BLEND_ONE_MINUS_SRC_ALPHA);
 
-    // Bind the texture to the material as a sampler
-    Texture::Sampler* sampler = Texture::Sampler::create(texture); // +ref texture
-    material->getParameter(samplerUniform->getName())->setValue(sampler);
-    
-    // Define the vertex format for the batch
+    // Bind the textures to the material as samplers
+    std::vector<Texture::Sampler*> samplers;
+    for (unsigned int i = 0; i < textureCount; ++i)
+    {
+        GP_ASSERT(textures[i]);
+        Texture::Sampler* sampler = Texture::Sampler::create(textures[i]); // +ref texture
+        material->getParameter(samplerUniforms[i]->getName())->setValue(sampler);
+        samplers.push_back(sampler);
+    }
+
+    // Define the vertex format for the batch, with the texture index of each vertex when there are several textures
     VertexFormat::Element vertexElements[] =
     {
         VertexFormat::Element(VertexFormat::POSITION, 3),
         VertexFormat::Element(VertexFormat::TEXCOORD0, 2),
-        VertexFormat::Element(VertexFormat::COLOR, 4)
+        VertexFormat::Element(VertexFormat::COLOR, 4),
+        VertexFormat::Element(VertexFormat::TEXCOORD1, 1)
     };
-    VertexFormat vertexFormat(vertexElements, 3);
+    VertexFormat vertexFormat(vertexElements, textureCount > 1 ? 4 : 3);
 
     // Create the mesh batch
     MeshBatch* meshBatch = MeshBatch::create(vertexFormat, Mesh::TRIANGLE_STRIP, material, true, initialCapacity > 0 ? initialCapacity : SPRITE_BATCH_DEFAULT_SIZE);
+    meshBatch->setStreaming(true);
     material->release(); // don't call SAFE_RELEASE since material is used below
 
     // Create the batch
     SpriteBatch* batch = new SpriteBatch();
-    batch->_sampler = sampler;
+    batch->_samplers = samplers;
     batch->_customEffect = customEffect;
     batch->_batch = meshBatch;
-    batch->_textureWidthRatio = 1.0f / (float)texture->getWidth();
-    batch->_textureHeightRatio = 1.0f / (float)texture->getHeight();
+    batch->_vertexSize = vertexFormat.getVertexSize();
+    batch->setTextureIndex(0);
 
     // Bind an ortho projection to the material by default (user can override with setProjectionMatrix)
     Game* game = Game::getInstance();
@@ -161,6 +290,40 @@ SpriteBatch* SpriteBatch::create(Texture* texture, Effect* effect, unsigned int
     return batch;
 }
 
+unsigned int SpriteBatch::getTextureCount() const
+{
+    return (unsigned int)_samplers.size();
+}
+
+unsigned int SpriteBatch::getTextureIndex() const
+{
+    return _textureIndex;
+}
+
+void SpriteBatch::setTextureIndex(unsigned int index)
+{
+    GP_ASSERT(index < _samplers.size());
+
+    _textureIndex = index;
+    Texture* texture = _samplers[index]->getTexture();
+    _textureWidthRatio = 1.0f / (float)texture->getWidth();
+    _textureHeightRatio = 1.0f / (float)texture->getHeight();
+}
+
+SpriteBatch::SpriteVertex* SpriteBatch::addSpriteVertices()
+{
+    unsigned char* vertices = _batch->addVertices(4, __spriteIndices, 4);
+    if (vertices && _vertexSize != sizeof(SpriteVertex))
+    {
+        float textureIndex = (float)_textureIndex;
+        for (unsigned int i = 0; i < 4; ++i)
+        {
+            *(float*)(vertices + i * _vertexSize + sizeof(SpriteVertex)) = textureIndex;
+        }
+    }
+    return (SpriteVertex*)vertices;
+}
+
 void SpriteBatch::start()
 {
     _batch->start();
@@ -236,16 +399,14 @@ void SpriteBatch::draw(float x, float y, float z, float width, float height, flo
     downLeft.rotate(pivotPoint, rotationAngle);
     downRight.rotate(pivotPoint, rotationAngle);
 
-    // Write sprite vertex data.
-    static SpriteVertex v[4];
-    SPRITE_ADD_VERTEX(v[0], downLeft.x, downLeft.y, z, u1, v1, color.x, color.y, color.z, color.w);
-    SPRITE_ADD_VERTEX(v[1], upLeft.x, upLeft.y, z, u1, v2, color.x, color.y, color.z, color.w);
-    SPRITE_ADD_VERTEX(v[2], downRight.x, downRight.y, z, u2, v1, color.x, color.y, color.z, color.w);
-    SPRITE_ADD_VERTEX(v[3], upRight.x, upRight.y, z, u2, v2, color.x, color.y, color.z, color.w);
-    
-    static unsigned short indices[4] = { 0, 1, 2, 3 };
-
-    _batch->add(v, 4, indices, 4);
+    // Write sprite vertex data directly to the batch.
+    SpriteVertex* v = addSpriteVertices();
+    if (v == NULL)
+        return;
+    SPRITE_ADD_VERTEX(SPRITE_VERTEX(v, 0), downLeft.x, downLeft.y, z, u1, v1, color.x, color.y, color.z, color.w);
+    SPRITE_ADD_VERTEX(SPRITE_VERTEX(v, 1), upLeft.x, upLeft.y, z, u1, v2, color.x, color.y, color.z, color.w);
+    SPRITE_ADD_VERTEX(SPRITE_VERTEX(v, 2), downRight.x, downRight.y, z, u2, v1, color.x, color.y, color.z, color.w);
+    SPRITE_ADD_VERTEX(SPRITE_VERTEX(v, 3), upRight.x, upRight.y, z, u2, v2, color.x, color.y, color.z, color.w);
 }
 
 void SpriteBatch::draw(const Vector3& position, const Vector3& right, const Vector3& forward, float width, float height,
@@ -303,14 +464,13 @@ void SpriteBatch::draw(const Vector3& position, const Vector3& right, const Vect
     p3 += rp;
 
     // Add the sprite vertex data to the batch.
-    static SpriteVertex v[4];
-    SPRITE_ADD_VERTEX(v[0], p0.x, p0.y, p0.z, u1, v1, color.x, color.y, color.z, color.w);
-    SPRITE_ADD_VERTEX(v[1], p1.x, p1.y, p1.z, u2, v1, color.x, color.y, color.z, color.w);
-    SPRITE_ADD_VERTEX(v[2], p2.x, p2.y, p2.z, u1, v2, color.x, color.y, color.z, color.w);
-    SPRITE_ADD_VERTEX(v[3], p3.x, p3.y, p3.z, u2, v2, color.x, color.y, color.z, color.w);
-    
-    static const unsigned short indices[4] = { 0, 1, 2, 3 };
-    _batch->add(v, 4, const_cast<unsigned short*>(indices), 4);
+    SpriteVertex* v = addSpriteVertices();
+    if (v == NULL)
+        return;
+    SPRITE_ADD_VERTEX(SPRITE_VERTEX(v, 0), p0.x, p0.y, p0.z, u1, v1, color.x, color.y, color.z, color.w);
+    SPRITE_ADD_VERTEX(SPRITE_VERTEX(v, 1), p1.x, p1.y, p1.z, u2, v1, color.x, color.y, color.z, color.w);
+    SPRITE_ADD_VERTEX(SPRITE_VERTEX(v, 2), p2.x, p2.y, p2.z, u1, v2, color.x, color.y, color.z, color.w);
+    SPRITE_ADD_VERTEX(SPRITE_VERTEX(v, 3), p3.x, p3.y, p3.z, u2, v2, color.x, color.y, color.z, color.w);
 }
 
 void SpriteBatch::draw(float x, float y, float width, float height, float u1, float v1, float u2, float v2, const Vector4& color)
@@ -358,7 +518,23 @@ void SpriteBatch::draw(SpriteBatch::SpriteVertex* vertices, unsigned int vertexC
     GP_ASSERT(vertices);
     GP_ASSERT(indices);
 
-    _batch->add(vertices, vertexCount, indices, indexCount);
+    if (_vertexSize == sizeof(SpriteVertex))
+    {
+        _batch->add(vertices, vertexCount, indices, indexCount);
+        return;
+    }
+
+    // Append the texture index to the vertices.
+    unsigned char* data = _batch->addVertices(vertexCount, indices, indexCount);
+    if (data)
+    {
+        float textureIndex = (float)_textureIndex;
+        for (unsigned int i = 0; i < vertexCount; ++i, data += _vertexSize)
+        {
+            memcpy(data, &vertices[i], sizeof(SpriteVertex));
+            *(float*)(data + sizeof(SpriteVertex)) = textureIndex;
+        }
+    }
 }
 
 void SpriteBatch::draw(float x, float y, float z, float width, float height, float u1, float v1, float u2, float v2, const Vector4& color, bool positionIsCenter)
@@ -370,27 +546,37 @@ void SpriteBatch::draw(float x, float y, float z, float width, float height, flo
         y -= 0.5f * height;
     }
 
-    // Write sprite vertex data.
+    // Write sprite vertex data directly to the batch.
+    SpriteVertex* v = addSpriteVertices();
+    if (v == NULL)
+        return;
     const float x2 = x + width;
     const float y2 = y + height;
-    static SpriteVertex v[4];
-    SPRITE_ADD_VERTEX(v[0], x, y, z, u1, v1, color.x, color.y, color.z, color.w);
-    SPRITE_ADD_VERTEX(v[1], x, y2, z, u1, v2, color.x, color.y, color.z, color.w);
-    SPRITE_ADD_VERTEX(v[2], x2, y, z, u2, v1, color.x, color.y, color.z, color.w);
-    SPRITE_ADD_VERTEX(v[3], x2, y2, z, u2, v2, color.x, color.y, color.z, color.w);
-
-    static unsigned short indices[4] = { 0, 1, 2, 3 };
-
-    _batch->add(v, 4, indices, 4);
+    SPRITE_ADD_VERTEX(SPRITE_VERTEX(v, 0), x, y, z, u1, v1, color.x, color.y, color.z, color.w);
+    SPRITE_ADD_VERTEX(SPRITE_VERTEX(v, 1), x, y2, z, u1, v2, color.x, color.y, color.z, color.w);
+    SPRITE_ADD_VERTEX(SPRITE_VERTEX(v, 2), x2, y, z, u2, v1, color.x, color.y, color.z, color.w);
+    SPRITE_ADD_VERTEX(SPRITE_VERTEX(v, 3), x2, y2, z, u2, v2, color.x, color.y, color.z, color.w);
 }
 
 void SpriteBatch::finish()
 {
+    Profiler::Scope profilerScope("SpriteBatch::finish");
+
     // Finish and draw the batch
     _batch->finish();
     _batch->draw();
 }
 
+bool SpriteBatch::isStreaming() const
+{
+    return _batch->isStreaming();
+}
+
+void SpriteBatch::setStreaming(bool streaming)
+{
+    _batch->setStreaming(streaming);
+}
+
 RenderState::StateBlock* SpriteBatch::getStateBlock() const
 {
     return _batch->getMaterial()->getStateBlock();
@@ -398,7 +584,14 @@ RenderState::StateBlock* SpriteBatch::getStateBlock() const
 
 Texture::Sampler* SpriteBatch::getSampler() const
 {
-    return _sampler;
+    return _samplers[0];
+}
+
+Texture::Sampler* SpriteBatch::getSampler(unsigned int index) const
+{
+    GP_ASSERT(index < _samplers.size());
+
+    return _samplers[index];
 }
 
 Material* SpriteBatch::getMaterial() const
@@ -9,6 +9,9 @@
 #include "RenderState.h"
 #include "MeshBatch.h"
 
+// The maximum number of textures of a sprite batch
+#define SPRITE_BATCH_MAX_TEXTURES 8
+
 namespace gameplay
 {
 
@@ -16,10 +19,11 @@ namespace gameplay
  * Enables groups of sprites to be drawn with common settings.
  *
  * This class provides efficient rendering and sorting of two-dimensional
- * sprites. Only a single texture and effect can be used with a SpriteBatch.
- * This limitation promotes efficient batching by using texture atlases and
- * implicit sorting to minimize state changes. Therefore, it is highly
- * recommended to combine multiple small textures into larger texture atlases
+ * sprites. Only a single effect, and a single texture or a few textures
+ * selected per sprite, can be used with a SpriteBatch. This limitation
+ * promotes efficient batching by using texture atlases and implicit sorting
+ * to minimize state changes. Therefore, it is highly recommended to combine
+ * multiple small textures into larger texture atlases (see TextureAtlas)
  * where possible when drawing sprites.
  */
 class SpriteBatch
@@ -83,6 +87,30 @@ public:
      */
     static SpriteBatch* create(Texture* texture, Effect* effect = NULL, unsigned int initialCapacity = 0);
 
+    /**
+     * Creates a new SpriteBatch for drawing sprites with any of several textures.
+     *
+     * Each sprite is drawn with the texture selected by setTextureIndex when it is
+     * drawn, so sprites of different textures are drawn together without flushing
+     * the batch. The texture index is passed to the effect as a float vertex attribute
+     * named by VERTEX_ATTRIBUTE_TEXCOORD_PREFIX_NAME followed by 1, and the texture of
+     * each index is bound to a sampler uniform named u_texture followed by the index.
+     *
+     * If the effect parameter is NULL, a default effect is used, whose fragment shader
+     * selects between the textures with a chain of branches, so batches of fewer textures
+     * are cheaper to draw. The requirements of custom effects are otherwise the same as
+     * for batches of a single texture.
+     *
+     * @param textures The textures for this sprite batch.
+     * @param textureCount The number of textures, up to SPRITE_BATCH_MAX_TEXTURES.
+     * @param effect An optional effect to use with the SpriteBatch.
+     * @param initialCapacity An optional initial capacity of the batch (number of sprites).
+     *
+     * @return A new SpriteBatch for drawing sprites using the given textures.
+     * @script{ignore}
+     */
+    static SpriteBatch* create(Texture** textures, unsigned int textureCount, Effect* effect = NULL, unsigned int initialCapacity = 0);
+
     /**
      * Destructor.
      */
@@ -254,6 +282,39 @@ public:
      */
     Texture::Sampler* getSampler() const;
 
+    /**
+     * Gets the sampler of a texture of the batch.
+     *
+     * @param index The index of the texture.
+     *
+     * @return The sampler of the texture.
+     */
+    Texture::Sampler* getSampler(unsigned int index) const;
+
+    /**
+     * Gets the number of textures of the batch.
+     *
+     * @return The number of textures.
+     */
+    unsigned int getTextureCount() const;
+
+    /**
+     * Gets the index of the texture that sprites are drawn with.
+     *
+     * @return The index of the texture.
+     */
+    unsigned int getTextureIndex() const;
+
+    /**
+     * Sets the index of the texture that the sprites drawn next are drawn with.
+     *
+     * Source rectangles given in pixels are relative to the size of this texture.
+     * The texture can be changed between start() and finish().
+     *
+     * @param index The index of the texture.
+     */
+    void setTextureIndex(unsigned int index);
+
     /**
      * Gets the StateBlock for the SpriteBatch.
      *
@@ -272,6 +333,29 @@ public:
      */
     Material* getMaterial() const;
 
+    /**
+     * Determines if the batch streams its sprites to buffers on the graphics device.
+     *
+     * @return true if the batch is streaming, false if it draws from client memory.
+     *
+     * @see MeshBatch::isStreaming
+     */
+    bool isStreaming() const;
+
+    /**
+     * Sets whether the batch streams its sprites to buffers on the graphics device,
+     * which sprite batches do by default.
+     *
+     * A batch drawn from client memory is limited to 16-bit indices, so it holds at
+     * most 10922 sprites between start() and finish(), while a streaming batch is not
+     * limited.
+     *
+     * @param streaming true to stream the batch, false to draw it from client memory.
+     *
+     * @see MeshBatch::setStreaming
+     */
+    void setStreaming(bool streaming);
+
     /**
      * Sets a custom projection matrix to use with the sprite batch.
      *
@@ -371,8 +455,17 @@ private:
      */
     bool clipSprite(const Rectangle& clip, float& x, float& y, float& width, float& height, float& u1, float& v1, float& u2, float& v2);
 
+    /**
+     * Adds the vertices of a sprite to the batch, setting their texture index.
+     *
+     * @return The vertices to write, or NULL if the batch is full.
+     */
+    SpriteVertex* addSpriteVertices();
+
     MeshBatch* _batch;
-    Texture::Sampler* _sampler;
+    std::vector<Texture::Sampler*> _samplers;
+    unsigned int _textureIndex;
+    unsigned int _vertexSize;
     bool _customEffect;
     float _textureWidthRatio;
     float _textureHeightRatio;
@@ -2,6 +2,8 @@
 #include "Image.h"
 #include "Texture.h"
 #include "FileSystem.h"
+#include "ResourceCache.h"
+#include "RenderQueue.h"
 
 // PVRTC (GL_IMG_texture_compression_pvrtc) : Imagination based gpus
 #ifndef GL_COMPRESSED_RGB_PVRTC_2BPPV1_IMG
@@ -42,17 +44,57 @@
 namespace gameplay
 {
 
-static std::vector<Texture*> __textureCache;
+// The number of texture units whose bound texture is tracked.
+#define TEXTURE_UNIT_COUNT 32
+
 static TextureHandle __currentTextureId;
+static TextureHandle __boundTextures[TEXTURE_UNIT_COUNT];
+static unsigned int __activeTextureUnit = 0;
+
+/**
+ * Gets the memory used by a texture, assuming one byte per pixel for compressed formats.
+ */
+static size_t __getMemorySize(const Texture* texture)
+{
+    size_t bytesPerPixel = 1;
+    if (!texture->isCompressed())
+    {
+        switch (texture->getFormat())
+        {
+        case Texture::RGB:
+            bytesPerPixel = 3;
+            break;
+        case Texture::RGBA:
+            bytesPerPixel = 4;
+            break;
+        default:
+            break;
+        }
+    }
+
+    size_t size = (size_t)texture->getWidth() * texture->getHeight() * bytesPerPixel;
 
-Texture::Texture() : _handle(0), _format(UNKNOWN), _width(0), _height(0), _mipmapped(false), _cached(false), _compressed(false)
+    // A full mipmap chain adds a third.
+    return texture->isMipmapped() ? size + size / 3 : size;
+}
+
+Texture::Texture() : _handle(0), _format(UNKNOWN), _width(0), _height(0), _mipmapped(false), _cached(false), _compressed(false),
+    _wrapS((Wrap)0), _wrapT((Wrap)0), _minFilter((Filter)0), _magFilter((Filter)0)
 {
+    // The sampler state of the texture object is unknown until it is first set.
 }
 
 Texture::~Texture()
 {
     if (_handle)
     {
+        // Deleting a texture unbinds it from every unit.
+        for (unsigned int i = 0; i < TEXTURE_UNIT_COUNT; ++i)
+        {
+            if (__boundTextures[i] == _handle)
+                __boundTextures[i] = 0;
+        }
+
         GL_ASSERT( glDeleteTextures(1, &_handle) );
         _handle = 0;
     }
@@ -60,11 +102,7 @@ Texture::~Texture()
     // Remove ourself from the texture cache.
     if (_cached)
     {
-        std::vector<Texture*>::iterator itr = std::find(__textureCache.begin(), __textureCache.end(), this);
-        if (itr != __textureCache.end())
-        {
-            __textureCache.erase(itr);
-        }
+        ResourceCache::remove(this);
     }
 }
 
@@ -73,27 +111,9 @@ Texture* Texture::create(const char* path, bool generateMipmaps)
     GP_ASSERT(path);
 
     // Search texture cache first.
-    for (size_t i = 0, count = __textureCache.size(); i < count; ++i)
-    {
-        Texture* t = __textureCache[i];
-        GP_ASSERT(t);
-        if (t->_path == path)
-        {
-            // If 'generateMipmaps' is true, call Texture::generateMipamps() to force the 
-            // texture to generate its mipmap chain if it hasn't already done so.
-            if (generateMipmaps)
-            {
-                t->generateMipmaps();
-            }
-
-            // Found a match.
-            t->addRef();
-
-            return t;
-        }
-    }
-
-    Texture* texture = NULL;
+    Texture* texture = findCached(path, generateMipmaps);
+    if (texture)
+        return texture;
 
     // Filter loading based on file extension.
     const char* ext = strrchr(FileSystem::resolvePath(path), '.');
@@ -125,12 +145,7 @@ Texture* Texture::create(const char* path, bool generateMipmaps)
 
     if (texture)
     {
-        texture->_path = path;
-        texture->_cached = true;
-
-        // Add to texture cache.
-        __textureCache.push_back(texture);
-
+        texture->addToCache(path);
         return texture;
     }
 
@@ -138,6 +153,38 @@ Texture* Texture::create(const char* path, bool generateMipmaps)
     return NULL;
 }
 
+Texture* Texture::findCached(const char* path, bool generateMipmaps)
+{
+    GP_ASSERT(path);
+
+    Texture* t = static_cast<Texture*>(ResourceCache::find(ResourceCache::TEXTURE, ResourceCache::getPathKey(path)));
+    if (t)
+    {
+        // Found a match. Take the reference first so that the cache does not trim the
+        // texture when generating mipmaps grows it over the budget.
+        t->addRef();
+
+        // If 'generateMipmaps' is true, call Texture::generateMipamps() to force the 
+        // texture to generate its mipmap chain if it hasn't already done so.
+        if (generateMipmaps)
+        {
+            t->generateMipmaps();
+        }
+    }
+
+    return t;
+}
+
+void Texture::addToCache(const char* path)
+{
+    GP_ASSERT(path);
+    GP_ASSERT(!_cached);
+
+    _path = path;
+    _cached = true;
+    ResourceCache::add(ResourceCache::TEXTURE, ResourceCache::getPathKey(path), this, __getMemorySize(this));
+}
+
 Texture* Texture::create(Image* image, bool generateMipmaps)
 {
     GP_ASSERT(image);
@@ -159,7 +206,7 @@ Texture* Texture::create(Format format, unsigned int width, unsigned int height,
     // Create and load the texture.
     GLuint textureId;
     GL_ASSERT( glGenTextures(1, &textureId) );
-    GL_ASSERT( glBindTexture(GL_TEXTURE_2D, textureId) );
+    bindHandle(textureId);
     GL_ASSERT( glPixelStorei(GL_UNPACK_ALIGNMENT, 1) );
     GL_ASSERT( glTexImage2D(GL_TEXTURE_2D, 0, (GLenum)format, width, height, 0, (GLenum)format, GL_UNSIGNED_BYTE, data) );
 
@@ -177,7 +224,7 @@ Texture* Texture::create(Format format, unsigned int width, unsigned int height,
     }
 
     // Restore the texture id
-    GL_ASSERT( glBindTexture(GL_TEXTURE_2D, __currentTextureId) );
+    bindHandle(__currentTextureId);
 
     return texture;
 }
@@ -292,7 +339,7 @@ Texture* Texture::createCompressedPVRTC(const char* path)
     // Generate our texture.
     GLuint textureId;
     GL_ASSERT( glGenTextures(1, &textureId) );
-    GL_ASSERT( glBindTexture(GL_TEXTURE_2D, textureId) );
+    bindHandle(textureId);
     GL_ASSERT( glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mipMapCount > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR) );
 
     Texture* texture = new Texture();
@@ -719,7 +766,7 @@ Texture* Texture::createCompressedDDS(const char* path)
     // Generate GL texture.
     GLuint textureId;
     GL_ASSERT( glGenTextures(1, &textureId) );
-    GL_ASSERT( glBindTexture(GL_TEXTURE_2D, textureId) );
+    bindHandle(textureId);
     GL_ASSERT( glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, header.dwMipMapCount > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR ) );
 
     // Create gameplay texture.
@@ -775,26 +822,71 @@ TextureHandle Texture::getHandle() const
 
 void Texture::setWrapMode(Wrap wrapS, Wrap wrapT)
 {
-    GL_ASSERT( glBindTexture(GL_TEXTURE_2D, _handle) );
+    bindHandle(_handle);
     GL_ASSERT( glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, (GLenum)wrapS) );
     GL_ASSERT( glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, (GLenum)wrapT) );
+    _wrapS = wrapS;
+    _wrapT = wrapT;
 }
 
 void Texture::setFilterMode(Filter minificationFilter, Filter magnificationFilter)
 {
-    GL_ASSERT( glBindTexture(GL_TEXTURE_2D, _handle) );
+    bindHandle(_handle);
     GL_ASSERT( glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, (GLenum)minificationFilter) );
     GL_ASSERT( glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, (GLenum)magnificationFilter) );
+    _minFilter = minificationFilter;
+    _magFilter = magnificationFilter;
+}
+
+void Texture::setActiveUnit(unsigned int unit)
+{
+    if (unit != __activeTextureUnit)
+    {
+        GL_ASSERT( glActiveTexture(GL_TEXTURE0 + unit) );
+        __activeTextureUnit = unit;
+    }
+}
+
+void Texture::bindHandle(TextureHandle handle)
+{
+    // Units beyond the tracked ones are always bound.
+    if (__activeTextureUnit < TEXTURE_UNIT_COUNT)
+    {
+        if (__boundTextures[__activeTextureUnit] == handle)
+            return;
+        __boundTextures[__activeTextureUnit] = handle;
+    }
+
+    GL_ASSERT( glBindTexture(GL_TEXTURE_2D, handle) );
+    ++RenderQueue::_frameCounters.textureBinds;
+}
+
+void Texture::setData(const unsigned char* data)
+{
+    GP_ASSERT(data);
+    GP_ASSERT(!_compressed);
+
+    bindHandle(_handle);
+    GL_ASSERT( glPixelStorei(GL_UNPACK_ALIGNMENT, 1) );
+    GL_ASSERT( glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, _width, _height, (GLenum)_format, GL_UNSIGNED_BYTE, data) );
+    if (_mipmapped)
+    {
+        GL_ASSERT( glGenerateMipmap(GL_TEXTURE_2D) );
+    }
 }
 
 void Texture::generateMipmaps()
 {
     if (!_mipmapped)
     {
-        GL_ASSERT( glBindTexture(GL_TEXTURE_2D, _handle) );
+        bindHandle(_handle);
         GL_ASSERT( glGenerateMipmap(GL_TEXTURE_2D) );
 
         _mipmapped = true;
+
+        // The mipmaps add to the memory the cache accounted for when the texture was added.
+        if (_cached)
+            ResourceCache::setSize(this, __getMemorySize(this));
     }
 }
 
@@ -854,11 +946,23 @@ void Texture::Sampler::bind()
 {
     GP_ASSERT(_texture);
 
-    GL_ASSERT( glBindTexture(GL_TEXTURE_2D, _texture->_handle) );
-    GL_ASSERT( glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, (GLenum)_wrapS) );
-    GL_ASSERT( glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, (GLenum)_wrapT) );
-    GL_ASSERT( glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, (GLenum)_minFilter) );
-    GL_ASSERT( glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, (GLenum)_magFilter) );
+    Texture::bindHandle(_texture->_handle);
+
+    // Only apply the sampler state that differs from the state of the texture object.
+    if (_texture->_wrapS != _wrapS || _texture->_wrapT != _wrapT)
+    {
+        GL_ASSERT( glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, (GLenum)_wrapS) );
+        GL_ASSERT( glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, (GLenum)_wrapT) );
+        _texture->_wrapS = _wrapS;
+        _texture->_wrapT = _wrapT;
+    }
+    if (_texture->_minFilter != _minFilter || _texture->_magFilter != _magFilter)
+    {
+        GL_ASSERT( glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, (GLenum)_minFilter) );
+        GL_ASSERT( glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, (GLenum)_magFilter) );
+        _texture->_minFilter = _minFilter;
+        _texture->_magFilter = _magFilter;
+    }
 }
 
 }
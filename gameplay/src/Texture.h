@@ -14,6 +14,8 @@ class Image;
 class Texture : public Ref
 {
     friend class Sampler;
+    friend class ResourceLoader;
+    friend class Effect;
 
 public:
 
@@ -235,6 +237,16 @@ public:
      */
     void setFilterMode(Filter minificationFilter, Filter magnificationFilter);
 
+    /**
+     * Replaces the data of this texture.
+     *
+     * The data must be in the format and of the size of the texture, which must not be
+     * compressed. The mipmap chain of a mipmapped texture is generated again.
+     *
+     * @param data The new texture data.
+     */
+    void setData(const unsigned char* data);
+
     /**
      * Generates a full mipmap chain for this texture if it isn't already mipmapped.
      */
@@ -281,6 +293,39 @@ private:
      */
     Texture& operator=(const Texture&);
 
+    /**
+     * Gets the cached texture loaded from the given path and increments its reference count.
+     *
+     * @param path The path the texture was loaded from.
+     * @param generateMipmaps true to generate the mipmap chain of the cached texture if it has none.
+     *
+     * @return The cached texture, or NULL if no texture was loaded from the path.
+     */
+    static Texture* findCached(const char* path, bool generateMipmaps);
+
+    /**
+     * Adds this texture to the texture cache as loaded from the given path.
+     *
+     * @param path The path the texture was loaded from.
+     */
+    void addToCache(const char* path);
+
+    /**
+     * Makes a texture unit active, unless it already is.
+     *
+     * @param unit The index of the texture unit.
+     */
+    static void setActiveUnit(unsigned int unit);
+
+    /**
+     * Binds a texture to the active texture unit, unless it is already bound to it.
+     *
+     * All texture binds go through this method, so that the texture bound to each unit is known.
+     *
+     * @param handle The texture to bind.
+     */
+    static void bindHandle(TextureHandle handle);
+
     static Texture* createCompressedPVRTC(const char* path);
 
     static Texture* createCompressedDDS(const char* path);
@@ -297,6 +342,10 @@ private:
     bool _mipmapped;
     bool _cached;
     bool _compressed;
+    Wrap _wrapS;
+    Wrap _wrapT;
+    Filter _minFilter;
+    Filter _magFilter;
 };
 
 }
@@ -0,0 +1,283 @@
+#include "Base.h"
+#include "TextureAtlas.h"
+#include "Image.h"
+
+namespace gameplay
+{
+
+TextureAtlas::TextureAtlas(unsigned int pageWidth, unsigned int pageHeight, unsigned int padding)
+    : _pageWidth(pageWidth), _pageHeight(pageHeight), _padding(padding)
+{
+}
+
+TextureAtlas::~TextureAtlas()
+{
+    for (size_t i = 0, count = _pages.size(); i < count; ++i)
+    {
+        SAFE_RELEASE(_pages[i]->sampler);
+        SAFE_DELETE(_pages[i]);
+    }
+}
+
+TextureAtlas* TextureAtlas::create(unsigned int pageWidth, unsigned int pageHeight, unsigned int padding)
+{
+    GP_ASSERT(pageWidth > 2 * padding && pageHeight > 2 * padding);
+
+    return new TextureAtlas(pageWidth, pageHeight, padding);
+}
+
+bool TextureAtlas::add(const char* path)
+{
+    GP_ASSERT(path);
+
+    if (contains(path))
+        return true;
+
+    Image* image = Image::create(path);
+    if (image == NULL)
+    {
+        GP_WARN("Failed to load image '%s' for texture atlas.", path);
+        return false;
+    }
+    bool added = add(path, image);
+    SAFE_RELEASE(image);
+    return added;
+}
+
+bool TextureAtlas::add(const char* id, Image* image)
+{
+    GP_ASSERT(id);
+    GP_ASSERT(image);
+    GP_ASSERT(!contains(id));
+
+    unsigned int width = image->getWidth() + 2 * _padding;
+    unsigned int height = image->getHeight() + 2 * _padding;
+    if (width > _pageWidth || height > _pageHeight)
+    {
+        GP_WARN("Image '%s' (%ux%u) is larger than the pages of the texture atlas (%ux%u).", id, image->getWidth(), image->getHeight(), _pageWidth, _pageHeight);
+        return false;
+    }
+
+    // Place the image in the first page with room for it, or in a new page.
+    unsigned int pageIndex = 0;
+    unsigned int y = 0;
+    int span = -1;
+    for (unsigned int count = (unsigned int)_pages.size(); pageIndex < count; ++pageIndex)
+    {
+        span = findPlace(*_pages[pageIndex], width, height, &y);
+        if (span >= 0)
+            break;
+    }
+    if (span < 0)
+    {
+        Page* page = new Page();
+        page->data.resize(_pageWidth * _pageHeight * 4, 0);
+        Span s = { 0, 0, _pageWidth };
+        page->skyline.push_back(s);
+        page->sampler = NULL;
+        page->dirty = true;
+        _pages.push_back(page);
+        pageIndex = (unsigned int)_pages.size() - 1;
+        span = findPlace(*page, width, height, &y);
+        GP_ASSERT(span >= 0);
+    }
+
+    Page& page = *_pages[pageIndex];
+    Entry entry;
+    entry.page = pageIndex;
+    entry.x = page.skyline[span].x + _padding;
+    entry.y = y + _padding;
+    entry.width = image->getWidth();
+    entry.height = image->getHeight();
+    place(page, span, width, height, y);
+    copyImage(page, entry, image);
+    page.dirty = true;
+    _entries[id] = entry;
+    return true;
+}
+
+bool TextureAtlas::contains(const char* id) const
+{
+    GP_ASSERT(id);
+
+    return _entries.find(id) != _entries.end();
+}
+
+unsigned int TextureAtlas::getPageCount() const
+{
+    return (unsigned int)_pages.size();
+}
+
+Texture::Sampler* TextureAtlas::getPageSampler(unsigned int page)
+{
+    GP_ASSERT(page < _pages.size());
+
+    Page* p = _pages[page];
+    if (p->dirty)
+    {
+        if (p->sampler == NULL)
+        {
+            Texture* texture = Texture::create(Texture::RGBA, _pageWidth, _pageHeight, &p->data[0]);
+            p->sampler = Texture::Sampler::create(texture);
+            p->sampler->setWrapMode(Texture::CLAMP, Texture::CLAMP);
+            p->sampler->setFilterMode(Texture::LINEAR, Texture::LINEAR);
+            SAFE_RELEASE(texture);
+        }
+        else
+        {
+            p->sampler->getTexture()->setData(&p->data[0]);
+        }
+        p->dirty = false;
+    }
+    return p->sampler;
+}
+
+Texture::Sampler* TextureAtlas::getSampler(const char* id)
+{
+    std::map<std::string, Entry>::const_iterator itr = _entries.find(id);
+    return itr != _entries.end() ? getPageSampler(itr->second.page) : NULL;
+}
+
+unsigned int TextureAtlas::getPage(const char* id) const
+{
+    return getEntry(id).page;
+}
+
+Rectangle TextureAtlas::getRegion(const char* id) const
+{
+    const Entry& entry = getEntry(id);
+    return Rectangle((float)entry.x, (float)entry.y, (float)entry.width, (float)entry.height);
+}
+
+Rectangle TextureAtlas::getRegion(const char* id, const Rectangle& source) const
+{
+    const Entry& entry = getEntry(id);
+    return Rectangle(entry.x + source.x, entry.y + source.y, source.width, source.height);
+}
+
+void TextureAtlas::getUVs(const char* id, float* u1, float* v1, float* u2, float* v2) const
+{
+    GP_ASSERT(u1 && v1 && u2 && v2);
+
+    // Both the image and the page have their top at v = 1.
+    const Entry& entry = getEntry(id);
+    float x = (float)entry.x / _pageWidth;
+    float y = 1.0f - (float)(entry.y + entry.height) / _pageHeight;
+    float width = (float)entry.width / _pageWidth;
+    float height = (float)entry.height / _pageHeight;
+    *u1 = x + *u1 * width;
+    *v1 = y + *v1 * height;
+    *u2 = x + *u2 * width;
+    *v2 = y + *v2 * height;
+}
+
+const TextureAtlas::Entry& TextureAtlas::getEntry(const char* id) const
+{
+    GP_ASSERT(id);
+
+    std::map<std::string, Entry>::const_iterator itr = _entries.find(id);
+    GP_ASSERT(itr != _entries.end());
+    return itr->second;
+}
+
+int TextureAtlas::findPlace(const Page& page, unsigned int width, unsigned int height, unsigned int* y) const
+{
+    // Rest the rectangle on the skyline at the left of each span, keeping the place where its
+    // bottom is highest, and then the one with the narrowest span, to leave the fewest gaps.
+    int best = -1;
+    unsigned int bestBottom = UINT_MAX;
+    unsigned int bestWidth = UINT_MAX;
+    const std::vector<Span>& skyline = page.skyline;
+    for (size_t i = 0, count = skyline.size(); i < count; ++i)
+    {
+        if (skyline[i].x + width > _pageWidth)
+            break;
+
+        unsigned int top = 0;
+        unsigned int covered = 0;
+        for (size_t j = i; covered < width; ++j)
+        {
+            top = std::max(top, skyline[j].y);
+            covered += skyline[j].width;
+        }
+        if (top + height > _pageHeight)
+            continue;
+
+        if (top + height < bestBottom || (top + height == bestBottom && skyline[i].width < bestWidth))
+        {
+            best = (int)i;
+            bestBottom = top + height;
+            bestWidth = skyline[i].width;
+            *y = top;
+        }
+    }
+    return best;
+}
+
+void TextureAtlas::place(Page& page, int span, unsigned int width, unsigned int height, unsigned int y)
+{
+    std::vector<Span>& skyline = page.skyline;
+    Span s = { skyline[span].x, y + height, width };
+    skyline.insert(skyline.begin() + span, s);
+
+    // Cut the spans covered by the new span.
+    unsigned int right = s.x + s.width;
+    size_t i = span + 1;
+    while (i < skyline.size() && skyline[i].x < right)
+    {
+        unsigned int spanRight = skyline[i].x + skyline[i].width;
+        if (spanRight <= right)
+        {
+            skyline.erase(skyline.begin() + i);
+        }
+        else
+        {
+            skyline[i].width = spanRight - right;
+            skyline[i].x = right;
+            break;
+        }
+    }
+
+    // Merge neighbouring spans of the same height.
+    for (i = 0; i + 1 < skyline.size();)
+    {
+        if (skyline[i].y == skyline[i + 1].y)
+        {
+            skyline[i].width += skyline[i + 1].width;
+            skyline.erase(skyline.begin() + i + 1);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+
+void TextureAtlas::copyImage(Page& page, const Entry& entry, Image* image)
+{
+    unsigned int imageWidth = image->getWidth();
+    unsigned int imageHeight = image->getHeight();
+    unsigned int components = image->getFormat() == Image::RGBA ? 4 : 3;
+    const unsigned char* imageData = image->getData();
+    int padding = (int)_padding;
+
+    // Both the image and the page hold their bottom row first.
+    for (int y = -padding; y < (int)imageHeight + padding; ++y)
+    {
+        int imageY = std::min(std::max(y, 0), (int)imageHeight - 1);
+        const unsigned char* imageRow = imageData + (imageHeight - 1 - imageY) * imageWidth * components;
+        unsigned char* pageRow = &page.data[((_pageHeight - 1 - (entry.y + y)) * _pageWidth + entry.x) * 4];
+        for (int x = -padding; x < (int)imageWidth + padding; ++x)
+        {
+            int imageX = std::min(std::max(x, 0), (int)imageWidth - 1);
+            const unsigned char* pixel = imageRow + imageX * components;
+            unsigned char* pagePixel = pageRow + x * 4;
+            pagePixel[0] = pixel[0];
+            pagePixel[1] = pixel[1];
+            pagePixel[2] = pixel[2];
+            pagePixel[3] = components == 4 ? pixel[3] : 255;
+        }
+    }
+}
+
+}
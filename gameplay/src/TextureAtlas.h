@@ -0,0 +1,234 @@
+#ifndef TEXTUREATLAS_H_
+#define TEXTUREATLAS_H_
+
+#include "Ref.h"
+#include "Texture.h"
+#include "Rectangle.h"
+
+namespace gameplay
+{
+
+class Image;
+
+/**
+ * Defines a set of textures, or pages, into which images are packed at runtime.
+ *
+ * Drawing images from a few shared textures, rather than from a texture per image,
+ * lets a SpriteBatch draw sprites of different images without being flushed. Images
+ * are packed into the first page with room for them, and a new page is added when
+ * none has room. Each image is surrounded by padding that repeats its edge pixels, so
+ * that filtering does not blend it with its neighbours.
+ *
+ * Images are looked up by id, which is the path of the images added from files, and
+ * are drawn with the sampler of their page and their region or texture coordinates
+ * within it. Pages are uploaded to the graphics device when their samplers are first
+ * requested after images were added to them. Adding the largest images first packs
+ * them most tightly.
+ */
+class TextureAtlas : public Ref
+{
+public:
+
+    /**
+     * Creates a new, empty texture atlas.
+     *
+     * @param pageWidth The width of the pages of the atlas, in pixels.
+     * @param pageHeight The height of the pages of the atlas, in pixels.
+     * @param padding The number of pixels around each image.
+     *
+     * @return A new texture atlas.
+     * @script{create}
+     */
+    static TextureAtlas* create(unsigned int pageWidth = 1024, unsigned int pageHeight = 1024, unsigned int padding = 1);
+
+    /**
+     * Adds the image of a file to the atlas, using its path as its id.
+     *
+     * @param path The path of the image file, which is loaded with Image::create.
+     *
+     * @return true if the image was added or is already in the atlas, false if it could not
+     *      be loaded or is larger than a page.
+     */
+    bool add(const char* path);
+
+    /**
+     * Adds an image to the atlas.
+     *
+     * The pixels of the image are copied, so it does not need to be kept.
+     *
+     * @param id The id of the image, which must not be in the atlas already.
+     * @param image The image to add.
+     *
+     * @return true if the image was added, false if it is larger than a page.
+     */
+    bool add(const char* id, Image* image);
+
+    /**
+     * Determines if an image is in the atlas.
+     *
+     * @param id The id of the image.
+     *
+     * @return true if the image is in the atlas.
+     */
+    bool contains(const char* id) const;
+
+    /**
+     * Gets the number of pages in the atlas.
+     *
+     * @return The number of pages.
+     */
+    unsigned int getPageCount() const;
+
+    /**
+     * Gets the sampler of a page, uploading the images added to the page since it was
+     * last uploaded.
+     *
+     * @param page The index of the page.
+     *
+     * @return The sampler of the page, whose texture is in the RGBA format.
+     */
+    Texture::Sampler* getPageSampler(unsigned int page);
+
+    /**
+     * Gets the sampler of the page that holds an image.
+     *
+     * @param id The id of the image.
+     *
+     * @return The sampler of the page, or NULL if the image is not in the atlas.
+     */
+    Texture::Sampler* getSampler(const char* id);
+
+    /**
+     * Gets the index of the page that holds an image.
+     *
+     * @param id The id of the image, which must be in the atlas.
+     *
+     * @return The index of the page.
+     */
+    unsigned int getPage(const char* id) const;
+
+    /**
+     * Gets the region of the page that holds an image, in pixels from the top left corner
+     * of the page, as used for the source rectangles of SpriteBatch::draw.
+     *
+     * @param id The id of the image, which must be in the atlas.
+     *
+     * @return The region of the image.
+     */
+    Rectangle getRegion(const char* id) const;
+
+    /**
+     * Maps a region of an image, in pixels from the top left corner of the image, to the
+     * region of the page that holds it.
+     *
+     * @param id The id of the image, which must be in the atlas.
+     * @param source The region of the image.
+     *
+     * @return The region of the page.
+     */
+    Rectangle getRegion(const char* id, const Rectangle& source) const;
+
+    /**
+     * Maps texture coordinates of an image to the texture coordinates of the page that
+     * holds it.
+     *
+     * Texture coordinates are given in the convention of SpriteBatch::draw, where the top
+     * of an image is at v = 1.
+     *
+     * @param id The id of the image, which must be in the atlas.
+     * @param u1 The left texture coordinate, mapped in place.
+     * @param v1 The top texture coordinate, mapped in place.
+     * @param u2 The right texture coordinate, mapped in place.
+     * @param v2 The bottom texture coordinate, mapped in place.
+     */
+    void getUVs(const char* id, float* u1, float* v1, float* u2, float* v2) const;
+
+private:
+
+    /**
+     * The span of a page's skyline: the top of the free space above a range of columns.
+     */
+    struct Span
+    {
+        unsigned int x;
+        unsigned int y;
+        unsigned int width;
+    };
+
+    /**
+     * A page of the atlas, which keeps its pixels, bottom row first, to upload them again
+     * when images are added to it.
+     */
+    struct Page
+    {
+        std::vector<unsigned char> data;
+        std::vector<Span> skyline;
+        Texture::Sampler* sampler;
+        bool dirty;
+    };
+
+    /**
+     * The region of an image in a page, in pixels from the top left corner of the page,
+     * excluding its padding.
+     */
+    struct Entry
+    {
+        unsigned int page;
+        unsigned int x;
+        unsigned int y;
+        unsigned int width;
+        unsigned int height;
+    };
+
+    /**
+     * Constructor.
+     */
+    TextureAtlas(unsigned int pageWidth, unsigned int pageHeight, unsigned int padding);
+
+    /**
+     * Destructor.
+     */
+    ~TextureAtlas();
+
+    /**
+     * Hidden copy constructor.
+     */
+    TextureAtlas(const TextureAtlas& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    TextureAtlas& operator=(const TextureAtlas&);
+
+    /**
+     * Finds the lowest place of a page for a rectangle, by the skyline bottom-left rule.
+     *
+     * @return The index of the span the rectangle starts at, or -1 if it does not fit.
+     */
+    int findPlace(const Page& page, unsigned int width, unsigned int height, unsigned int* y) const;
+
+    /**
+     * Raises the skyline of a page over a rectangle placed at a span.
+     */
+    void place(Page& page, int span, unsigned int width, unsigned int height, unsigned int y);
+
+    /**
+     * Copies an image to a region of a page, repeating its edges over its padding.
+     */
+    void copyImage(Page& page, const Entry& entry, Image* image);
+
+    /**
+     * Gets the entry of an image, which must be in the atlas.
+     */
+    const Entry& getEntry(const char* id) const;
+
+    unsigned int _pageWidth;
+    unsigned int _pageHeight;
+    unsigned int _padding;
+    std::vector<Page*> _pages;
+    std::map<std::string, Entry> _entries;
+};
+
+}
+
+#endif
@@ -1,11 +1,11 @@
 #include "Base.h"
 #include "Theme.h"
 #include "ThemeStyle.h"
+#include "ResourceCache.h"
 
 namespace gameplay
 {
 
-static std::vector<Theme*> __themeCache;
 
 Theme::Theme()
 {
@@ -42,11 +42,7 @@ Theme::~Theme()
     SAFE_RELEASE(_texture);
 
     // Remove ourself from the theme cache.
-    std::vector<Theme*>::iterator itr = std::find(__themeCache.begin(), __themeCache.end(), this);
-    if (itr != __themeCache.end())
-    {
-        __themeCache.erase(itr);
-    }
+    ResourceCache::remove(this);
 }
 
 Theme* Theme::create(const char* url)
@@ -54,16 +50,14 @@ Theme* Theme::create(const char* url)
     GP_ASSERT(url);
 
     // Search theme cache first.
-    for (size_t i = 0, count = __themeCache.size(); i < count; ++i)
+    std::string key = ResourceCache::getPathKey(url);
+    Theme* t = static_cast<Theme*>(ResourceCache::find(ResourceCache::THEME, key));
+    if (t)
     {
-        Theme* t = __themeCache[i];
-        if (t->_url == url)
-        {
-            // Found a match.
-            t->addRef();
+        // Found a match.
+        t->addRef();
 
-            return t;
-        }
+        return t;
     }
 
     // Load theme properties from file path.
@@ -424,7 +418,7 @@ Theme* Theme::create(const char* url)
     }
 
     // Add this theme to the cache.
-    __themeCache.push_back(theme);
+    ResourceCache::add(ResourceCache::THEME, key, theme, 0);
 
     SAFE_DELETE(properties);
 
@@ -0,0 +1,252 @@
+#include "Base.h"
+#include "ThreadPool.h"
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+namespace gameplay
+{
+
+/**
+ * The synchronization state shared by the worker threads.
+ */
+struct ThreadPool::Context
+{
+#ifdef WIN32
+    CRITICAL_SECTION lock;
+    CONDITION_VARIABLE workReady;
+    CONDITION_VARIABLE workDone;
+    std::vector<HANDLE> threads;
+#else
+    pthread_mutex_t lock;
+    pthread_cond_t workReady;
+    pthread_cond_t workDone;
+    std::vector<pthread_t> threads;
+#endif
+    JobFunction function;
+    ThreadJobFunction threadFunction;
+    void* data;
+    unsigned int count;
+    unsigned int next;
+    unsigned int remaining;
+    unsigned int generation;
+    unsigned int startedThreads;
+    bool exiting;
+};
+
+#ifdef WIN32
+#define THREADPOOL_LOCK(c)          EnterCriticalSection(&(c)->lock)
+#define THREADPOOL_UNLOCK(c)        LeaveCriticalSection(&(c)->lock)
+#define THREADPOOL_WAIT(c, cond)    SleepConditionVariableCS(&(c)->cond, &(c)->lock, INFINITE)
+#define THREADPOOL_SIGNAL(c, cond)  WakeConditionVariable(&(c)->cond)
+#define THREADPOOL_BROADCAST(c, cond) WakeAllConditionVariable(&(c)->cond)
+#else
+#define THREADPOOL_LOCK(c)          pthread_mutex_lock(&(c)->lock)
+#define THREADPOOL_UNLOCK(c)        pthread_mutex_unlock(&(c)->lock)
+#define THREADPOOL_WAIT(c, cond)    pthread_cond_wait(&(c)->cond, &(c)->lock)
+#define THREADPOOL_SIGNAL(c, cond)  pthread_cond_signal(&(c)->cond)
+#define THREADPOOL_BROADCAST(c, cond) pthread_cond_broadcast(&(c)->cond)
+#endif
+
+ThreadPool::ThreadPool()
+    : _threadCount(1), _context(NULL)
+{
+}
+
+ThreadPool::~ThreadPool()
+{
+    if (_context)
+    {
+        THREADPOOL_LOCK(_context);
+        _context->exiting = true;
+        THREADPOOL_BROADCAST(_context, workReady);
+        THREADPOOL_UNLOCK(_context);
+
+        for (size_t i = 0, count = _context->threads.size(); i < count; ++i)
+        {
+#ifdef WIN32
+            WaitForSingleObject(_context->threads[i], INFINITE);
+            CloseHandle(_context->threads[i]);
+#else
+            pthread_join(_context->threads[i], NULL);
+#endif
+        }
+
+#ifdef WIN32
+        DeleteCriticalSection(&_context->lock);
+#else
+        pthread_cond_destroy(&_context->workDone);
+        pthread_cond_destroy(&_context->workReady);
+        pthread_mutex_destroy(&_context->lock);
+#endif
+        SAFE_DELETE(_context);
+    }
+}
+
+ThreadPool* ThreadPool::create(unsigned int threadCount)
+{
+    ThreadPool* pool = new ThreadPool();
+    if (threadCount <= 1)
+        return pool;
+
+    Context* context = new Context();
+    context->function = NULL;
+    context->threadFunction = NULL;
+    context->data = NULL;
+    context->count = 0;
+    context->next = 0;
+    context->remaining = 0;
+    context->generation = 0;
+    context->startedThreads = 0;
+    context->exiting = false;
+#ifdef WIN32
+    InitializeCriticalSection(&context->lock);
+    InitializeConditionVariable(&context->workReady);
+    InitializeConditionVariable(&context->workDone);
+#else
+    pthread_mutex_init(&context->lock, NULL);
+    pthread_cond_init(&context->workReady, NULL);
+    pthread_cond_init(&context->workDone, NULL);
+#endif
+    pool->_context = context;
+
+    // The calling thread runs jobs as well, so start one less worker thread.
+    for (unsigned int i = 1; i < threadCount; ++i)
+    {
+#ifdef WIN32
+        HANDLE thread = CreateThread(NULL, 0, &ThreadPool::workerThread, pool, 0, NULL);
+        if (thread == NULL)
+#else
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, &ThreadPool::workerThread, pool) != 0)
+#endif
+        {
+            GP_WARN("Failed to create thread pool worker thread %u of %u.", i, threadCount - 1);
+            break;
+        }
+        context->threads.push_back(thread);
+    }
+    pool->_threadCount = (unsigned int)context->threads.size() + 1;
+
+    return pool;
+}
+
+unsigned int ThreadPool::getThreadCount() const
+{
+    return _threadCount;
+}
+
+void ThreadPool::run(JobFunction function, void* data, unsigned int count)
+{
+    GP_ASSERT(function);
+
+    run(function, NULL, data, count);
+}
+
+void ThreadPool::run(ThreadJobFunction function, void* data, unsigned int count)
+{
+    GP_ASSERT(function);
+
+    run(NULL, function, data, count);
+}
+
+void ThreadPool::run(JobFunction function, ThreadJobFunction threadFunction, void* data, unsigned int count)
+{
+    if (_context == NULL || count <= 1)
+    {
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            if (function)
+                function(data, i);
+            else
+                threadFunction(data, i, 0);
+        }
+        return;
+    }
+
+    THREADPOOL_LOCK(_context);
+    _context->function = function;
+    _context->threadFunction = threadFunction;
+    _context->data = data;
+    _context->count = count;
+    _context->next = 0;
+    _context->remaining = count;
+    ++_context->generation;
+    THREADPOOL_BROADCAST(_context, workReady);
+
+    runJobs(0);
+    while (_context->remaining > 0)
+        THREADPOOL_WAIT(_context, workDone);
+
+    _context->function = NULL;
+    _context->threadFunction = NULL;
+    _context->data = NULL;
+    THREADPOOL_UNLOCK(_context);
+}
+
+void ThreadPool::runJobs(unsigned int threadIndex)
+{
+    while (_context->next < _context->count)
+    {
+        unsigned int index = _context->next++;
+        JobFunction function = _context->function;
+        ThreadJobFunction threadFunction = _context->threadFunction;
+        void* data = _context->data;
+
+        THREADPOOL_UNLOCK(_context);
+        if (function)
+            function(data, index);
+        else
+            threadFunction(data, index, threadIndex);
+        THREADPOOL_LOCK(_context);
+
+        if (--_context->remaining == 0)
+            THREADPOOL_SIGNAL(_context, workDone);
+    }
+}
+
+#ifdef WIN32
+unsigned long __stdcall ThreadPool::workerThread(void* pool)
+#else
+void* ThreadPool::workerThread(void* pool)
+#endif
+{
+    ThreadPool* threadPool = static_cast<ThreadPool*>(pool);
+    Context* context = threadPool->_context;
+
+    // The calling thread of run() has index zero, and worker threads count up from one.
+    THREADPOOL_LOCK(context);
+    unsigned int threadIndex = ++context->startedThreads;
+    unsigned int generation = context->generation;
+    while (true)
+    {
+        while (!context->exiting && generation == context->generation)
+            THREADPOOL_WAIT(context, workReady);
+        if (context->exiting)
+            break;
+
+        generation = context->generation;
+        threadPool->runJobs(threadIndex);
+    }
+    THREADPOOL_UNLOCK(context);
+
+    return 0;
+}
+
+unsigned int ThreadPool::getProcessorCount()
+{
+#ifdef WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (unsigned int)info.dwNumberOfProcessors : 1;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (unsigned int)count : 1;
+#endif
+}
+
+}
@@ -0,0 +1,128 @@
+#ifndef THREADPOOL_H_
+#define THREADPOOL_H_
+
+namespace gameplay
+{
+
+/**
+ * Defines a pool of worker threads used to run independent jobs in parallel.
+ *
+ * Jobs are submitted as a function and a job count using run(). The function is called
+ * once for each job index, on the worker threads and on the calling thread, and run()
+ * returns once all jobs have completed. Jobs of a single run must not depend on each other.
+ */
+class ThreadPool
+{
+public:
+
+    /**
+     * Defines the function called for each job.
+     *
+     * @param data The user data passed to run().
+     * @param index The index of the job, between zero and the job count minus one.
+     */
+    typedef void (*JobFunction)(void* data, unsigned int index);
+
+    /**
+     * Defines the function called for each job, with the index of the thread running it.
+     *
+     * @param data The user data passed to run().
+     * @param index The index of the job, between zero and the job count minus one.
+     * @param threadIndex The index of the thread running the job, between zero and the thread
+     *      count minus one, where zero is the thread calling run(). Jobs running concurrently
+     *      have different thread indices, so they can accumulate results per thread without locking.
+     */
+    typedef void (*ThreadJobFunction)(void* data, unsigned int index, unsigned int threadIndex);
+
+    /**
+     * Creates a thread pool.
+     *
+     * @param threadCount The number of threads running jobs, including the thread calling run().
+     *      A thread pool with a thread count of one runs all jobs on the calling thread.
+     *
+     * @return The new thread pool.
+     * @script{ignore}
+     */
+    static ThreadPool* create(unsigned int threadCount);
+
+    /**
+     * Destructor. Waits for the worker threads to exit.
+     */
+    ~ThreadPool();
+
+    /**
+     * Gets the number of threads running jobs, including the thread calling run().
+     *
+     * @return The number of threads.
+     */
+    unsigned int getThreadCount() const;
+
+    /**
+     * Runs a number of jobs and waits for all of them to complete.
+     *
+     * @param function The function to call for each job.
+     * @param data The user data passed to the function.
+     * @param count The number of jobs to run.
+     * @script{ignore}
+     */
+    void run(JobFunction function, void* data, unsigned int count);
+
+    /**
+     * Runs a number of jobs, passing each the index of the thread running it, and waits for all of them to complete.
+     *
+     * @param function The function to call for each job.
+     * @param data The user data passed to the function.
+     * @param count The number of jobs to run.
+     * @script{ignore}
+     */
+    void run(ThreadJobFunction function, void* data, unsigned int count);
+
+    /**
+     * Gets the number of processors available on the device.
+     *
+     * @return The number of processors.
+     */
+    static unsigned int getProcessorCount();
+
+private:
+
+    struct Context;
+
+    /**
+     * Constructor.
+     */
+    ThreadPool();
+
+    /**
+     * Hidden copy constructor.
+     */
+    ThreadPool(const ThreadPool& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    ThreadPool& operator=(const ThreadPool&);
+
+    /**
+     * Runs a number of jobs with either kind of function and waits for all of them to complete.
+     */
+    void run(JobFunction function, ThreadJobFunction threadFunction, void* data, unsigned int count);
+
+    /**
+     * Runs jobs of the current run until none are left. The context lock must be held.
+     */
+    void runJobs(unsigned int threadIndex);
+
+#ifdef WIN32
+    static unsigned long __stdcall workerThread(void* pool);
+#else
+    static void* workerThread(void* pool);
+#endif
+
+    unsigned int _threadCount;
+    Context* _context;
+};
+
+}
+
+#endif
@@ -0,0 +1,180 @@
+#include "Base.h"
+#include "TransformHierarchy.h"
+#include "Node.h"
+#include "PhysicsCollisionObject.h"
+#include "Scene.h"
+#include "ThreadPool.h"
+
+// The number of nodes below which a dirty subtree is computed as a single job.
+#define TRANSFORM_JOB_SIZE 1024
+
+namespace gameplay
+{
+
+TransformHierarchy::TransformHierarchy(Scene* scene, unsigned int threadCount)
+    : _scene(scene), _threadPool(NULL), _valid(false), _notifying(NULL)
+{
+    GP_ASSERT(scene);
+
+    if (threadCount == 0)
+        threadCount = ThreadPool::getProcessorCount();
+    if (threadCount > 1)
+        _threadPool = ThreadPool::create(threadCount);
+}
+
+TransformHierarchy::~TransformHierarchy()
+{
+    for (Node* node = _scene->getFirstNode(); node != NULL; node = node->getNextSibling())
+    {
+        node->detachTransformHierarchy();
+    }
+    SAFE_DELETE(_threadPool);
+}
+
+bool TransformHierarchy::isDirty() const
+{
+    return !_valid || !_dirtyRoots.empty();
+}
+
+void TransformHierarchy::invalidate()
+{
+    _valid = false;
+    _dirtyRoots.clear();
+}
+
+void TransformHierarchy::setDirty(unsigned int index)
+{
+    GP_ASSERT(_valid && index < _nodes.size());
+
+    if (!_dirty[index])
+    {
+        _dirty[index] = 1;
+        _dirtyRoots.push_back(index);
+    }
+}
+
+void TransformHierarchy::update()
+{
+    if (!_valid)
+        rebuild();
+    if (_dirtyRoots.empty())
+        return;
+
+    // Find the dirty subtrees that are not inside another dirty subtree.
+    std::sort(_dirtyRoots.begin(), _dirtyRoots.end());
+    std::vector<unsigned int> stack;
+    unsigned int end = 0;
+    for (size_t i = 0, count = _dirtyRoots.size(); i < count; ++i)
+    {
+        unsigned int root = _dirtyRoots[i];
+        _dirty[root] = 0;
+        if (root < end)
+            continue;
+        end = _ends[root];
+
+        // Split large subtrees into one job per child subtree, computing their roots first.
+        stack.push_back(root);
+        while (!stack.empty())
+        {
+            unsigned int index = stack.back();
+            stack.pop_back();
+            if (_threadPool == NULL || _ends[index] - index <= TRANSFORM_JOB_SIZE)
+            {
+                _jobs.push_back(index);
+            }
+            else
+            {
+                computeWorldMatrix(index);
+                for (unsigned int child = index + 1; child < _ends[index]; child = _ends[child])
+                    stack.push_back(child);
+            }
+        }
+    }
+    _dirtyRoots.clear();
+
+    if (_threadPool)
+    {
+        _threadPool->run(&TransformHierarchy::computeJob, this, (unsigned int)_jobs.size());
+    }
+    else
+    {
+        for (unsigned int i = 0, count = (unsigned int)_jobs.size(); i < count; ++i)
+            computeJob(this, i);
+    }
+    _jobs.clear();
+}
+
+void TransformHierarchy::rebuild()
+{
+    _nodes.clear();
+    _parents.clear();
+    _ends.clear();
+
+    // Flatten the scene in depth-first order.
+    std::vector<unsigned int> stack;
+    for (Node* root = _scene->getFirstNode(); root != NULL; root = root->getNextSibling())
+    {
+        Node* node = root;
+        while (node)
+        {
+            unsigned int index = (unsigned int)_nodes.size();
+            node->_hierarchy = this;
+            node->_hierarchyIndex = index;
+            _nodes.push_back(node);
+            _parents.push_back(stack.empty() ? -1 : (int)stack.back());
+            _ends.push_back(0);
+
+            // Descend to the first child, or move to the next sibling, closing the subtrees left behind.
+            if (node->getFirstChild())
+            {
+                stack.push_back(index);
+                node = node->getFirstChild();
+                continue;
+            }
+            _ends[index] = index + 1;
+            while (node != root && node->getNextSibling() == NULL)
+            {
+                node = node->getParent();
+                _ends[stack.back()] = (unsigned int)_nodes.size();
+                stack.pop_back();
+            }
+            node = node == root ? NULL : node->getNextSibling();
+        }
+    }
+
+    size_t count = _nodes.size();
+    _world.resize(count);
+    _dirty.assign(count, 0);
+    _dirtyRoots.clear();
+    _valid = true;
+
+    // Every root subtree must be computed.
+    for (unsigned int i = 0; i < count; i = _ends[i])
+        setDirty(i);
+}
+
+void TransformHierarchy::computeWorldMatrix(unsigned int index)
+{
+    Node* node = _nodes[index];
+    int parent = _parents[index];
+
+    // Nodes with a dynamic collision object are not affected by their parent.
+    PhysicsCollisionObject* collisionObject = node->_collisionObject;
+    if (parent >= 0 && (!collisionObject || collisionObject->isKinematic()))
+        Matrix::multiply(_world[parent], node->getMatrix(), &_world[index]);
+    else
+        _world[index] = node->getMatrix();
+
+    node->setFlattenedWorldMatrix(_world[index]);
+}
+
+void TransformHierarchy::computeJob(void* hierarchy, unsigned int job)
+{
+    TransformHierarchy* h = static_cast<TransformHierarchy*>(hierarchy);
+    for (unsigned int i = h->_jobs[job], end = h->_ends[i]; i < end; ++i)
+    {
+        h->computeWorldMatrix(i);
+    }
+}
+
+}
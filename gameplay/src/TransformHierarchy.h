@@ -0,0 +1,107 @@
+#ifndef TRANSFORMHIERARCHY_H_
+#define TRANSFORMHIERARCHY_H_
+
+#include "Matrix.h"
+
+namespace gameplay
+{
+
+class Node;
+class Scene;
+class ThreadPool;
+
+/**
+ * Defines a flattened copy of the node hierarchy of a scene, used to update the
+ * world matrices of its nodes together.
+ *
+ * The nodes are stored in depth-first order, so every node comes after its parent and
+ * the descendants of a node are the contiguous range that follows it. World matrices are
+ * kept in a contiguous array indexed the same way. When the transform of a node changes,
+ * the range of its subtree is marked dirty, and all dirty ranges are recomputed in one
+ * pass, split by subtree across threads, the next time a world matrix is requested.
+ *
+ * The hierarchy is rebuilt on the next update after nodes are added to or removed from the scene.
+ *
+ * @script{ignore}
+ */
+class TransformHierarchy
+{
+    friend class Node;
+    friend class Scene;
+
+private:
+
+    /**
+     * Constructor.
+     *
+     * @param scene The scene whose nodes are flattened.
+     * @param threadCount The number of threads computing world matrices.
+     */
+    TransformHierarchy(Scene* scene, unsigned int threadCount);
+
+    /**
+     * Destructor. Detaches all nodes of the scene.
+     */
+    ~TransformHierarchy();
+
+    /**
+     * Hidden copy constructor.
+     */
+    TransformHierarchy(const TransformHierarchy& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    TransformHierarchy& operator=(const TransformHierarchy&);
+
+    /**
+     * Determines if world matrices must be updated before they are read.
+     */
+    bool isDirty() const;
+
+    /**
+     * Marks the hierarchy to be rebuilt, after nodes were added or removed.
+     */
+    void invalidate();
+
+    /**
+     * Marks the subtree of a node dirty. The node must be part of the hierarchy.
+     */
+    void setDirty(unsigned int index);
+
+    /**
+     * Rebuilds the hierarchy if needed and recomputes the world matrices of the dirty subtrees.
+     */
+    void update();
+
+    /**
+     * Rebuilds the flattened arrays from the nodes of the scene.
+     */
+    void rebuild();
+
+    /**
+     * Computes the world matrix of the node at an index from the world matrix of its parent.
+     */
+    void computeWorldMatrix(unsigned int index);
+
+    /**
+     * Computes the world matrices of the subtree of a job.
+     */
+    static void computeJob(void* hierarchy, unsigned int job);
+
+    Scene* _scene;
+    ThreadPool* _threadPool;
+    bool _valid;
+    std::vector<Node*> _nodes;
+    std::vector<int> _parents;
+    std::vector<unsigned int> _ends;
+    std::vector<Matrix> _world;
+    std::vector<unsigned char> _dirty;
+    std::vector<unsigned int> _dirtyRoots;
+    std::vector<unsigned int> _jobs;
+    Node* _notifying;
+};
+
+}
+
+#endif
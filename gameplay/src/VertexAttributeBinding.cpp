@@ -2,26 +2,31 @@
 #include "VertexAttributeBinding.h"
 #include "Mesh.h"
 #include "Effect.h"
+#include "ResourceCache.h"
 
 namespace gameplay
 {
 
 static GLuint __maxVertexAttribs = 0;
-static std::vector<VertexAttributeBinding*> __vertexAttributeBindingCache;
+
+/**
+ * Gets the cache key of the binding between a mesh and an effect.
+ */
+static std::string __getCacheKey(Mesh* mesh, Effect* effect)
+{
+    const void* pointers[2] = { mesh, effect };
+    return std::string((const char*)pointers, sizeof(pointers));
+}
 
 VertexAttributeBinding::VertexAttributeBinding() :
-    _handle(0), _attributes(NULL), _mesh(NULL), _effect(NULL)
+    _handle(0), _attributes(NULL), _mesh(NULL), _vertexBuffer(0), _effect(NULL)
 {
 }
 
 VertexAttributeBinding::~VertexAttributeBinding()
 {
     // Delete from the vertex attribute binding cache.
-    std::vector<VertexAttributeBinding*>::iterator itr = std::find(__vertexAttributeBindingCache.begin(), __vertexAttributeBindingCache.end(), this);
-    if (itr != __vertexAttributeBindingCache.end())
-    {
-        __vertexAttributeBindingCache.erase(itr);
-    }
+    ResourceCache::remove(this);
 
     SAFE_RELEASE(_mesh);
     SAFE_RELEASE(_effect);
@@ -39,25 +44,21 @@ VertexAttributeBinding* VertexAttributeBinding::create(Mesh* mesh, Effect* effec
     GP_ASSERT(mesh);
 
     // Search for an existing vertex attribute binding that can be used.
-    VertexAttributeBinding* b;
-    for (size_t i = 0, count = __vertexAttributeBindingCache.size(); i < count; ++i)
+    std::string key = __getCacheKey(mesh, effect);
+    VertexAttributeBinding* b = static_cast<VertexAttributeBinding*>(ResourceCache::find(ResourceCache::VERTEX_ATTRIBUTE_BINDING, key));
+    if (b)
     {
-        b = __vertexAttributeBindingCache[i];
-        GP_ASSERT(b);
-        if (b->_mesh == mesh && b->_effect == effect)
-        {
-            // Found a match!
-            b->addRef();
-            return b;
-        }
+        // Found a match!
+        b->addRef();
+        return b;
     }
 
-    b = create(mesh, mesh->getVertexFormat(), 0, effect);
+    b = create(mesh, mesh->getVertexBuffer(), mesh->getVertexFormat(), 0, effect);
 
     // Add the new vertex attribute binding to the cache.
     if (b)
     {
-        __vertexAttributeBindingCache.push_back(b);
+        ResourceCache::add(ResourceCache::VERTEX_ATTRIBUTE_BINDING, key, b, 0);
     }
 
     return b;
@@ -65,10 +66,17 @@ VertexAttributeBinding* VertexAttributeBinding::create(Mesh* mesh, Effect* effec
 
 VertexAttributeBinding* VertexAttributeBinding::create(const VertexFormat& vertexFormat, void* vertexPointer, Effect* effect)
 {
-    return create(NULL, vertexFormat, vertexPointer, effect);
+    return create(NULL, 0, vertexFormat, vertexPointer, effect);
+}
+
+VertexAttributeBinding* VertexAttributeBinding::create(VertexBufferHandle vertexBuffer, const VertexFormat& vertexFormat, unsigned int vertexOffset, Effect* effect)
+{
+    GP_ASSERT(vertexBuffer);
+
+    return create(NULL, vertexBuffer, vertexFormat, (void*)(size_t)vertexOffset, effect);
 }
 
-VertexAttributeBinding* VertexAttributeBinding::create(Mesh* mesh, const VertexFormat& vertexFormat, void* vertexPointer, Effect* effect)
+VertexAttributeBinding* VertexAttributeBinding::create(Mesh* mesh, VertexBufferHandle vertexBuffer, const VertexFormat& vertexFormat, void* vertexPointer, Effect* effect)
 {
     GP_ASSERT(effect);
 
@@ -90,7 +98,7 @@ VertexAttributeBinding* VertexAttributeBinding::create(Mesh* mesh, const VertexF
     VertexAttributeBinding* b = new VertexAttributeBinding();
 
 #ifdef USE_VAO
-    if (mesh && glGenVertexArrays)
+    if (vertexBuffer && glGenVertexArrays)
     {
         GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, 0) );
         GL_ASSERT( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0) );
@@ -108,8 +116,8 @@ VertexAttributeBinding* VertexAttributeBinding::create(Mesh* mesh, const VertexF
         // Bind the new VAO.
         GL_ASSERT( glBindVertexArray(b->_handle) );
 
-        // Bind the Mesh VBO so our glVertexAttribPointer calls use it.
-        GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, mesh->getVertexBuffer()) );
+        // Bind the VBO so our glVertexAttribPointer calls use it.
+        GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer) );
     }
     else
 #endif
@@ -134,6 +142,7 @@ VertexAttributeBinding* VertexAttributeBinding::create(Mesh* mesh, const VertexF
         b->_mesh = mesh;
         mesh->addRef();
     }
+    b->_vertexBuffer = vertexBuffer;
     
     b->_effect = effect;
     effect->addRef();
@@ -253,14 +262,7 @@ void VertexAttributeBinding::bind()
     else
     {
         // Software mode
-        if (_mesh)
-        {
-            GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, _mesh->getVertexBuffer()) );
-        }
-        else
-        {
-            GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, 0) );
-        }
+        GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer) );
 
         GP_ASSERT(_attributes);
         for (unsigned int i = 0; i < __maxVertexAttribs; ++i)
@@ -285,7 +287,7 @@ void VertexAttributeBinding::unbind()
     else
     {
         // Software mode
-        if (_mesh)
+        if (_vertexBuffer)
         {
             GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, 0) );
         }
@@ -68,6 +68,23 @@ public:
      */
     static VertexAttributeBinding* create(const VertexFormat& vertexFormat, void* vertexPointer, Effect* effect);
 
+    /**
+     * Creates a new VertexAttributeBinding between a vertex buffer that is not owned
+     * by a Mesh and an Effect.
+     *
+     * The binding is not cached and does not own the vertex buffer, which must outlive
+     * the binding. The buffer may be reallocated with glBufferData while it is bound.
+     *
+     * @param vertexBuffer The vertex buffer.
+     * @param vertexFormat The vertex format.
+     * @param vertexOffset Offset of the first vertex in the vertex buffer, in bytes.
+     * @param effect The effect.
+     *
+     * @return A VertexAttributeBinding for the requested parameters.
+     * @script{ignore}
+     */
+    static VertexAttributeBinding* create(VertexBufferHandle vertexBuffer, const VertexFormat& vertexFormat, unsigned int vertexOffset, Effect* effect);
+
     /**
      * Binds this vertex array object.
      */
@@ -106,13 +123,14 @@ private:
      */
     VertexAttributeBinding& operator=(const VertexAttributeBinding&);
 
-    static VertexAttributeBinding* create(Mesh* mesh, const VertexFormat& vertexFormat, void* vertexPointer, Effect* effect);
+    static VertexAttributeBinding* create(Mesh* mesh, VertexBufferHandle vertexBuffer, const VertexFormat& vertexFormat, void* vertexPointer, Effect* effect);
 
     void setVertexAttribPointer(GLuint indx, GLint size, GLenum type, GLboolean normalize, GLsizei stride, void* pointer);
 
     GLuint _handle;
     VertexAttribute* _attributes;
     Mesh* _mesh;
+    VertexBufferHandle _vertexBuffer;
     Effect* _effect;
 };
 
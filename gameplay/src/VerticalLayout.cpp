@@ -71,7 +71,7 @@ void VerticalLayout::update(const Container* container, const Vector2& offset)
         yPosition += margin.top;
 
         control->setPosition(margin.left, yPosition);
-        control->update(container, offset);
+        updateControl(control, container, offset);
 
         yPosition += bounds.height + margin.bottom;
 
@@ -11,6 +11,10 @@
 #include "Bundle.h"
 #include "MathUtil.h"
 #include "Logger.h"
+#include "Profiler.h"
+#include "ThreadPool.h"
+#include "ResourceCache.h"
+#include "ResourceLoader.h"
 
 // Math
 #include "Rectangle.h"
@@ -29,6 +33,7 @@
 
 // Graphics
 #include "Texture.h"
+#include "TextureAtlas.h"
 #include "Mesh.h"
 #include "MeshPart.h"
 #include "Effect.h"
@@ -37,6 +42,8 @@
 #include "VertexFormat.h"
 #include "VertexAttributeBinding.h"
 #include "Model.h"
+#include "ModelBatch.h"
+#include "RenderQueue.h"
 #include "Camera.h"
 #include "Light.h"
 #include "Scene.h"